@@ -0,0 +1,584 @@
+/**
+ * @file kernels_bench.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Kernel-level microbenchmarks of the z2r_core library, without Python in the way.
+ *
+ * Every kernel is timed over a sweep of row counts, itemsizes and thread counts. For each
+ * configuration, the median wall time of a few repeats is reported, along with the throughput in
+ * bytes/s (bytes read + written by the kernel) and elements/s (rows, or pairs of rows for the
+ * products of weighted sums).
+ *
+ * Results are written as a JSON object of parallel lists, like the other files of
+ * benchmarks/results/ (e.g. {"num_qubits": [...], "time": [...]}), so they can be loaded with
+ * json.load() and plotted the same way.
+ *
+ * Usage:
+ *   z2r_bench [--kernels and,compose,...] [--rows 1000,1000000] [--itemsize 8,32]
+ *             [--threads 1,4,8] [--repeats 5] [--output results/kernels.json]
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_core.h"
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief One prepared run of a kernel: the call to time, and what it processes per call.
+ */
+struct Run {
+    std::function<void()> call;
+    double bytes;
+    double elements;
+};
+
+/**
+ * @brief A benchmarked kernel. `prepare` allocates the inputs and outputs for (rows, itemsize),
+ * and returns the call to time. Kernels whose cost grows faster than linearly cap the row count.
+ */
+struct Kernel {
+    std::string name;
+    size_t max_rows;
+    std::function<Run(size_t rows, size_t itemsize)> prepare;
+};
+
+struct Result {
+    std::string kernel;
+    size_t rows;
+    size_t itemsize;
+    int threads;
+    double time;
+    double bytes_per_second;
+    double elements_per_second;
+};
+
+std::vector<uint8_t> random_bytes(size_t n, uint64_t seed) {
+    std::vector<uint8_t> bytes(n);
+    uint64_t key = splitmix64(seed);
+    for (size_t i = 0; i < n; i += 8) {
+        uint64_t word = counter_rng64(key, i / 8);
+        std::memcpy(bytes.data() + i, &word, std::min<size_t>(8, n - i));
+    }
+    return bytes;
+}
+
+std::vector<std::complex<double>> random_weights(size_t n, uint64_t seed) {
+    std::vector<std::complex<double>> weights(n);
+    uint64_t key = splitmix64(seed);
+    for (size_t i = 0; i < n; ++i) {
+        weights[i] = {static_cast<double>(counter_rng64(key, 2 * i) >> 11) * 0x1.0p-53,
+                      static_cast<double>(counter_rng64(key, 2 * i + 1) >> 11) * 0x1.0p-53};
+    }
+    return weights;
+}
+
+// Buffers shared by the prepared calls, kept alive by the closures
+template <typename T> std::shared_ptr<std::vector<T>> share(std::vector<T> v) {
+    return std::make_shared<std::vector<T>>(std::move(v));
+}
+
+// rows voids drawn from rows / 8 distinct ones
+std::vector<uint8_t> duplicated_rows(size_t rows, size_t itemsize) {
+    size_t distinct = std::max<size_t>(rows / 8, 1);
+    std::vector<uint8_t> pool = random_bytes(distinct * itemsize, 1);
+    std::vector<uint8_t> out(rows * itemsize);
+    for (size_t i = 0; i < rows; ++i) {
+        std::memcpy(out.data() + i * itemsize, pool.data() + (i % distinct) * itemsize, itemsize);
+    }
+    return out;
+}
+
+// Random upper unitriangular matrices of itemsize * 8 bits, which are always invertible
+std::vector<uint8_t> invertible_matrices(size_t n_mats, size_t itemsize) {
+    size_t num_bits = itemsize * 8;
+    std::vector<uint8_t> out = random_bytes(n_mats * num_bits * itemsize, 1);
+    for (size_t r = 0; r < n_mats * num_bits; ++r) {
+        uint8_t *row = out.data() + r * itemsize;
+        size_t diagonal = r % num_bits;
+        for (size_t b = 0; b < num_bits; ++b) {
+            if (b < diagonal) {
+                row[b / 8] &= static_cast<uint8_t>(~(1u << (b % 8)));
+            }
+        }
+        row[diagonal / 8] |= static_cast<uint8_t>(1u << (diagonal % 8));
+    }
+    return out;
+}
+
+std::vector<int64_t> every_other_qubit(size_t itemsize) {
+    std::vector<int64_t> indices;
+    for (size_t q = 0; q < itemsize * 8; q += 2) {
+        indices.push_back(static_cast<int64_t>(q));
+    }
+    return indices;
+}
+
+template <typename Op> Kernel binary_kernel(const std::string &name, Op op) {
+    return {name, SIZE_MAX, [op](size_t rows, size_t itemsize) {
+                size_t n = rows * itemsize;
+                auto a = share(random_bytes(n, 1));
+                auto b = share(random_bytes(n, 2));
+                auto out = share(std::vector<uint8_t>(n));
+                return Run{[=] { op(*a, *b, *out); }, 3.0 * n, static_cast<double>(rows)};
+            }};
+}
+
+std::vector<Kernel> all_kernels() {
+    std::vector<Kernel> kernels;
+    kernels.push_back(binary_kernel("bitwise_and", [](auto &a, auto &b, auto &out) {
+        z2r::bitwise_and(a, b, out);
+    }));
+    kernels.push_back(binary_kernel("bitwise_xor", [](auto &a, auto &b, auto &out) {
+        z2r::bitwise_xor(a, b, out);
+    }));
+    kernels.push_back(binary_kernel("bitwise_or", [](auto &a, auto &b, auto &out) {
+        z2r::bitwise_or(a, b, out);
+    }));
+    kernels.push_back({"bitwise_not", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           size_t n = rows * itemsize;
+                           auto a = share(random_bytes(n, 1));
+                           auto out = share(std::vector<uint8_t>(n));
+                           return Run{[=] { z2r::bitwise_not(*a, *out); }, 2.0 * n,
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"bitwise_count", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<int64_t>(rows));
+                           return Run{[=] {
+                                          z2r::bitwise_count(VoidView(a->data(), rows, itemsize),
+                                                             *out);
+                                      },
+                                      static_cast<double>(rows * (itemsize + 8)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"bitwise_dot", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto b = share(random_bytes(rows * itemsize, 2));
+                           auto out = share(std::vector<int64_t>(rows));
+                           return Run{[=] {
+                                          z2r::bitwise_dot(VoidView(a->data(), rows, itemsize),
+                                                           VoidView(b->data(), rows, itemsize),
+                                                           *out);
+                                      },
+                                      static_cast<double>(rows * (2 * itemsize + 8)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"compose", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           size_t n = rows * itemsize;
+                           auto z1 = share(random_bytes(n, 1));
+                           auto x1 = share(random_bytes(n, 2));
+                           auto z2 = share(random_bytes(n, 3));
+                           auto x2 = share(random_bytes(n, 4));
+                           auto z = share(std::vector<uint8_t>(n));
+                           auto x = share(std::vector<uint8_t>(n));
+                           auto phases = share(std::vector<std::complex<double>>(rows));
+                           return Run{[=] {
+                                          z2r::compose(VoidView(z1->data(), rows, itemsize),
+                                                       VoidView(x1->data(), rows, itemsize),
+                                                       VoidView(z2->data(), rows, itemsize),
+                                                       VoidView(x2->data(), rows, itemsize),
+                                                       MutableVoidView(z->data(), rows, itemsize),
+                                                       MutableVoidView(x->data(), rows, itemsize),
+                                                       *phases);
+                                      },
+                                      static_cast<double>(rows * (6 * itemsize + 16)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"commute_with", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           size_t n = rows * itemsize;
+                           auto z1 = share(random_bytes(n, 1));
+                           auto x1 = share(random_bytes(n, 2));
+                           auto z2 = share(random_bytes(n, 3));
+                           auto x2 = share(random_bytes(n, 4));
+                           auto out = std::shared_ptr<bool[]>(new bool[rows]);
+                           return Run{[=] {
+                                          z2r::commute_with(VoidView(z1->data(), rows, itemsize),
+                                                            VoidView(x1->data(), rows, itemsize),
+                                                            VoidView(z2->data(), rows, itemsize),
+                                                            VoidView(x2->data(), rows, itemsize),
+                                                            std::span<bool>(out.get(), rows));
+                                      },
+                                      static_cast<double>(rows * (4 * itemsize + 1)),
+                                      static_cast<double>(rows)};
+                       }});
+    // O(rows * bits), one bit at a time
+    kernels.push_back({"transpose", 1 << 16, [](size_t rows, size_t itemsize) {
+                           size_t num_bits = itemsize * 8;
+                           size_t out_bytes = (rows + 7) / 8;
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<uint8_t>(num_bits * out_bytes));
+                           return Run{[=] {
+                                          z2r::transpose(
+                                              VoidView(a->data(), rows, itemsize), num_bits,
+                                              MutableVoidView(out->data(), num_bits, out_bytes));
+                                      },
+                                      static_cast<double>(2 * rows * itemsize),
+                                      static_cast<double>(rows)};
+                       }});
+    // O(rows * bits^2), one bit at a time
+    kernels.push_back({"matmul", 1 << 10, [](size_t rows, size_t itemsize) {
+                           size_t num_bits = itemsize * 8;
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto b = share(random_bytes(num_bits * itemsize, 2));
+                           auto out = share(std::vector<uint8_t>(rows * itemsize));
+                           return Run{[=] {
+                                          z2r::matmul(VoidView(a->data(), rows, itemsize),
+                                                      VoidView(b->data(), num_bits, itemsize),
+                                                      num_bits, num_bits,
+                                                      MutableVoidView(out->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>((2 * rows + num_bits) * itemsize),
+                                      static_cast<double>(rows)};
+                       }});
+    // rows x 16 pairs of stitched zx voids
+    kernels.push_back({"accumulate_products", 1 << 16, [](size_t rows, size_t itemsize) {
+                           const size_t rows_b = 16;
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto b = share(random_bytes(rows_b * itemsize, 2));
+                           auto w_a = share(random_weights(rows, 3));
+                           auto w_b = share(random_weights(rows_b, 4));
+                           size_t num_qubits = itemsize * 4;
+                           return Run{[=] {
+                                          z2r::accumulate_products(
+                                              VoidView(a->data(), rows, itemsize), *w_a,
+                                              VoidView(b->data(), rows_b, itemsize), *w_b,
+                                              num_qubits, false);
+                                      },
+                                      static_cast<double>((rows + rows_b) * (itemsize + 16)),
+                                      static_cast<double>(rows * rows_b)};
+                       }});
+    // Many duplicates: only 1/8 of the rows are distinct
+    kernels.push_back({"simplify", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           size_t distinct = std::max<size_t>(rows / 8, 1);
+                           auto pool = random_bytes(distinct * itemsize, 1);
+                           auto a = share(std::vector<uint8_t>(rows * itemsize));
+                           for (size_t i = 0; i < rows; ++i) {
+                               std::memcpy(a->data() + i * itemsize,
+                                           pool.data() + (i % distinct) * itemsize, itemsize);
+                           }
+                           auto w = share(random_weights(rows, 2));
+                           return Run{[=] {
+                                          z2r::simplify(VoidView(a->data(), rows, itemsize), *w);
+                                      },
+                                      static_cast<double>(rows * (itemsize + 16)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"hash_partition", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<int64_t>(rows));
+                           return Run{[=] {
+                                          z2r::hash_partition(VoidView(a->data(), rows, itemsize),
+                                                              64, *out);
+                                      },
+                                      static_cast<double>(rows * (itemsize + 8)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"random_zx_voids", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           size_t n = rows * itemsize;
+                           auto z = share(std::vector<uint8_t>(n));
+                           auto x = share(std::vector<uint8_t>(n));
+                           return Run{[=] {
+                                          z2r::random_zx_voids(
+                                              itemsize * 8, -1, 1,
+                                              MutableVoidView(z->data(), rows, itemsize),
+                                              MutableVoidView(x->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>(2 * n), static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"unique", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto a = share(duplicated_rows(rows, itemsize));
+                           return Run{[=] { z2r::unique(VoidView(a->data(), rows, itemsize)); },
+                                      static_cast<double>(rows * (itemsize + 24)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"unordered_unique", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto a = share(duplicated_rows(rows, itemsize));
+                           return Run{[=] {
+                                          z2r::unordered_unique(
+                                              VoidView(a->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>(rows * (itemsize + 16)),
+                                      static_cast<double>(rows)};
+                       }});
+    // O(rows^2 * bits), one byte at a time
+    kernels.push_back({"row_echelon", 1 << 12, [](size_t rows, size_t itemsize) {
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<uint8_t>(rows * itemsize));
+                           return Run{[=] {
+                                          z2r::row_echelon(
+                                              VoidView(a->data(), rows, itemsize), itemsize * 8,
+                                              MutableVoidView(out->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>(2 * rows * itemsize),
+                                      static_cast<double>(rows)};
+                       }});
+    // rows terms on 10 qubits, O(rows * 2^10)
+    kernels.push_back({"to_matrix", 1 << 16, [](size_t rows, size_t itemsize) {
+                           const size_t num_qubits = std::min<size_t>(10, itemsize * 8);
+                           size_t dim = size_t{1} << num_qubits;
+                           auto z = share(random_bytes(rows * itemsize, 1));
+                           auto x = share(random_bytes(rows * itemsize, 2));
+                           auto out = share(std::vector<std::complex<double>>(dim * dim));
+                           return Run{[=] {
+                                          z2r::to_matrix(VoidView(z->data(), rows, itemsize),
+                                                         VoidView(x->data(), rows, itemsize),
+                                                         num_qubits, *out);
+                                      },
+                                      static_cast<double>(2 * rows * itemsize +
+                                                          dim * dim * 16),
+                                      static_cast<double>(rows)};
+                       }});
+    // The rows stack rows / bits invertible matrices of bits x bits, one call per matrix
+    kernels.push_back({"gauss_jordan_inverse", 1 << 16, [](size_t rows, size_t itemsize) {
+                           size_t num_bits = itemsize * 8;
+                           size_t n_mats = std::max<size_t>(rows / num_bits, 1);
+                           auto a = share(invertible_matrices(n_mats, itemsize));
+                           auto out = share(std::vector<uint8_t>(num_bits * itemsize));
+                           return Run{[=] {
+                                          for (size_t m = 0; m < n_mats; ++m) {
+                                              z2r::gauss_jordan_inverse(
+                                                  VoidView(a->data() + m * num_bits * itemsize,
+                                                           num_bits, itemsize),
+                                                  num_bits,
+                                                  MutableVoidView(out->data(), num_bits,
+                                                                  itemsize));
+                                          }
+                                      },
+                                      static_cast<double>(2 * n_mats * num_bits * itemsize),
+                                      static_cast<double>(n_mats * num_bits)};
+                       }});
+    kernels.push_back({"batched_gauss_jordan_inverse", SIZE_MAX,
+                       [](size_t rows, size_t itemsize) {
+                           size_t num_bits = itemsize * 8;
+                           size_t n_mats = std::max<size_t>(rows / num_bits, 1);
+                           auto a = share(invertible_matrices(n_mats, itemsize));
+                           auto out = share(std::vector<uint8_t>(a->size()));
+                           auto singular = std::shared_ptr<bool[]>(new bool[n_mats]);
+                           return Run{[=] {
+                                          z2r::batched_gauss_jordan_inverse(
+                                              VoidView(a->data(), n_mats * num_bits, itemsize),
+                                              num_bits,
+                                              MutableVoidView(out->data(), n_mats * num_bits,
+                                                              itemsize),
+                                              std::span<bool>(singular.get(), n_mats));
+                                      },
+                                      static_cast<double>(2 * n_mats * num_bits * itemsize),
+                                      static_cast<double>(n_mats * num_bits)};
+                       }});
+    // Every other qubit, so that each word is one PEXT
+    kernels.push_back({"get_qubit_slices", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto indices = share(every_other_qubit(itemsize));
+                           size_t out_itemsize = std::max<size_t>((indices->size() + 7) / 8, 1);
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<uint8_t>(rows * out_itemsize));
+                           return Run{[=] {
+                                          z2r::get_qubit_slices(
+                                              VoidView(a->data(), rows, itemsize), *indices,
+                                              MutableVoidView(out->data(), rows, out_itemsize));
+                                      },
+                                      static_cast<double>(rows * (itemsize + out_itemsize)),
+                                      static_cast<double>(rows)};
+                       }});
+    kernels.push_back({"set_qubit_slices", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto indices = share(every_other_qubit(itemsize));
+                           size_t sub_itemsize = std::max<size_t>((indices->size() + 7) / 8, 1);
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto sub = share(random_bytes(rows * sub_itemsize, 2));
+                           auto out = share(std::vector<uint8_t>(rows * itemsize));
+                           return Run{[=] {
+                                          z2r::set_qubit_slices(
+                                              VoidView(a->data(), rows, itemsize),
+                                              VoidView(sub->data(), rows, sub_itemsize),
+                                              *indices,
+                                              MutableVoidView(out->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>(rows * (2 * itemsize + sub_itemsize)),
+                                      static_cast<double>(rows)};
+                       }});
+    // Reversed qubits: the worst case, one run per qubit
+    kernels.push_back({"permute_qubits", SIZE_MAX, [](size_t rows, size_t itemsize) {
+                           auto permutation = share(std::vector<int64_t>(itemsize * 8));
+                           for (size_t q = 0; q < permutation->size(); ++q) {
+                               size_t reversed = permutation->size() - 1 - q;
+                               (*permutation)[q] = static_cast<int64_t>(reversed);
+                           }
+                           auto a = share(random_bytes(rows * itemsize, 1));
+                           auto out = share(std::vector<uint8_t>(rows * itemsize));
+                           return Run{[=] {
+                                          z2r::permute_qubits(
+                                              VoidView(a->data(), rows, itemsize), *permutation,
+                                              MutableVoidView(out->data(), rows, itemsize));
+                                      },
+                                      static_cast<double>(2 * rows * itemsize),
+                                      static_cast<double>(rows)};
+                       }});
+    return kernels;
+}
+
+std::vector<std::string> split(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::vector<size_t> split_sizes(const std::string &list) {
+    std::vector<size_t> sizes;
+    for (const std::string &item : split(list)) {
+        sizes.push_back(std::stoull(item));
+    }
+    return sizes;
+}
+
+double median_time(const std::function<void()> &call, int repeats) {
+    call(); // warm-up: page faults, thread pool creation
+    std::vector<double> times;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        call();
+        auto stop = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(stop - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+template <typename T, typename Get>
+void write_list(std::ostream &os, const char *key, const std::vector<Result> &results, Get get,
+                bool last = false) {
+    os << "    \"" << key << "\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        os << (i ? ",\n        " : "\n        ");
+        T value = get(results[i]);
+        if constexpr (std::is_same_v<T, std::string>) {
+            os << '"' << value << '"';
+        } else {
+            os << value;
+        }
+    }
+    os << (results.empty() ? "]" : "\n    ]") << (last ? "\n" : ",\n");
+}
+
+void write_json(std::ostream &os, const std::vector<Result> &results) {
+    os.precision(17);
+    os << "{\n";
+    write_list<std::string>(os, "kernel", results, [](const Result &r) { return r.kernel; });
+    write_list<size_t>(os, "rows", results, [](const Result &r) { return r.rows; });
+    write_list<size_t>(os, "itemsize", results, [](const Result &r) { return r.itemsize; });
+    write_list<int>(os, "threads", results, [](const Result &r) { return r.threads; });
+    write_list<double>(os, "time", results, [](const Result &r) { return r.time; });
+    write_list<double>(os, "bytes_per_second", results,
+                       [](const Result &r) { return r.bytes_per_second; });
+    write_list<double>(
+        os, "elements_per_second", results, [](const Result &r) { return r.elements_per_second; },
+        true);
+    os << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<Kernel> kernels = all_kernels();
+    std::vector<size_t> rows_list = {1'000, 100'000, 10'000'000};
+    std::vector<size_t> itemsize_list = {8, 32, 128};
+#ifdef USE_OPENMP
+    std::vector<size_t> threads_list = {1, static_cast<size_t>(z2r::threads::num_threads())};
+#else
+    std::vector<size_t> threads_list = {1};
+#endif
+    std::vector<std::string> selected;
+    int repeats = 5;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--kernels") {
+            selected = split(value);
+        } else if (arg == "--rows") {
+            rows_list = split_sizes(value);
+        } else if (arg == "--itemsize") {
+            itemsize_list = split_sizes(value);
+        } else if (arg == "--threads") {
+            threads_list = split_sizes(value);
+        } else if (arg == "--repeats") {
+            repeats = std::max(std::stoi(value), 1);
+        } else if (arg == "--output") {
+            output = value;
+        } else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    std::printf("%-28s %10s %8s %7s %12s %12s %12s\n", "kernel", "rows", "itemsize", "threads",
+                "time (s)", "GB/s", "Melem/s");
+    for (const Kernel &kernel : kernels) {
+        if (!selected.empty() &&
+            std::find(selected.begin(), selected.end(), kernel.name) == selected.end()) {
+            continue;
+        }
+        for (size_t rows : rows_list) {
+            if (rows > kernel.max_rows) {
+                continue;
+            }
+            for (size_t itemsize : itemsize_list) {
+                Run run = kernel.prepare(rows, itemsize);
+                for (size_t threads : threads_list) {
+#ifdef USE_OPENMP
+                    z2r::threads::set_num_threads(static_cast<int>(threads));
+#else
+                    if (threads != 1) {
+                        continue;
+                    }
+#endif
+                    double time = median_time(run.call, repeats);
+                    Result result{kernel.name, rows, itemsize, static_cast<int>(threads), time,
+                                  run.bytes / time, run.elements / time};
+                    std::printf("%-28s %10zu %8zu %7zu %12.6g %12.4g %12.4g\n",
+                                kernel.name.c_str(), rows, itemsize, threads, time,
+                                result.bytes_per_second * 1e-9, result.elements_per_second * 1e-6);
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    if (!output.empty()) {
+        std::ofstream file(output);
+        if (!file) {
+            std::cerr << "Cannot write " << output << "\n";
+            return 1;
+        }
+        write_json(file, results);
+    } else {
+        write_json(std::cout, results);
+    }
+    return 0;
+}
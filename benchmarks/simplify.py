@@ -1,15 +1,39 @@
+import os
 import pickle
+import numpy as np
 from qiskit.quantum_info import SparsePauliOp
 import pauliarray as pa
 import pauliarray.conversion.qiskit as conv
 
-with open("SparsePauliOp.pkl", "rb") as f:
-    op: SparsePauliOp = pickle.load(f)
+from z2r_accel.storage import read_operator, write_operator
 
-# pa.WeightedPauliArray.from_labels_and_weights(op.paulis.to_labels(), op.coeffs)
-# conv.pauli_array_from_pauli_list(op.paulis)
-# op.coeffs
-wpa = conv.weighted_pauli_array_from_pauli_list_and_coeffs(op.paulis, op.coeffs)
-print(wpa.num_qubits)
-print(wpa.x_voids)
+CACHE = "SparsePauliOp.z2r"
+
+
+def stitch_zx(z_voids, x_voids, num_qubits):
+    # Z bits [0, n) followed by X bits [n, 2n), as expected by the weighted-sum kernels
+    z_bytes = z_voids.view(np.uint8).reshape(z_voids.size, -1)
+    x_bytes = x_voids.view(np.uint8).reshape(x_voids.size, -1)
+    z_bits = np.unpackbits(z_bytes, axis=1, bitorder="little")
+    x_bits = np.unpackbits(x_bytes, axis=1, bitorder="little")
+    zx_bits = np.concatenate((z_bits[:, :num_qubits], x_bits[:, :num_qubits]), axis=1)
+    zx = np.packbits(zx_bits, axis=1, bitorder="little")
+    return np.ascontiguousarray(zx).view(f"V{zx.shape[1]}").ravel()
+
+
+if not os.path.exists(CACHE):
+    with open("SparsePauliOp.pkl", "rb") as f:
+        op: SparsePauliOp = pickle.load(f)
+
+    # pa.WeightedPauliArray.from_labels_and_weights(op.paulis.to_labels(), op.coeffs)
+    # conv.pauli_array_from_pauli_list(op.paulis)
+    # op.coeffs
+    wpa = conv.weighted_pauli_array_from_pauli_list_and_coeffs(op.paulis, op.coeffs)
+    zx = stitch_zx(wpa.z_voids.ravel(), wpa.x_voids.ravel(), wpa.num_qubits)
+    write_operator(CACHE, zx, wpa.weights, wpa.num_qubits)
+
+# Zero-copy views on the file, pages are loaded on first touch
+zx_voids, weights, num_qubits = read_operator(CACHE)
+print(num_qubits)
+print(zx_voids)
 # op.paulis.to_labels()
@@ -0,0 +1,80 @@
+import numpy as np
+from numpy.typing import NDArray
+
+# Dense references for the tests: Pauli strings as (z, x) bool arrays of shape (rows, num_qubits),
+# packed into voids with bit q at bit q % 8 of byte q // 8, and their 2^n x 2^n matrices, qubit 0
+# being the leftmost factor of the Kronecker product. (z, x) = (1, 1) is Y = -i Z X.
+
+I2 = np.eye(2, dtype=np.complex128)
+X = np.array([[0, 1], [1, 0]], dtype=np.complex128)
+Z = np.array([[1, 0], [0, -1]], dtype=np.complex128)
+Y = np.array([[0, -1j], [1j, 0]], dtype=np.complex128)
+
+
+def random_paulis(rng, rows: int, num_qubits: int, density: float = 0.5):
+    """Random (z, x) bool arrays, each bit set with probability density."""
+    z = rng.random((rows, num_qubits)) < density
+    x = rng.random((rows, num_qubits)) < density
+    return z, x
+
+
+def pack_voids(bits: NDArray[np.bool_], itemsize: int = None) -> NDArray:
+    """Packs the rows of a bool array into voids, zero-padded to itemsize bytes."""
+    bits = np.asarray(bits, dtype=bool)
+    bits = bits.reshape(len(bits), int(np.prod(bits.shape[1:])))
+    packed = np.packbits(bits, axis=1, bitorder="little")
+    if itemsize is None:
+        itemsize = max(packed.shape[1], 1)
+    out = np.zeros((len(bits), itemsize), dtype=np.uint8)
+    out[:, : packed.shape[1]] = packed
+    return out.view(f"|V{itemsize}").ravel()
+
+
+def unpack_voids(voids: NDArray, num_bits: int) -> NDArray[np.bool_]:
+    """The first num_bits bits of every void, as a bool array of shape (len(voids), num_bits)."""
+    voids = np.ascontiguousarray(voids).ravel()
+    raw = voids.view(np.uint8).reshape(len(voids), voids.dtype.itemsize)
+    return np.unpackbits(raw, axis=1, bitorder="little")[:, :num_bits].astype(bool)
+
+
+def zx_voids(z, x, itemsize: int = None) -> NDArray:
+    """Stitched zx voids: Z bits [0, n) followed by X bits [n, 2n)."""
+    return pack_voids(np.concatenate([z, x], axis=1), itemsize)
+
+
+def split_zx_voids(zx: NDArray, num_qubits: int):
+    """(z, x) bool arrays of stitched zx voids."""
+    bits = unpack_voids(zx, 2 * num_qubits)
+    return bits[:, :num_qubits], bits[:, num_qubits:]
+
+
+def pauli_matrix(z_row, x_row) -> NDArray[np.complex128]:
+    """Dense matrix of one Pauli string."""
+    out = np.ones((1, 1), dtype=np.complex128)
+    for zq, xq in zip(z_row, x_row):
+        out = np.kron(out, [[I2, X], [Z, Y]][int(zq)][int(xq)])
+    return out
+
+
+def operator_matrix(z, x, weights, num_qubits: int) -> NDArray[np.complex128]:
+    """Dense matrix of a weighted sum of Pauli strings."""
+    out = np.zeros((2**num_qubits, 2**num_qubits), dtype=np.complex128)
+    for zr, xr, w in zip(z, x, weights):
+        out += w * pauli_matrix(zr, xr)
+    return out
+
+
+def zx_operator_matrix(zx: NDArray, weights, num_qubits: int) -> NDArray[np.complex128]:
+    """Dense matrix of a weighted sum of Pauli strings given as stitched zx voids."""
+    z, x = split_zx_voids(zx, num_qubits)
+    return operator_matrix(z, x, weights, num_qubits)
+
+
+def simplify_reference(zx: NDArray, weights) -> dict:
+    """Serial reference of simplify(): the summed weight of every distinct void, by its bytes."""
+    out = {}
+    raw = np.ascontiguousarray(zx).ravel().view(np.uint8).reshape(len(zx), -1)
+    for row, w in zip(raw, weights):
+        key = row.tobytes()
+        out[key] = out.get(key, 0) + w
+    return out
@@ -0,0 +1,85 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._bitops")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import pack_voids
+
+
+@pytest.fixture(autouse=True)
+def restore_arena():
+    limit, outputs = z2r_accel.arena_stats()["limit"], z2r_accel.arena_outputs()
+    yield
+    z2r_accel.set_arena_limit(limit)
+    z2r_accel.set_arena_outputs(outputs)
+
+
+def _operands(rows: int = 5000):
+    rng = np.random.default_rng(0)
+    return pack_voids(rng.random((rows, 72)) < 0.5), pack_voids(rng.random((rows, 72)) < 0.5)
+
+
+def test_arena_stats_and_limit():
+    stats = z2r_accel.arena_stats()
+    assert set(stats) == {"hits", "misses", "live_bytes", "cached_bytes", "limit"}
+    z2r_accel.set_arena_limit(1 << 20)
+    assert z2r_accel.arena_stats()["limit"] == 1 << 20
+
+
+def test_arena_outputs():
+    a, b = _operands()
+    expected = np.bitwise_xor(a.view(np.uint8), b.view(np.uint8))
+    z2r_accel.set_arena_outputs(False)
+    assert not z2r_accel.arena_outputs()
+    z2r_accel.set_arena_outputs(True)
+    assert z2r_accel.arena_outputs()
+
+    before = z2r_accel.arena_stats()
+    out = z2r_accel.bitwise_xor(a, b)
+    during = z2r_accel.arena_stats()
+    assert out.ctypes.data % 64 == 0
+    np.testing.assert_array_equal(out.view(np.uint8), expected)
+    assert during["live_bytes"] >= before["live_bytes"] + out.nbytes
+
+    # Freeing the array gives its block back to the pool, and the next output of that size reuses it
+    del out
+    after = z2r_accel.arena_stats()
+    assert after["live_bytes"] <= during["live_bytes"] - a.nbytes
+    assert after["cached_bytes"] >= a.nbytes
+    out = z2r_accel.bitwise_xor(a, b)
+    assert z2r_accel.arena_stats()["hits"] > after["hits"]
+    np.testing.assert_array_equal(out.view(np.uint8), expected)
+
+
+def test_arena_limit_and_trim():
+    a, b = _operands()
+    z2r_accel.set_arena_outputs(True)
+    z2r_accel.set_arena_limit(0)
+    assert z2r_accel.arena_stats()["cached_bytes"] == 0
+    out = z2r_accel.bitwise_xor(a, b)
+    del out
+    # Nothing is kept with a limit of 0
+    assert z2r_accel.arena_stats()["cached_bytes"] == 0
+
+    z2r_accel.set_arena_limit(1 << 30)
+    out = z2r_accel.bitwise_xor(a, b)
+    del out
+    assert z2r_accel.arena_stats()["cached_bytes"] > 0
+    z2r_accel.trim_arena()
+    assert z2r_accel.arena_stats()["cached_bytes"] == 0
+
+
+def test_arena_limit_covers_every_module():
+    # One pool per process: the blocks freed by the outputs of _bitops and _cz2m share one limit
+    a, b = _operands(70000)
+    z2r_accel.set_arena_outputs(True)
+    z2r_accel.set_arena_limit(1 << 20)
+    z2r_accel.trim_arena()
+    new_z, new_x, phases = _cz2m.compose(a, b, b, a)
+    out = z2r_accel.bitwise_xor(a, b)
+    assert z2r_accel.arena_stats()["live_bytes"] >= out.nbytes + new_z.nbytes + new_x.nbytes
+    del new_z, new_x, phases, out
+    # Each of the three blocks of the voids fits alone, but two of them do not
+    cached = z2r_accel.arena_stats()["cached_bytes"]
+    assert a.nbytes <= cached <= 1 << 20
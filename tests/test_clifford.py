@@ -0,0 +1,185 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._clifford")
+import z2r_accel
+from dense import I2, X, Y, Z, pack_voids, pauli_matrix, random_paulis, unpack_voids
+
+H = np.array([[1, 1], [1, -1]], dtype=np.complex128) / np.sqrt(2)
+S = np.diag([1, 1j])
+P0 = np.diag([1, 0]).astype(np.complex128)
+P1 = np.diag([0, 1]).astype(np.complex128)
+SINGLE_QUBIT = {"h": H, "s": S, "sdg": S.conj().T, "x": X, "y": Y, "z": Z}
+INVERSE = {"s": "sdg", "sdg": "s"}
+
+
+def _embed(ops: dict, num_qubits: int):
+    out = np.ones((1, 1), dtype=np.complex128)
+    for q in range(num_qubits):
+        out = np.kron(out, ops.get(q, I2))
+    return out
+
+
+def gate_matrix(gate, num_qubits: int):
+    """Dense matrix of one gate, qubit 0 being the leftmost factor as in dense.py."""
+    name, a = gate[0], gate[1]
+    if name in SINGLE_QUBIT:
+        return _embed({a: SINGLE_QUBIT[name]}, num_qubits)
+    b = gate[2]
+    if name == "cx":
+        return _embed({a: P0}, num_qubits) + _embed({a: P1, b: X}, num_qubits)
+    if name == "cz":
+        return _embed({a: P0}, num_qubits) + _embed({a: P1, b: Z}, num_qubits)
+    assert name == "swap"
+    return sum(_embed({a: p, b: p}, num_qubits) for p in (I2, X, Y, Z)) / 2
+
+
+def circuit_matrix(gates, num_qubits: int):
+    out = np.eye(2**num_qubits, dtype=np.complex128)
+    for gate in gates:
+        out = gate_matrix(gate, num_qubits) @ out
+    return out
+
+
+def random_circuit(rng, num_qubits: int, num_gates: int):
+    gates = []
+    for _ in range(num_gates):
+        name = rng.choice(["h", "s", "sdg", "x", "y", "z", "cx", "cz", "swap"])
+        a, b = rng.choice(num_qubits, 2, replace=False)
+        gates.append((name, int(a), int(b)) if name in ("cx", "cz", "swap") else (name, int(a)))
+    return gates
+
+
+def inverse_circuit(gates):
+    return [(INVERSE.get(g[0], g[0]),) + tuple(g[1:]) for g in reversed(gates)]
+
+
+def test_clifford_conjugate_matches_dense():
+    num_qubits = 4
+    rng = np.random.default_rng(0)
+    z, x = random_paulis(rng, 60, num_qubits)
+    weights = rng.normal(size=60) + 1j * rng.normal(size=60)
+    gates = random_circuit(rng, num_qubits, 40)
+    new_z, new_x, new_weights = z2r_accel.clifford_conjugate(
+        pack_voids(z), pack_voids(x), gates, weights
+    )
+
+    u = circuit_matrix(gates, num_qubits)
+    out_z, out_x = unpack_voids(new_z, num_qubits), unpack_voids(new_x, num_qubits)
+    for i in range(len(z)):
+        expected = u @ (weights[i] * pauli_matrix(z[i], x[i])) @ u.conj().T
+        np.testing.assert_allclose(
+            new_weights[i] * pauli_matrix(out_z[i], out_x[i]), expected, atol=1e-12
+        )
+
+
+def test_clifford_conjugate_inverse_circuit():
+    # Qubits on both sides of a 64-bit word boundary, and a compiled circuit
+    num_qubits = 130
+    rng = np.random.default_rng(1)
+    z, x = random_paulis(rng, 500, num_qubits)
+    gates = random_circuit(rng, num_qubits, 300)
+    compiled = z2r_accel.compile_gates(gates)
+    new_z, new_x, phases = z2r_accel.clifford_conjugate(pack_voids(z), pack_voids(x), compiled)
+
+    assert np.all(np.isin(phases, [1, -1]))
+    back_z, back_x, back_phases = z2r_accel.clifford_conjugate(
+        new_z, new_x, inverse_circuit(gates), phases
+    )
+    np.testing.assert_array_equal(unpack_voids(back_z, num_qubits), z)
+    np.testing.assert_array_equal(unpack_voids(back_x, num_qubits), x)
+    np.testing.assert_array_equal(back_phases, 1)
+
+
+def test_clifford_conjugate_errors():
+    voids = pack_voids(np.zeros((3, 4), dtype=bool))
+    with pytest.raises(RuntimeError):
+        z2r_accel.clifford_conjugate(voids, voids, [("cx", 0, 8)])
+    with pytest.raises(RuntimeError):
+        z2r_accel.clifford_conjugate(voids, voids, np.array([[9, 0, 0]]))
+
+
+def _state(gates, num_qubits: int):
+    psi = np.zeros(2**num_qubits, dtype=np.complex128)
+    psi[0] = 1
+    return circuit_matrix(gates, num_qubits) @ psi
+
+
+def _assert_stabilized(tableau, psi, num_qubits: int):
+    z, x, signs = tableau.stabilizers()
+    z, x = unpack_voids(z, num_qubits), unpack_voids(x, num_qubits)
+    for i in range(num_qubits):
+        np.testing.assert_allclose(signs[i] * pauli_matrix(z[i], x[i]) @ psi, psi, atol=1e-12)
+
+
+def test_tableau_stabilizers_and_destabilizers():
+    num_qubits = 5
+    rng = np.random.default_rng(2)
+    gates = random_circuit(rng, num_qubits, 60)
+    tableau = z2r_accel.StabilizerTableau(num_qubits, seed=0)
+    tableau.apply(gates)
+
+    _assert_stabilized(tableau, _state(gates, num_qubits), num_qubits)
+    sz, sx, _ = tableau.stabilizers()
+    dz, dx, _ = tableau.destabilizers()
+    sz, sx = unpack_voids(sz, num_qubits), unpack_voids(sx, num_qubits)
+    dz, dx = unpack_voids(dz, num_qubits), unpack_voids(dx, num_qubits)
+    # Destabilizer i only anticommutes with stabilizer i
+    anticommute = ((dz.astype(int) @ sx.T.astype(int)) + (dx.astype(int) @ sz.T.astype(int))) % 2
+    np.testing.assert_array_equal(anticommute, np.eye(num_qubits))
+
+
+def test_tableau_expectation_values_match_dense():
+    num_qubits = 5
+    rng = np.random.default_rng(3)
+    gates = random_circuit(rng, num_qubits, 60)
+    tableau = z2r_accel.StabilizerTableau(num_qubits, seed=0)
+    tableau.apply(gates)
+    psi = _state(gates, num_qubits)
+
+    # Random strings are mostly anticommuting with the state: add its stabilizers and products
+    z, x = random_paulis(rng, 200, num_qubits)
+    sz, sx, _ = tableau.stabilizers()
+    sz, sx = unpack_voids(sz, num_qubits), unpack_voids(sx, num_qubits)
+    pick = rng.random((100, num_qubits)) < 0.5
+    z = np.concatenate([z, sz, (pick.astype(int) @ sz.astype(int)) % 2 == 1])
+    x = np.concatenate([x, sx, (pick.astype(int) @ sx.astype(int)) % 2 == 1])
+    values = tableau.expectation_values(pack_voids(z), pack_voids(x))
+
+    expected = [np.vdot(psi, pauli_matrix(z[i], x[i]) @ psi).real for i in range(len(z))]
+    np.testing.assert_allclose(values, expected, atol=1e-12)
+    assert np.all(np.isin(values, [-1, 0, 1]))
+    assert (values != 0).sum() > 100
+
+
+def test_tableau_measure_matches_dense():
+    num_qubits = 5
+    rng = np.random.default_rng(4)
+    for seed in range(5):
+        gates = random_circuit(rng, num_qubits, 40)
+        tableau = z2r_accel.StabilizerTableau(num_qubits, seed=seed)
+        tableau.apply(gates)
+        psi = _state(gates, num_qubits)
+        for qubit in rng.permutation(num_qubits):
+            outcome, deterministic = tableau.measure(int(qubit))
+            p1 = np.linalg.norm(_embed({qubit: P1}, num_qubits) @ psi) ** 2
+            if deterministic:
+                assert p1 == pytest.approx(outcome)
+            else:
+                assert p1 == pytest.approx(0.5)
+            projected = _embed({qubit: [P0, P1][outcome]}, num_qubits) @ psi
+            psi = projected / np.linalg.norm(projected)
+            _assert_stabilized(tableau, psi, num_qubits)
+            # Measuring again gives the same outcome, deterministically
+            assert tableau.measure(int(qubit)) == (outcome, True)
+
+
+def test_tableau_measure_is_seeded():
+    gates = [("h", q) for q in range(70)]
+    outcomes = []
+    for _ in range(2):
+        tableau = z2r_accel.StabilizerTableau(70, seed=11)
+        tableau.apply(gates)
+        outcomes.append([tableau.measure(q)[0] for q in range(70)])
+    assert outcomes[0] == outcomes[1]
+    assert 0 < sum(outcomes[0]) < 70
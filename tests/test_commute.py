@@ -0,0 +1,100 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import random_paulis, zx_voids
+
+
+def _commute_matrix(zx, terms, num_qubits, qubit_wise):
+    """Reference flags of each void against every term, from the element-wise kernels."""
+    pairwise = z2r_accel.zx_bitwise_commute_with if qubit_wise else z2r_accel.zx_commute_with
+    return np.array([pairwise(zx[i : i + 1], terms, num_qubits) for i in range(len(zx))])
+
+
+@pytest.mark.parametrize("qubit_wise", [False, True])
+@pytest.mark.parametrize("num_qubits", [7, 70])
+def test_commute_reductions_match_pairwise(num_qubits, qubit_wise):
+    # Sparse strings, so that each void commutes with some terms and not with others. The first
+    # void is the identity, which commutes with every term.
+    rng = np.random.default_rng(num_qubits + qubit_wise)
+    density = 1 / num_qubits
+    z, x = random_paulis(rng, 150, num_qubits, density)
+    tz, tx = random_paulis(rng, 301, num_qubits, density)
+    z[0], x[0] = False, False
+    zx, terms = zx_voids(z, x), zx_voids(tz, tx)
+    flags = _commute_matrix(zx, terms, num_qubits, qubit_wise)
+    anticommuting = ~flags
+
+    def call(function):
+        return function(zx, terms, num_qubits, qubit_wise=qubit_wise)
+
+    np.testing.assert_array_equal(call(z2r_accel.commutes_all), flags.all(axis=1))
+    np.testing.assert_array_equal(call(z2r_accel.commutes_any), flags.any(axis=1))
+    np.testing.assert_array_equal(call(z2r_accel.count_anticommuting), anticommuting.sum(axis=1))
+    first = np.where(anticommuting.any(axis=1), anticommuting.argmax(axis=1), -1)
+    np.testing.assert_array_equal(call(z2r_accel.first_anticommuting), first)
+    mask = call(z2r_accel.commute_mask)
+    assert mask.shape == (150, (301 + 7) // 8) and mask.dtype == np.uint8
+    unpacked = np.unpackbits(mask, axis=-1, count=301, bitorder="little").astype(bool)
+    np.testing.assert_array_equal(unpacked, flags)
+    assert not np.unpackbits(mask, axis=-1, bitorder="little")[:, 301:].any()
+    assert flags.all(axis=1).any() and not flags.all(axis=1).all()
+
+
+@pytest.mark.parametrize("qubit_wise", [False, True])
+def test_commute_reductions_many_rows(qubit_wise):
+    # Many voids against fewer terms than one block of them: the work is split over the voids
+    num_qubits = 70
+    rng = np.random.default_rng(10 + qubit_wise)
+    z, x = random_paulis(rng, 3000, num_qubits, 1 / num_qubits)
+    tz, tx = random_paulis(rng, 301, num_qubits, 1 / num_qubits)
+    zx, terms = zx_voids(z, x), zx_voids(tz, tx)
+    flags = _commute_matrix(zx, terms, num_qubits, qubit_wise)
+    anticommuting = ~flags
+
+    def call(function):
+        return function(zx, terms, num_qubits, qubit_wise=qubit_wise)
+
+    np.testing.assert_array_equal(call(z2r_accel.commutes_any), flags.any(axis=1))
+    np.testing.assert_array_equal(call(z2r_accel.count_anticommuting), anticommuting.sum(axis=1))
+    first = np.where(anticommuting.any(axis=1), anticommuting.argmax(axis=1), -1)
+    np.testing.assert_array_equal(call(z2r_accel.first_anticommuting), first)
+    unpacked = np.unpackbits(call(z2r_accel.commute_mask), axis=-1, count=301, bitorder="little")
+    np.testing.assert_array_equal(unpacked.astype(bool), flags)
+
+
+def test_commute_reductions_shapes():
+    num_qubits = 5
+    rng = np.random.default_rng(1)
+    z, x = random_paulis(rng, 6, num_qubits)
+    tz, tx = random_paulis(rng, 20, num_qubits)
+    zx, terms = zx_voids(z, x).reshape(2, 3), zx_voids(tz, tx)
+
+    flags = _commute_matrix(zx.ravel(), terms, num_qubits, False)
+    np.testing.assert_array_equal(
+        z2r_accel.count_anticommuting(zx, terms, num_qubits), (~flags).sum(axis=1).reshape(2, 3)
+    )
+    assert z2r_accel.commute_mask(zx, terms, num_qubits).shape == (2, 3, 3)
+    # A single void gives a scalar
+    single = z2r_accel.commutes_all(zx[0, 0], terms, num_qubits)
+    assert np.ndim(single) == 0 and single == flags[0].all()
+    assert z2r_accel.count_anticommuting(zx[0, 0], terms, num_qubits) == (~flags[0]).sum()
+
+
+def test_commute_reductions_without_terms():
+    zx = zx_voids(*random_paulis(np.random.default_rng(2), 4, 3))
+    terms = zx[:0]
+    assert z2r_accel.commutes_all(zx, terms, 3).all()
+    assert not z2r_accel.commutes_any(zx, terms, 3).any()
+    np.testing.assert_array_equal(z2r_accel.count_anticommuting(zx, terms, 3), 0)
+    np.testing.assert_array_equal(z2r_accel.first_anticommuting(zx, terms, 3), -1)
+    assert z2r_accel.commute_mask(zx, terms, 3).shape == (4, 0)
+
+
+def test_commute_reductions_errors():
+    zx = zx_voids(*random_paulis(np.random.default_rng(3), 4, 8))
+    with pytest.raises(RuntimeError):
+        z2r_accel.commutes_all(zx, zx, 9)
+    with pytest.raises(RuntimeError):
+        z2r_accel.commutes_all(zx, np.zeros(4, dtype="V4"), 8)
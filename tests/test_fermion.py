@@ -0,0 +1,168 @@
+import itertools
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import I2, Z, unpack_voids, zx_operator_matrix
+
+MAPPINGS = ["jordan_wigner", "parity", "bravyi_kitaev"]
+LOWER = np.array([[0, 1], [0, 0]], dtype=np.complex128)  # |0><1|, |1> being occupied
+
+
+def _encoding(mapping: str, num_modes: int):
+    """GF(2) matrix A such that the qubits of the occupations n hold A n."""
+    if mapping == "jordan_wigner":
+        return np.eye(num_modes, dtype=int)
+    if mapping == "parity":
+        return np.tril(np.ones((num_modes, num_modes), dtype=int))
+    # Qubit k holds the parity of the modes (k - lowbit(k + 1), k] of a Fenwick tree
+    a = np.zeros((num_modes, num_modes), dtype=int)
+    for k in range(num_modes):
+        a[k, k + 1 - ((k + 1) & -(k + 1)) : k + 1] = 1
+    return a
+
+
+def _basis_change(mapping: str, num_modes: int):
+    """Permutation matrix sending the occupation state |n> to the qubit state |A n>."""
+    a = _encoding(mapping, num_modes)
+    weights = 2 ** np.arange(num_modes - 1, -1, -1)
+    u = np.zeros((2**num_modes, 2**num_modes))
+    for n in itertools.product([0, 1], repeat=num_modes):
+        u[(a @ n) % 2 @ weights, np.array(n) @ weights] = 1
+    return u
+
+
+def _ladders(mapping: str, num_modes: int):
+    """Dense annihilation operators of every mode, in the qubit encoding of the mapping."""
+    u = _basis_change(mapping, num_modes)
+    out = []
+    for j in range(num_modes):
+        factors = [Z] * j + [LOWER] + [I2] * (num_modes - j - 1)
+        a = np.ones((1, 1), dtype=np.complex128)
+        for factor in factors:
+            a = np.kron(a, factor)
+        out.append(u @ a @ u.T)
+    return out
+
+
+def _mapped(modes, creation, values, num_modes, mapping, tolerance=0.0):
+    zx, w = z2r_accel.ladder_to_qubit(modes, creation, values, num_modes, mapping, tolerance)
+    raw = np.ascontiguousarray(zx).view(np.uint8).reshape(len(zx), -1)
+    assert len(np.unique(raw, axis=0)) == len(zx)
+    return zx_operator_matrix(zx, w, num_modes)
+
+
+@pytest.mark.parametrize("mapping", MAPPINGS)
+def test_ladder_operators_match_dense(mapping):
+    num_modes = 5
+    ladders = _ladders(mapping, num_modes)
+    mapped = []
+    for j in range(num_modes):
+        a = _mapped([[j]], [[False]], [1], num_modes, mapping)
+        a_dag = _mapped([[j]], [[True]], [1], num_modes, mapping)
+        np.testing.assert_allclose(a, ladders[j], atol=1e-12)
+        np.testing.assert_allclose(a_dag, ladders[j].conj().T, atol=1e-12)
+        mapped.append(a)
+
+    # Canonical anticommutation relations
+    identity = np.eye(2**num_modes)
+    for i, j in itertools.product(range(num_modes), repeat=2):
+        ai, aj = mapped[i], mapped[j]
+        np.testing.assert_allclose(ai @ aj + aj @ ai, 0, atol=1e-12)
+        expected = identity if i == j else 0
+        np.testing.assert_allclose(ai @ aj.conj().T + aj.conj().T @ ai, expected, atol=1e-12)
+
+
+@pytest.mark.parametrize("mapping", MAPPINGS)
+def test_ladder_products_match_dense(mapping):
+    # Products of up to 4 ladder operators, padded with identities (-1)
+    num_modes = 4
+    rng = np.random.default_rng(0)
+    modes = rng.integers(-1, num_modes, (30, 4))
+    creation = rng.random((30, 4)) < 0.5
+    values = rng.normal(size=30) + 1j * rng.normal(size=30)
+    ladders = _ladders(mapping, num_modes)
+
+    expected = np.zeros((2**num_modes, 2**num_modes), dtype=np.complex128)
+    for term_modes, term_creation, value in zip(modes, creation, values):
+        product = np.eye(2**num_modes, dtype=np.complex128)
+        for mode, create in zip(term_modes, term_creation):
+            if mode >= 0:
+                product = product @ (ladders[mode].conj().T if create else ladders[mode])
+        expected += value * product
+    result = _mapped(modes, creation, values, num_modes, mapping)
+    np.testing.assert_allclose(result, expected, atol=1e-12)
+
+
+@pytest.mark.parametrize("mapping", MAPPINGS)
+def test_fermion_to_qubit_integrals(mapping):
+    num_modes = 4
+    rng = np.random.default_rng(1)
+    one_body = rng.normal(size=(num_modes, num_modes))
+    one_body[rng.random(one_body.shape) < 0.3] = 0
+    two_body = np.zeros((num_modes,) * 4)
+    indices = rng.integers(0, num_modes, (25, 4))
+    values = rng.normal(size=25)
+    np.add.at(two_body, tuple(indices.T), values)
+    ladders = _ladders(mapping, num_modes)
+    dag = [a.conj().T for a in ladders]
+
+    expected = 0.5 * np.eye(2**num_modes, dtype=np.complex128)
+    for i, j in itertools.product(range(num_modes), repeat=2):
+        expected += one_body[i, j] * dag[i] @ ladders[j]
+    for i, j, k, l in itertools.product(range(num_modes), repeat=4):
+        expected += two_body[i, j, k, l] * dag[i] @ dag[j] @ ladders[k] @ ladders[l]
+
+    zx, w = z2r_accel.fermion_to_qubit(one_body, two_body, mapping=mapping, constant=0.5)
+    np.testing.assert_allclose(zx_operator_matrix(zx, w, num_modes), expected, atol=1e-12)
+    # The same integrals, as sparse (orbitals, values) tuples
+    sparse_one = (np.nonzero(one_body), one_body[np.nonzero(one_body)])
+    zx, w = z2r_accel.fermion_to_qubit(
+        sparse_one, (tuple(indices.T), values), num_modes, mapping, constant=0.5
+    )
+    np.testing.assert_allclose(zx_operator_matrix(zx, w, num_modes), expected, atol=1e-12)
+
+
+@pytest.mark.parametrize("mapping", MAPPINGS)
+def test_anticommutators_past_a_word(mapping):
+    # {a_i, a_j^dagger} maps to delta_ij I on 70 modes: every other string cancels exactly
+    num_modes = 70
+    for i, j in [(0, 69), (63, 64), (5, 5), (64, 64)]:
+        modes = [[i, j], [j, i]]
+        creation = [[False, True], [True, False]]
+        zx, w = z2r_accel.ladder_to_qubit(modes, creation, [1, 1], num_modes, mapping)
+        if i == j:
+            assert len(zx) == 1 and w[0] == pytest.approx(1)
+            assert not unpack_voids(zx, 2 * num_modes).any()
+        else:
+            assert len(zx) == 0
+        zx, _ = z2r_accel.ladder_to_qubit([[i, i]], [[True, True]], [1], num_modes, mapping)
+        assert len(zx) == 0
+
+
+def test_fermion_to_qubit_tolerance():
+    num_modes = 3
+    one_body = np.diag([1.0, 0.1, 0.2])
+    zx, w = z2r_accel.fermion_to_qubit(one_body, tolerance=0.075)
+    # a_j^dagger a_j = (I - Z_j) / 2: the Z_1 term of weight 0.05 is dropped
+    z = unpack_voids(zx, num_modes)
+    assert len(zx) == 3
+    assert sorted(np.flatnonzero(row).tolist() for row in z) == [[], [0], [2]]
+    assert w[~z.any(axis=1)][0] == pytest.approx(0.65)
+
+
+def test_fermion_to_qubit_errors():
+    with pytest.raises(ValueError):
+        z2r_accel.fermion_to_qubit(np.eye(2), mapping="ternary_tree")
+    with pytest.raises(ValueError):
+        z2r_accel.fermion_to_qubit(two_body=np.ones((2, 2)))
+    with pytest.raises(RuntimeError):
+        z2r_accel.ladder_to_qubit([[0, 3]], [[True, False]], [1], 3)
+    with pytest.raises(RuntimeError):
+        z2r_accel.ladder_to_qubit([[0, -2]], [[True, False]], [1], 3)
+    with pytest.raises(RuntimeError):
+        z2r_accel.ladder_to_qubit(np.zeros((1, 17), dtype=int), False, [1], 3)
+    with pytest.raises(RuntimeError):
+        z2r_accel.ladder_to_qubit([[0, 1]], [[True, False]], [1, 2], 3)
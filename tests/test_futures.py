@@ -0,0 +1,180 @@
+import asyncio
+import gc
+import weakref
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from z2r_accel import futures
+from z2r_accel._core.build import _cz2m
+from dense import pack_voids, pauli_matrix, random_paulis, zx_voids
+
+
+@pytest.fixture(autouse=True)
+def restore_workers():
+    yield
+    z2r_accel.set_async_workers(2)
+    z2r_accel.set_num_threads(None)
+
+
+def _calls(rng):
+    """(async function, sync function, inputs) of every *_async kernel."""
+    z, x = random_paulis(rng, 300, 20)
+    zx = zx_voids(z, x)
+    # Duplicated rows, so that unordered_unique has something to merge
+    repeated = zx[rng.integers(0, 100, 300)]
+    z1, x1 = pack_voids(z[:150]), pack_voids(x[:150])
+    z2, x2 = pack_voids(z[150:]), pack_voids(x[150:])
+    a = pack_voids(rng.random((50, 20)) < 0.5)
+    b = pack_voids(rng.random((20, 30)) < 0.5)
+    small_z, small_x = random_paulis(rng, 12, 4)
+    return [
+        (z2r_accel.unordered_unique_async, _cz2m.unordered_unique, (repeated,)),
+        (z2r_accel.compose_async, _cz2m.compose, (z1, x1, z2, x2)),
+        (z2r_accel.matmul_async, _cz2m.matmul, (a, b, 20, 30)),
+        (z2r_accel.row_echelon_async, _cz2m.row_echelon, (zx[:40], 40)),
+        (
+            z2r_accel.to_matrix_async,
+            _cz2m.to_matrix,
+            (pack_voids(small_z), pack_voids(small_x), 4),
+        ),
+    ]
+
+
+def _assert_results_equal(a, b):
+    if isinstance(a, tuple):
+        assert isinstance(b, tuple) and len(a) == len(b)
+        for a_i, b_i in zip(a, b):
+            _assert_results_equal(a_i, b_i)
+    else:
+        assert a.dtype == b.dtype and a.shape == b.shape
+        np.testing.assert_array_equal(a.view(np.uint8), b.view(np.uint8))
+
+
+def test_async_matches_sync_result():
+    for function, sync, inputs in _calls(np.random.default_rng(0)):
+        future = function(*inputs)
+        assert isinstance(future, futures.Z2RFuture)
+        _assert_results_equal(future.result(timeout=60), sync(*inputs))
+
+
+def test_async_matches_sync_await():
+    calls = _calls(np.random.default_rng(1))
+
+    async def run_all():
+        return await asyncio.gather(*(function(*inputs) for function, _, inputs in calls))
+
+    for result, (_, sync, inputs) in zip(asyncio.run(run_all()), calls):
+        _assert_results_equal(result, sync(*inputs))
+
+
+def test_async_keeps_inputs_alive():
+    rng = np.random.default_rng(2)
+    z, x = random_paulis(rng, 2000, 64)
+    z1, x1, z2, x2 = (pack_voids(bits) for bits in (z[:1000], x[:1000], z[1000:], x[1000:]))
+    expected = _cz2m.compose(z1, x1, z2, x2)
+
+    future = z2r_accel.compose_async(z1, x1, z2, x2)
+    watched = weakref.ref(z1)
+    del z1, x1, z2, x2
+    gc.collect()
+    # The future holds the caller's arrays, as they are C-contiguous
+    assert watched() is future.inputs[0]
+    _assert_results_equal(future.result(timeout=60), expected)
+    assert len(future.inputs) == 4
+
+
+def test_async_copies_non_contiguous_inputs():
+    zx = zx_voids(*random_paulis(np.random.default_rng(3), 200, 20))
+    strided = zx[::2]
+    future = z2r_accel.unordered_unique_async(strided)
+    assert future.inputs[0].flags.c_contiguous and future.inputs[0] is not strided
+    _assert_results_equal(future.result(timeout=60), _cz2m.unordered_unique(zx[::2].copy()))
+
+
+def test_async_exceptions():
+    zx = zx_voids(*random_paulis(np.random.default_rng(4), 10, 8))
+    future = z2r_accel.to_matrix_async(zx, zx[:5], 4)
+    with pytest.raises(RuntimeError):
+        future.result(timeout=60)
+
+    async def wait():
+        return await z2r_accel.to_matrix_async(zx, zx[:5], 4)
+
+    with pytest.raises(RuntimeError):
+        asyncio.run(wait())
+
+
+def _submitted_threads() -> int:
+    """Number of threads a kernel submitted now would run with."""
+    return futures._submit(z2r_accel.get_num_threads).result(timeout=60)
+
+
+def test_set_async_workers():
+    with pytest.raises(ValueError):
+        z2r_accel.set_async_workers(0)
+
+    z2r_accel.set_num_threads(8)
+    z2r_accel.set_async_workers(2)
+    assert _submitted_threads() == 4
+    z2r_accel.set_async_workers(3)
+    assert _submitted_threads() == 2
+    z2r_accel.set_async_workers(16)
+    assert _submitted_threads() == 1
+    z2r_accel.set_async_workers(2, threads_per_worker=3)
+    assert _submitted_threads() == 3
+
+    # The previous pool still runs the calls submitted to it
+    future = z2r_accel.compose_async(*(pack_voids(np.eye(8, dtype=bool)),) * 4)
+    z2r_accel.set_async_workers(1)
+    future.result(timeout=60)
+
+
+def test_async_threads_follow_settings():
+    # The share of each call is counted when it is submitted, not when the pool was created
+    z2r_accel.set_async_workers(2)
+    z2r_accel.set_num_threads(8)
+    assert _submitted_threads() == 4
+    z2r_accel.set_num_threads(6)
+    assert _submitted_threads() == 3
+    with z2r_accel.thread_limits(2):
+        assert _submitted_threads() == 1
+    assert _submitted_threads() == 3
+
+
+@pytest.mark.parametrize("num_qubits", [1, 3, 9])
+def test_to_matrix_matches_dense(num_qubits):
+    # Row r of a string has its single non-zero at column r ^ x_int, equal to (-1)^|r & z_int|,
+    # qubit q being bit q of r. That is (1j)^|z & x| times the Pauli matrix, without the phase of
+    # Y = -i Z X, with qubit 0 the rightmost factor.
+    rng = np.random.default_rng(num_qubits)
+    z, x = random_paulis(rng, 7, num_qubits)
+    z[0], x[0] = False, False
+    z_voids, x_voids = pack_voids(z), pack_voids(x)
+
+    dim = 2**num_qubits
+    expected = np.zeros((dim, dim), dtype=np.complex128)
+    for zr, xr in zip(z, x):
+        expected += 1j ** np.sum(zr & xr) * pauli_matrix(zr[::-1], xr[::-1])
+
+    matrix = _cz2m.to_matrix(z_voids, x_voids, num_qubits)
+    assert matrix.shape == (dim, dim) and matrix.dtype == np.complex128
+    np.testing.assert_allclose(matrix, expected, atol=1e-12)
+    future = z2r_accel.to_matrix_async(z_voids, x_voids, num_qubits)
+    np.testing.assert_array_equal(future.result(timeout=60), matrix)
+
+    # No string, and the one string on no qubit
+    np.testing.assert_array_equal(_cz2m.to_matrix(z_voids[:0], x_voids[:0], num_qubits), 0)
+    np.testing.assert_array_equal(_cz2m.to_matrix(z_voids[:1], x_voids[:1], 0), [[1]])
+
+
+def test_to_matrix_errors():
+    z_voids = pack_voids(np.zeros((3, 8), dtype=bool))
+    with pytest.raises(RuntimeError):
+        _cz2m.to_matrix(z_voids, z_voids[:2], 3)
+    with pytest.raises(RuntimeError):
+        _cz2m.to_matrix(z_voids, z_voids, 9)
+    with pytest.raises(RuntimeError):
+        _cz2m.to_matrix(z_voids, z_voids, -1)
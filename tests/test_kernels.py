@@ -0,0 +1,153 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import pack_voids, pauli_matrix, random_paulis, unpack_voids
+
+
+@pytest.mark.parametrize("num_qubits", [3, 11])
+def test_compose_phase(num_qubits):
+    # The phase power (2 x1.z2 + z1.x1 + z2.x2 - z.x) is negative when the product makes new Ys,
+    # which % 4 left out of the [0, 4) range of the phases. It now wraps with & 3.
+    rng = np.random.default_rng(0)
+    z1, x1 = random_paulis(rng, 40, num_qubits)
+    z2, x2 = random_paulis(rng, 40, num_qubits)
+    z1[0], x1[0], z2[0], x2[0] = True, False, False, True  # Z...Z . X...X = i^n Y...Y
+    new_z, new_x, phases = _cz2m.compose(
+        pack_voids(z1), pack_voids(x1), pack_voids(z2), pack_voids(x2)
+    )
+
+    out_z = unpack_voids(new_z, num_qubits)
+    out_x = unpack_voids(new_x, num_qubits)
+    np.testing.assert_array_equal(out_z, z1 ^ z2)
+    np.testing.assert_array_equal(out_x, x1 ^ x2)
+    assert phases[0] == pytest.approx(1j**num_qubits)
+    for i in range(len(z1)):
+        product = pauli_matrix(z1[i], x1[i]) @ pauli_matrix(z2[i], x2[i])
+        np.testing.assert_allclose(product, phases[i] * pauli_matrix(out_z[i], out_x[i]))
+
+
+def test_bitwise_commute_with_is_qubit_wise():
+    # Every qubit of the voids is compared, not only those of their first byte
+    num_qubits = 16
+    rng = np.random.default_rng(1)
+    z1, x1 = random_paulis(rng, 200, num_qubits)
+    z2, x2 = random_paulis(rng, 200, num_qubits)
+    z1[0], x1[0], z2[0], x2[0] = False, False, False, False
+    z1[0, 12], x2[0, 12] = True, True  # Z and X on qubit 12 only
+    result = _cz2m.bitwise_commute_with(
+        pack_voids(z1), pack_voids(x1), pack_voids(z2), pack_voids(x2)
+    )
+
+    expected = ~((z1 & x2) ^ (x1 & z2)).any(axis=1)
+    assert result.shape == (200,)
+    assert not result[0]
+    np.testing.assert_array_equal(result, expected)
+
+
+def test_matmul_is_silent(capfd):
+    rng = np.random.default_rng(2)
+    a = rng.random((30, 20)) < 0.5
+    b = rng.random((20, 12)) < 0.5
+    out = z2r_accel.matmul(pack_voids(a), pack_voids(b), 20, 12)
+
+    np.testing.assert_array_equal(unpack_voids(out, 12), (a.astype(int) @ b.astype(int)) % 2 == 1)
+    captured = capfd.readouterr()
+    assert captured.out == ""
+    assert captured.err == ""
+
+
+def _gf2_rank(matrix):
+    m = matrix.copy()
+    rank = 0
+    for col in range(m.shape[1]):
+        pivots = np.flatnonzero(m[rank:, col])
+        if len(pivots) == 0:
+            continue
+        m[[rank, rank + pivots[0]]] = m[[rank + pivots[0], rank]]
+        below = m[:, col].copy()
+        below[rank] = False
+        m[below] ^= m[rank]
+        rank += 1
+        if rank == m.shape[0]:
+            break
+    return rank
+
+
+@pytest.mark.parametrize("num_bits", [5, 64, 70])
+def test_batched_gauss_jordan_inverse(num_bits):
+    rng = np.random.default_rng(num_bits)
+    # Random matrices over Z2 are invertible about 29% of the time
+    bits = rng.random((3, 8, num_bits, num_bits)) < 0.5
+    bits[0, 0] = np.eye(num_bits, dtype=bool)
+    bits[0, 1] = False
+    itemsize = (num_bits + 7) // 8
+    matrices = pack_voids(bits.reshape(-1, num_bits), itemsize).reshape(3, 8, num_bits)
+    inverses, singular = z2r_accel.batched_gauss_jordan_inverse(matrices, num_bits)
+
+    assert inverses.shape == matrices.shape and singular.shape == (3, 8)
+    inv_bits = unpack_voids(inverses.ravel(), num_bits).reshape(bits.shape)
+    for index in np.ndindex(3, 8):
+        a = bits[index]
+        assert singular[index] == (_gf2_rank(a) < num_bits)
+        if singular[index]:
+            assert not inv_bits[index].any()
+        else:
+            product = (a.astype(int) @ inv_bits[index].astype(int)) % 2
+            np.testing.assert_array_equal(product, np.eye(num_bits))
+            single = z2r_accel.gauss_jordan_inverse(matrices[index], num_bits)
+            np.testing.assert_array_equal(unpack_voids(single, num_bits), inv_bits[index])
+    assert not singular[0, 0] and singular[0, 1]
+    assert 0 < singular.sum() < singular.size
+
+
+def test_bitwise_xor_many_matches_bitwise_xor():
+    # Empty, single-row and multi-chunk arrays in the same batch
+    rng = np.random.default_rng(3)
+    sizes, itemsizes = [0, 1, 7, 9000, 3], [1, 9, 2, 16, 130]
+    first = [pack_voids(rng.random((s, 8 * b)) < 0.5) for s, b in zip(sizes, itemsizes)]
+    second = [pack_voids(rng.random((s, 8 * b)) < 0.5) for s, b in zip(sizes, itemsizes)]
+    first[2] = first[2].reshape(7, 1)
+    second[2] = second[2].reshape(7, 1)
+    outputs = z2r_accel.bitwise_xor_many(first, second)
+
+    assert len(outputs) == len(sizes)
+    for a, b, out in zip(first, second, outputs):
+        expected = z2r_accel.bitwise_xor(a, b)
+        assert out.shape == a.shape and out.dtype == a.dtype
+        np.testing.assert_array_equal(out.view(np.uint8), expected.view(np.uint8))
+
+
+def test_compose_many_matches_compose():
+    rng = np.random.default_rng(4)
+    sizes, qubits = [0, 1, 40, 6000, 5], [3, 70, 11, 64, 130]
+    left = [random_paulis(rng, s, n) for s, n in zip(sizes, qubits)]
+    right = [random_paulis(rng, s, n) for s, n in zip(sizes, qubits)]
+    z1s, x1s = [pack_voids(z) for z, _ in left], [pack_voids(x) for _, x in left]
+    z2s, x2s = [pack_voids(z) for z, _ in right], [pack_voids(x) for _, x in right]
+    results = z2r_accel.compose_many(z1s, x1s, z2s, x2s)
+
+    assert len(results) == len(sizes)
+    for i, (new_z, new_x, phases) in enumerate(results):
+        z, x, expected_phases = _cz2m.compose(z1s[i], x1s[i], z2s[i], x2s[i])
+        assert new_z.shape == z1s[i].shape and new_z.dtype == z1s[i].dtype
+        np.testing.assert_array_equal(new_z.view(np.uint8), z.view(np.uint8))
+        np.testing.assert_array_equal(new_x.view(np.uint8), x.view(np.uint8))
+        np.testing.assert_array_equal(phases, expected_phases)
+
+
+def test_many_errors():
+    a, b = pack_voids(np.zeros((4, 8), dtype=bool)), pack_voids(np.zeros((3, 8), dtype=bool))
+    wide = pack_voids(np.zeros((4, 16), dtype=bool))
+    with pytest.raises(RuntimeError):
+        z2r_accel.bitwise_xor_many([a, a], [a])
+    with pytest.raises(RuntimeError):
+        z2r_accel.bitwise_xor_many([a], [b])
+    with pytest.raises(RuntimeError):
+        z2r_accel.bitwise_xor_many([a], [wide])
+    with pytest.raises(RuntimeError):
+        z2r_accel.compose_many([a], [a], [a], [])
+    with pytest.raises(RuntimeError):
+        z2r_accel.compose_many([a], [a], [b], [b])
@@ -0,0 +1,57 @@
+import os
+import sys
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import simplify_reference
+
+pytestmark = pytest.mark.skipif(sys.platform != "linux", reason="NUMA mode is Linux only")
+
+
+@pytest.fixture(autouse=True)
+def restore_numa():
+    enabled = z2r_accel.get_numa()
+    yield
+    z2r_accel.set_numa(enabled)
+
+
+def test_numa_nodes():
+    nodes = z2r_accel.numa_nodes()
+    cpus = [cpu for node in nodes for cpu in node]
+    assert len(cpus) == len(set(cpus))
+    assert set(cpus) <= os.sched_getaffinity(0)
+    assert all(node for node in nodes)
+
+
+def test_set_numa():
+    z2r_accel.set_numa(True)
+    assert z2r_accel.get_numa()
+    z2r_accel.set_numa(False)
+    assert not z2r_accel.get_numa()
+
+
+def _kernels():
+    # Above the parallel thresholds, so that the outputs are first touched by the team
+    z, x = z2r_accel.random_zx_voids(200000, 16, seed=5)
+    new_z, new_x, phases = _cz2m.compose(z, x, x, z)
+    keys = np.ascontiguousarray(z.view(np.uint64)[::2] & np.uint64(0xFFF)).view("|V8")
+    unique_zx, unique_w = z2r_accel.simplify(keys, np.ones(len(keys)))
+    return z, x, new_z, new_x, phases, keys, unique_zx, unique_w
+
+
+def test_numa_outputs_unchanged():
+    with z2r_accel.thread_limits(4):
+        z2r_accel.set_numa(False)
+        reference = _kernels()
+        z2r_accel.set_numa(True)
+        results = _kernels()
+
+    for expected, result in zip(reference[:5], results[:5]):
+        np.testing.assert_array_equal(result.view(np.uint8), expected.view(np.uint8))
+    keys, unique_zx, unique_w = results[5:]
+    simplified = {key.tobytes(): w for key, w in zip(unique_zx, unique_w)}
+    assert simplified == simplify_reference(keys, np.ones(len(keys)))
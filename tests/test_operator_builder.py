@@ -0,0 +1,99 @@
+import threading
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import simplify_reference
+
+
+def _batches(rng, num_batches: int, rows: int, distinct: int):
+    out = []
+    for _ in range(num_batches):
+        keys = rng.integers(0, distinct, rows).astype(np.uint64).view("|V8")
+        out.append((keys, rng.integers(-3, 4, rows) + 1j * rng.integers(-3, 4, rows)))
+    return out
+
+
+def _first_order(batches):
+    """The distinct keys in the order of their first addition."""
+    seen = {}
+    for keys, _ in batches:
+        for key in keys:
+            seen.setdefault(key.tobytes(), len(seen))
+    return list(seen)
+
+
+@pytest.mark.parametrize("flush_threshold", [1, 100, 1 << 20])
+def test_operator_builder_matches_simplify(flush_threshold):
+    rng = np.random.default_rng(flush_threshold)
+    batches = _batches(rng, 20, 300, 500)
+    builder = z2r_accel.OperatorBuilder(8, flush_threshold)
+    for keys, weights in batches:
+        builder.add(keys, weights)
+        if flush_threshold <= 300:
+            assert builder.num_pending == 0
+    zx, w = builder.finalize()
+
+    # The unique terms include the ones that cancelled, which finalize() leaves out
+    assert builder.num_pending == 0 and builder.num_unique == len(_first_order(batches))
+    all_keys = np.concatenate([keys for keys, _ in batches])
+    all_weights = np.concatenate([weights for _, weights in batches])
+    # Integer weights: the sums are exact, and the ones that cancel are dropped
+    reference = {k: v for k, v in simplify_reference(all_keys, all_weights).items() if v != 0}
+    assert {key.tobytes(): value for key, value in zip(zx, w)} == reference
+    order = [key for key in _first_order(batches) if key in reference]
+    assert [key.tobytes() for key in zx] == order
+
+
+def test_operator_builder_flush_and_tolerance():
+    rng = np.random.default_rng(0)
+    builder = z2r_accel.OperatorBuilder(8, 1 << 20)
+    keys = rng.integers(0, 300, 1000).astype(np.uint64).view("|V8")
+    builder.add(keys, 0.25)
+    assert builder.num_pending == 1000 and builder.num_unique == 0
+    builder.flush()
+    assert builder.num_pending == 0 and builder.num_unique == len(set(keys.tolist()))
+
+    # A scalar weight is shared by every term: a key added c times sums to c / 4
+    sums = simplify_reference(keys, np.full(1000, 0.25))
+    zx, w = builder.finalize(0.875)
+    expected = {k: v for k, v in sums.items() if v > 0.875}
+    assert 0 < len(expected) < len(sums)
+    assert {key.tobytes(): value for key, value in zip(zx, w)} == expected
+    # The builder keeps its terms, and takes more after finalize()
+    builder.add(keys[:1], 1.0)
+    zx, w = builder.finalize()
+    assert len(zx) == len(sums)
+    assert w[0] == sums[keys[0].tobytes()] + 1
+
+
+def test_operator_builder_threads():
+    rng = np.random.default_rng(1)
+    batches = _batches(rng, 64, 2000, 3000)
+    builder = z2r_accel.OperatorBuilder(8, 5000)
+
+    def worker(part):
+        for keys, weights in part:
+            builder.add(keys, weights)
+
+    threads = [threading.Thread(target=worker, args=(batches[i::8],)) for i in range(8)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    zx, w = builder.finalize()
+
+    all_keys = np.concatenate([keys for keys, _ in batches])
+    all_weights = np.concatenate([weights for _, weights in batches])
+    reference = {k: v for k, v in simplify_reference(all_keys, all_weights).items() if v != 0}
+    assert {key.tobytes(): value for key, value in zip(zx, w)} == reference
+
+
+def test_operator_builder_errors():
+    builder = z2r_accel.OperatorBuilder(8)
+    with pytest.raises(RuntimeError):
+        builder.add(np.zeros(3, dtype="V4"), 1.0)
+    with pytest.raises(ValueError):
+        builder.add(np.zeros(3, dtype="V8"), np.ones(2))
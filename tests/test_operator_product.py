@@ -0,0 +1,96 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import random_paulis, zx_operator_matrix, zx_voids
+
+
+def _operator(rng, rows: int, num_qubits: int, density: float = 0.5):
+    z, x = random_paulis(rng, rows, num_qubits, density)
+    weights = rng.normal(size=rows) + 1j * rng.normal(size=rows)
+    return zx_voids(z, x), weights
+
+
+def _assert_unique(zx):
+    raw = np.ascontiguousarray(zx).view(np.uint8).reshape(len(zx), -1)
+    assert len(np.unique(raw, axis=0)) == len(zx)
+
+
+@pytest.mark.parametrize("num_qubits", [1, 3, 5])
+def test_operator_product_matches_dense(num_qubits):
+    rng = np.random.default_rng(num_qubits)
+    zx_a, w_a = _operator(rng, 30, num_qubits)
+    zx_b, w_b = _operator(rng, 20, num_qubits)
+    zx, w = z2r_accel.operator_product(zx_a, w_a, zx_b, w_b, num_qubits)
+
+    _assert_unique(zx)
+    a = zx_operator_matrix(zx_a, w_a, num_qubits)
+    b = zx_operator_matrix(zx_b, w_b, num_qubits)
+    np.testing.assert_allclose(zx_operator_matrix(zx, w, num_qubits), a @ b, atol=1e-10)
+
+
+def test_operator_product_tolerance():
+    num_qubits = 4
+    rng = np.random.default_rng(10)
+    zx_a, w_a = _operator(rng, 12, num_qubits)
+    zx_b, w_b = _operator(rng, 12, num_qubits)
+    zx, w = z2r_accel.operator_product(zx_a, w_a, zx_b, w_b, num_qubits)
+    # Halfway between two weights, so that rounding cannot move a term across the cut
+    magnitudes = np.sort(np.abs(w))
+    cut = (magnitudes[len(w) // 2] + magnitudes[len(w) // 2 + 1]) / 2
+    zx_cut, w_cut = z2r_accel.operator_product(zx_a, w_a, zx_b, w_b, num_qubits, cut)
+
+    assert len(w_cut) == (np.abs(w) > cut).sum()
+    assert np.all(np.abs(w_cut) > cut)
+    mask = np.abs(w) > cut
+    kept = {key.tobytes(): value for key, value in zip(zx[mask], w[mask])}
+    for key, value in zip(zx_cut, w_cut):
+        assert value == pytest.approx(kept[key.tobytes()])
+
+
+def test_operator_product_identity_term():
+    # Past a 64-bit word: the identity term of A A is the sum of the squared weights, since
+    # P_i P_j = I only for i = j
+    num_qubits = 70
+    rng = np.random.default_rng(11)
+    zx_a, w_a = _operator(rng, 50, num_qubits, 0.1)
+    _assert_unique(zx_a)
+    zx, w = z2r_accel.operator_product(zx_a, w_a, zx_a, w_a, num_qubits)
+
+    _assert_unique(zx)
+    identity = ~np.ascontiguousarray(zx).view(np.uint8).reshape(len(zx), -1).any(axis=1)
+    assert identity.sum() == 1
+    assert w[identity][0] == pytest.approx(np.sum(w_a**2))
+
+
+@pytest.mark.parametrize("num_qubits", [2, 4])
+def test_commutator_matches_dense(num_qubits):
+    rng = np.random.default_rng(20 + num_qubits)
+    zx_a, w_a = _operator(rng, 25, num_qubits)
+    zx_b, w_b = _operator(rng, 15, num_qubits)
+    zx, w = z2r_accel.commutator(zx_a, w_a, zx_b, w_b, num_qubits)
+
+    _assert_unique(zx)
+    a = zx_operator_matrix(zx_a, w_a, num_qubits)
+    b = zx_operator_matrix(zx_b, w_b, num_qubits)
+    expected = a @ b - b @ a
+    np.testing.assert_allclose(zx_operator_matrix(zx, w, num_qubits), expected, atol=1e-10)
+    # The Pauli strings are orthogonal for the trace inner product: sum |c_k|^2 = |C|_F^2 / 2^n
+    norm = z2r_accel.commutator(zx_a, w_a, zx_b, w_b, num_qubits, return_norm=True)
+    assert norm == pytest.approx(np.linalg.norm(expected) / np.sqrt(2**num_qubits))
+
+
+def test_commutator_of_commuting_operators():
+    # Z-only operators commute: no term is composed, and the norm is zero
+    num_qubits = 6
+    rng = np.random.default_rng(30)
+    z_a, _ = random_paulis(rng, 20, num_qubits)
+    z_b, _ = random_paulis(rng, 20, num_qubits)
+    no_x = np.zeros((20, num_qubits), dtype=bool)
+    zx_a, zx_b = zx_voids(z_a, no_x), zx_voids(z_b, no_x)
+    w = np.ones(20)
+    zx, weights = z2r_accel.commutator(zx_a, w, zx_b, w, num_qubits)
+
+    assert len(zx) == 0 and len(weights) == 0
+    assert z2r_accel.commutator(zx_a, w, zx_b, w, num_qubits, return_norm=True) == 0.0
@@ -0,0 +1,97 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+
+
+def _random_voids(rng, rows: int, distinct: int):
+    """16-byte voids drawn among about distinct values, with both words varying."""
+    values = rng.integers(0, distinct, (rows, 1)).astype(np.uint64)
+    words = np.concatenate([values * np.uint64(0x9E3779B97F4A7C15), values], axis=1)
+    return np.ascontiguousarray(words).view("|V16").ravel()
+
+
+def _numbering(voids):
+    """Reference numbering: each distinct void by order of first appearance."""
+    out = {}
+    for v in voids:
+        out.setdefault(v.tobytes(), len(out))
+    return out
+
+
+def test_pauli_index_lookup_and_isin():
+    # Above FUNC_THRESHOLD_PARALLEL rows, so that the parallel paths run
+    rng = np.random.default_rng(0)
+    keys = _random_voids(rng, 120000, 5000)
+    index = z2r_accel.PauliIndex(keys)
+    numbers = _numbering(keys)
+
+    assert len(index) == len(numbers) and index.itemsize == 16
+    expected_keys = np.frombuffer(b"".join(numbers), dtype=np.uint8)
+    np.testing.assert_array_equal(index.keys().view(np.uint8), expected_keys)
+    queries = _random_voids(rng, 110000, 10000)
+    expected = np.array([numbers.get(q.tobytes(), -1) for q in queries])
+    np.testing.assert_array_equal(index.lookup(queries), expected)
+    np.testing.assert_array_equal(index.isin(queries), expected >= 0)
+
+
+def test_pauli_index_insert():
+    rng = np.random.default_rng(1)
+    first, second = _random_voids(rng, 300, 200), _random_voids(rng, 300, 400)
+    index = z2r_accel.PauliIndex(first)
+    numbers = _numbering(np.concatenate([first, second]))
+    inserted = index.insert(second)
+
+    np.testing.assert_array_equal(inserted, [numbers[v.tobytes()] for v in second])
+    assert len(index) == len(numbers)
+    np.testing.assert_array_equal(index.lookup(second), inserted)
+    # Inserting again changes nothing
+    np.testing.assert_array_equal(index.insert(first), index.lookup(first))
+    assert len(index) == len(numbers)
+
+
+def test_pauli_index_set_operations():
+    rng = np.random.default_rng(2)
+    keys, others = _random_voids(rng, 400, 300), _random_voids(rng, 400, 600)
+    index = z2r_accel.PauliIndex(keys)
+    numbers = _numbering(keys)
+    in_keys = np.array([v.tobytes() in numbers for v in others])
+
+    positions, found = index.intersect(others)
+    np.testing.assert_array_equal(positions, np.flatnonzero(in_keys))
+    np.testing.assert_array_equal(found, [numbers[v.tobytes()] for v in others[in_keys]])
+
+    other_set = {v.tobytes() for v in others}
+    expected = [n for key, n in numbers.items() if key not in other_set]
+    np.testing.assert_array_equal(index.difference(others), expected)
+    np.testing.assert_array_equal(index.difference(z2r_accel.PauliIndex(others)), expected)
+
+    union, union_numbers = index.union(others)
+    all_numbers = _numbering(np.concatenate([keys, others]))
+    assert len(union) == len(all_numbers)
+    np.testing.assert_array_equal(union_numbers, [all_numbers[v.tobytes()] for v in others])
+    # The union is a copy: the index itself is unchanged
+    assert len(index) == len(numbers)
+
+
+def test_pauli_index_copy():
+    rng = np.random.default_rng(3)
+    keys = _random_voids(rng, 100, 50)
+    index = z2r_accel.PauliIndex(keys)
+    copy = index.copy()
+    copy.insert(_random_voids(rng, 100, 1000))
+
+    assert len(copy) > len(index) == len(_numbering(keys))
+    np.testing.assert_array_equal(index.lookup(keys), copy.lookup(keys))
+
+
+def test_pauli_index_empty_and_errors():
+    index = z2r_accel.PauliIndex(np.zeros(0, dtype="V3"))
+    assert len(index) == 0
+    assert index.lookup(np.zeros(2, dtype="V3")).tolist() == [-1, -1]
+    assert index.insert(np.zeros(2, dtype="V3")).tolist() == [0, 0]
+    with pytest.raises(RuntimeError):
+        index.lookup(np.zeros(2, dtype="V4"))
+    with pytest.raises(RuntimeError):
+        index.insert(z2r_accel.PauliIndex(np.zeros(1, dtype="V8")))
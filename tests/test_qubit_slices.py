@@ -0,0 +1,67 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import pack_voids, unpack_voids
+
+
+def test_get_qubit_slices_any_order():
+    rng = np.random.default_rng(0)
+    bits = rng.random((60, 37)) < 0.5
+    indices = [36, 0, 9, 10, 11, 12, 35, 7, 8, 20, 1]
+    out = z2r_accel.get_qubit_slices(pack_voids(bits), indices)
+
+    assert out.dtype.itemsize == 2
+    unpacked = unpack_voids(out, 16)
+    np.testing.assert_array_equal(unpacked[:, : len(indices)], bits[:, indices])
+    assert not unpacked[:, len(indices) :].any()
+
+
+def test_set_then_get_qubit_slices():
+    rng = np.random.default_rng(1)
+    bits = rng.random((40, 70)) < 0.5
+    sub = rng.random((40, 9)) < 0.5
+    indices = [69, 3, 64, 4, 5, 63, 31, 32, 0]
+    out = z2r_accel.set_qubit_slices(pack_voids(bits), pack_voids(sub), indices)
+
+    expected = bits.copy()
+    expected[:, indices] = sub
+    np.testing.assert_array_equal(unpack_voids(out, 70), expected)
+    np.testing.assert_array_equal(
+        unpack_voids(z2r_accel.get_qubit_slices(out, indices), 9), sub
+    )
+
+
+def test_qubit_slices_keep_the_shape():
+    rng = np.random.default_rng(2)
+    bits = rng.random((24, 20)) < 0.5
+    voids = pack_voids(bits).reshape(4, 6)
+    out = z2r_accel.get_qubit_slices(voids, [19, 2])
+
+    assert out.shape == (4, 6)
+    np.testing.assert_array_equal(unpack_voids(out.ravel(), 2), bits[:, [19, 2]])
+
+
+def test_permute_qubits_round_trip():
+    rng = np.random.default_rng(3)
+    num_qubits = 45
+    bits = rng.random((50, 48)) < 0.5  # 3 padding bits past num_qubits
+    permutation = rng.permutation(num_qubits)
+    out = z2r_accel.permute_qubits(pack_voids(bits), permutation.tolist())
+
+    unpacked = unpack_voids(out, 48)
+    np.testing.assert_array_equal(unpacked[:, :num_qubits], bits[:, permutation])
+    np.testing.assert_array_equal(unpacked[:, num_qubits:], bits[:, num_qubits:])
+    back = z2r_accel.permute_qubits(out, np.argsort(permutation).tolist())
+    np.testing.assert_array_equal(unpack_voids(back, 48), bits)
+
+
+def test_qubit_slices_errors():
+    voids = pack_voids(np.zeros((3, 16), dtype=bool))
+    with pytest.raises(RuntimeError):
+        z2r_accel.get_qubit_slices(voids, [16])
+    with pytest.raises(RuntimeError):
+        z2r_accel.permute_qubits(voids, [0, 0, 1])
+    with pytest.raises(RuntimeError):
+        z2r_accel.set_qubit_slices(voids, voids[:2], [0])
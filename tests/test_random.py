@@ -0,0 +1,66 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import unpack_voids
+
+
+def _bits(voids, num_bits):
+    return unpack_voids(voids.ravel(), num_bits)
+
+
+def test_random_zx_voids_seed():
+    z1, x1 = z2r_accel.random_zx_voids((4, 25), 9, seed=7)
+    z2, x2 = z2r_accel.random_zx_voids((4, 25), 9, seed=7)
+    z3, _ = z2r_accel.random_zx_voids((4, 25), 9, seed=8)
+
+    assert z1.shape == (4, 25) and z1.dtype == np.dtype("|V9")
+    np.testing.assert_array_equal(_bits(z1, 72), _bits(z2, 72))
+    np.testing.assert_array_equal(_bits(x1, 72), _bits(x2, 72))
+    assert (_bits(z1, 72) != _bits(z3, 72)).any()
+
+
+def test_random_zx_voids_thread_independent():
+    # Above FUNC_THRESHOLD_PARALLEL words, so that the parallel path runs
+    shape = (60000,)
+    with z2r_accel.thread_limits(1):
+        z1, x1 = z2r_accel.random_zx_voids(shape, 16, seed=3)
+    with z2r_accel.thread_limits(4, "dynamic", 7):
+        z2, x2 = z2r_accel.random_zx_voids(shape, 16, seed=3)
+
+    np.testing.assert_array_equal(_bits(z1, 128), _bits(z2, 128))
+    np.testing.assert_array_equal(_bits(x1, 128), _bits(x2, 128))
+
+
+def test_random_zx_voids_num_qubits():
+    z, x = z2r_accel.random_zx_voids(2000, 12, num_qubits=70, seed=0)
+    bz, bx = _bits(z, 96), _bits(x, 96)
+
+    assert not bz[:, 70:].any() and not bx[:, 70:].any()
+    # Every qubit below num_qubits is drawn, with about half of its bits set
+    assert np.all(np.abs(bz[:, :70].mean(axis=0) - 0.5) < 0.1)
+    assert np.all(np.abs(bx[:, :70].mean(axis=0) - 0.5) < 0.1)
+
+
+@pytest.mark.parametrize("weight", [0, 1, 5, 70])
+def test_random_zx_voids_weight(weight):
+    z, x = z2r_accel.random_zx_voids(3000, 9, num_qubits=70, weight=weight, seed=1)
+    bz, bx = _bits(z, 72), _bits(x, 72)
+
+    np.testing.assert_array_equal((bz | bx).sum(axis=1), weight)
+    assert not (bz | bx)[:, 70:].any()
+    if weight:
+        # X, Y and Z equally likely on the chosen qubits
+        support = bz | bx
+        counts = np.array([(bx & ~bz).sum(), (bz & ~bx).sum(), (bz & bx).sum()])
+        assert np.all(np.abs(counts / support.sum() - 1 / 3) < 0.05)
+
+
+def test_random_zx_voids_errors():
+    with pytest.raises(RuntimeError):
+        z2r_accel.random_zx_voids(10, 2, num_qubits=17)
+    with pytest.raises(RuntimeError):
+        z2r_accel.random_zx_voids(10, 2, num_qubits=8, weight=9)
+    with pytest.raises(RuntimeError):
+        z2r_accel.random_zx_voids(10, 0)
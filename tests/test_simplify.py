@@ -0,0 +1,67 @@
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import simplify_reference
+
+ROOT = Path(__file__).resolve().parents[1]
+
+# Run in a child process, since the OpenMP settings are read once, when the runtime starts
+SCRIPT = """
+import sys
+import numpy as np
+import z2r_accel
+
+rng = np.random.default_rng(0)
+keys = rng.integers(0, 1000, 200000).astype(np.uint64)
+weights = rng.integers(-3, 4, keys.size).astype(np.complex128)
+zx, w = z2r_accel.simplify(keys.view("|V8"), weights)
+np.save(sys.argv[1], np.stack([zx.view(np.uint64).astype(np.complex128), w]))
+"""
+
+
+def _reference():
+    rng = np.random.default_rng(0)
+    keys = rng.integers(0, 1000, 200000).astype(np.uint64)
+    weights = rng.integers(-3, 4, keys.size).astype(np.complex128)
+    return simplify_reference(keys.view("|V8"), weights)
+
+
+@pytest.mark.parametrize(
+    "env",
+    [
+        {},
+        {"OMP_NUM_THREADS": "4", "OMP_THREAD_LIMIT": "2"},
+        {"OMP_NUM_THREADS": "8", "OMP_DYNAMIC": "true"},
+    ],
+)
+def test_simplify_reduced_team(tmp_path, env):
+    out = tmp_path / "out.npy"
+    child_env = dict(os.environ, PYTHONPATH=str(ROOT), **env)
+    subprocess.run([sys.executable, "-c", SCRIPT, str(out)], env=child_env, cwd=ROOT, check=True)
+    keys, weights = np.load(out)
+
+    reference = _reference()
+    assert len(keys) == len(reference)
+    assert weights.sum() == pytest.approx(sum(reference.values()))
+    for key, w in zip(keys.real.astype(np.uint64), weights):
+        assert reference[key.tobytes()] == w
+
+
+def test_simplify_tolerance():
+    rng = np.random.default_rng(1)
+    keys = rng.integers(0, 50, 5000).astype(np.uint64)
+    weights = rng.normal(size=keys.size) + 0j
+    zx, w = z2r_accel.simplify(keys.view("|V8"), weights, 0.5)
+
+    reference = simplify_reference(keys.view("|V8"), weights)
+    kept = {k: v for k, v in reference.items() if abs(v) > 0.5}
+    assert len(zx) == len(kept)
+    for key, value in zip(zx.view(np.uint64), w):
+        assert value == pytest.approx(kept[key.tobytes()])
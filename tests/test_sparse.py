@@ -0,0 +1,104 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import pack_voids, unpack_voids
+
+NUM_QUBITS = 1000
+
+
+def _low_weight(rng, rows: int, num_qubits: int = NUM_QUBITS, max_weight: int = 6):
+    """(z, x) bool arrays of strings of weight at most max_weight, on qubits up to num_qubits."""
+    z = np.zeros((rows, num_qubits), dtype=bool)
+    x = np.zeros((rows, num_qubits), dtype=bool)
+    for i in range(rows):
+        qubits = rng.choice(num_qubits, rng.integers(0, max_weight + 1), replace=False)
+        paulis = rng.integers(1, 4, len(qubits))
+        x[i, qubits] = paulis & 1 == 1
+        z[i, qubits] = paulis & 2 == 2
+    return z, x
+
+
+def _support(z, x):
+    return z2r_accel.to_support_lists(pack_voids(z), pack_voids(x))
+
+
+def test_support_lists_round_trip():
+    rng = np.random.default_rng(0)
+    z, x = _low_weight(rng, 200)
+    offsets, entries = _support(z, x)
+
+    np.testing.assert_array_equal(np.diff(offsets), (z | x).sum(axis=1))
+    assert offsets[0] == 0 and offsets[-1] == len(entries)
+    for i in range(len(z)):
+        row = entries[offsets[i] : offsets[i + 1]]
+        qubits = np.flatnonzero(z[i] | x[i])
+        np.testing.assert_array_equal(row >> 2, qubits)
+        np.testing.assert_array_equal(row & 3, x[i, qubits] + 2 * z[i, qubits])
+
+    new_z, new_x = z2r_accel.from_support_lists((offsets, entries), NUM_QUBITS)
+    np.testing.assert_array_equal(unpack_voids(new_z, NUM_QUBITS), z)
+    np.testing.assert_array_equal(unpack_voids(new_x, NUM_QUBITS), x)
+
+
+def test_sparse_compose_matches_dense():
+    # Overlapping supports on few qubits, so that the products cancel and make Ys
+    rng = np.random.default_rng(1)
+    z1, x1 = _low_weight(rng, 300, 12)
+    z2, x2 = _low_weight(rng, 300, 12)
+    (offsets, entries), phases = z2r_accel.sparse_compose(_support(z1, x1), _support(z2, x2))
+    new_z, new_x, expected_phases = _cz2m.compose(
+        pack_voids(z1), pack_voids(x1), pack_voids(z2), pack_voids(x2)
+    )
+
+    z, x = z2r_accel.from_support_lists((offsets, entries), 12)
+    np.testing.assert_array_equal(unpack_voids(z, 12), unpack_voids(new_z, 12))
+    np.testing.assert_array_equal(unpack_voids(x, 12), unpack_voids(new_x, 12))
+    np.testing.assert_allclose(phases, expected_phases)
+
+
+def test_sparse_commute_with_matches_dense():
+    rng = np.random.default_rng(2)
+    z1, x1 = _low_weight(rng, 400, 10)
+    z2, x2 = _low_weight(rng, 400, 10)
+    s1, s2 = _support(z1, x1), _support(z2, x2)
+
+    parity = ((z1 & x2) ^ (x1 & z2)).sum(axis=1) % 2 == 0
+    np.testing.assert_array_equal(z2r_accel.sparse_commute_with(s1, s2), parity)
+    qubit_wise = _cz2m.bitwise_commute_with(
+        pack_voids(z1), pack_voids(x1), pack_voids(z2), pack_voids(x2)
+    )
+    np.testing.assert_array_equal(z2r_accel.sparse_bitwise_commute_with(s1, s2), qubit_wise)
+    assert (parity != qubit_wise).any()
+
+
+def test_sparse_unique():
+    rng = np.random.default_rng(3)
+    z, x = _low_weight(rng, 50)
+    picks = rng.integers(0, 50, 500)
+    z, x = z[picks], x[picks]
+    indices, inverse = z2r_accel.sparse_unique(_support(z, x))
+
+    rows = np.concatenate([z, x], axis=1)
+    assert len(indices) == len(np.unique(rows, axis=0))
+    assert len(np.unique(rows[indices], axis=0)) == len(indices)
+    np.testing.assert_array_equal(rows[indices[inverse]], rows)
+    # Each unique string is represented by its first occurrence
+    for number, first in enumerate(indices):
+        assert np.flatnonzero(inverse == number)[0] == first
+
+
+def test_support_lists_errors():
+    offsets, entries = np.array([0, 1, 2]), np.array([(5 << 2) | 1, (9 << 2) | 3], dtype=np.uint32)
+    with pytest.raises(RuntimeError):
+        z2r_accel.from_support_lists((offsets, entries), 9)
+    with pytest.raises(RuntimeError):
+        z2r_accel.from_support_lists((np.array([0, 2, 1, 2]), entries), 10)
+    with pytest.raises(RuntimeError):
+        z2r_accel.from_support_lists((np.array([0, 1, 3]), entries), 10)
+    with pytest.raises(RuntimeError):
+        z2r_accel.sparse_compose((offsets, entries), (offsets[:2], entries[:1]))
+    with pytest.raises(RuntimeError):
+        z2r_accel.to_support_lists(pack_voids(np.zeros((2, 8))), pack_voids(np.zeros((3, 8))))
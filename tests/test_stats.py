@@ -0,0 +1,74 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import pack_voids, random_paulis
+
+# Rows of 8 bytes: bitwise_not() runs in parallel from BOPS_THRESHOLD_PARALLEL words
+BOPS_THRESHOLD_PARALLEL = 1_000_000
+
+
+@pytest.fixture
+def recording():
+    z2r_accel.enable_stats()
+    z2r_accel.reset_stats()
+    yield
+    z2r_accel.enable_stats(False)
+    z2r_accel.reset_stats()
+
+
+@pytest.mark.skipif(not z2r_accel.stats_available(), reason="built without Z2R_PERF_COUNTERS")
+def test_stats_count_calls(recording):
+    large = np.zeros(BOPS_THRESHOLD_PARALLEL, dtype="V8")
+    small = large[:10]
+    with z2r_accel.thread_limits(num_threads=2):
+        z2r_accel.bitwise_not(large)
+        z2r_accel.bitwise_not(small)
+        with z2r_accel.thread_limits(num_threads=1):
+            z2r_accel.bitwise_not(large)
+
+    counters = z2r_accel.stats()["bitwise_not"]
+    assert counters["calls"] == 3
+    # Only the large call below the limit of 2 threads ran on more than one
+    assert counters["parallel_calls"] == 1
+    assert counters["max_threads"] == 2
+    assert counters["elements"] == 2 * BOPS_THRESHOLD_PARALLEL + 10
+    assert counters["bytes"] == 2 * 8 * (2 * BOPS_THRESHOLD_PARALLEL + 10)
+    assert counters["time"] > 0
+
+
+@pytest.mark.skipif(not z2r_accel.stats_available(), reason="built without Z2R_PERF_COUNTERS")
+def test_stats_merge_modules_and_reset(recording):
+    rng = np.random.default_rng(0)
+    z, x = (pack_voids(a) for a in random_paulis(rng, 20, 9))
+    z2r_accel.bitwise_not(z)
+    _cz2m.compose(z, x, x, z)
+
+    counters = z2r_accel.stats(reset=True)
+    # The kernels of both modules are reported together
+    assert counters["bitwise_not"]["calls"] == 1
+    assert counters["compose"]["calls"] == 1
+    assert counters["compose"]["parallel_calls"] == 0
+    assert counters["compose"]["elements"] == 20
+    assert z2r_accel.stats() == {}
+
+    z2r_accel.bitwise_not(z)
+    z2r_accel.reset_stats()
+    assert z2r_accel.stats() == {}
+
+    # Stopped, the counters are left as they are
+    z2r_accel.enable_stats(False)
+    z2r_accel.bitwise_not(z)
+    assert z2r_accel.stats() == {}
+
+
+@pytest.mark.skipif(z2r_accel.stats_available(), reason="built with Z2R_PERF_COUNTERS")
+def test_stats_compiled_out():
+    with pytest.raises(RuntimeError):
+        z2r_accel.enable_stats()
+    z2r_accel.enable_stats(False)
+    z2r_accel.bitwise_not(np.zeros(BOPS_THRESHOLD_PARALLEL, dtype="V8"))
+    assert z2r_accel.stats() == {}
+    z2r_accel.reset_stats()
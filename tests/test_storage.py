@@ -0,0 +1,146 @@
+import numpy as np
+import pytest
+
+storage = pytest.importorskip("z2r_accel.storage")
+from dense import random_paulis, zx_voids
+
+
+def _operator(rng, rows: int, num_qubits: int):
+    z, x = random_paulis(rng, rows, num_qubits)
+    weights = rng.normal(size=rows) + 1j * rng.normal(size=rows)
+    return zx_voids(z, x), weights
+
+
+@pytest.mark.parametrize("rows", [0, 1, 1000])
+def test_write_read_round_trip(tmp_path, rows):
+    rng = np.random.default_rng(rows)
+    zx, weights = _operator(rng, rows, 37)
+    path = tmp_path / "op.z2r"
+    storage.write_operator(path, zx, weights, 37)
+    op = storage.read_operator(path)
+
+    assert op.num_qubits == 37
+    assert op.zx_voids.dtype == zx.dtype and op.zx_voids.shape == (rows,)
+    np.testing.assert_array_equal(op.zx_voids.view(np.uint8), zx.view(np.uint8))
+    np.testing.assert_array_equal(op.weights, weights)
+    if rows:
+        assert op.zx_voids.ctypes.data % 64 == 0
+        assert op.weights.ctypes.data % 64 == 0
+
+
+def test_read_modes(tmp_path):
+    rng = np.random.default_rng(0)
+    zx, weights = _operator(rng, 10, 5)
+    path = tmp_path / "op.z2r"
+    storage.write_operator(path, zx, weights, 5)
+
+    with pytest.raises(ValueError):
+        storage.read_operator(path).weights[0] = 0
+    copy = storage.read_operator(path, "c")
+    copy.weights[0] = 42
+    assert storage.read_operator(path).weights[0] == weights[0]
+    shared = storage.read_operator(path, "r+")
+    shared.weights[0] = 42
+    del shared
+    assert storage.read_operator(path).weights[0] == 42
+    with pytest.raises(ValueError):
+        storage.read_operator(path, "w")
+
+
+def test_write_errors(tmp_path):
+    path = tmp_path / "op.z2r"
+    zx = np.zeros(4, dtype="V2")
+    with pytest.raises(ValueError):
+        storage.write_operator(path, np.zeros(4, dtype=np.uint16), np.ones(4), 8)
+    with pytest.raises(ValueError):
+        storage.write_operator(path, zx, np.ones(3), 8)
+    with pytest.raises(ValueError):
+        storage.write_operator(path, zx, np.ones(4), 9)
+
+
+def test_read_errors(tmp_path):
+    path = tmp_path / "op.z2r"
+    storage.write_operator(path, np.zeros(100, dtype="V2"), np.ones(100), 8)
+    data = path.read_bytes()
+
+    path.write_bytes(data[:40])
+    with pytest.raises(ValueError, match="too small"):
+        storage.read_operator(path)
+    path.write_bytes(data[:-1])
+    with pytest.raises(ValueError, match="truncated"):
+        storage.read_operator(path)
+    path.write_bytes(b"X" + data[1:])
+    with pytest.raises(ValueError, match="not a Z2R"):
+        storage.read_operator(path)
+    path.write_bytes(data[:8] + (2).to_bytes(4, "little") + data[12:])
+    with pytest.raises(ValueError, match="version"):
+        storage.read_operator(path)
+
+
+def _simplified(op):
+    return {key.tobytes(): w for key, w in zip(op.zx_voids, op.weights)}
+
+
+# 1 << 16 bytes splits the 20000 terms into about 30 buckets
+@pytest.mark.parametrize("memory_budget", [1 << 30, 1 << 16])
+def test_simplify_out_of_core(tmp_path, memory_budget):
+    pytest.importorskip("z2r_accel._core.build._cz2m")
+    from dense import simplify_reference
+
+    rng = np.random.default_rng(1)
+    keys = rng.integers(0, 300, 20000).astype(np.uint64)
+    weights = rng.integers(-3, 4, keys.size).astype(np.complex128)
+    src, dst = tmp_path / "src.z2r", tmp_path / "dst.z2r"
+    storage.write_operator(src, keys.view("|V8"), weights, 32)
+    num_terms = storage.simplify_out_of_core(src, dst, memory_budget, tmpdir=tmp_path)
+    op = storage.read_operator(dst)
+
+    # Integer weights: the sums are exact, and the ones that cancel are dropped
+    reference = simplify_reference(keys.view("|V8"), weights)
+    reference = {key: w for key, w in reference.items() if w != 0}
+    assert num_terms == len(reference) == len(op.weights)
+    assert op.num_qubits == 32
+    assert _simplified(op) == reference
+
+
+def test_simplify_out_of_core_tolerance(tmp_path):
+    pytest.importorskip("z2r_accel._core.build._cz2m")
+    from dense import simplify_reference
+
+    rng = np.random.default_rng(2)
+    keys = rng.integers(0, 50, 5000).astype(np.uint64)
+    weights = rng.normal(size=keys.size) + 0j
+    src, dst = tmp_path / "src.z2r", tmp_path / "dst.z2r"
+    storage.write_operator(src, keys.view("|V8"), weights, 32)
+    storage.simplify_out_of_core(src, dst, 1 << 14, tolerance=0.5, tmpdir=tmp_path)
+
+    reference = simplify_reference(keys.view("|V8"), weights)
+    kept = {k: w for k, w in reference.items() if abs(w) > 0.5}
+    simplified = _simplified(storage.read_operator(dst))
+    assert simplified.keys() == kept.keys()
+    for key, w in kept.items():
+        assert simplified[key] == pytest.approx(w)
+
+
+def test_simplify_out_of_core_empty(tmp_path):
+    pytest.importorskip("z2r_accel._core.build._cz2m")
+    src, dst = tmp_path / "src.z2r", tmp_path / "dst.z2r"
+    storage.write_operator(src, np.zeros(0, dtype="V4"), np.zeros(0), 16)
+
+    assert storage.simplify_out_of_core(src, dst) == 0
+    op = storage.read_operator(dst)
+    assert op.zx_voids.dtype.itemsize == 4 and op.zx_voids.size == 0 and op.num_qubits == 16
+
+
+def test_hash_partition():
+    pytest.importorskip("z2r_accel._core.build._cz2m")
+    import z2r_accel
+
+    rng = np.random.default_rng(3)
+    keys = rng.integers(0, 100, 10000).astype(np.uint64)
+    parts = z2r_accel.hash_partition(keys.view("|V8"), 7)
+
+    assert parts.shape == keys.shape and parts.min() >= 0 and parts.max() < 7
+    for key in np.unique(keys)[:20]:
+        assert len(np.unique(parts[keys == key])) == 1
+    assert len(np.unique(parts)) == 7
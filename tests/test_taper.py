@@ -0,0 +1,105 @@
+import itertools
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._clifford")
+import z2r_accel
+from dense import pack_voids, split_zx_voids, unpack_voids, zx_operator_matrix, zx_voids
+
+
+def _anticommute(z1, x1, z2, x2):
+    """Symplectic product of every pair of rows, as a bool matrix."""
+    z1, x1, z2, x2 = (a.astype(int) for a in (z1, x1, z2, x2))
+    return ((z1 @ x2.T + x1 @ z2.T) % 2).astype(bool)
+
+
+def _symmetric_operator(rng, rows: int, num_qubits: int):
+    """Random Hermitian operator commuting with the Z parity and with X0 X1."""
+    z = rng.random((8 * rows, num_qubits)) < 0.5
+    x = rng.random((8 * rows, num_qubits)) < 0.5
+    parity = np.ones((1, num_qubits), dtype=bool)
+    x01 = np.zeros((1, num_qubits), dtype=bool)
+    x01[0, :2] = True
+    no_bits = np.zeros((1, num_qubits), dtype=bool)
+    keep = ~_anticommute(z, x, parity, no_bits)[:, 0] & ~_anticommute(z, x, no_bits, x01)[:, 0]
+    z, x = z[keep][:rows], x[keep][:rows]
+    assert len(z) == rows
+    return zx_voids(z, x), rng.normal(size=rows)
+
+
+@pytest.mark.parametrize("num_qubits", [5, 70])
+def test_z2_symmetries_commute(num_qubits):
+    rng = np.random.default_rng(num_qubits)
+    zx, _ = _symmetric_operator(rng, 40, num_qubits)
+    generators, qubits, gates, signs = z2r_accel.z2_symmetries(zx, num_qubits)
+
+    assert len(generators) >= 2
+    assert len(qubits) == len(signs) == len(generators)
+    assert len(set(qubits.tolist())) == len(qubits)
+    assert np.all(np.isin(signs, [1, -1]))
+    z, x = split_zx_voids(zx, num_qubits)
+    gz, gx = split_zx_voids(generators, num_qubits)
+    assert not _anticommute(z, x, gz, gx).any()
+    assert not _anticommute(gz, gx, gz, gx).any()
+
+    # C g_k C^dagger = s_k Z_{q_k}
+    new_z, new_x, phases = z2r_accel.clifford_conjugate(pack_voids(gz), pack_voids(gx), gates)
+    expected = np.zeros((len(qubits), num_qubits), dtype=bool)
+    expected[np.arange(len(qubits)), qubits] = True
+    np.testing.assert_array_equal(unpack_voids(new_z, num_qubits), expected)
+    assert not unpack_voids(new_x, num_qubits).any()
+    np.testing.assert_array_equal(phases, signs)
+
+
+def _sector_spectrum(h, generators, sector, num_qubits):
+    """Spectrum of h restricted to the joint eigenspace of the generators given by sector."""
+    projector = np.eye(2**num_qubits, dtype=np.complex128)
+    for i, eigenvalue in enumerate(sector):
+        g = zx_operator_matrix(generators[i : i + 1], [1], num_qubits)
+        projector = projector @ (np.eye(2**num_qubits) + eigenvalue * g) / 2
+    values, vectors = np.linalg.eigh(projector)
+    basis = vectors[:, values > 0.5]
+    return np.linalg.eigvalsh(basis.conj().T @ h @ basis)
+
+
+def test_taper_matches_dense_sectors():
+    num_qubits = 5
+    rng = np.random.default_rng(0)
+    zx, weights = _symmetric_operator(rng, 40, num_qubits)
+    h = zx_operator_matrix(zx, weights, num_qubits)
+    generators, *_ = z2r_accel.z2_symmetries(zx, num_qubits)
+    k = len(generators)
+
+    spectra = []
+    for sector in itertools.product([1, -1], repeat=k):
+        tapered_zx, tapered_w = z2r_accel.taper(zx, weights, num_qubits, sector)
+        tapered = zx_operator_matrix(tapered_zx, tapered_w, num_qubits - k)
+        np.testing.assert_allclose(tapered, tapered.conj().T, atol=1e-12)
+        spectrum = np.linalg.eigvalsh(tapered)
+        expected = _sector_spectrum(h, generators, sector, num_qubits)
+        np.testing.assert_allclose(spectrum, expected, atol=1e-10)
+        spectra.append(spectrum)
+    # The sectors together hold the whole spectrum
+    np.testing.assert_allclose(np.sort(np.concatenate(spectra)), np.linalg.eigvalsh(h), atol=1e-10)
+
+    default_zx, default_w = z2r_accel.taper(zx, weights, num_qubits)
+    np.testing.assert_allclose(
+        zx_operator_matrix(default_zx, default_w, num_qubits - k),
+        zx_operator_matrix(*z2r_accel.taper(zx, weights, num_qubits, [1] * k), num_qubits - k),
+    )
+
+
+def test_taper_errors():
+    num_qubits = 5
+    rng = np.random.default_rng(1)
+    zx, weights = _symmetric_operator(rng, 20, num_qubits)
+    k = len(z2r_accel.z2_symmetries(zx, num_qubits)[0])
+    with pytest.raises(RuntimeError):
+        z2r_accel.taper(zx, weights, num_qubits, [1] * (k + 1))
+    with pytest.raises(RuntimeError):
+        z2r_accel.taper(zx, weights, num_qubits, [0] * k)
+    with pytest.raises(RuntimeError):
+        z2r_accel.taper(zx, weights[:-1], num_qubits)
+    with pytest.raises(RuntimeError):
+        z2r_accel.taper(zx, weights, 9)
@@ -0,0 +1,110 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+from dense import random_paulis, zx_voids
+
+
+def _operator(rng, rows: int, num_qubits: int, density: float = 0.03):
+    z, x = random_paulis(rng, rows, num_qubits, density)
+    weights = rng.normal(size=rows) + 1j * rng.normal(size=rows)
+    return z, x, zx_voids(z, x), weights
+
+
+def _assert_voids_equal(a, b):
+    assert a.dtype == b.dtype and a.shape == b.shape
+    np.testing.assert_array_equal(a.view(np.uint8), b.view(np.uint8))
+
+
+@pytest.mark.parametrize("rows", [500, 120000])
+def test_filter_terms_matches_numpy(rows):
+    # 120000 rows is above FUNC_THRESHOLD_PARALLEL, so that the parallel pass runs
+    num_qubits = 70
+    rng = np.random.default_rng(rows)
+    z, x, zx, weights = _operator(rng, rows, num_qubits)
+    weight = (z | x).sum(axis=1)
+    support = [0, 3, 5, 63, 64, 65, 66, 67, 68, 69] + list(range(10, 40))
+    outside = np.ones(num_qubits, dtype=bool)
+    outside[support] = False
+
+    cases = [
+        (dict(tolerance=1.0), np.abs(weights) > 1.0),
+        (dict(max_weight=6), weight <= 6),
+        (dict(support=support), ~((z | x) & outside).any(axis=1)),
+        (
+            dict(tolerance=0.5, max_weight=8, support=support),
+            (np.abs(weights) > 0.5) & (weight <= 8) & ~((z | x) & outside).any(axis=1),
+        ),
+    ]
+    for kwargs, mask in cases:
+        assert 0 < mask.sum() < rows
+        kept_zx, kept_w = z2r_accel.filter_terms(zx, weights, num_qubits, **kwargs)
+        _assert_voids_equal(kept_zx, zx[mask])
+        np.testing.assert_array_equal(kept_w, weights[mask])
+
+    # Without weights, only the voids are filtered
+    kept_zx, kept_w = z2r_accel.filter_terms(zx, num_qubits=num_qubits, max_weight=6)
+    _assert_voids_equal(kept_zx, zx[weight <= 6])
+    assert kept_w is None
+
+
+def test_take_matches_numpy():
+    rng = np.random.default_rng(0)
+    _, _, zx, weights = _operator(rng, 1000, 20)
+    indices = rng.integers(0, 1000, 3000)
+
+    _assert_voids_equal(z2r_accel.take(zx, indices), zx[indices])
+    taken_zx, taken_w = z2r_accel.take(zx, indices, weights)
+    _assert_voids_equal(taken_zx, zx[indices])
+    np.testing.assert_array_equal(taken_w, weights[indices])
+    assert z2r_accel.take(zx, []).shape == (0,)
+
+
+@pytest.mark.parametrize("rows", [1000, 150000])
+def test_top_k_matches_numpy(rows):
+    rng = np.random.default_rng(rows)
+    _, _, zx, weights = _operator(rng, rows, 20)
+
+    for k in [0, 1, 37, rows, rows + 5]:
+        top_zx, top_w = z2r_accel.top_k(zx, weights, k)
+        order = np.argsort(-np.abs(weights), kind="stable")[:k]
+        _assert_voids_equal(top_zx, zx[order])
+        np.testing.assert_array_equal(top_w, weights[order])
+
+
+@pytest.mark.parametrize("rows", [1000, 150000])
+def test_top_k_nan_last(rows):
+    # NaN magnitudes sort last, in their order, as in NumPy
+    rng = np.random.default_rng(rows + 1)
+    _, _, zx, weights = _operator(rng, rows, 20)
+    nan = rng.choice(rows, rows // 10, replace=False)
+    weights[nan[::2]] = np.nan
+    weights[nan[1::2]] = complex(1.0, np.nan)
+
+    for k in [1, 37, rows - rows // 20, rows]:
+        top_zx, top_w = z2r_accel.top_k(zx, weights, k)
+        order = np.argsort(-np.abs(weights), kind="stable")[:k]
+        _assert_voids_equal(top_zx, zx[order])
+        np.testing.assert_array_equal(top_w, weights[order])
+
+
+def test_terms_errors():
+    rng = np.random.default_rng(1)
+    _, _, zx, weights = _operator(rng, 10, 8)
+    with pytest.raises(RuntimeError):
+        z2r_accel.filter_terms(zx, weights, max_weight=2)
+    with pytest.raises(RuntimeError):
+        z2r_accel.filter_terms(zx, weights, support=[0, 1])
+    with pytest.raises(RuntimeError):
+        z2r_accel.filter_terms(zx, tolerance=0.1)
+    with pytest.raises(RuntimeError):
+        z2r_accel.filter_terms(zx, weights, 8, support=[8])
+    with pytest.raises(RuntimeError):
+        z2r_accel.filter_terms(zx, weights, 8, max_weight=-1)
+    with pytest.raises(RuntimeError):
+        z2r_accel.take(zx, [10])
+    with pytest.raises(RuntimeError):
+        z2r_accel.take(zx, [-1])
+    with pytest.raises(RuntimeError):
+        z2r_accel.top_k(zx, weights, -1)
@@ -0,0 +1,143 @@
+import os
+import sys
+import threading
+
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+import z2r_accel
+
+linux_only = pytest.mark.skipif(sys.platform != "linux", reason="affinity is Linux only")
+
+
+@pytest.fixture(autouse=True)
+def restore_settings():
+    schedule = z2r_accel.get_schedule()
+    persistent = z2r_accel.get_persistent_pool()
+    yield
+    z2r_accel.set_num_threads(None)
+    z2r_accel.set_schedule(*schedule)
+    z2r_accel.set_persistent_pool(persistent)
+    if sys.platform == "linux":
+        z2r_accel.set_affinity(None)
+
+
+def test_num_threads():
+    default = z2r_accel.get_num_threads()
+    z2r_accel.set_num_threads(3)
+    assert z2r_accel.get_num_threads() == 3
+    z2r_accel.set_num_threads(None)
+    assert z2r_accel.get_num_threads() == default
+    with pytest.raises(RuntimeError):
+        z2r_accel.set_num_threads(-1)
+
+
+def test_schedule():
+    z2r_accel.set_schedule("dynamic", 4)
+    assert z2r_accel.get_schedule() == ("dynamic", 4)
+    z2r_accel.set_schedule("guided")
+    assert z2r_accel.get_schedule() == ("guided", 0)
+    with pytest.raises(ValueError):
+        z2r_accel.set_schedule("auto")
+    with pytest.raises(RuntimeError):
+        z2r_accel.set_schedule("static", -1)
+    assert z2r_accel.get_schedule() == ("guided", 0)
+
+
+@pytest.mark.skipif(not z2r_accel.stats_available(), reason="built without Z2R_PERF_COUNTERS")
+def test_settings_shared_by_modules():
+    # Set through _cz2m, read by a kernel of _bitops: both use the settings of z2r_core
+    z2r_accel.enable_stats()
+    z2r_accel.reset_stats()
+    try:
+        z2r_accel.set_num_threads(3)
+        z2r_accel.bitwise_not(np.zeros(1_000_000, dtype="V8"))
+        assert z2r_accel.stats()["bitwise_not"]["max_threads"] == 3
+    finally:
+        z2r_accel.enable_stats(False)
+        z2r_accel.reset_stats()
+
+
+@linux_only
+def test_affinity():
+    original = os.sched_getaffinity(0)
+    cpu = min(original)
+    z2r_accel.set_affinity([cpu], pin_caller=True)
+    assert z2r_accel.get_affinity() == [cpu]
+    assert os.sched_getaffinity(0) == {cpu}
+    # The kernels of every module run with the same pinning
+    a = np.random.default_rng(0).integers(0, 256, 64, dtype=np.uint8).view("V8")
+    np.testing.assert_array_equal(z2r_accel.bitwise_not(a).view(np.uint8), ~a.view(np.uint8))
+
+    z2r_accel.set_affinity(None)
+    assert z2r_accel.get_affinity() == []
+    assert os.sched_getaffinity(0) == original
+    with pytest.raises(RuntimeError):
+        z2r_accel.set_affinity([-1])
+
+
+def test_nested_thread_limits():
+    z2r_accel.set_num_threads(4)
+    with z2r_accel.thread_limits(3):
+        assert z2r_accel.get_num_threads() == 3
+        with z2r_accel.thread_limits(2):
+            assert z2r_accel.get_num_threads() == 2
+        # Only the schedule is overridden: the thread count of the outer limits stays
+        with z2r_accel.thread_limits(schedule="dynamic"):
+            assert z2r_accel.get_num_threads() == 3
+        assert z2r_accel.get_num_threads() == 3
+    assert z2r_accel.get_num_threads() == 4
+
+    @z2r_accel.thread_limits(1)
+    def limited():
+        return z2r_accel.get_num_threads()
+
+    assert limited() == 1
+    assert z2r_accel.get_num_threads() == 4
+    with pytest.raises(ValueError):
+        z2r_accel.thread_limits(schedule="auto")
+
+
+def test_thread_limits_do_not_leak():
+    z2r_accel.set_num_threads(4)
+    entered = threading.Event()
+    release = threading.Event()
+    seen = {}
+
+    def limited():
+        with z2r_accel.thread_limits(1):
+            seen["limited"] = z2r_accel.get_num_threads()
+            entered.set()
+            release.wait()
+
+    worker = threading.Thread(target=limited)
+    worker.start()
+    try:
+        entered.wait()
+        # The limits of the worker do not reach this thread, and those of this thread not the
+        # worker
+        assert z2r_accel.get_num_threads() == 4
+        with z2r_accel.thread_limits(2):
+            other = threading.Thread(target=lambda: seen.update(other=z2r_accel.get_num_threads()))
+            other.start()
+            other.join()
+            assert z2r_accel.get_num_threads() == 2
+    finally:
+        release.set()
+        worker.join()
+    assert seen == {"limited": 1, "other": 4}
+    assert z2r_accel.get_num_threads() == 4
+
+
+def test_persistent_pool_and_warm_up():
+    z2r_accel.set_persistent_pool(True)
+    assert z2r_accel.get_persistent_pool()
+    z2r_accel.set_num_threads(2)
+    z2r_accel.warm_up()
+    # Above the parallel threshold of bitwise_not()
+    a = np.random.default_rng(1).integers(0, 256, 8_000_000, dtype=np.uint8).view("V8")
+    np.testing.assert_array_equal(z2r_accel.bitwise_not(a).view(np.uint8), ~a.view(np.uint8))
+    z2r_accel.set_persistent_pool(False)
+    assert not z2r_accel.get_persistent_pool()
+    z2r_accel.warm_up()
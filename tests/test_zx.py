@@ -0,0 +1,96 @@
+import numpy as np
+import pytest
+
+pytest.importorskip("z2r_accel._core.build._cz2m")
+from z2r_accel._core.build import _cz2m
+import z2r_accel
+from dense import pack_voids, random_paulis, split_zx_voids, unpack_voids, zx_voids
+
+# Within a byte, the Z bits ending on a word, and the X bits straddling a word boundary
+QUBITS = [3, 64, 70]
+
+
+@pytest.mark.parametrize("num_qubits", QUBITS)
+def test_split_stitch_round_trip(num_qubits):
+    rng = np.random.default_rng(num_qubits)
+    z, x = random_paulis(rng, 300, num_qubits)
+    zx = zx_voids(z, x)
+    z_voids, x_voids = z2r_accel.split_zx(zx, num_qubits)
+
+    np.testing.assert_array_equal(unpack_voids(z_voids, num_qubits), z)
+    np.testing.assert_array_equal(unpack_voids(x_voids, num_qubits), x)
+    stitched = z2r_accel.stitch_zx(z_voids, x_voids, num_qubits)
+    np.testing.assert_array_equal(split_zx_voids(stitched, num_qubits)[0], z)
+    np.testing.assert_array_equal(split_zx_voids(stitched, num_qubits)[1], x)
+
+    # In place, into given outputs
+    z_out, x_out = np.zeros_like(z_voids), np.zeros_like(x_voids)
+    z2r_accel.split_zx(zx, num_qubits, z_out, x_out)
+    np.testing.assert_array_equal(z_out.view(np.uint8), z_voids.view(np.uint8))
+    np.testing.assert_array_equal(x_out.view(np.uint8), x_voids.view(np.uint8))
+    out = np.zeros_like(stitched)
+    z2r_accel.stitch_zx(z_voids, x_voids, num_qubits, out)
+    np.testing.assert_array_equal(out.view(np.uint8), stitched.view(np.uint8))
+
+
+@pytest.mark.parametrize("num_qubits", QUBITS)
+def test_zx_compose_matches_compose(num_qubits):
+    rng = np.random.default_rng(10 + num_qubits)
+    z1, x1 = random_paulis(rng, 300, num_qubits)
+    z2, x2 = random_paulis(rng, 300, num_qubits)
+    zx1, zx2 = zx_voids(z1, x1), zx_voids(z2, x2)
+    new_z, new_x, expected_phases = _cz2m.compose(
+        pack_voids(z1), pack_voids(x1), pack_voids(z2), pack_voids(x2)
+    )
+    expected_z, expected_x = unpack_voids(new_z, num_qubits), unpack_voids(new_x, num_qubits)
+
+    zx, phases = z2r_accel.zx_compose(zx1, zx2, num_qubits)
+    np.testing.assert_array_equal(split_zx_voids(zx, num_qubits)[0], expected_z)
+    np.testing.assert_array_equal(split_zx_voids(zx, num_qubits)[1], expected_x)
+    np.testing.assert_array_equal(phases, expected_phases)
+
+    # In place, over the first operand
+    _, in_place_phases = z2r_accel.zx_compose(zx1, zx2, num_qubits, out=zx1)
+    np.testing.assert_array_equal(zx1.view(np.uint8), zx.view(np.uint8))
+    np.testing.assert_array_equal(in_place_phases, expected_phases)
+
+
+@pytest.mark.parametrize("num_qubits", QUBITS)
+def test_zx_commute_with_and_weight(num_qubits):
+    # Sparse strings, so that both commuting and anticommuting pairs show up on many qubits
+    rng = np.random.default_rng(20 + num_qubits)
+    z1, x1 = random_paulis(rng, 500, num_qubits, 2 / num_qubits)
+    z2, x2 = random_paulis(rng, 500, num_qubits, 2 / num_qubits)
+    zx1, zx2 = zx_voids(z1, x1), zx_voids(z2, x2)
+
+    parity = ((z1 & x2) ^ (x1 & z2)).sum(axis=1) % 2 == 0
+    qubit_wise = ~((z1 & x2) ^ (x1 & z2)).any(axis=1)
+    np.testing.assert_array_equal(z2r_accel.zx_commute_with(zx1, zx2, num_qubits), parity)
+    np.testing.assert_array_equal(
+        z2r_accel.zx_bitwise_commute_with(zx1, zx2, num_qubits), qubit_wise
+    )
+    assert parity.any() and not parity.all()
+    np.testing.assert_array_equal(z2r_accel.zx_weight(zx1, num_qubits), (z1 | x1).sum(axis=1))
+
+
+def test_zx_broadcast():
+    # A single void against an array, as the other element-wise kernels
+    num_qubits = 9
+    rng = np.random.default_rng(30)
+    z, x = random_paulis(rng, 50, num_qubits)
+    zx = zx_voids(z, x)
+    commute = z2r_accel.zx_commute_with(zx[:1], zx, num_qubits)
+    expected = ((z[0] & x) ^ (x[0] & z)).sum(axis=1) % 2 == 0
+    np.testing.assert_array_equal(commute, expected)
+
+
+def test_zx_errors():
+    zx = zx_voids(np.zeros((4, 8), dtype=bool), np.zeros((4, 8), dtype=bool))
+    with pytest.raises(RuntimeError):
+        z2r_accel.split_zx(zx, 9)
+    with pytest.raises(RuntimeError):
+        z2r_accel.zx_weight(zx, 9)
+    with pytest.raises(RuntimeError):
+        z2r_accel.zx_compose(zx, zx, 8, out=zx[:3].copy())
+    with pytest.raises(RuntimeError):
+        z2r_accel.split_zx(zx, 8, np.zeros(3, dtype="V1"), np.zeros(4, dtype="V1"))
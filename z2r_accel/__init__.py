@@ -10,5 +10,14 @@
 
 __version__ = "0.0.6"
 
+# First, so that the thread settings from the environment are set before OpenMP starts
+from .threads import *
+from .arena import *
 from .bitops import *
 from .cz2m import *
+from .clifford import *
+from .fermion import *
+from .sparse import *
+from .storage import *
+from .perf import *
+from .futures import *
@@ -0,0 +1,44 @@
+/**
+ * @file arena_bindings.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Bindings of the pooled allocator of the kernels (z2r_arena.h).
+ *
+ * The pool lives in the shared z2r_core library, so there is one for every module. It is only
+ * bound in _cz2m, which the functions of z2r_accel.arena call.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include "z2r_arena.h"
+#include <pybind11/pybind11.h>
+
+inline void def_arena(pybind11::module_ &m) {
+    namespace py = pybind11;
+    using namespace z2r::arena;
+
+    m.def(
+        "arena_stats",
+        [] {
+            ArenaStats s = snapshot();
+            py::dict out;
+            out["hits"] = s.hits;
+            out["misses"] = s.misses;
+            out["live_bytes"] = s.live_bytes;
+            out["cached_bytes"] = s.cached_bytes;
+            out["limit"] = s.limit;
+            return out;
+        },
+        "Counters of the pool, as {hits, misses, live_bytes, cached_bytes, limit}");
+    m.def("set_arena_limit", &set_limit,
+          "Set the maximum number of bytes kept in the pool (0 disables the pooling)",
+          py::arg("bytes"));
+    m.def("trim_arena", &trim, "Release every cached block of the pool");
+    m.def("set_arena_outputs", &set_outputs,
+          "Allocate the returned arrays from the pool, or with NumPy", py::arg("enabled"));
+    m.def("arena_outputs", &outputs, "Whether the returned arrays are allocated from the pool");
+}
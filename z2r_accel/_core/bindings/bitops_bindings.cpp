@@ -20,6 +20,9 @@ PYBIND11_MODULE(_bitops, m) {
 
     m.def("bitwise_xor", &bitwise_xor, "Computes XOR between each bit", py::arg("z2r_1"),
           py::arg("z2r_2"));
+    m.def("bitwise_xor_many", &bitwise_xor_many,
+          "Computes the XOR of every pair of a batch of arrays, in a single call",
+          py::arg("z2r_1s"), py::arg("z2r_2s"));
 
     m.def("bitwise_not", &bitwise_not, "addwad");
     m.def("paded_bitwise_not", &paded_bitwise_not, "addwad", py::arg("voids"),
@@ -27,4 +30,5 @@ PYBIND11_MODULE(_bitops, m) {
     m.def("bitwise_count", &bitwise_count, "addwad");
     m.def("bitwise_dot", &bitwise_dot, "addwad");
     m.def("bitwise_or", &bitwise_or, "addwad");
+
 }
@@ -0,0 +1,52 @@
+/**
+ * @file clifford_bindings.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#include "clifford.h"
+#include "taper.h"
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+PYBIND11_MODULE(_clifford, m) {
+    m.doc() = "Clifford circuits acting on Z2R encoded Pauli strings";
+
+    m.def("clifford_conjugate", &clifford_conjugate,
+          "Conjugate every Pauli string by a compiled Clifford circuit", py::arg("z_voids"),
+          py::arg("x_voids"), py::arg("gates"), py::arg("phases"));
+
+    m.def("z2_symmetries", &z2_symmetries,
+          "Independent commuting Z2 symmetries, and the Clifford mapping them to single-qubit Z",
+          py::arg("zx_voids"), py::arg("num_qubits"));
+    m.def("taper", &taper, "Taper off one qubit per Z2 symmetry, in the given sector",
+          py::arg("zx_voids"), py::arg("weights"), py::arg("num_qubits"),
+          py::arg("sector") = py::none(), py::arg("tolerance") = 0.0);
+
+    py::class_<StabilizerTableau>(m, "StabilizerTableau")
+        .def(py::init<size_t, std::optional<uint64_t>>(), py::arg("num_qubits"),
+             py::arg("seed") = py::none())
+        .def_property_readonly("num_qubits", &StabilizerTableau::num_qubits)
+        .def("apply_gate", &StabilizerTableau::apply_gate, "Apply one Clifford gate",
+             py::arg("code"), py::arg("qubit_0"), py::arg("qubit_1") = -1)
+        .def("apply_circuit", &StabilizerTableau::apply_circuit,
+             "Apply a compiled Clifford circuit", py::arg("gates"))
+        .def("measure", &StabilizerTableau::measure,
+             "Measure a qubit in the Z basis. Returns (outcome, deterministic)", py::arg("qubit"))
+        .def("expectation_values", &StabilizerTableau::expectation_values,
+             "Expectation values of Pauli strings against the state", py::arg("z_voids"),
+             py::arg("x_voids"))
+        .def("stabilizers", &StabilizerTableau::stabilizers,
+             "Stabilizer generators as (z_voids, x_voids, signs)")
+        .def("destabilizers", &StabilizerTableau::destabilizers,
+             "Destabilizers as (z_voids, x_voids, signs)")
+        .def("copy", [](const StabilizerTableau &self) { return StabilizerTableau(self); });
+
+}
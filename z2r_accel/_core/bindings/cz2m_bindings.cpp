@@ -9,7 +9,14 @@
  *
  */
 
+#include "arena_bindings.h"
 #include "cz2m.h"
+#include "fermion.h"
+#include "operator_builder.h"
+#include "pauli_index.h"
+#include "sparse_pauli.h"
+#include "stats_bindings.h"
+#include "threads_bindings.h"
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 namespace py = pybind11;
@@ -19,9 +26,16 @@ PYBIND11_MODULE(_cz2m, m) {
 
     m.def("tensor", &tensor, "awdwa");
     m.def("compose", &compose, "Compose two Pauli arrays");
+    m.def("compose_many", &compose_many,
+          "Compose every pair of a batch of Pauli arrays, in a single call", py::arg("z1s"),
+          py::arg("x1s"), py::arg("z2s"), py::arg("x2s"));
     m.def("bitwise_commute_with", &bitwise_commute_with,
           "Check commutation between two Pauli arrays");
     m.def("random_zx_strings", &random_zx_strings, "Gfddy");
+    m.def("random_zx_voids", &random_zx_voids,
+          "Generate random Z and X voids with a seedable, parallel generator", py::arg("shape"),
+          py::arg("itemsize"), py::arg("num_qubits") = -1, py::arg("weight") = -1,
+          py::arg("seed") = py::none());
     m.def("unique", &unique, "Unique arrays 1", py::arg("zx_voids"),
           py::arg("return_index") = false, py::arg("return_inverse") = false,
           py::arg("return_counts") = false);
@@ -37,4 +51,118 @@ PYBIND11_MODULE(_cz2m, m) {
     m.def("gauss_jordan_inverse", &gauss_jordan_inverse,
           "Compute the Gauss-Jordan inverse of a binary matrix", py::arg("matrix"),
           py::arg("num_qubits"));
+    m.def("batched_gauss_jordan_inverse", &batched_gauss_jordan_inverse,
+          "Invert a stack of binary matrices, flagging the singular ones", py::arg("matrices"),
+          py::arg("num_qubits"));
+    m.def("get_qubit_slices", &get_qubit_slices, "Extract the given qubits from every void",
+          py::arg("voids"), py::arg("indices"));
+    m.def("set_qubit_slices", &set_qubit_slices,
+          "Insert narrow voids into wider ones at the given qubits", py::arg("voids"),
+          py::arg("sub_voids"), py::arg("indices"));
+    m.def("permute_qubits", &permute_qubits, "Apply a qubit permutation to every void",
+          py::arg("voids"), py::arg("permutation"));
+    m.def("operator_product", &operator_product,
+          "Multiply two weighted sums of Pauli strings and simplify the result", py::arg("zx_a"),
+          py::arg("w_a"), py::arg("zx_b"), py::arg("w_b"), py::arg("num_qubits"),
+          py::arg("tolerance") = 0.0);
+    m.def("commutator", &commutator,
+          "Commutator of two weighted sums of Pauli strings, from their anticommuting pairs only",
+          py::arg("zx_a"), py::arg("w_a"), py::arg("zx_b"), py::arg("w_b"), py::arg("num_qubits"),
+          py::arg("tolerance") = 0.0, py::arg("return_norm") = false);
+    m.def("simplify", &simplify, "Sum the weights of identical Pauli strings",
+          py::arg("zx_voids"), py::arg("weights"), py::arg("tolerance") = 0.0);
+    m.def("fermion_to_qubit", &fermion_to_qubit,
+          "Map a sum of products of ladder operators to qubits and simplify the result",
+          py::arg("modes"), py::arg("creation"), py::arg("values"), py::arg("num_modes"),
+          py::arg("mapping"), py::arg("tolerance") = 0.0);
+    m.def("hash_partition", &hash_partition, "Assign Pauli strings to partitions by hash",
+          py::arg("zx_voids"), py::arg("num_partitions"));
+    m.def("split_zx", &split_zx, "Split stitched zx voids into Z and X voids",
+          py::arg("zx_voids"), py::arg("num_qubits"), py::arg("z_out") = py::none(),
+          py::arg("x_out") = py::none());
+    m.def("stitch_zx", &stitch_zx, "Stitch Z and X voids into zx voids", py::arg("z_voids"),
+          py::arg("x_voids"), py::arg("num_qubits"), py::arg("out") = py::none());
+    m.def("zx_compose", &zx_compose, "Compose two Pauli arrays of stitched zx voids",
+          py::arg("zx1"), py::arg("zx2"), py::arg("num_qubits"), py::arg("out") = py::none());
+    m.def("zx_commute_with", &zx_commute_with,
+          "Check commutation between two Pauli arrays of stitched zx voids", py::arg("zx1"),
+          py::arg("zx2"), py::arg("num_qubits"));
+    m.def("zx_bitwise_commute_with", &zx_bitwise_commute_with,
+          "Check qubit-wise commutation between two Pauli arrays of stitched zx voids",
+          py::arg("zx1"), py::arg("zx2"), py::arg("num_qubits"));
+    m.def("zx_weight", &zx_weight, "Weight of the Pauli strings of stitched zx voids",
+          py::arg("zx_voids"), py::arg("num_qubits"));
+    m.def("filter_terms", &filter_terms,
+          "Keep the terms above a weight tolerance, up to a Pauli weight or within a support",
+          py::arg("zx_voids"), py::arg("weights"), py::arg("num_qubits"),
+          py::arg("tolerance") = py::none(), py::arg("max_weight") = py::none(),
+          py::arg("support") = py::none());
+    m.def("take_terms", &take_terms, "Gather terms by index", py::arg("zx_voids"),
+          py::arg("indices"), py::arg("weights") = py::none());
+    m.def("top_k_terms", &top_k_terms, "Keep the k terms of largest weight magnitude",
+          py::arg("zx_voids"), py::arg("weights"), py::arg("k"));
+    m.def("commutes_all", &commutes_all, "Whether each Pauli string commutes with all the terms",
+          py::arg("zx_voids"), py::arg("zx_terms"), py::arg("num_qubits"),
+          py::arg("qubit_wise") = false);
+    m.def("commutes_any", &commutes_any,
+          "Whether each Pauli string commutes with at least one of the terms", py::arg("zx_voids"),
+          py::arg("zx_terms"), py::arg("num_qubits"), py::arg("qubit_wise") = false);
+    m.def("count_anticommuting", &count_anticommuting,
+          "Number of terms not commuting with each Pauli string", py::arg("zx_voids"),
+          py::arg("zx_terms"), py::arg("num_qubits"), py::arg("qubit_wise") = false);
+    m.def("first_anticommuting", &first_anticommuting,
+          "Index of the first term not commuting with each Pauli string, or -1",
+          py::arg("zx_voids"), py::arg("zx_terms"), py::arg("num_qubits"),
+          py::arg("qubit_wise") = false);
+    m.def("commute_mask", &commute_mask,
+          "Bit-packed commutation flags of each Pauli string with every term", py::arg("zx_voids"),
+          py::arg("zx_terms"), py::arg("num_qubits"), py::arg("qubit_wise") = false);
+    m.def("to_support_lists", &to_support_lists,
+          "Convert Z and X voids to support lists (offsets, entries)", py::arg("z_voids"),
+          py::arg("x_voids"));
+    m.def("from_support_lists", &from_support_lists,
+          "Convert support lists back to Z and X voids", py::arg("offsets"), py::arg("entries"),
+          py::arg("num_qubits"));
+    m.def("sparse_compose", &sparse_compose, "Compose two Pauli arrays in support lists",
+          py::arg("offsets_1"), py::arg("entries_1"), py::arg("offsets_2"), py::arg("entries_2"));
+    m.def("sparse_commute_with", &sparse_commute_with,
+          "Check commutation between two Pauli arrays in support lists", py::arg("offsets_1"),
+          py::arg("entries_1"), py::arg("offsets_2"), py::arg("entries_2"));
+    m.def("sparse_bitwise_commute_with", &sparse_bitwise_commute_with,
+          "Check qubit-wise commutation between two Pauli arrays in support lists",
+          py::arg("offsets_1"), py::arg("entries_1"), py::arg("offsets_2"), py::arg("entries_2"));
+    m.def("sparse_unique", &sparse_unique, "Unordered unique Pauli strings in support lists",
+          py::arg("offsets"), py::arg("entries"));
+
+    py::class_<PauliIndex>(m, "PauliIndex")
+        .def(py::init<py::array>(), py::arg("zx_voids"))
+        .def(py::init<const PauliIndex &>(), py::arg("other"))
+        .def("__len__", &PauliIndex::size)
+        .def_property_readonly("itemsize", &PauliIndex::itemsize)
+        .def("keys", &PauliIndex::keys, "The voids of the set, in the order of their numbers")
+        .def("lookup", &PauliIndex::lookup, "Number of each void in the set, or -1",
+             py::arg("zx_voids"))
+        .def("isin", &PauliIndex::isin, "Whether each void is in the set", py::arg("zx_voids"))
+        .def("insert", &PauliIndex::insert, "Add voids to the set, returning their numbers",
+             py::arg("zx_voids"))
+        .def("intersect", &PauliIndex::intersect,
+             "Positions of the voids in the set, and their numbers", py::arg("zx_voids"))
+        .def("difference", &PauliIndex::difference,
+             "Numbers of the voids of the set which are not among zx_voids", py::arg("zx_voids"));
+
+    py::class_<OperatorBuilder>(m, "OperatorBuilder")
+        .def(py::init<size_t, size_t>(), py::arg("itemsize"),
+             py::arg("flush_threshold") = BUILDER_FLUSH_THRESHOLD)
+        .def_property_readonly("itemsize", &OperatorBuilder::itemsize)
+        .def_property_readonly("num_unique", &OperatorBuilder::num_unique)
+        .def_property_readonly("num_pending", &OperatorBuilder::num_pending)
+        .def("add", &OperatorBuilder::add, "Append terms, merged once the pending ones fill up",
+             py::arg("zx_voids"), py::arg("weights"))
+        .def("flush", &OperatorBuilder::flush, "Merge the pending terms into the unique ones")
+        .def("finalize", &OperatorBuilder::finalize, "The unique terms and their summed weights",
+             py::arg("tolerance") = 0.0);
+
+    def_arena(m);
+    def_stats(m);
+    def_threads(m);
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+/**
+ * @file stats_bindings.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Bindings of the per-kernel performance counters (z2r_stats.h).
+ *
+ * The counters live in the shared z2r_core library, so they cover the kernels of every module.
+ * They are only bound in _cz2m, which the functions of z2r_accel.perf call.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include "z2r_stats.h"
+#include <pybind11/pybind11.h>
+
+inline void def_stats(pybind11::module_ &m) {
+    namespace py = pybind11;
+
+    m.def(
+        "stats",
+        [](bool reset) {
+            py::dict out;
+            for (const z2r::stats::KernelStats &s : z2r::stats::snapshot(reset)) {
+                py::dict entry;
+                entry["calls"] = s.calls;
+                entry["parallel_calls"] = s.parallel_calls;
+                entry["elements"] = s.elements;
+                entry["bytes"] = s.bytes;
+                entry["time"] = s.seconds;
+                entry["max_threads"] = s.max_threads;
+                out[s.name.c_str()] = entry;
+            }
+            return out;
+        },
+        "Per-kernel counters, as {kernel: {calls, parallel_calls, elements, bytes, "
+        "time, max_threads}}",
+        py::arg("reset") = false);
+    m.def("set_stats_enabled", &z2r::stats::set_enabled,
+          "Start or stop recording the per-kernel counters", py::arg("enabled"));
+    m.def("stats_enabled", &z2r::stats::enabled, "Whether the per-kernel counters are recording");
+    m.def(
+        "stats_compiled", [] { return z2r::stats::compiled(); },
+        "Whether the per-kernel counters were compiled in (-DZ2R_PERF_COUNTERS=ON)");
+}
@@ -0,0 +1,56 @@
+/**
+ * @file threads_bindings.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Bindings of the thread settings of the parallel kernels (z2r_threads.h).
+ *
+ * The settings live in the shared z2r_core library, so they are the same for every module. They
+ * are only bound in _cz2m, which the functions of z2r_accel.threads call.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include "z2r_threads.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+inline void def_threads(pybind11::module_ &m) {
+    namespace py = pybind11;
+    using namespace z2r::threads;
+
+    m.def("set_num_threads", &set_num_threads,
+          "Set the number of threads of the parallel kernels (0 for the OpenMP default)",
+          py::arg("num_threads"));
+    m.def("get_num_threads", &num_threads,
+          "Number of threads the parallel kernels use when called from this thread");
+    m.def(
+        "set_schedule",
+        [](int kind, int chunk) { set_schedule(static_cast<Schedule>(kind), chunk); },
+        "Set the schedule of the parallel loops (1: static, 2: dynamic, 3: guided)",
+        py::arg("kind"), py::arg("chunk") = 0);
+    m.def(
+        "get_schedule",
+        [] { return py::make_tuple(static_cast<int>(schedule_kind()), schedule_chunk()); },
+        "Schedule of the parallel loops, as (kind, chunk)");
+    m.def("set_affinity", &set_affinity,
+          "Pin the teams of the calling threads to slices of cpus. An empty list unpins them",
+          py::arg("cpus"), py::arg("pin_caller") = false);
+    m.def("get_affinity", &affinity, "CPUs the threads are pinned to");
+    m.def("set_numa", &set_numa,
+          "Pin the threads node by node and first touch the large outputs in parallel",
+          py::arg("enabled"), py::arg("pin_caller") = false);
+    m.def("get_numa", &numa, "Whether the NUMA mode is on");
+    m.def("numa_nodes", &numa_nodes, "CPUs available to this process, grouped by NUMA node");
+    m.def("set_persistent_pool", &set_persistent_pool,
+          "Start the worker threads as soon as the settings change", py::arg("enabled"));
+    m.def("get_persistent_pool", &persistent_pool, "Whether the persistent pool mode is on");
+    m.def("warm_up", &warm_up, "Start the worker threads now");
+    m.def("push_thread_limits", &push_limits,
+          "Override the settings for the calling thread, until pop_thread_limits()",
+          py::arg("num_threads"), py::arg("kind") = 0, py::arg("chunk") = 0);
+    m.def("pop_thread_limits", &pop_limits, "Undo the last push_thread_limits()");
+}
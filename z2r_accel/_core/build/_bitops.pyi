@@ -1,7 +1,16 @@
 from __future__ import annotations
+import collections.abc
 import numpy
 import typing
-__all__: list[str] = ['bitwise_and', 'bitwise_count', 'bitwise_dot', 'bitwise_not', 'bitwise_or', 'bitwise_xor', 'paded_bitwise_not']
+__all__: list[str] = ['arena_outputs', 'arena_stats', 'bitwise_and', 'bitwise_count', 'bitwise_dot', 'bitwise_not', 'bitwise_or', 'bitwise_xor', 'bitwise_xor_many', 'get_affinity', 'get_num_threads', 'get_numa', 'get_persistent_pool', 'get_schedule', 'numa_nodes', 'paded_bitwise_not', 'pop_thread_limits', 'push_thread_limits', 'set_affinity', 'set_arena_limit', 'set_arena_outputs', 'set_num_threads', 'set_numa', 'set_persistent_pool', 'set_schedule', 'set_stats_enabled', 'stats', 'stats_compiled', 'stats_enabled', 'trim_arena', 'warm_up']
+def arena_outputs() -> bool:
+    """
+    Whether the returned arrays are allocated from the pool
+    """
+def arena_stats() -> dict:
+    """
+    Counters of the pool of this module, as {hits, misses, live_bytes, cached_bytes, limit}
+    """
 def bitwise_and(voids_1: numpy.ndarray, voids_2: numpy.ndarray) -> numpy.ndarray:
     """
     addwad
@@ -26,7 +35,95 @@ def bitwise_xor(z2r_1: numpy.ndarray, z2r_2: numpy.ndarray) -> numpy.ndarray:
     """
     Computes XOR between each bit
     """
+def bitwise_xor_many(z2r_1s: collections.abc.Sequence[numpy.ndarray], z2r_2s: collections.abc.Sequence[numpy.ndarray]) -> list:
+    """
+    Computes the XOR of every pair of a batch of arrays, in a single call
+    """
+def get_affinity() -> list[int]:
+    """
+    CPUs the threads are pinned to
+    """
+def get_num_threads() -> int:
+    """
+    Number of threads the parallel kernels use when called from this thread
+    """
+def get_numa() -> bool:
+    """
+    Whether the NUMA mode is on
+    """
+def get_persistent_pool() -> bool:
+    """
+    Whether the persistent pool mode is on
+    """
+def get_schedule() -> tuple:
+    """
+    Schedule of the parallel loops, as (kind, chunk)
+    """
+def numa_nodes() -> list[list[int]]:
+    """
+    CPUs available to this process, grouped by NUMA node
+    """
 def paded_bitwise_not(voids: numpy.ndarray, num_qubits: typing.SupportsInt) -> numpy.ndarray:
     """
     addwad
     """
+def pop_thread_limits() -> None:
+    """
+    Undo the last push_thread_limits()
+    """
+def push_thread_limits(num_threads: typing.SupportsInt, kind: typing.SupportsInt = 0, chunk: typing.SupportsInt = 0) -> None:
+    """
+    Override the settings for the calling thread, until pop_thread_limits()
+    """
+def set_affinity(cpus: collections.abc.Sequence[typing.SupportsInt], pin_caller: bool = False) -> None:
+    """
+    Pin the teams of the calling threads to slices of cpus. An empty list unpins them
+    """
+def set_arena_limit(bytes: typing.SupportsInt) -> None:
+    """
+    Set the maximum number of bytes kept in the pool (0 disables the pooling)
+    """
+def set_arena_outputs(enabled: bool) -> None:
+    """
+    Allocate the returned arrays from the pool, or with NumPy
+    """
+def set_num_threads(num_threads: typing.SupportsInt) -> None:
+    """
+    Set the number of threads of the parallel kernels (0 for the OpenMP default)
+    """
+def set_numa(enabled: bool, pin_caller: bool = False) -> None:
+    """
+    Pin the threads node by node and first touch the large outputs in parallel
+    """
+def set_persistent_pool(enabled: bool) -> None:
+    """
+    Start the worker threads as soon as the settings change
+    """
+def set_schedule(kind: typing.SupportsInt, chunk: typing.SupportsInt = 0) -> None:
+    """
+    Set the schedule of the parallel loops (1: static, 2: dynamic, 3: guided)
+    """
+def set_stats_enabled(enabled: bool) -> None:
+    """
+    Start or stop recording the per-kernel counters
+    """
+def stats(reset: bool = False) -> dict:
+    """
+    Per-kernel counters of this module, as {kernel: {calls, parallel_calls, elements, bytes, time, max_threads}}
+    """
+def stats_compiled() -> bool:
+    """
+    Whether the per-kernel counters were compiled in (-DZ2R_PERF_COUNTERS=ON)
+    """
+def stats_enabled() -> bool:
+    """
+    Whether the per-kernel counters are recording
+    """
+def trim_arena() -> None:
+    """
+    Release every cached block of the pool
+    """
+def warm_up() -> None:
+    """
+    Start the worker threads now
+    """
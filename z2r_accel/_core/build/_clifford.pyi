@@ -0,0 +1,231 @@
+"""
+Clifford circuits acting on Z2R encoded Pauli strings
+"""
+
+from __future__ import annotations
+import collections.abc
+import numpy
+import numpy.typing
+import typing
+
+__all__: list[str] = [
+    "StabilizerTableau",
+    "arena_outputs",
+    "arena_stats",
+    "clifford_conjugate",
+    "get_affinity",
+    "get_num_threads",
+    "get_numa",
+    "get_persistent_pool",
+    "get_schedule",
+    "numa_nodes",
+    "pop_thread_limits",
+    "push_thread_limits",
+    "set_affinity",
+    "set_arena_limit",
+    "set_arena_outputs",
+    "set_num_threads",
+    "set_numa",
+    "set_persistent_pool",
+    "set_schedule",
+    "set_stats_enabled",
+    "stats",
+    "stats_compiled",
+    "stats_enabled",
+    "taper",
+    "trim_arena",
+    "warm_up",
+    "z2_symmetries",
+]
+
+class StabilizerTableau:
+    def __init__(
+        self, num_qubits: typing.SupportsInt, seed: typing.SupportsInt | None = None
+    ) -> None: ...
+    def apply_circuit(
+        self, gates: typing.Annotated[numpy.typing.ArrayLike, numpy.int64]
+    ) -> None:
+        """
+        Apply a compiled Clifford circuit
+        """
+
+    def apply_gate(
+        self,
+        code: typing.SupportsInt,
+        qubit_0: typing.SupportsInt,
+        qubit_1: typing.SupportsInt = -1,
+    ) -> None:
+        """
+        Apply one Clifford gate
+        """
+
+    def copy(self) -> StabilizerTableau: ...
+    def destabilizers(self) -> tuple:
+        """
+        Destabilizers as (z_voids, x_voids, signs)
+        """
+
+    def expectation_values(
+        self, z_voids: numpy.ndarray, x_voids: numpy.ndarray
+    ) -> numpy.typing.NDArray[numpy.float64]:
+        """
+        Expectation values of Pauli strings against the state
+        """
+
+    def measure(self, qubit: typing.SupportsInt) -> tuple:
+        """
+        Measure a qubit in the Z basis. Returns (outcome, deterministic)
+        """
+
+    def stabilizers(self) -> tuple:
+        """
+        Stabilizer generators as (z_voids, x_voids, signs)
+        """
+
+    @property
+    def num_qubits(self) -> int: ...
+
+def arena_outputs() -> bool:
+    """
+    Whether the returned arrays are allocated from the pool
+    """
+
+def arena_stats() -> dict:
+    """
+    Counters of the pool of this module, as {hits, misses, live_bytes, cached_bytes, limit}
+    """
+
+def clifford_conjugate(
+    z_voids: numpy.ndarray,
+    x_voids: numpy.ndarray,
+    gates: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    phases: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+) -> tuple:
+    """
+    Conjugate every Pauli string by a compiled Clifford circuit
+    """
+
+def get_affinity() -> list[int]:
+    """
+    CPUs the threads are pinned to
+    """
+
+def get_num_threads() -> int:
+    """
+    Number of threads the parallel kernels use when called from this thread
+    """
+
+def get_numa() -> bool:
+    """
+    Whether the NUMA mode is on
+    """
+
+def get_persistent_pool() -> bool:
+    """
+    Whether the persistent pool mode is on
+    """
+
+def get_schedule() -> tuple:
+    """
+    Schedule of the parallel loops, as (kind, chunk)
+    """
+
+def numa_nodes() -> list[list[int]]:
+    """
+    CPUs available to this process, grouped by NUMA node
+    """
+
+def pop_thread_limits() -> None:
+    """
+    Undo the last push_thread_limits()
+    """
+
+def push_thread_limits(
+    num_threads: typing.SupportsInt, kind: typing.SupportsInt = 0, chunk: typing.SupportsInt = 0
+) -> None:
+    """
+    Override the settings for the calling thread, until pop_thread_limits()
+    """
+
+def set_affinity(
+    cpus: collections.abc.Sequence[typing.SupportsInt], pin_caller: bool = False
+) -> None:
+    """
+    Pin the teams of the calling threads to slices of cpus. An empty list unpins them
+    """
+
+def set_arena_limit(bytes: typing.SupportsInt) -> None:
+    """
+    Set the maximum number of bytes kept in the pool (0 disables the pooling)
+    """
+
+def set_arena_outputs(enabled: bool) -> None:
+    """
+    Allocate the returned arrays from the pool, or with NumPy
+    """
+
+def set_num_threads(num_threads: typing.SupportsInt) -> None:
+    """
+    Set the number of threads of the parallel kernels (0 for the OpenMP default)
+    """
+
+def set_numa(enabled: bool, pin_caller: bool = False) -> None:
+    """
+    Pin the threads node by node and first touch the large outputs in parallel
+    """
+
+def set_persistent_pool(enabled: bool) -> None:
+    """
+    Start the worker threads as soon as the settings change
+    """
+
+def set_schedule(kind: typing.SupportsInt, chunk: typing.SupportsInt = 0) -> None:
+    """
+    Set the schedule of the parallel loops (1: static, 2: dynamic, 3: guided)
+    """
+
+def set_stats_enabled(enabled: bool) -> None:
+    """
+    Start or stop recording the per-kernel counters
+    """
+
+def stats(reset: bool = False) -> dict:
+    """
+    Per-kernel counters of this module, as {kernel: {calls, parallel_calls, elements, bytes, time, max_threads}}
+    """
+
+def stats_compiled() -> bool:
+    """
+    Whether the per-kernel counters were compiled in (-DZ2R_PERF_COUNTERS=ON)
+    """
+
+def stats_enabled() -> bool:
+    """
+    Whether the per-kernel counters are recording
+    """
+
+def taper(
+    zx_voids: numpy.ndarray,
+    weights: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    num_qubits: typing.SupportsInt,
+    sector: collections.abc.Sequence[typing.SupportsInt] | None = None,
+    tolerance: typing.SupportsFloat = 0.0,
+) -> tuple:
+    """
+    Taper off one qubit per Z2 symmetry, in the given sector
+    """
+
+def trim_arena() -> None:
+    """
+    Release every cached block of the pool
+    """
+
+def warm_up() -> None:
+    """
+    Start the worker threads now
+    """
+
+def z2_symmetries(zx_voids: numpy.ndarray, num_qubits: typing.SupportsInt) -> tuple:
+    """
+    Independent commuting Z2 symmetries, and the Clifford mapping them to single-qubit Z
+    """
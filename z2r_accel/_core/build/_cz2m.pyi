@@ -9,21 +9,161 @@ import numpy.typing
 import typing
 
 __all__: list[str] = [
+    "OperatorBuilder",
+    "PauliIndex",
+    "arena_outputs",
+    "arena_stats",
+    "batched_gauss_jordan_inverse",
     "bitwise_commute_with",
+    "commutator",
+    "commute_mask",
+    "commutes_all",
+    "commutes_any",
     "compose",
+    "compose_many",
     "concatenate",
+    "count_anticommuting",
+    "fermion_to_qubit",
+    "filter_terms",
+    "first_anticommuting",
+    "from_support_lists",
     "gauss_jordan_inverse",
+    "get_affinity",
+    "get_num_threads",
+    "get_numa",
+    "get_persistent_pool",
+    "get_qubit_slices",
+    "get_schedule",
+    "hash_partition",
     "matmul",
+    "numa_nodes",
+    "operator_product",
+    "permute_qubits",
+    "pop_thread_limits",
+    "push_thread_limits",
     "random_zx_strings",
+    "random_zx_voids",
     "row_echelon",
+    "set_affinity",
+    "set_arena_limit",
+    "set_arena_outputs",
+    "set_num_threads",
+    "set_numa",
+    "set_persistent_pool",
+    "set_qubit_slices",
+    "set_schedule",
+    "set_stats_enabled",
+    "simplify",
+    "sparse_bitwise_commute_with",
+    "sparse_commute_with",
+    "sparse_compose",
+    "sparse_unique",
+    "split_zx",
+    "stats",
+    "stats_compiled",
+    "stats_enabled",
+    "stitch_zx",
+    "take_terms",
     "tensor",
     "to_matrix",
+    "to_support_lists",
+    "top_k_terms",
     "transpose",
+    "trim_arena",
     "unique",
     "unordered_unique",
+    "warm_up",
     "z2_to_uint8",
+    "zx_bitwise_commute_with",
+    "zx_commute_with",
+    "zx_compose",
+    "zx_weight",
 ]
 
+class OperatorBuilder:
+    def __init__(
+        self, itemsize: typing.SupportsInt, flush_threshold: typing.SupportsInt = 1048576
+    ) -> None: ...
+    def add(
+        self, zx_voids: numpy.ndarray, weights: numpy.typing.NDArray[numpy.complex128]
+    ) -> None:
+        """
+        Append terms, merged once the pending ones fill up
+        """
+
+    def finalize(self, tolerance: typing.SupportsFloat = 0.0) -> tuple:
+        """
+        The unique terms and their summed weights
+        """
+
+    def flush(self) -> None:
+        """
+        Merge the pending terms into the unique ones
+        """
+
+    @property
+    def itemsize(self) -> int: ...
+    @property
+    def num_pending(self) -> int: ...
+    @property
+    def num_unique(self) -> int: ...
+
+class PauliIndex:
+    @typing.overload
+    def __init__(self, zx_voids: numpy.ndarray) -> None: ...
+    @typing.overload
+    def __init__(self, other: PauliIndex) -> None: ...
+    def __len__(self) -> int: ...
+    def difference(self, zx_voids: numpy.ndarray) -> numpy.typing.NDArray[numpy.int64]:
+        """
+        Numbers of the voids of the set which are not among zx_voids
+        """
+
+    def insert(self, zx_voids: numpy.ndarray) -> numpy.typing.NDArray[numpy.int64]:
+        """
+        Add voids to the set, returning their numbers
+        """
+
+    def intersect(self, zx_voids: numpy.ndarray) -> tuple:
+        """
+        Positions of the voids in the set, and their numbers
+        """
+
+    def isin(self, zx_voids: numpy.ndarray) -> numpy.typing.NDArray[numpy.bool_]:
+        """
+        Whether each void is in the set
+        """
+
+    def keys(self) -> numpy.ndarray:
+        """
+        The voids of the set, in the order of their numbers
+        """
+
+    def lookup(self, zx_voids: numpy.ndarray) -> numpy.typing.NDArray[numpy.int64]:
+        """
+        Number of each void in the set, or -1
+        """
+
+    @property
+    def itemsize(self) -> int: ...
+
+def arena_outputs() -> bool:
+    """
+    Whether the returned arrays are allocated from the pool
+    """
+
+def arena_stats() -> dict:
+    """
+    Counters of the pool of this module, as {hits, misses, live_bytes, cached_bytes, limit}
+    """
+
+def batched_gauss_jordan_inverse(
+    matrices: numpy.ndarray, num_qubits: typing.SupportsInt
+) -> tuple:
+    """
+    Invert a stack of binary matrices, flagging the singular ones
+    """
+
 def bitwise_commute_with(
     arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: numpy.ndarray, arg3: numpy.ndarray
 ) -> numpy.typing.NDArray[numpy.bool]:
@@ -31,6 +171,49 @@ def bitwise_commute_with(
     Check commutation between two Pauli arrays
     """
 
+def commutator(
+    zx_a: numpy.ndarray,
+    w_a: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    zx_b: numpy.ndarray,
+    w_b: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    num_qubits: typing.SupportsInt,
+    tolerance: typing.SupportsFloat = 0.0,
+    return_norm: bool = False,
+) -> typing.Any:
+    """
+    Commutator of two weighted sums of Pauli strings, from their anticommuting pairs only
+    """
+
+def commute_mask(
+    zx_voids: numpy.ndarray,
+    zx_terms: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    qubit_wise: bool = False,
+) -> numpy.ndarray:
+    """
+    Bit-packed commutation flags of each Pauli string with every term
+    """
+
+def commutes_all(
+    zx_voids: numpy.ndarray,
+    zx_terms: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    qubit_wise: bool = False,
+) -> numpy.typing.NDArray[numpy.bool_]:
+    """
+    Whether each Pauli string commutes with all the terms
+    """
+
+def commutes_any(
+    zx_voids: numpy.ndarray,
+    zx_terms: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    qubit_wise: bool = False,
+) -> numpy.typing.NDArray[numpy.bool_]:
+    """
+    Whether each Pauli string commutes with at least one of the terms
+    """
+
 def compose(
     arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: numpy.ndarray, arg3: numpy.ndarray
 ) -> tuple:
@@ -38,6 +221,16 @@ def compose(
     Compose two Pauli arrays
     """
 
+def compose_many(
+    z1s: collections.abc.Sequence[numpy.ndarray],
+    x1s: collections.abc.Sequence[numpy.ndarray],
+    z2s: collections.abc.Sequence[numpy.ndarray],
+    x2s: collections.abc.Sequence[numpy.ndarray],
+) -> list:
+    """
+    Compose every pair of a batch of Pauli arrays, in a single call
+    """
+
 def concatenate(
     arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: typing.SupportsInt
 ) -> numpy.ndarray:
@@ -45,11 +238,103 @@ def concatenate(
     addwad
     """
 
+def count_anticommuting(
+    zx_voids: numpy.ndarray,
+    zx_terms: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    qubit_wise: bool = False,
+) -> numpy.typing.NDArray[numpy.int64]:
+    """
+    Number of terms not commuting with each Pauli string
+    """
+
+def fermion_to_qubit(
+    modes: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    creation: typing.Annotated[numpy.typing.ArrayLike, numpy.bool_],
+    values: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    num_modes: typing.SupportsInt,
+    mapping: typing.SupportsInt,
+    tolerance: typing.SupportsFloat = 0.0,
+) -> tuple:
+    """
+    Map a sum of products of ladder operators to qubits and simplify the result
+    """
+
+def filter_terms(
+    zx_voids: numpy.ndarray,
+    weights: numpy.typing.NDArray[numpy.complex128] | None,
+    num_qubits: typing.SupportsInt,
+    tolerance: typing.SupportsFloat | None = None,
+    max_weight: typing.SupportsInt | None = None,
+    support: numpy.typing.NDArray[numpy.int64] | None = None,
+) -> tuple:
+    """
+    Keep the terms above a weight tolerance, up to a Pauli weight or within a support
+    """
+
+def first_anticommuting(
+    zx_voids: numpy.ndarray,
+    zx_terms: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    qubit_wise: bool = False,
+) -> numpy.typing.NDArray[numpy.int64]:
+    """
+    Index of the first term not commuting with each Pauli string, or -1
+    """
+
+def from_support_lists(
+    offsets: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+    num_qubits: typing.SupportsInt,
+) -> tuple:
+    """
+    Convert support lists back to Z and X voids
+    """
+
 def gauss_jordan_inverse(matrix: numpy.ndarray, num_qubits: typing.SupportsInt) -> numpy.ndarray:
     """
     Compute the Gauss-Jordan inverse of a binary matrix
     """
 
+def get_affinity() -> list[int]:
+    """
+    CPUs the threads are pinned to
+    """
+
+def get_num_threads() -> int:
+    """
+    Number of threads the parallel kernels use when called from this thread
+    """
+
+def get_numa() -> bool:
+    """
+    Whether the NUMA mode is on
+    """
+
+def get_persistent_pool() -> bool:
+    """
+    Whether the persistent pool mode is on
+    """
+
+def get_qubit_slices(
+    voids: numpy.ndarray, indices: collections.abc.Sequence[typing.SupportsInt]
+) -> numpy.ndarray:
+    """
+    Extract the given qubits from every void
+    """
+
+def get_schedule() -> tuple:
+    """
+    Schedule of the parallel loops, as (kind, chunk)
+    """
+
+def hash_partition(
+    zx_voids: numpy.ndarray, num_partitions: typing.SupportsInt
+) -> numpy.typing.NDArray[numpy.int64]:
+    """
+    Assign Pauli strings to partitions by hash
+    """
+
 def matmul(
     arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: typing.SupportsInt, arg3: typing.SupportsInt
 ) -> numpy.ndarray:
@@ -57,16 +342,205 @@ def matmul(
     addwad
     """
 
+def numa_nodes() -> list[list[int]]:
+    """
+    CPUs available to this process, grouped by NUMA node
+    """
+
+def operator_product(
+    zx_a: numpy.ndarray,
+    w_a: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    zx_b: numpy.ndarray,
+    w_b: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    num_qubits: typing.SupportsInt,
+    tolerance: typing.SupportsFloat = 0.0,
+) -> tuple:
+    """
+    Multiply two weighted sums of Pauli strings and simplify the result
+    """
+
+def permute_qubits(
+    voids: numpy.ndarray, permutation: collections.abc.Sequence[typing.SupportsInt]
+) -> numpy.ndarray:
+    """
+    Apply a qubit permutation to every void
+    """
+
+def pop_thread_limits() -> None:
+    """
+    Undo the last push_thread_limits()
+    """
+
+def push_thread_limits(
+    num_threads: typing.SupportsInt, kind: typing.SupportsInt = 0, chunk: typing.SupportsInt = 0
+) -> None:
+    """
+    Override the settings for the calling thread, until pop_thread_limits()
+    """
+
 def random_zx_strings(arg0: collections.abc.Sequence[typing.SupportsInt]) -> tuple:
     """
     Gfddy
     """
 
+def random_zx_voids(
+    shape: collections.abc.Sequence[typing.SupportsInt],
+    itemsize: typing.SupportsInt,
+    num_qubits: typing.SupportsInt = -1,
+    weight: typing.SupportsInt = -1,
+    seed: typing.SupportsInt | None = None,
+) -> tuple:
+    """
+    Generate random Z and X voids with a seedable, parallel generator
+    """
+
 def row_echelon(arg0: numpy.ndarray, arg1: typing.SupportsInt) -> numpy.ndarray:
     """
     addwad
     """
 
+def set_affinity(
+    cpus: collections.abc.Sequence[typing.SupportsInt], pin_caller: bool = False
+) -> None:
+    """
+    Pin the teams of the calling threads to slices of cpus. An empty list unpins them
+    """
+
+def set_arena_limit(bytes: typing.SupportsInt) -> None:
+    """
+    Set the maximum number of bytes kept in the pool (0 disables the pooling)
+    """
+
+def set_arena_outputs(enabled: bool) -> None:
+    """
+    Allocate the returned arrays from the pool, or with NumPy
+    """
+
+def set_num_threads(num_threads: typing.SupportsInt) -> None:
+    """
+    Set the number of threads of the parallel kernels (0 for the OpenMP default)
+    """
+
+def set_numa(enabled: bool, pin_caller: bool = False) -> None:
+    """
+    Pin the threads node by node and first touch the large outputs in parallel
+    """
+
+def set_persistent_pool(enabled: bool) -> None:
+    """
+    Start the worker threads as soon as the settings change
+    """
+
+def set_qubit_slices(
+    voids: numpy.ndarray,
+    sub_voids: numpy.ndarray,
+    indices: collections.abc.Sequence[typing.SupportsInt],
+) -> numpy.ndarray:
+    """
+    Insert narrow voids into wider ones at the given qubits
+    """
+
+def set_schedule(kind: typing.SupportsInt, chunk: typing.SupportsInt = 0) -> None:
+    """
+    Set the schedule of the parallel loops (1: static, 2: dynamic, 3: guided)
+    """
+
+def set_stats_enabled(enabled: bool) -> None:
+    """
+    Start or stop recording the per-kernel counters
+    """
+
+def simplify(
+    zx_voids: numpy.ndarray,
+    weights: typing.Annotated[numpy.typing.ArrayLike, numpy.complex128],
+    tolerance: typing.SupportsFloat = 0.0,
+) -> tuple:
+    """
+    Sum the weights of identical Pauli strings
+    """
+
+def sparse_bitwise_commute_with(
+    offsets_1: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_1: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+    offsets_2: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_2: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+) -> numpy.typing.NDArray[numpy.bool_]:
+    """
+    Check qubit-wise commutation between two Pauli arrays in support lists
+    """
+
+def sparse_commute_with(
+    offsets_1: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_1: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+    offsets_2: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_2: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+) -> numpy.typing.NDArray[numpy.bool_]:
+    """
+    Check commutation between two Pauli arrays in support lists
+    """
+
+def sparse_compose(
+    offsets_1: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_1: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+    offsets_2: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries_2: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+) -> tuple:
+    """
+    Compose two Pauli arrays in support lists
+    """
+
+def sparse_unique(
+    offsets: typing.Annotated[numpy.typing.ArrayLike, numpy.int64],
+    entries: typing.Annotated[numpy.typing.ArrayLike, numpy.uint32],
+) -> tuple:
+    """
+    Unordered unique Pauli strings in support lists
+    """
+
+def split_zx(
+    zx_voids: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    z_out: numpy.ndarray | None = None,
+    x_out: numpy.ndarray | None = None,
+) -> tuple:
+    """
+    Split stitched zx voids into Z and X voids
+    """
+
+def stats(reset: bool = False) -> dict:
+    """
+    Per-kernel counters of this module, as {kernel: {calls, parallel_calls, elements, bytes, time, max_threads}}
+    """
+
+def stats_compiled() -> bool:
+    """
+    Whether the per-kernel counters were compiled in (-DZ2R_PERF_COUNTERS=ON)
+    """
+
+def stats_enabled() -> bool:
+    """
+    Whether the per-kernel counters are recording
+    """
+
+def stitch_zx(
+    z_voids: numpy.ndarray,
+    x_voids: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    out: numpy.ndarray | None = None,
+) -> numpy.ndarray:
+    """
+    Stitch Z and X voids into zx voids
+    """
+
+def take_terms(
+    zx_voids: numpy.ndarray,
+    indices: numpy.typing.NDArray[numpy.int64],
+    weights: numpy.typing.NDArray[numpy.complex128] | None = None,
+) -> tuple:
+    """
+    Gather terms by index
+    """
+
 def tensor(
     arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: numpy.ndarray, arg3: numpy.ndarray
 ) -> tuple:
@@ -81,11 +555,30 @@ def to_matrix(
     addwad
     """
 
+def to_support_lists(z_voids: numpy.ndarray, x_voids: numpy.ndarray) -> tuple:
+    """
+    Convert Z and X voids to support lists (offsets, entries)
+    """
+
+def top_k_terms(
+    zx_voids: numpy.ndarray,
+    weights: numpy.typing.NDArray[numpy.complex128],
+    k: typing.SupportsInt,
+) -> tuple:
+    """
+    Keep the k terms of largest weight magnitude
+    """
+
 def transpose(arg0: numpy.ndarray, arg1: typing.SupportsInt) -> numpy.ndarray:
     """
     addwad
     """
 
+def trim_arena() -> None:
+    """
+    Release every cached block of the pool
+    """
+
 def unique(
     zx_voids: numpy.ndarray,
     return_index: bool = False,
@@ -101,9 +594,45 @@ def unordered_unique(arg0: numpy.ndarray) -> tuple:
     Returns unordered unique rows of the input array
     """
 
+def warm_up() -> None:
+    """
+    Start the worker threads now
+    """
+
 def z2_to_uint8(
     z2r: numpy.ndarray, num_qubits: typing.SupportsInt
 ) -> numpy.typing.NDArray[numpy.uint8]:
     """
     Convert z2r array to uint8 representation
     """
+
+def zx_bitwise_commute_with(
+    zx1: numpy.ndarray, zx2: numpy.ndarray, num_qubits: typing.SupportsInt
+) -> numpy.typing.NDArray[numpy.bool]:
+    """
+    Check qubit-wise commutation between two Pauli arrays of stitched zx voids
+    """
+
+def zx_commute_with(
+    zx1: numpy.ndarray, zx2: numpy.ndarray, num_qubits: typing.SupportsInt
+) -> numpy.typing.NDArray[numpy.bool]:
+    """
+    Check commutation between two Pauli arrays of stitched zx voids
+    """
+
+def zx_compose(
+    zx1: numpy.ndarray,
+    zx2: numpy.ndarray,
+    num_qubits: typing.SupportsInt,
+    out: numpy.ndarray | None = None,
+) -> tuple:
+    """
+    Compose two Pauli arrays of stitched zx voids
+    """
+
+def zx_weight(
+    zx_voids: numpy.ndarray, num_qubits: typing.SupportsInt
+) -> numpy.typing.NDArray[numpy.int64]:
+    """
+    Weight of the Pauli strings of stitched zx voids
+    """
@@ -20,11 +20,8 @@ namespace py = pybind11;
 #include <iostream>
 #include <vector>
 
-#ifdef USE_OPENMP
-    #include <omp.h>
-#else
-    #warning "OpenMP is not enabled"
-#endif
+#include "z2r_arena.h"
+#include "z2r_core.h"
 
 // bit_operations
 // cz2m
@@ -32,10 +29,6 @@ namespace py = pybind11;
 // z2row
 // z2r  = voids
 
-// This threshold is completely arbitrary and can be tuned for performance depending on the
-// hardware.
-#define BOPS_THRESHOLD_PARALLEL 1'000'000
-
 py::array bitwise_and(py::array z2r_1, py::array z2r_2);
 py::array bitwise_xor(py::array z2r_1, py::array z2r_2);
 py::array bitwise_or(py::array z2r_1, py::array z2r_2);
@@ -43,11 +36,116 @@ py::array bitwise_not(py::array voids);
 py::array paded_bitwise_not(py::array voids, int num_qubits);
 py::object bitwise_count(py::array z2r_1);
 py::object bitwise_dot(py::array z2r_1, py::array z2r_2);
+py::list bitwise_xor_many(const std::vector<py::array> &z2r_1s,
+                          const std::vector<py::array> &z2r_2s);
+
+/**
+ * @brief Bytes of a contiguous NumPy array, for the element-wise kernels of z2r_core.h.
+ *
+ * @param buf The buffer of the array
+ * @return std::span<const uint8_t>
+ */
+inline std::span<const uint8_t> byte_span(const py::buffer_info &buf) {
+    return {static_cast<const uint8_t *>(buf.ptr), static_cast<size_t>(buf.size * buf.itemsize)};
+}
+
+inline std::span<uint8_t> mutable_byte_span(const py::buffer_info &buf) {
+    return {static_cast<uint8_t *>(buf.ptr), static_cast<size_t>(buf.size * buf.itemsize)};
+}
+
+/**
+ * @brief Rows of a contiguous NumPy array of voids, for the row-wise kernels of z2r_core.h. The
+ * array is seen as flat, whatever its shape.
+ *
+ * @param buf The buffer of the array
+ * @return VoidView
+ */
+inline VoidView void_view(const py::buffer_info &buf) {
+    return VoidView(static_cast<const uint8_t *>(buf.ptr), static_cast<size_t>(buf.size),
+                    static_cast<size_t>(buf.itemsize));
+}
+
+inline MutableVoidView mutable_void_view(const py::buffer_info &buf) {
+    return MutableVoidView(static_cast<uint8_t *>(buf.ptr), static_cast<size_t>(buf.size),
+                           static_cast<size_t>(buf.itemsize));
+}
+
+/**
+ * @brief The array itself when it is C-contiguous, a contiguous copy otherwise. The batched
+ * (*_many) functions check contiguity here rather than in Python, to save a call per array.
+ *
+ * @param arr The input array
+ * @return py::array
+ */
+inline py::array c_contiguous(const py::array &arr) {
+    if (arr.flags() & py::array::c_style) {
+        return arr;
+    }
+    return py::array::ensure(arr, py::array::c_style);
+}
+
+/**
+ * @brief Allocates an uninitialized, C-contiguous output array. When z2r::arena::outputs() is on,
+ * its buffer comes from the pool of z2r_arena.h, and goes back to it when the array is freed. In
+ * NUMA mode, large buffers are first touched in parallel (z2r::first_touch()).
+ *
+ * @param dtype The dtype of the array
+ * @param shape The shape of the array
+ * @return py::array
+ */
+inline py::array output_array(const py::dtype &dtype, const std::vector<ssize_t> &shape) {
+    size_t nbytes = static_cast<size_t>(dtype.itemsize());
+    for (ssize_t dim : shape) {
+        nbytes *= static_cast<size_t>(dim);
+    }
+    py::array out;
+    if (z2r::arena::outputs()) {
+        void *ptr = z2r::arena::allocate(nbytes);
+        py::capsule owner(ptr, [](void *p) { z2r::arena::deallocate(p); });
+        out = py::array(dtype, shape, ptr, owner);
+    } else {
+        out = py::array(dtype, shape);
+    }
+    z2r::first_touch({static_cast<uint8_t *>(out.mutable_data()), nbytes});
+    return out;
+}
+
+/**
+ * @brief Allocates the outputs of a batched function as views into a single buffer, rather than
+ * one buffer per output. Each view starts 64 bytes after the end of the previous one, so that
+ * threads writing to neighbouring outputs do not share cache lines. The buffer lives as long as
+ * any of the views.
+ *
+ * @param dtypes The dtype of each output
+ * @param shapes The shape of each output
+ * @return std::vector<py::array> The outputs, C-contiguous and uninitialized
+ */
+inline std::vector<py::array> batch_outputs(const std::vector<py::dtype> &dtypes,
+                                            const std::vector<std::vector<ssize_t>> &shapes) {
+    std::vector<size_t> offsets(dtypes.size() + 1, 0);
+    for (size_t t = 0; t < dtypes.size(); ++t) {
+        size_t nbytes = static_cast<size_t>(dtypes[t].itemsize());
+        for (ssize_t dim : shapes[t]) {
+            nbytes *= static_cast<size_t>(dim);
+        }
+        offsets[t + 1] = (offsets[t] + nbytes + 63) / 64 * 64;
+    }
+
+    py::array block = output_array(py::dtype("u1"), {static_cast<ssize_t>(offsets.back())});
+    uint8_t *base = static_cast<uint8_t *>(block.mutable_data());
+    std::vector<py::array> outputs;
+    outputs.reserve(dtypes.size());
+    for (size_t t = 0; t < dtypes.size(); ++t) {
+        outputs.emplace_back(dtypes[t], shapes[t], base + offsets[t], block);
+    }
+    return outputs;
+}
 
 /**
  * @brief This templated function performs an element-wise, bitwise operation onto two NumPy
- * contiguous (C-like) arrays. Any other type of operators or type of arrays will lead to undefined
- * behavior. This function is the basis all two-array bitwise operations.
+ * contiguous (C-like) arrays, through z2r::bitwise_binary(). Any other type of operators or type
+ * of arrays will lead to undefined behavior. This function is the basis all two-array bitwise
+ * operations.
  *
  * @tparam Op The type of the bitwise operator (std::bit_and<uint64_t>, std::bit_xor<uint64_t>...)
  * @param z2r_1 The first input array from Python.
@@ -67,43 +165,10 @@ template <typename Op> py::object bitwise_core(py::array z2r_1, py::array z2r_2,
         throw std::runtime_error("Input arrays must have the same size.");
     }
 
-    size_t total_bytes = buf1.size * buf1.itemsize;
-    py::array z2r_out = py::array(z2r_1.dtype(), buf1.shape);
+    py::array z2r_out = output_array(z2r_1.dtype(), buf1.shape);
     auto buf_out = z2r_out.request();
 
-    // Cut the data into 64-bit chunks for faster proceCest ssing
-    // ptr1_64 and ptr2_64 are the pointers to the input data, ptr_out_64 is the pointer to the
-    // output data
-    // TODO: With C++20, we could use std::assume_aligned, which could potentially lead to better
-    // auto-vectorization by the compiler? ? Since NumPy cant guarantee alignement and we cant
-    // afford to copy the data just to get better SIMD, I dont know if assume_aligned is worth
-    // anything.
-    const uint64_t *ptr1_64 = std::bit_cast<uint64_t *>(buf1.ptr);
-    const uint64_t *ptr2_64 = std::bit_cast<uint64_t *>(buf2.ptr);
-    int64_t *ptr_out_64 = std::bit_cast<int64_t *>(buf_out.ptr);
-
-    size_t num_u64_chunks = total_bytes / 8;
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t i = 0; i < num_u64_chunks; ++i) {
-        // Applies the bitwise operation.
-        ptr_out_64[i] = op(ptr1_64[i], ptr2_64[i]);
-    }
-
-    // Handle any bytes that don't fit into a 64-bit chunk (the tail)
-    size_t tail_bytes = total_bytes % 8;
-    if (tail_bytes > 0) {
-        const uint8_t *ptr1_8 = std::bit_cast<uint8_t *>(buf1.ptr);
-        const uint8_t *ptr2_8 = std::bit_cast<uint8_t *>(buf2.ptr);
-        int8_t *ptr_out_8 = std::bit_cast<int8_t *>(buf_out.ptr);
-
-        size_t start_byte = num_u64_chunks * 8;
-        for (size_t i = 0; i < tail_bytes; ++i) {
-            ptr_out_8[start_byte + i] = op(ptr1_8[start_byte + i], ptr2_8[start_byte + i]);
-        }
-    }
+    z2r::bitwise_binary(byte_span(buf1), byte_span(buf2), mutable_byte_span(buf_out), op);
 
     // If the input arrays were actually scalars (shape == ()), return a scalar as well
     if (buf1.size == 1) {
@@ -0,0 +1,79 @@
+/**
+ * @file clifford.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+namespace py = pybind11;
+
+#include <bit>
+#include <complex>
+#include <cstdint> // uint8_t
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "bitops.h"
+#include "cz2m.h"
+#include "z2r_clifford.h"
+
+#ifdef USE_OPENMP
+    #include <omp.h>
+#else
+    #warning "OpenMP is not enabled"
+#endif
+
+// Number of tableau rows (or Pauli strings for expectation values) before going multi-threaded
+#define TABLEAU_THRESHOLD_PARALLEL 2048
+
+/**
+ * @brief Stabilizer state of n qubits, stored as an Aaronson-Gottesman tableau (quant-ph/0406196).
+ *
+ * Rows 0 to n-1 are the destabilizers, rows n to 2n-1 are the stabilizers and row 2n is a scratch
+ * row. Each row is a Pauli string in the Z2R layout: `words` 64-bit words of Z followed by as many
+ * words of X, plus a sign bit. Row operations are thus plain loops over contiguous words, which
+ * the compiler vectorizes.
+ */
+class StabilizerTableau {
+  public:
+    StabilizerTableau(size_t num_qubits, std::optional<uint64_t> seed = std::nullopt);
+
+    size_t num_qubits() const { return n_; }
+
+    void apply_gate(int64_t code, int64_t a, int64_t b = -1);
+    void apply_circuit(py::array_t<int64_t> gates);
+
+    py::tuple measure(size_t qubit);
+    py::array_t<double> expectation_values(py::array z_voids, py::array x_voids) const;
+
+    py::tuple stabilizers() const;
+    py::tuple destabilizers() const;
+
+  private:
+    uint64_t *z_row(size_t r) { return data_.data() + 2 * r * words_; }
+    uint64_t *x_row(size_t r) { return data_.data() + (2 * r + 1) * words_; }
+    const uint64_t *z_row(size_t r) const { return data_.data() + 2 * r * words_; }
+    const uint64_t *x_row(size_t r) const { return data_.data() + (2 * r + 1) * words_; }
+    bool x_bit(size_t r, size_t q) const { return (x_row(r)[q / 64] >> (q % 64)) & 1; }
+
+    void rowsum(size_t h, size_t i);
+    py::tuple rows_to_voids(size_t first) const;
+
+    size_t n_;
+    size_t words_;
+    std::vector<uint64_t> data_;
+    std::vector<uint8_t> signs_;
+    uint64_t key_;
+    uint64_t counter_ = 0;
+};
+
+py::tuple clifford_conjugate(py::array z_voids, py::array x_voids, py::array_t<int64_t> gates,
+                             py::array_t<std::complex<double>> phases);
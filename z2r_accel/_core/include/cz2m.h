@@ -18,30 +18,32 @@ namespace py = pybind11;
 #include <cstdint> // uint8_t
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <optional>
 #include <random>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "bitops.h"
 
-#ifdef USE_OPENMP
-    #include <omp.h>
-#else
-    #warning "OpenMP is not enabled"
-#endif
-
-#define FUNC_THRESHOLD_PARALLEL 100000
-
 // Function declarations
 py::tuple tensor(py::array z2, py::array x2, py::array z1, py::array x1);
 
 py::tuple compose(py::array z1, py::array x1, py::array z2, py::array x2);
 
+py::list compose_many(const std::vector<py::array> &z1s, const std::vector<py::array> &x1s,
+                      const std::vector<py::array> &z2s, const std::vector<py::array> &x2s);
+
 py::array_t<bool> bitwise_commute_with(py::array z1, py::array x1, py::array z2, py::array x2);
 
 py::tuple random_zx_strings(const std::vector<size_t> &shape);
 
+py::tuple random_zx_voids(const std::vector<ssize_t> &shape, size_t itemsize,
+                          int64_t num_qubits = -1, int64_t weight = -1,
+                          std::optional<uint64_t> seed = std::nullopt);
+
 py::object unique(py::array zx_voids, bool return_index = false, bool return_inverse = false,
                   bool return_counts = false);
 
@@ -64,4 +66,98 @@ py::array concatenate(py::array x1, py::array x2, int axis = 0);
 
 py::array_t<uint8_t> z2_to_uint8(py::array z2r, int num_qubits);
 
-py::array gauss_jordan_inverse(py::array matrix, int num_bits);
\ No newline at end of file
+py::array gauss_jordan_inverse(py::array matrix, int num_bits);
+
+py::tuple batched_gauss_jordan_inverse(py::array matrices, int num_bits);
+
+py::array get_qubit_slices(py::array voids, const std::vector<int64_t> &indices);
+
+py::array set_qubit_slices(py::array voids, py::array sub_voids,
+                           const std::vector<int64_t> &indices);
+
+py::array permute_qubits(py::array voids, const std::vector<int64_t> &permutation);
+
+py::tuple operator_product(py::array zx_a, py::array_t<std::complex<double>> w_a, py::array zx_b,
+                           py::array_t<std::complex<double>> w_b, int num_qubits,
+                           double tolerance = 0.0);
+
+py::object commutator(py::array zx_a, py::array_t<std::complex<double>> w_a, py::array zx_b,
+                      py::array_t<std::complex<double>> w_b, int num_qubits,
+                      double tolerance = 0.0, bool return_norm = false);
+
+py::tuple simplify(py::array zx_voids, py::array_t<std::complex<double>> weights,
+                   double tolerance = 0.0);
+
+py::array_t<int64_t> hash_partition(py::array zx_voids, int64_t num_partitions);
+
+py::tuple split_zx(py::array zx_voids, int num_qubits,
+                   std::optional<py::array> z_out = std::nullopt,
+                   std::optional<py::array> x_out = std::nullopt);
+
+py::array stitch_zx(py::array z_voids, py::array x_voids, int num_qubits,
+                    std::optional<py::array> out = std::nullopt);
+
+py::tuple zx_compose(py::array zx1, py::array zx2, int num_qubits,
+                     std::optional<py::array> out = std::nullopt);
+
+py::array_t<bool> zx_commute_with(py::array zx1, py::array zx2, int num_qubits);
+
+py::array_t<bool> zx_bitwise_commute_with(py::array zx1, py::array zx2, int num_qubits);
+
+py::array_t<int64_t> zx_weight(py::array zx_voids, int num_qubits);
+
+py::tuple filter_terms(py::array zx_voids, std::optional<py::array_t<std::complex<double>>> weights,
+                       int num_qubits, std::optional<double> tolerance = std::nullopt,
+                       std::optional<int64_t> max_weight = std::nullopt,
+                       std::optional<py::array_t<int64_t>> support = std::nullopt);
+
+py::tuple take_terms(py::array zx_voids, py::array_t<int64_t> indices,
+                     std::optional<py::array_t<std::complex<double>>> weights = std::nullopt);
+
+py::tuple top_k_terms(py::array zx_voids, py::array_t<std::complex<double>> weights, int64_t k);
+
+py::array_t<bool> commutes_all(py::array zx_voids, py::array zx_terms, int num_qubits,
+                               bool qubit_wise);
+py::array_t<bool> commutes_any(py::array zx_voids, py::array zx_terms, int num_qubits,
+                               bool qubit_wise);
+py::array_t<int64_t> count_anticommuting(py::array zx_voids, py::array zx_terms, int num_qubits,
+                                         bool qubit_wise);
+py::array_t<int64_t> first_anticommuting(py::array zx_voids, py::array zx_terms, int num_qubits,
+                                         bool qubit_wise);
+py::array commute_mask(py::array zx_voids, py::array zx_terms, int num_qubits, bool qubit_wise);
+
+/**
+ * @brief Copies the terms of one or more accumulators whose weight magnitude is above a tolerance
+ * into a (zx voids, weights) tuple. The accumulators must not share any Pauli string.
+ *
+ * @param parts The accumulators
+ * @param num_parts Number of accumulators
+ * @param dtype The void dtype of the output Pauli strings
+ * @param tolerance Terms with a weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights)
+ */
+inline py::tuple accumulator_to_arrays(const PauliAccumulator *parts, size_t num_parts,
+                                       py::dtype dtype, double tolerance) {
+    size_t itemsize = dtype.itemsize();
+    std::vector<std::pair<size_t, size_t>> kept;
+    for (size_t p = 0; p < num_parts; ++p) {
+        for (size_t i = 0; i < parts[p].size(); ++i) {
+            if (std::abs(parts[p].weight(i)) > tolerance) {
+                kept.emplace_back(p, i);
+            }
+        }
+    }
+
+    std::vector<ssize_t> out_shape = {static_cast<ssize_t>(kept.size())};
+    py::array zx_out = py::array(dtype, out_shape);
+    py::array_t<std::complex<double>> w_out(out_shape);
+    uint8_t *ptr_out = static_cast<uint8_t *>(zx_out.request().ptr);
+    std::complex<double> *ptr_wout = static_cast<std::complex<double> *>(w_out.request().ptr);
+    for (size_t k = 0; k < kept.size(); ++k) {
+        const PauliAccumulator &acc = parts[kept[k].first];
+        std::memcpy(ptr_out + k * itemsize, acc.key(kept[k].second), itemsize);
+        ptr_wout[k] = acc.weight(kept[k].second);
+    }
+
+    return py::make_tuple(zx_out, w_out);
+}
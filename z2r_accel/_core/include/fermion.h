@@ -0,0 +1,19 @@
+/**
+ * @file fermion.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the fermion-to-qubit mappings. The kernels are in z2r_fermion.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include "cz2m.h"
+#include "z2r_fermion.h"
+
+py::tuple fermion_to_qubit(py::array_t<int64_t> modes, py::array_t<bool> creation,
+                           py::array_t<std::complex<double>> values, int num_modes,
+                           int64_t mapping, double tolerance = 0.0);
@@ -0,0 +1,39 @@
+/**
+ * @file operator_builder.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the append-only builder of weighted sums of Pauli strings. See
+ * z2r_builder.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+
+#include "cz2m.h"
+#include "z2r_builder.h"
+
+/**
+ * @brief Python face of z2r::OperatorBuilder. The methods release the GIL while the builder runs,
+ * so that several Python threads can add terms to one builder at once.
+ */
+class OperatorBuilder {
+  public:
+    explicit OperatorBuilder(size_t itemsize, size_t flush_threshold = BUILDER_FLUSH_THRESHOLD)
+        : builder_(itemsize, flush_threshold) {}
+
+    size_t itemsize() const { return builder_.itemsize(); }
+    size_t num_unique() const { return builder_.num_unique(); }
+    size_t num_pending() const { return builder_.num_pending(); }
+
+    void add(py::array zx_voids, py::array_t<std::complex<double>> weights);
+    void flush();
+    py::tuple finalize(double tolerance);
+
+  private:
+    z2r::OperatorBuilder builder_;
+};
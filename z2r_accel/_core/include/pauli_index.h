@@ -0,0 +1,42 @@
+/**
+ * @file pauli_index.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the persistent hash index over a set of Pauli strings. The index
+ * itself is z2r::PauliIndex, in z2r_index.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "cz2m.h"
+#include "z2r_index.h"
+
+/**
+ * @brief NumPy front end of z2r::PauliIndex. Every method checks the itemsize of the queries,
+ * then calls the index without the GIL, so several Python threads may use one index at once.
+ */
+class PauliIndex {
+  public:
+    explicit PauliIndex(py::array zx_voids);
+
+    size_t size() const { return index_.size(); }
+    size_t itemsize() const { return index_.itemsize(); }
+
+    py::array keys() const;
+    py::array_t<int64_t> lookup(py::array zx_voids) const;
+    py::array_t<bool> isin(py::array zx_voids) const;
+    py::array_t<int64_t> insert(py::array zx_voids);
+    py::tuple intersect(py::array zx_voids) const;
+    py::array_t<int64_t> difference(py::array zx_voids) const;
+
+  private:
+    VoidView checked_view(const py::buffer_info &buf) const;
+
+    z2r::PauliIndex index_;
+};
@@ -0,0 +1,31 @@
+/**
+ * @file sparse_pauli.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the support-list encoding of low-weight Pauli strings on many qubits.
+ * See z2r_sparse.h for the encoding.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include "cz2m.h"
+#include "z2r_sparse.h"
+
+py::tuple to_support_lists(py::array z_voids, py::array x_voids);
+py::tuple from_support_lists(py::array_t<int64_t> offsets, py::array_t<uint32_t> entries,
+                             int num_qubits);
+py::tuple sparse_compose(py::array_t<int64_t> offsets_1, py::array_t<uint32_t> entries_1,
+                         py::array_t<int64_t> offsets_2, py::array_t<uint32_t> entries_2);
+py::array_t<bool> sparse_commute_with(py::array_t<int64_t> offsets_1,
+                                      py::array_t<uint32_t> entries_1,
+                                      py::array_t<int64_t> offsets_2,
+                                      py::array_t<uint32_t> entries_2);
+py::array_t<bool> sparse_bitwise_commute_with(py::array_t<int64_t> offsets_1,
+                                              py::array_t<uint32_t> entries_1,
+                                              py::array_t<int64_t> offsets_2,
+                                              py::array_t<uint32_t> entries_2);
+py::tuple sparse_unique(py::array_t<int64_t> offsets, py::array_t<uint32_t> entries);
@@ -0,0 +1,24 @@
+/**
+ * @file taper.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the Z2 symmetries of a qubit operator, and qubit tapering. The kernels
+ * are in z2r_taper.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "clifford.h"
+#include "z2r_taper.h"
+
+py::tuple z2_symmetries(py::array zx_voids, int num_qubits);
+
+py::tuple taper(py::array zx_voids, py::array_t<std::complex<double>> weights, int num_qubits,
+                std::optional<std::vector<int>> sector = std::nullopt, double tolerance = 0.0);
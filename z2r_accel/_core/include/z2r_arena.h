@@ -0,0 +1,97 @@
+/**
+ * @file z2r_arena.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Pooled, cache-line aligned allocator for the outputs and temporaries of the kernels.
+ *
+ * Every block is 64-byte aligned and rounded up to a size class: 64, 128, 192 and 256 bytes, then
+ * four classes per power of two (at most 25% of padding). A freed block is not given back to the
+ * system but kept in the free list of its class, as long as the cached blocks stay under a limit
+ * (set_limit(), 2 GiB by default, or the Z2R_ARENA_LIMIT environment variable, in bytes). The next
+ * allocation of the same class reuses it: its pages are already mapped, so the kernel that writes
+ * to it takes no page fault.
+ *
+ * Temporaries use it through z2r::arena::vector. NumPy outputs only do when set_outputs(true) was
+ * called (or Z2R_ARENA_OUTPUTS=1): the array then owns its block through a capsule, which gives it
+ * back to the pool when the array is freed.
+ *
+ * @note z2r_core is a shared library, so there is one pool, and one limit, for the whole process:
+ * the Python modules all allocate from it.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace z2r::arena {
+
+// Alignment of every block, one cache line
+inline constexpr size_t ALIGNMENT = 64;
+
+/**
+ * @brief Running totals of the pool, as returned by snapshot().
+ */
+struct ArenaStats {
+    uint64_t hits;         // Allocations served from a free list
+    uint64_t misses;       // Allocations that went to the system
+    uint64_t live_bytes;   // Bytes of the blocks in use
+    uint64_t cached_bytes; // Bytes of the blocks waiting in the free lists
+    uint64_t limit;        // Maximum of cached_bytes
+};
+
+/**
+ * @brief Allocates a 64-byte aligned block of at least `bytes` bytes, uninitialized.
+ *
+ * @throws std::bad_alloc
+ */
+void *allocate(size_t bytes);
+
+/**
+ * @brief Gives back a block returned by allocate(). Null is ignored.
+ */
+void deallocate(void *ptr) noexcept;
+
+/**
+ * @brief Sets the maximum number of bytes kept in the free lists. 0 disables the pooling. Blocks
+ * cached beyond the new limit are released.
+ */
+void set_limit(size_t bytes);
+size_t limit();
+
+/**
+ * @brief Releases every cached block to the system.
+ */
+void trim();
+
+ArenaStats snapshot();
+
+/**
+ * @brief Whether the NumPy arrays returned by the kernels are allocated from the pool.
+ */
+void set_outputs(bool enable);
+bool outputs();
+
+/**
+ * @brief Standard allocator over the pool, for the temporaries of the kernels.
+ */
+template <typename T> struct Allocator {
+    using value_type = T;
+
+    Allocator() noexcept = default;
+    template <typename U> Allocator(const Allocator<U> &) noexcept {}
+
+    T *allocate(size_t n) { return static_cast<T *>(arena::allocate(n * sizeof(T))); }
+    void deallocate(T *ptr, size_t) noexcept { arena::deallocate(ptr); }
+
+    template <typename U> bool operator==(const Allocator<U> &) const noexcept { return true; }
+};
+
+template <typename T> using vector = std::vector<T, Allocator<T>>;
+
+} // namespace z2r::arena
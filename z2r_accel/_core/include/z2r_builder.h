@@ -0,0 +1,73 @@
+/**
+ * @file z2r_builder.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free append-only builder of weighted sums of Pauli strings, with deferred
+ * simplification.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "z2r_core.h"
+#include "z2r_index.h"
+
+// Default number of pending terms that triggers a flush()
+#define BUILDER_FLUSH_THRESHOLD (size_t{1} << 20)
+
+namespace z2r {
+
+/**
+ * @brief Voids and weights of the terms of an operator, the voids stored back to back.
+ */
+struct WeightedTerms {
+    std::vector<uint8_t> keys;
+    std::vector<std::complex<double>> weights;
+};
+
+/**
+ * @brief Accumulates an operator from many small batches of (voids, weights), without the
+ * concatenate and simplify() of the whole operator after every batch.
+ *
+ * add() only appends the batch to a pending buffer, which grows geometrically. Once it holds
+ * flush_threshold terms (or on flush() / finalize()), the pending terms are merged into a
+ * PauliIndex of the unique voids, summing their weights. The index keeps the hash of every
+ * unique void, so a merge only hashes the pending terms: the cost of building an operator is
+ * linear in the number of terms added, whatever the number of batches.
+ *
+ * Every method locks the builder, so that several threads can add terms to one builder at once.
+ */
+class OperatorBuilder {
+  public:
+    explicit OperatorBuilder(size_t itemsize, size_t flush_threshold = BUILDER_FLUSH_THRESHOLD);
+
+    size_t itemsize() const { return index_.itemsize(); }
+    size_t num_unique() const;
+    size_t num_pending() const;
+
+    void add(VoidView rows, std::span<const std::complex<double>> weights);
+    void flush();
+    WeightedTerms finalize(double tolerance);
+
+  private:
+    void merge_pending();
+
+    // Guards every member below
+    mutable std::mutex mutex_;
+    size_t flush_threshold_;
+    PauliIndex index_;
+    // Summed weight of each void of index_, by number
+    std::vector<std::complex<double>> weights_;
+    std::vector<uint8_t> pending_keys_;
+    std::vector<std::complex<double>> pending_weights_;
+};
+
+} // namespace z2r
@@ -0,0 +1,116 @@
+/**
+ * @file z2r_clifford.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free Clifford conjugation of Pauli strings, shared by clifford.cpp and the Z2
+ * symmetries of z2r_taper.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+#include <cstdint> // uint8_t
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "z2r_core.h"
+
+// Number of blocks of 64 Pauli strings before going multi-threaded
+#define CLIFFORD_THRESHOLD_PARALLEL 64
+
+/**
+ * @brief Codes of the gates of a compiled Clifford circuit. A compiled circuit is an int64 array of
+ * shape (num_gates, 3), where each row is (code, qubit_0, qubit_1). qubit_1 is ignored by
+ * single-qubit gates.
+ * @attention Must be kept in sync with CLIFFORD_GATES in clifford.py
+ */
+enum CliffordGate : int64_t {
+    GATE_H = 0,
+    GATE_S = 1,
+    GATE_SDG = 2,
+    GATE_X = 3,
+    GATE_Y = 4,
+    GATE_Z = 5,
+    GATE_CX = 6,
+    GATE_CZ = 7,
+    GATE_SWAP = 8,
+};
+
+/**
+ * @brief Applies one Clifford gate to 64 Pauli strings at once, in the "column" layout: z[q] and
+ * x[q] hold the bits of qubit q for 64 Pauli strings, and each bit of `sign` is set when the
+ * corresponding Pauli string picked up a -1. The update rules are the ones of Aaronson and
+ * Gottesman (2004), for the Hermitian Paulis encoded by (z, x) = (0, 1) X, (1, 1) Y, (1, 0) Z.
+ *
+ * @param code The gate, from CliffordGate
+ * @param a Column of the first qubit
+ * @param b Column of the second qubit (ignored for single-qubit gates)
+ * @param z Z columns
+ * @param x X columns
+ * @param sign Sign bits of the 64 Pauli strings
+ */
+inline void apply_clifford_gate(int64_t code, size_t a, size_t b, uint64_t *z, uint64_t *x,
+                                uint64_t &sign) {
+    switch (code) {
+    case GATE_H:
+        sign ^= z[a] & x[a];
+        std::swap(z[a], x[a]);
+        break;
+    case GATE_S:
+        sign ^= z[a] & x[a];
+        z[a] ^= x[a];
+        break;
+    case GATE_SDG:
+        sign ^= ~z[a] & x[a];
+        z[a] ^= x[a];
+        break;
+    case GATE_X:
+        sign ^= z[a];
+        break;
+    case GATE_Y:
+        sign ^= z[a] ^ x[a];
+        break;
+    case GATE_Z:
+        sign ^= x[a];
+        break;
+    case GATE_CX:
+        sign ^= x[a] & z[b] & ~(x[b] ^ z[a]);
+        x[b] ^= x[a];
+        z[a] ^= z[b];
+        break;
+    case GATE_CZ:
+        sign ^= x[a] & x[b] & (z[a] ^ z[b]);
+        z[a] ^= x[b];
+        z[b] ^= x[a];
+        break;
+    case GATE_SWAP:
+        std::swap(z[a], z[b]);
+        std::swap(x[a], x[b]);
+        break;
+    }
+}
+
+/**
+ * @brief A Clifford circuit ready to be applied by conjugate_rows(): the gate codes, and the
+ * columns of their qubits in the block buffers, which only hold the touched words of the voids.
+ */
+struct CompiledCircuit {
+    std::vector<int64_t> codes;
+    std::vector<size_t> cols_a;
+    std::vector<size_t> cols_b;
+    std::vector<size_t> touched_words;
+};
+
+namespace z2r {
+
+CompiledCircuit compile_circuit(std::span<const int64_t> gates, size_t itemsize);
+void conjugate_rows(const CompiledCircuit &circuit, VoidView z, VoidView x,
+                    std::span<const std::complex<double>> phases, MutableVoidView new_z,
+                    MutableVoidView new_x, std::span<std::complex<double>> new_phases);
+
+} // namespace z2r
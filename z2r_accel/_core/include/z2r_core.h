@@ -0,0 +1,642 @@
+/**
+ * @file z2r_core.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free core of the Z2R kernels.
+ *
+ * Everything in this header (and in z2r_core.cpp) works on raw memory: byte spans for
+ * element-wise operations, and VoidView / MutableVoidView (pointer, rows, itemsize, row stride)
+ * for row-wise ones. Nothing here includes pybind11, allocates NumPy arrays or touches the GIL, so
+ * the z2r_core static library can be linked by plain C++ programs. The Python modules (_bitops,
+ * _cz2m) are thin adapters that validate the arrays, allocate the outputs, release the GIL and
+ * call these kernels.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <complex>
+#include <cstdint> // uint8_t
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "z2r_stats.h"
+#include "z2r_threads.h"
+
+#ifdef USE_OPENMP
+    #include <omp.h>
+#else
+    #warning "OpenMP is not enabled"
+#endif
+
+#ifdef __BMI2__
+    #include <immintrin.h>
+#endif
+
+// These thresholds are completely arbitrary and can be tuned for performance depending on the
+// hardware.
+// Number of 64-bit words before element-wise bitwise operations go multi-threaded
+#define BOPS_THRESHOLD_PARALLEL 1'000'000
+// Number of Pauli strings (or pairs of Pauli strings) before the cz2m kernels go multi-threaded
+#define FUNC_THRESHOLD_PARALLEL 100000
+// Number of 64-bit words (or Pauli strings) per chunk of work of the batched (*_many) kernels
+#define BATCH_CHUNK_SIZE 4096
+// Number of bytes before the outputs are first touched in parallel, in NUMA mode
+#define NUMA_FIRST_TOUCH_BYTES (size_t{1} << 20)
+// Rows of the second operand per task of the commutation reductions, a multiple of 8 so that the
+// bytes of a packed mask are never shared between tasks
+#define COMMUTE_BLOCK_ROWS 2048
+// Rows of the first operand per task of the commutation reductions
+#define COMMUTE_TILE_ROWS 256
+
+/**
+ * @brief Read-only view of `rows` voids of `itemsize` bytes each. Row i starts at
+ * data + i * stride; a C-contiguous NumPy array of voids has stride == itemsize.
+ */
+struct VoidView {
+    const uint8_t *data = nullptr;
+    size_t rows = 0;
+    size_t itemsize = 0;
+    size_t stride = 0;
+
+    VoidView() = default;
+    VoidView(const uint8_t *data, size_t rows, size_t itemsize, size_t stride = 0)
+        : data(data), rows(rows), itemsize(itemsize), stride(stride ? stride : itemsize) {}
+    VoidView(std::span<const uint8_t> bytes, size_t itemsize)
+        : VoidView(bytes.data(), bytes.size() / itemsize, itemsize) {}
+    VoidView(std::span<const uint64_t> words, size_t itemsize)
+        : VoidView(reinterpret_cast<const uint8_t *>(words.data()), words.size_bytes() / itemsize,
+                   itemsize) {}
+
+    const uint8_t *row(size_t i) const { return data + i * stride; }
+    bool contiguous() const { return stride == itemsize; }
+};
+
+/**
+ * @brief Writable counterpart of VoidView.
+ */
+struct MutableVoidView {
+    uint8_t *data = nullptr;
+    size_t rows = 0;
+    size_t itemsize = 0;
+    size_t stride = 0;
+
+    MutableVoidView() = default;
+    MutableVoidView(uint8_t *data, size_t rows, size_t itemsize, size_t stride = 0)
+        : data(data), rows(rows), itemsize(itemsize), stride(stride ? stride : itemsize) {}
+    MutableVoidView(std::span<uint8_t> bytes, size_t itemsize)
+        : MutableVoidView(bytes.data(), bytes.size() / itemsize, itemsize) {}
+    MutableVoidView(std::span<uint64_t> words, size_t itemsize)
+        : MutableVoidView(reinterpret_cast<uint8_t *>(words.data()),
+                          words.size_bytes() / itemsize, itemsize) {}
+
+    uint8_t *row(size_t i) const { return data + i * stride; }
+    bool contiguous() const { return stride == itemsize; }
+    operator VoidView() const { return VoidView(data, rows, itemsize, stride); }
+};
+
+/**
+ * @brief Loads the `len` (< 8) trailing bytes of a void into the low bytes of a word.
+ *
+ * @param ptr The first byte
+ * @param len Number of bytes
+ * @return uint64_t
+ */
+inline uint64_t load_tail(const uint8_t *ptr, size_t len) {
+    uint64_t word = 0;
+    std::memcpy(&word, ptr, len);
+    return word;
+}
+
+/**
+ * @brief Parallel bit extract. Gathers the bits of `src` selected by `mask` into the low bits of
+ * the result, keeping their order. Uses the BMI2 instruction when the compiler targets it (which
+ * is the case with -march=native on any recent x86 CPU), and a portable loop otherwise.
+ *
+ * @param src The word to extract from
+ * @param mask The bits to extract
+ * @return uint64_t The extracted bits, packed at the bottom of the word
+ */
+inline uint64_t pext64(uint64_t src, uint64_t mask) {
+#ifdef __BMI2__
+    return _pext_u64(src, mask);
+#else
+    uint64_t res = 0;
+    for (uint64_t bb = 1; mask != 0; bb <<= 1) {
+        if (src & mask & (~mask + 1)) {
+            res |= bb;
+        }
+        mask &= mask - 1;
+    }
+    return res;
+#endif
+}
+
+/**
+ * @brief Parallel bit deposit. Scatters the low bits of `src` to the positions selected by `mask`.
+ * This is the inverse operation of pext64().
+ *
+ * @param src The bits to deposit, packed at the bottom of the word
+ * @param mask The positions where the bits are deposited
+ * @return uint64_t A word with the bits of `src` at the positions of `mask`, zeroes elsewhere
+ */
+inline uint64_t pdep64(uint64_t src, uint64_t mask) {
+#ifdef __BMI2__
+    return _pdep_u64(src, mask);
+#else
+    uint64_t res = 0;
+    for (uint64_t bb = 1; mask != 0; bb <<= 1) {
+        if (src & bb) {
+            res |= mask & (~mask + 1);
+        }
+        mask &= mask - 1;
+    }
+    return res;
+#endif
+}
+
+/**
+ * @brief In-place transpose of a 64x64 bit matrix, stored as 64 words (one per row). After the
+ * call, bit i of word j is what bit j of word i was. Recursive block swap (Hacker's Delight 7-3),
+ * in 6 passes of 32 word swaps instead of 4096 single bit moves.
+ *
+ * @param a The 64 words of the matrix
+ */
+inline void transpose64(uint64_t *a) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (size_t j = 32; j != 0; j >>= 1, m ^= m << j) {
+        for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+/**
+ * @brief SplitMix64 finalizer. Maps any 64-bit integer to a well mixed 64-bit integer.
+ *
+ * @param x
+ * @return uint64_t
+ */
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Counter-based random number generator. Returns the `counter`-th output of the SplitMix64
+ * stream starting at state `key`. Since no state is carried between calls, any thread can draw
+ * any number of the stream, and the result does not depend on the number of threads.
+ *
+ * @param key The stream key, usually splitmix64(seed)
+ * @param counter The position in the stream
+ * @return uint64_t
+ */
+inline uint64_t counter_rng64(uint64_t key, uint64_t counter) {
+    return splitmix64(key + counter * 0x9E3779B97F4A7C15ULL);
+}
+
+/**
+ * @brief Maps a random 64-bit word to [0, bound) with a multiply-shift (Lemire's method, without
+ * the rejection step). The bias is below bound / 2^64, which is negligible for qubit counts.
+ *
+ * @param r A random word
+ * @param bound The exclusive upper bound
+ * @return uint64_t
+ */
+inline uint64_t bounded_rng64(uint64_t r, uint64_t bound) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(r) * bound) >> 64);
+}
+
+/**
+ * @brief 64-bit hash of the bytes of one void, built by folding its words through splitmix64().
+ * Unlike std::hash, the value does not depend on the standard library, so it can be used to assign
+ * Pauli strings to partitions that must be reproducible across runs (e.g. on-disk buckets).
+ *
+ * @param row The void
+ * @param itemsize Number of bytes of the void
+ * @return uint64_t
+ */
+inline uint64_t hash_void(const uint8_t *row, size_t itemsize) {
+    uint64_t h = itemsize;
+    size_t k = 0;
+    for (; k + 8 <= itemsize; k += 8) {
+        uint64_t word;
+        std::memcpy(&word, row + k, 8);
+        h = splitmix64(h ^ word);
+    }
+    if (k < itemsize) {
+        uint64_t word = 0;
+        std::memcpy(&word, row + k, itemsize - k);
+        h = splitmix64(h ^ word);
+    }
+    return h;
+}
+
+/**
+ * @brief Splits one zx void (Z bits [0, n) followed by X bits [n, 2n), as in `zx_voids`) into
+ * separate Z and X words.
+ *
+ * @param row The zx void
+ * @param itemsize Number of bytes of the zx void
+ * @param num_qubits Number of qubits n
+ * @param buffer Scratch space of at least itemsize / 8 + 2 words
+ * @param z Output Z words, (n + 63) / 64 of them
+ * @param x Output X words, (n + 63) / 64 of them
+ */
+inline void split_zx_row(const uint8_t *row, size_t itemsize, size_t num_qubits, uint64_t *buffer,
+                         uint64_t *z, uint64_t *x) {
+    size_t words = (num_qubits + 63) / 64;
+    size_t buffer_words = itemsize / 8 + 2;
+    std::fill(buffer, buffer + buffer_words, 0);
+    std::memcpy(buffer, row, itemsize);
+    uint64_t last_mask = (num_qubits % 64) ? (uint64_t{1} << (num_qubits % 64)) - 1 : ~uint64_t{0};
+
+    size_t shift = num_qubits % 64;
+    const uint64_t *x_start = buffer + num_qubits / 64;
+    for (size_t k = 0; k < words; ++k) {
+        z[k] = buffer[k];
+        x[k] = shift ? (x_start[k] >> shift) | (x_start[k + 1] << (64 - shift)) : x_start[k];
+    }
+    z[words - 1] &= last_mask;
+    x[words - 1] &= last_mask;
+}
+
+/**
+ * @brief Stitches separate Z and X words back into one zx void. Inverse of split_zx_row().
+ *
+ * @param z Z words, (n + 63) / 64 of them, with no bit set past n
+ * @param x X words, (n + 63) / 64 of them, with no bit set past n
+ * @param itemsize Number of bytes of the zx void
+ * @param num_qubits Number of qubits n
+ * @param buffer Scratch space of at least itemsize / 8 + 2 words
+ * @param row The output zx void
+ */
+inline void stitch_zx_row(const uint64_t *z, const uint64_t *x, size_t itemsize,
+                          size_t num_qubits, uint64_t *buffer, uint8_t *row) {
+    size_t words = (num_qubits + 63) / 64;
+    size_t buffer_words = itemsize / 8 + 2;
+    std::fill(buffer, buffer + buffer_words, 0);
+
+    size_t shift = num_qubits % 64;
+    uint64_t *x_start = buffer + num_qubits / 64;
+    for (size_t k = 0; k < words; ++k) {
+        buffer[k] |= z[k];
+        x_start[k] |= x[k] << shift;
+        if (shift) {
+            x_start[k + 1] |= x[k] >> (64 - shift);
+        }
+    }
+    std::memcpy(row, buffer, itemsize);
+}
+
+/**
+ * @brief Multiplies in place a Pauli string by another one, P <- P Q, word by word. The product of
+ * two Hermitian Pauli strings is i^s times a Hermitian Pauli string; the mod 4 sum of the i and -i
+ * picked up by each qubit is accumulated in two bit-sliced counters (one bit per qubit position),
+ * so the phase costs two popcounts instead of a loop over qubits.
+ *
+ * @param z1 Z words of P, overwritten with the product
+ * @param x1 X words of P, overwritten with the product
+ * @param z2 Z words of Q
+ * @param x2 X words of Q
+ * @param words Number of words of each Pauli string
+ * @return int The exponent s (mod 4) of the phase i^s
+ */
+inline int pauli_mul_log_i(uint64_t *z1, uint64_t *x1, const uint64_t *z2, const uint64_t *x2,
+                           size_t words) {
+    uint64_t cnt1 = 0;
+    uint64_t cnt2 = 0;
+    for (size_t k = 0; k < words; ++k) {
+        uint64_t old_z = z1[k];
+        uint64_t old_x = x1[k];
+        z1[k] ^= z2[k];
+        x1[k] ^= x2[k];
+        uint64_t x1z2 = old_x & z2[k];
+        uint64_t anti = (x2[k] & old_z) ^ x1z2;
+        cnt2 ^= (cnt1 ^ x1[k] ^ z1[k] ^ x1z2) & anti;
+        cnt1 ^= anti;
+    }
+    return (std::popcount(cnt1) + 2 * std::popcount(cnt2)) & 3;
+}
+
+/**
+ * @brief Accumulates complex weights per Pauli string. Pauli strings are raw byte keys of a fixed
+ * size, copied once into blocks that never move, so the table can key on std::string_view just
+ * like unordered_unique() does.
+ */
+class PauliAccumulator {
+  public:
+    explicit PauliAccumulator(size_t key_bytes) : key_bytes_(key_bytes) {}
+
+    /**
+     * @brief Adds a weight to a Pauli string, inserting it if it is new.
+     *
+     * @param key The key_bytes bytes of the Pauli string
+     * @param weight The weight to add
+     */
+    void add(const uint8_t *key, std::complex<double> weight) {
+        std::string_view view(reinterpret_cast<const char *>(key), key_bytes_);
+        auto it = table_.find(view);
+        if (it != table_.end()) {
+            weights_[it->second] += weight;
+            return;
+        }
+        const char *stored = store(key);
+        table_.try_emplace(std::string_view(stored, key_bytes_), keys_.size());
+        keys_.push_back(stored);
+        weights_.push_back(weight);
+    }
+
+    /**
+     * @brief Adds all the Pauli strings of another accumulator into this one.
+     *
+     * @param other An accumulator with the same key size
+     */
+    void merge(const PauliAccumulator &other) {
+        for (size_t i = 0; i < other.size(); ++i) {
+            add(other.key(i), other.weight(i));
+        }
+    }
+
+    void reserve(size_t n) { table_.reserve(n); }
+
+    size_t size() const { return keys_.size(); }
+    const uint8_t *key(size_t i) const { return reinterpret_cast<const uint8_t *>(keys_[i]); }
+    std::complex<double> weight(size_t i) const { return weights_[i]; }
+
+  private:
+    const char *store(const uint8_t *key) {
+        if (blocks_.empty() || block_used_ + key_bytes_ > block_size_) {
+            block_size_ = std::max<size_t>(key_bytes_ * 4096, 1 << 16);
+            blocks_.push_back(std::make_unique<char[]>(block_size_));
+            block_used_ = 0;
+        }
+        char *dst = blocks_.back().get() + block_used_;
+        std::memcpy(dst, key, key_bytes_);
+        block_used_ += key_bytes_;
+        return dst;
+    }
+
+    size_t key_bytes_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_ = 0;
+    size_t block_used_ = 0;
+    std::vector<const char *> keys_;
+    std::vector<std::complex<double>> weights_;
+    std::unordered_map<std::string_view, size_t> table_;
+};
+
+
+namespace z2r {
+
+/**
+ * @brief Element-wise bitwise operation on two byte buffers of the same size, 64 bits at a time.
+ * This is the basis of all two-array bitwise operations.
+ *
+ * @tparam Op The type of the bitwise operator (std::bit_and<uint64_t>, std::bit_xor<uint64_t>...)
+ * @param a The first buffer
+ * @param b The second buffer
+ * @param out The output buffer, which may alias a or b
+ * @param op The bitwise operator to apply
+ */
+template <typename Op>
+void bitwise_binary(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out,
+                    Op op) {
+    z2r::threads::apply();
+    if (a.size() != b.size() || a.size() != out.size()) {
+        throw std::runtime_error("Input arrays must have the same size.");
+    }
+    size_t total_bytes = a.size();
+
+    // TODO: With C++20, we could use std::assume_aligned, which could potentially lead to better
+    // auto-vectorization by the compiler? ? Since NumPy cant guarantee alignement and we cant
+    // afford to copy the data just to get better SIMD, I dont know if assume_aligned is worth
+    // anything.
+    const uint64_t *ptr1_64 = std::bit_cast<const uint64_t *>(a.data());
+    const uint64_t *ptr2_64 = std::bit_cast<const uint64_t *>(b.data());
+    uint64_t *ptr_out_64 = std::bit_cast<uint64_t *>(out.data());
+
+    size_t num_u64_chunks = total_bytes / 8;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < num_u64_chunks; ++i) {
+            ptr_out_64[i] = op(ptr1_64[i], ptr2_64[i]);
+        }
+    }
+
+    // Handle any bytes that don't fit into a 64-bit chunk (the tail)
+    for (size_t i = num_u64_chunks * 8; i < total_bytes; ++i) {
+        out[i] = static_cast<uint8_t>(op(a[i], b[i]));
+    }
+}
+
+/**
+ * @brief One pair of buffers, and their output, of a batched element-wise operation.
+ */
+struct BinaryTask {
+    std::span<const uint8_t> a;
+    std::span<const uint8_t> b;
+    std::span<uint8_t> out;
+};
+
+/**
+ * @brief Elements [begin, end) of the task-th array of a batch.
+ */
+struct BatchRange {
+    size_t task;
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * @brief Splits a batch of arrays into chunks of at most `chunk` elements. A parallel loop over the
+ * chunks spreads a batch of many small arrays as well as a batch holding a few large ones.
+ *
+ * @param sizes Number of elements of each array
+ * @param chunk Maximum number of elements per chunk
+ * @return std::vector<BatchRange> The chunks, in order. Empty arrays have none.
+ */
+std::vector<BatchRange> batch_ranges(std::span<const size_t> sizes, size_t chunk);
+
+/**
+ * @brief Batched bitwise_binary(): the same operation on every pair of buffers of the batch, in a
+ * single parallel loop over all of their words.
+ *
+ * @tparam Op The type of the bitwise operator (std::bit_and<uint64_t>, std::bit_xor<uint64_t>...)
+ * @param tasks The pairs of buffers, each output of the same size as its inputs
+ * @param op The bitwise operator to apply
+ */
+template <typename Op> void bitwise_binary_many(std::span<const BinaryTask> tasks, Op op) {
+    z2r::threads::apply();
+    std::vector<size_t> words(tasks.size());
+    size_t total_words = 0;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        if (tasks[t].a.size() != tasks[t].b.size() || tasks[t].a.size() != tasks[t].out.size()) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        words[t] = tasks[t].a.size() / 8;
+        total_words += words[t];
+    }
+    std::vector<BatchRange> ranges = batch_ranges(words, BATCH_CHUNK_SIZE);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (total_words >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            const BinaryTask &task = tasks[ranges[r].task];
+            const uint64_t *ptr1_64 = std::bit_cast<const uint64_t *>(task.a.data());
+            const uint64_t *ptr2_64 = std::bit_cast<const uint64_t *>(task.b.data());
+            uint64_t *ptr_out_64 = std::bit_cast<uint64_t *>(task.out.data());
+            for (size_t i = ranges[r].begin; i < ranges[r].end; ++i) {
+                ptr_out_64[i] = op(ptr1_64[i], ptr2_64[i]);
+            }
+        }
+    }
+
+    for (const BinaryTask &task : tasks) {
+        for (size_t i = task.a.size() / 8 * 8; i < task.a.size(); ++i) {
+            task.out[i] = static_cast<uint8_t>(op(task.a[i], task.b[i]));
+        }
+    }
+}
+
+/**
+ * @brief One composition of a batch: the inputs and outputs of a compose() call.
+ */
+struct ComposeTask {
+    VoidView z1;
+    VoidView x1;
+    VoidView z2;
+    VoidView x2;
+    MutableVoidView z_out;
+    MutableVoidView x_out;
+    std::span<std::complex<double>> phases;
+};
+
+/**
+ * @brief Predicate of select_terms(). Every check is optional; a term is kept when it passes all
+ * of them.
+ */
+struct TermFilter {
+    // Keep the terms with |weight| > tolerance. Negative: no check.
+    double tolerance = -1.0;
+    // Keep the terms acting on at most max_weight qubits. Negative: no check.
+    int64_t max_weight = -1;
+    // Keep the terms acting only on the qubits set in this mask of (num_qubits + 63) / 64 words.
+    // Empty: no check.
+    std::span<const uint64_t> support;
+    // Number of qubits of the stitched zx voids. Must be positive for max_weight and support.
+    size_t num_qubits = 0;
+};
+
+/**
+ * @brief Result of unique() and unordered_unique().
+ */
+struct UniqueVoids {
+    // Position of the first occurrence of each unique void
+    std::vector<int64_t> index;
+    // Number of the unique void of each void
+    std::vector<int64_t> inverse;
+    // Number of occurrences of each unique void, only filled by unique()
+    std::vector<int64_t> counts;
+};
+
+void bitwise_and(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out);
+void bitwise_xor(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out);
+void bitwise_or(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out);
+void bitwise_not(std::span<const uint8_t> in, std::span<uint8_t> out);
+void bitwise_xor_many(std::span<const BinaryTask> tasks);
+
+void bitwise_count(VoidView voids, std::span<int64_t> out);
+void bitwise_dot(VoidView a, VoidView b, std::span<int64_t> out);
+
+void compose(VoidView z1, VoidView x1, VoidView z2, VoidView x2, MutableVoidView z_out,
+             MutableVoidView x_out, std::span<std::complex<double>> phases);
+void compose_many(std::span<const ComposeTask> tasks);
+void commute_with(VoidView z1, VoidView x1, VoidView z2, VoidView x2, std::span<bool> out);
+
+void transpose(VoidView voids, size_t num_bits, MutableVoidView out);
+void matmul(VoidView a, VoidView b, size_t a_cols, size_t b_cols, MutableVoidView out);
+
+PauliAccumulator accumulate_products(VoidView zx_a, std::span<const std::complex<double>> w_a,
+                                     VoidView zx_b, std::span<const std::complex<double>> w_b,
+                                     size_t num_qubits, bool anticommuting_only);
+std::vector<PauliAccumulator> simplify(VoidView zx_voids,
+                                       std::span<const std::complex<double>> weights);
+void hash_partition(VoidView zx_voids, uint64_t num_partitions, std::span<int64_t> out);
+
+void first_touch(std::span<uint8_t> bytes);
+
+void split_zx(VoidView zx, size_t num_qubits, MutableVoidView z_out, MutableVoidView x_out);
+void stitch_zx(VoidView z, VoidView x, size_t num_qubits, MutableVoidView zx_out);
+void zx_compose(VoidView zx1, VoidView zx2, size_t num_qubits, MutableVoidView zx_out,
+                std::span<std::complex<double>> phases);
+void zx_commute_with(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                     std::span<bool> out);
+void zx_weight(VoidView zx, size_t num_qubits, std::span<int64_t> out);
+
+/**
+ * @brief Reduction of zx_commute_reduce(), for each row of the first operand over all the rows of
+ * the second.
+ */
+enum class CommuteReduction : int {
+    FirstAnticommuting = 1, // Index of the first row that does not commute, or -1
+    FirstCommuting = 2,     // Index of the first row that commutes, or -1
+    CountAnticommuting = 3  // Number of rows that do not commute
+};
+
+void zx_commute_reduce(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                       CommuteReduction reduction, std::span<int64_t> out);
+void zx_commute_mask(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                     MutableVoidView out);
+
+std::vector<int64_t> select_terms(VoidView zx, std::span<const std::complex<double>> weights,
+                                  const TermFilter &filter);
+void gather_terms(VoidView zx, std::span<const std::complex<double>> weights,
+                  std::span<const int64_t> indices, MutableVoidView zx_out,
+                  std::span<std::complex<double>> w_out);
+std::vector<int64_t> top_k(std::span<const std::complex<double>> weights, size_t k);
+
+void random_zx_voids(size_t num_qubits, int64_t weight, uint64_t seed, MutableVoidView z_out,
+                     MutableVoidView x_out);
+UniqueVoids unique(VoidView voids);
+UniqueVoids unordered_unique(VoidView voids);
+void row_echelon(VoidView voids, size_t num_cols, MutableVoidView out);
+void to_matrix(VoidView z, VoidView x, size_t num_qubits, std::span<std::complex<double>> out);
+void gauss_jordan_inverse(VoidView matrix, size_t num_bits, MutableVoidView out);
+void batched_gauss_jordan_inverse(VoidView matrices, size_t num_bits, MutableVoidView out,
+                                  std::span<bool> singular);
+void get_qubit_slices(VoidView voids, std::span<const int64_t> indices, MutableVoidView out);
+void permute_qubits(VoidView voids, std::span<const int64_t> permutation, MutableVoidView out);
+void set_qubit_slices(VoidView voids, VoidView sub_voids, std::span<const int64_t> indices,
+                      MutableVoidView out);
+
+} // namespace z2r
@@ -0,0 +1,63 @@
+/**
+ * @file z2r_fermion.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free fermion-to-qubit mappings (Jordan-Wigner, parity and Bravyi-Kitaev) of sums
+ * of products of ladder operators.
+ *
+ * Each mapping sends the Majorana operators c_j = a_j + a_j^dagger and d_j = i (a_j^dagger - a_j)
+ * of mode j to Pauli strings. With U(j) the qubits that store the occupation of mode j (update
+ * set), P(j) the qubits whose parity is the parity of the modes below j, and O(j) the qubits whose
+ * parity is the occupation of mode j,
+ *
+ *     c_j = X_{U(j)} Z_{P(j)},    d_j = i c_j Z_{O(j)}
+ *
+ * (Seeley, Richard and Love, arXiv:1208.5986). Since a_j^dagger = (c_j - i d_j) / 2 and
+ * a_j = (c_j + i d_j) / 2, a product of L ladder operators is a sum of 2^L products of Majorana
+ * strings, which are multiplied word by word and summed per Pauli string.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+#include <span>
+#include <vector>
+
+#include "z2r_core.h"
+
+// Maximum number of ladder operators in a term (the term expands into 2^L Pauli strings)
+#define MAX_LADDER_OPERATORS 16
+
+/**
+ * @brief Codes of the fermion-to-qubit mappings.
+ * @attention Must be kept in sync with FERMION_MAPPINGS in fermion.py
+ */
+enum FermionMapping : int64_t {
+    MAPPING_JORDAN_WIGNER = 0,
+    MAPPING_PARITY = 1,
+    MAPPING_BRAVYI_KITAEV = 2,
+};
+
+/**
+ * @brief Terms of a sum of products of ladder operators, sum_t v_t op_{t,0} op_{t,1} ... Term t
+ * is modes[t * length, (t + 1) * length) and creation[...] over the same range. A mode of -1 is
+ * an identity, for terms shorter than `length` (or constant ones).
+ */
+struct LadderTerms {
+    std::span<const int64_t> modes;
+    std::span<const uint8_t> creation;
+    std::span<const std::complex<double>> values;
+    size_t length = 0;
+
+    size_t num_terms() const { return values.size(); }
+};
+
+namespace z2r {
+
+PauliAccumulator map_ladder_terms(const LadderTerms &terms, size_t num_modes, int64_t mapping);
+
+} // namespace z2r
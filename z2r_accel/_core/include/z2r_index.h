@@ -0,0 +1,76 @@
+/**
+ * @file z2r_index.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free persistent hash index over a set of Pauli strings, for repeated lookups and
+ * set operations.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <shared_mutex>
+#include <span>
+#include <vector>
+
+#include "z2r_core.h"
+
+namespace z2r {
+
+/**
+ * @brief Positions of the queries found in an index, and their numbers in it.
+ */
+struct IndexMatches {
+    std::vector<int64_t> positions;
+    std::vector<int64_t> numbers;
+};
+
+/**
+ * @brief A set of unique voids (in any layout, only byte equality matters), numbered 0, 1, ... in
+ * insertion order. Unlike unordered_unique(), the hash table is kept between calls, so a batch of
+ * queries costs O(queries) instead of a rebuild of the whole set.
+ *
+ * The keys are stored back to back in one buffer, with their hash_void(). The table is open
+ * addressing with linear probing over a power of two number of slots, holding key numbers rather
+ * than pointers, so that the key buffer can grow. Queries only read the table and run in parallel;
+ * insertions are serial, once the hashes of the batch are computed in parallel.
+ *
+ * Several threads may use one index at once: queries share a lock, and insertions take it
+ * exclusively. Keys are never removed, so a number, once given, stays valid.
+ */
+class PauliIndex {
+  public:
+    static constexpr int64_t EMPTY = -1;
+
+    explicit PauliIndex(size_t itemsize) : itemsize_(itemsize) {}
+    PauliIndex(const PauliIndex &other);
+
+    size_t size() const;
+    size_t itemsize() const { return itemsize_; }
+    // Only for the owner of the index, while no insertion can run
+    const uint8_t *key(size_t i) const { return keys_.data() + i * itemsize_; }
+
+    std::vector<uint8_t> keys() const;
+    size_t find_all(VoidView queries, std::span<int64_t> out) const;
+    void insert_rows(VoidView rows, std::span<int64_t> out);
+    IndexMatches intersect(VoidView queries) const;
+    std::vector<int64_t> difference(VoidView queries) const;
+
+  private:
+    int64_t find(const uint8_t *row, uint64_t hash) const;
+    int64_t insert_row(const uint8_t *row, uint64_t hash);
+    void reserve(size_t n);
+    void check_rows(VoidView rows, size_t out_size) const;
+
+    mutable std::shared_mutex mutex_;
+    size_t itemsize_;
+    std::vector<uint8_t> keys_;
+    std::vector<uint64_t> hashes_;
+    // Number of the key in each slot, or EMPTY. The size is a power of two, at least twice size().
+    std::vector<int64_t> slots_;
+};
+
+} // namespace z2r
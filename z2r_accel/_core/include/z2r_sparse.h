@@ -0,0 +1,62 @@
+/**
+ * @file z2r_sparse.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free support-list encoding of low-weight Pauli strings on many qubits.
+ *
+ * A batch of N Pauli strings is stored as in a CSR matrix: `offsets` (N + 1 int64) and `entries`
+ * (uint32), string i being entries[offsets[i], offsets[i + 1]). Each entry is one qubit which is
+ * not the identity, encoded as (qubit << 2) | code, with code = x | (z << 1): 1 for X, 2 for Z and
+ * 3 for Y. The entries of a string are sorted by qubit, without repeats, which makes the encoding
+ * canonical (equal strings have equal entries) and lets the kernels below work by merging sorted
+ * lists. A string of weight w takes 4w bytes, against n / 4 bytes for its Z and X voids.
+ *
+ * The kernels producing support lists run in two passes, so that the caller can allocate the
+ * entries in between: the first one (*_offsets()) counts the entries of each string and sums them
+ * into the offsets, and the second one writes every string at its offset.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+#include <span>
+
+#include "z2r_core.h"
+
+// Support lists address at most 2^30 qubits
+#define SUPPORT_MAX_QUBITS (size_t{1} << 30)
+
+/**
+ * @brief Read-only view of a batch of Pauli strings in the support-list encoding. Made by
+ * z2r::support_lists(), which checks the offsets.
+ */
+struct SupportLists {
+    std::span<const int64_t> offsets;
+    std::span<const uint32_t> entries;
+
+    size_t rows() const { return offsets.size() - 1; }
+    const uint32_t *begin(size_t i) const { return entries.data() + offsets[i]; }
+    size_t weight(size_t i) const { return static_cast<size_t>(offsets[i + 1] - offsets[i]); }
+};
+
+namespace z2r {
+
+SupportLists support_lists(std::span<const int64_t> offsets, std::span<const uint32_t> entries);
+
+size_t support_list_offsets(VoidView z, VoidView x, std::span<int64_t> offsets);
+void to_support_lists(VoidView z, VoidView x, std::span<const int64_t> offsets,
+                      std::span<uint32_t> entries);
+void from_support_lists(SupportLists s, size_t num_qubits, MutableVoidView z_out,
+                        MutableVoidView x_out);
+size_t sparse_compose_offsets(SupportLists a, SupportLists b, std::span<int64_t> offsets,
+                              std::span<std::complex<double>> phases);
+void sparse_compose(SupportLists a, SupportLists b, std::span<const int64_t> offsets,
+                    std::span<uint32_t> entries);
+void sparse_commute_with(SupportLists a, SupportLists b, bool qubit_wise, std::span<bool> out);
+UniqueVoids sparse_unique(SupportLists s);
+
+} // namespace z2r
@@ -0,0 +1,143 @@
+/**
+ * @file z2r_stats.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Opt-in per-kernel performance counters.
+ *
+ * Each instrumented kernel opens a Z2R_KERNEL_STATS(name, elements, bytes) scope once its
+ * arguments are validated. While the counters are enabled, the scope adds to the kernel's counter:
+ * one call, the elements (rows, pairs of rows for the products of weighted sums, or 64-bit words
+ * for the element-wise bitwise operations) and bytes it processes, its wall time, and the size of
+ * the largest team that ran it.
+ *
+ * The team is measured from inside the parallel regions: each of them starts with
+ * Z2R_KERNEL_TEAM(), whose thread 0 reports omp_get_num_threads() to the innermost open scope of
+ * its thread. A call counts as parallel when one of its regions ran on more than one thread, so a
+ * region below its threshold, a team that the runtime makes smaller (OMP_DYNAMIC,
+ * OMP_THREAD_LIMIT) or a call from a team that can no longer fork counts as the threads it got.
+ *
+ * The counters are only compiled in with -DZ2R_PERF_COUNTERS=ON (CMake), which defines
+ * Z2R_PERF_COUNTERS. Without it, Z2R_KERNEL_STATS expands to nothing and its arguments are not
+ * evaluated. With it, they are still off until set_enabled(true) is called, or the Z2R_STATS
+ * environment variable is set to a non-zero value when the library is loaded. A disabled scope
+ * costs one relaxed atomic load, and a disabled Z2R_KERNEL_TEAM() one thread-local load.
+ *
+ * @note z2r_core is a shared library, so the Python modules all count into the same registry.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace z2r::stats {
+
+/**
+ * @brief Running totals of one kernel. Updated concurrently with relaxed atomics.
+ */
+struct KernelCounter {
+    std::atomic<uint64_t> calls{0};
+    // Calls that ran a parallel region on more than one thread
+    std::atomic<uint64_t> parallel_calls{0};
+    std::atomic<uint64_t> elements{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> nanoseconds{0};
+    // Largest team that ran a parallel region of a call
+    std::atomic<int> max_threads{0};
+};
+
+/**
+ * @brief Copy of a KernelCounter, as returned by snapshot().
+ */
+struct KernelStats {
+    std::string name;
+    uint64_t calls;
+    uint64_t parallel_calls;
+    uint64_t elements;
+    uint64_t bytes;
+    double seconds;
+    int max_threads;
+};
+
+/**
+ * @brief Whether the counters were compiled in (Z2R_PERF_COUNTERS).
+ */
+constexpr bool compiled() {
+#ifdef Z2R_PERF_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool enabled();
+void set_enabled(bool enable);
+
+/**
+ * @brief The counter of a kernel, created on first use. The reference stays valid for the lifetime
+ * of the program.
+ */
+KernelCounter &counter(const char *name);
+
+/**
+ * @brief The counters of every kernel called at least once, sorted by name.
+ *
+ * @param reset Whether to zero the counters after reading them
+ */
+std::vector<KernelStats> snapshot(bool reset = false);
+void reset();
+
+/**
+ * @brief Records one call of a kernel into its counter, when it goes out of scope. While open, it
+ * is the scope that record_team() reports to on its thread.
+ */
+class ScopedTimer {
+  public:
+    ScopedTimer(KernelCounter &counter, uint64_t elements, uint64_t bytes);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+    friend void record_team();
+
+    KernelCounter *counter_ = nullptr;
+    // The scope this one hides, when a kernel calls another
+    ScopedTimer *outer_ = nullptr;
+    uint64_t elements_ = 0;
+    uint64_t bytes_ = 0;
+    int team_ = 1;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Reports the size of the current team to the open scope of the calling thread, if any.
+ * Called by every thread of a parallel region; only thread 0, the one that opened the region,
+ * reports.
+ */
+void record_team();
+
+} // namespace z2r::stats
+
+#ifdef Z2R_PERF_COUNTERS
+    // The counter is looked up once per call site, then only touched while enabled. The name must
+    // thus be the same on every call: a kernel counted under several names needs one call site per
+    // name.
+    #define Z2R_KERNEL_STATS(name, elements, bytes)                                                \
+        static z2r::stats::KernelCounter &z2r_stats_counter_ = z2r::stats::counter(name);          \
+        z2r::stats::ScopedTimer z2r_stats_timer_(z2r_stats_counter_,                               \
+                                                 static_cast<uint64_t>(elements),                  \
+                                                 static_cast<uint64_t>(bytes))
+    #define Z2R_KERNEL_TEAM() z2r::stats::record_team()
+#else
+    #define Z2R_KERNEL_STATS(name, elements, bytes) static_cast<void>(0)
+    #define Z2R_KERNEL_TEAM() static_cast<void>(0)
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file z2r_taper.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free Z2 symmetries of a qubit operator, and qubit tapering.
+ *
+ * A Z2 symmetry of H = sum_t w_t P_t is a Pauli string g commuting with every P_t. For g = (z, x)
+ * and P_t = (z_t, x_t), this is z_t . x + x_t . z = 0 (mod 2), so the symmetries are the kernel of
+ * the check matrix whose row t is [z_t | x_t], applied to [x | z]. A maximal set of independent and
+ * commuting symmetries g_1..g_k is mapped by a Clifford circuit C to single-qubit Z on qubits
+ * q_1..q_k. C H C^dagger then only acts on these qubits with I or Z, which are replaced by the
+ * eigenvalues of the chosen sector, and the k qubits are removed (Bravyi et al., arXiv:1701.08213).
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <complex>
+#include <span>
+#include <vector>
+
+#include "z2r_clifford.h"
+#include "z2r_core.h"
+
+/**
+ * @brief Independent and commuting Z2 symmetries of an operator, with the Clifford circuit that
+ * maps them to single-qubit Z.
+ */
+struct Z2Symmetries {
+    size_t num_qubits = 0;
+    // (num_qubits + 63) / 64
+    size_t words = 0;
+    // Generator k is the Z words generators[2 * k * words, (2 * k + 1) * words), then its X words
+    std::vector<uint64_t> generators;
+    // C g_k C^dagger = (-1)^signs[k] Z_{qubits[k]}
+    std::vector<int64_t> qubits;
+    std::vector<uint8_t> signs;
+    // The circuit C, as rows of (code, qubit_0, qubit_1). See CliffordGate.
+    std::vector<int64_t> gates;
+
+    size_t size() const { return qubits.size(); }
+    // Bytes of the stitched voids of the tapered operator, on num_qubits - size() qubits
+    size_t tapered_itemsize() const {
+        return std::max<size_t>((2 * (num_qubits - size()) + 7) / 8, 1);
+    }
+};
+
+namespace z2r {
+
+Z2Symmetries find_z2_symmetries(VoidView zx_voids, size_t num_qubits);
+void symmetry_generators(const Z2Symmetries &sym, MutableVoidView zx_out);
+std::vector<PauliAccumulator> taper(VoidView zx_voids,
+                                    std::span<const std::complex<double>> weights,
+                                    const Z2Symmetries &sym, std::span<const int> sector);
+
+} // namespace z2r
@@ -0,0 +1,121 @@
+/**
+ * @file z2r_threads.h
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Thread count, scheduling and affinity of the parallel kernels.
+ *
+ * The OpenMP settings (nthreads-var, run-sched-var) are per calling thread, so changing them from
+ * one Python thread does not reach the kernels called from another. Instead, the settings are kept
+ * here, and every kernel calls apply() before its parallel regions: when the global settings, or
+ * the limits pushed by the calling thread, changed since its last call, apply() forwards them to
+ * OpenMP for this thread. Otherwise it costs two atomic loads.
+ *
+ * All the parallel loops use schedule(runtime), so the schedule set here is the one they run with.
+ * It defaults to static, as before.
+ *
+ * In NUMA mode (set_numa()), the threads are pinned node by node, contiguous thread numbers on the
+ * same node, and large output arrays are first touched in parallel with a static schedule (see
+ * z2r::first_touch()). Each page is then allocated on the node of the thread whose static chunk of
+ * the kernel covers it.
+ *
+ * Settings, from the highest priority:
+ * - Limits pushed by the calling thread (push_limits() / pop_limits()), for a scope of calls
+ * - Global settings (set_num_threads(), set_schedule())
+ * - The OpenMP defaults (OMP_NUM_THREADS, ...) for the thread count
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace z2r::threads {
+
+// Values of omp_sched_t
+enum class Schedule : int { Static = 1, Dynamic = 2, Guided = 3 };
+
+/**
+ * @brief Sets the number of threads of the parallel kernels, for every calling thread.
+ *
+ * @param num_threads The number of threads, or 0 for the OpenMP default
+ */
+void set_num_threads(int num_threads);
+
+/**
+ * @brief The number of threads the parallel kernels would use if called from this thread.
+ */
+int num_threads();
+
+/**
+ * @brief Sets the schedule of the parallel loops.
+ *
+ * @param kind Static, dynamic or guided
+ * @param chunk The chunk size, or 0 for the OpenMP default of this kind
+ */
+void set_schedule(Schedule kind, int chunk = 0);
+Schedule schedule_kind();
+int schedule_chunk();
+
+/**
+ * @brief Pins the threads of the teams to the CPUs of a list. Each root thread (a thread calling
+ * the kernels, which has its own team) takes the next slice of the list after the root threads
+ * already pinned, wrapping around, and thread t of its team goes to position t of its slice. The
+ * teams of concurrent callers, such as the workers of the async pool, thus run on different CPUs.
+ * The calling thread itself (t = 0) keeps its own mask unless pin_caller. An empty list gives every
+ * thread its original CPU mask back.
+ *
+ * @attention Only supported on Linux.
+ */
+void set_affinity(const std::vector<int> &cpus, bool pin_caller = false);
+std::vector<int> affinity();
+
+/**
+ * @brief Turns the NUMA mode on or off. On, it replaces the affinity of set_affinity(): a team of n
+ * alone puts thread t on node floor(t * nodes / n), on the CPUs of that node in turn. The teams of
+ * concurrent root threads take slices of the CPUs listed node by node, as for set_affinity().
+ * Setting an affinity turns it off.
+ *
+ * @attention Only supported on Linux.
+ */
+void set_numa(bool enable, bool pin_caller = false);
+bool numa();
+
+/**
+ * @brief The CPUs available to this process, grouped by NUMA node (from /sys/devices/system/node).
+ * Nodes without any available CPU are left out. Empty when the topology is unknown.
+ */
+std::vector<std::vector<int>> numa_nodes();
+
+/**
+ * @brief In persistent pool mode, the team of worker threads is started as soon as the settings
+ * change, rather than on the first parallel kernel. Whether idle workers spin or sleep between
+ * calls is up to OMP_WAIT_POLICY, which the OpenMP runtime only reads when it starts.
+ */
+void set_persistent_pool(bool enable);
+bool persistent_pool();
+
+/**
+ * @brief Starts the team of worker threads now, with the current settings.
+ */
+void warm_up();
+
+/**
+ * @brief Overrides the settings for the calling thread only, until the matching pop_limits().
+ *
+ * @param num_threads The number of threads, or 0 to keep the current one
+ * @param kind The schedule, or 0 to keep the current one
+ * @param chunk The chunk size, used when kind is given
+ */
+void push_limits(int num_threads, int kind = 0, int chunk = 0);
+void pop_limits();
+
+/**
+ * @brief Forwards the settings to OpenMP for the calling thread, if they changed since its last
+ * call. Called at the start of every parallel kernel.
+ */
+void apply();
+
+} // namespace z2r::threads
@@ -6,9 +6,7 @@
  * @attention Your compiler must support at least C++20 standard to properly compile this file.
  *
  * @todo Add SIMD support,
- * to_matrix,
- * inserer des matrices dans dautres via indexes,
- * get_qubit_slices (?) - return toutes qubits pour un ensemble dindexes via vector<int>
+ * to_matrix
  *
  * @note It is assumed that all of the input arrays are contiguous, of the dtype |V{N}, and the
  * exact same shape. No checks are performed to ensure this is the case. Any broadcasting and
@@ -62,6 +60,67 @@ py::array bitwise_or(py::array z2r_1, py::array z2r_2) {
     return bitwise_core(z2r_1, z2r_2, std::bit_or<uint64_t>());
 }
 
+/**
+ * @brief Batched bitwise_xor(): XORs z2r_1s[i] with z2r_2s[i], for every i, in a single call. All
+ * of the pairs are validated first, then computed together without the GIL, so that the cost of
+ * a call is paid once per batch rather than once per pair. See z2r::bitwise_xor_many().
+ *
+ * @note Unlike bitwise_xor(), the arrays do not need to be contiguous, and the outputs always have
+ * the shape of their inputs (no scalars). The outputs are views into a single buffer.
+ *
+ * @param z2r_1s The first arrays
+ * @param z2r_2s The second arrays, each of the same size and itemsize as its counterpart
+ * @return py::list The XOR of every pair
+ */
+py::list bitwise_xor_many(const std::vector<py::array> &z2r_1s,
+                          const std::vector<py::array> &z2r_2s) {
+    if (z2r_1s.size() != z2r_2s.size()) {
+        throw std::runtime_error("There must be as many first arrays as second arrays.");
+    }
+    size_t n = z2r_1s.size();
+    std::vector<py::array> inputs;
+    std::vector<py::buffer_info> bufs;
+    std::vector<py::dtype> dtypes;
+    std::vector<std::vector<ssize_t>> shapes;
+    inputs.reserve(2 * n);
+    bufs.reserve(2 * n);
+    dtypes.reserve(n);
+    shapes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        inputs.push_back(c_contiguous(z2r_1s[i]));
+        inputs.push_back(c_contiguous(z2r_2s[i]));
+        bufs.push_back(inputs[2 * i].request());
+        bufs.push_back(inputs[2 * i + 1].request());
+        if (bufs[2 * i].itemsize != bufs[2 * i + 1].itemsize) {
+            throw std::runtime_error(
+                "Input arrays must have the same itemsize (dtype compatibility).");
+        }
+        if (bufs[2 * i].size != bufs[2 * i + 1].size) {
+            throw std::runtime_error("Input arrays must have the same size.");
+        }
+        dtypes.push_back(inputs[2 * i].dtype());
+        shapes.push_back(bufs[2 * i].shape);
+    }
+
+    std::vector<py::array> outputs = batch_outputs(dtypes, shapes);
+    std::vector<z2r::BinaryTask> tasks(n);
+    for (size_t i = 0; i < n; ++i) {
+        tasks[i] = {byte_span(bufs[2 * i]), byte_span(bufs[2 * i + 1]),
+                    mutable_byte_span(outputs[i].request())};
+    }
+
+    {
+        py::gil_scoped_release release;
+        z2r::bitwise_xor_many(tasks);
+    }
+
+    py::list result;
+    for (py::array &out : outputs) {
+        result.append(out);
+    }
+    return result;
+}
+
 /**
  * @brief Performs an element-wise bitwise NOT operation on a NumPy contiguous (C-like) array.
  * In other words, it flips all bits in the array.
@@ -73,32 +132,10 @@ py::array bitwise_or(py::array z2r_1, py::array z2r_2) {
 // TODO: update to reflect new changes in bitwise_core for scalars
 py::array bitwise_not(py::array voids) {
     auto buf = voids.request();
-    size_t total_bytes = buf.size * buf.itemsize;
-    py::array res_voids = py::array(voids.dtype(), buf.shape);
+    py::array res_voids = output_array(voids.dtype(), buf.shape);
     auto buf_out = res_voids.request();
 
-    const uint64_t *ptr_64 = std::bit_cast<uint64_t *>(buf.ptr);
-    int64_t *ptr_out_64 = std::bit_cast<int64_t *>(buf_out.ptr);
-
-    size_t num_u64_chunks = total_bytes / 8;
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t i = 0; i < num_u64_chunks; ++i) {
-        ptr_out_64[i] = ~ptr_64[i];
-    }
-
-    size_t tail_bytes = total_bytes % 8;
-    if (tail_bytes > 0) {
-        const uint8_t *ptr_8 = std::bit_cast<const uint8_t *>(buf.ptr);
-        int8_t *ptr_out_8 = std::bit_cast<int8_t *>(buf_out.ptr);
-
-        size_t start_byte = num_u64_chunks * 8;
-        for (size_t i = 0; i < tail_bytes; ++i) {
-            ptr_out_8[start_byte + i] = ~ptr_8[start_byte + i];
-        }
-    }
+    z2r::bitwise_not(byte_span(buf), mutable_byte_span(buf_out));
 
     return res_voids;
 }
@@ -124,9 +161,10 @@ py::array paded_bitwise_not(py::array voids, int num_qubits) {
     int64_t *ptr_out_64 = std::bit_cast<int64_t *>(buf_out.ptr);
 
     size_t num_u64_chunks = total_bytes / 8;
+    z2r::threads::apply();
 
 #ifdef USE_OPENMP
-    #pragma omp parallel for if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(static)
+    #pragma omp parallel for if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(runtime)
 #endif
     for (size_t i = 0; i < num_u64_chunks; ++i) {
         ptr_out_64[i] = ~ptr_64[i];
@@ -160,53 +198,14 @@ py::object bitwise_count(py::array z2r_1) {
     py::array_t<int64_t> result(buf_in.size);
     auto buf_out = result.request();
 
-    const uint8_t *ptr1 = std::bit_cast<const uint8_t *>(buf_in.ptr);
-    int64_t *ptr_out = std::bit_cast<int64_t *>(buf_out.ptr);
+    z2r::bitwise_count(void_view(buf_in),
+                       {static_cast<int64_t *>(buf_out.ptr), static_cast<size_t>(buf_in.size)});
 
-    size_t itemsize = buf_in.itemsize;
-    size_t num_elem = buf_in.size;
-    size_t u64_per_elem = itemsize / 8;
-    size_t tail_bytes = itemsize % 8;
-
-    size_t total_64_chunks = num_elem * u64_per_elem;
-
-    if (num_elem == 1) {
+    if (buf_in.size == 1) {
         // Special case for when the NumPy array is one-dimensional.
         // This is necessary in order to return the exact same output as the Python version of this
         // function. i.e. a single integer instead of a one-element array.
-        const uint8_t *base = ptr1;
-        int64_t count = 0;
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (u64_per_elem >= BOPS_THRESHOLD_PARALLEL) schedule(static)         \
-        reduction(+ : count)
-#endif
-        for (size_t k = 0; k < u64_per_elem; ++k) {
-            uint64_t word;
-            std::memcpy(&word, base + k * 8, 8);
-            count += std::popcount(word);
-        }
-        for (size_t t = 0; t < tail_bytes; ++t) {
-            count += std::popcount(static_cast<uint8_t>(base[u64_per_elem * 8 + t]));
-        }
-        return py::int_(count);
-    }
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (total_64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t i = 0; i < num_elem; ++i) {
-        const uint8_t *base = ptr1 + i * itemsize;
-        int64_t count = 0;
-        for (size_t k = 0; k < u64_per_elem; ++k) {
-            uint64_t word;
-            std::memcpy(&word, base + k * 8, 8);
-            count += std::popcount(word);
-        }
-        for (size_t t = 0; t < tail_bytes; ++t) {
-            count += std::popcount(static_cast<uint8_t>(base[u64_per_elem * 8 + t]));
-        }
-        ptr_out[i] = count;
+        return py::int_(static_cast<int64_t *>(buf_out.ptr)[0]);
     }
 
     result.resize(buf_in.shape);
@@ -227,72 +226,17 @@ py::object bitwise_dot(py::array z2r_1, py::array z2r_2) {
     auto buf1 = z2r_1.request();
     auto buf2 = z2r_2.request();
 
-    if (buf1.itemsize != buf2.itemsize) {
-        throw std::runtime_error("Input arrays must have the same itemsize. Got " +
-                                 std::to_string(buf1.itemsize) + " and " +
-                                 std::to_string(buf2.itemsize));
-    }
-    if (buf1.size != buf2.size) {
-        throw std::runtime_error("Input arrays must have the same size. Got " +
-                                 std::to_string(buf1.size) + " and " + std::to_string(buf2.size));
-    }
-
     py::array_t<int64_t> result(buf1.shape);
     auto buf_out = result.request();
 
-    const uint8_t *ptr1 = std::bit_cast<const uint8_t *>(buf1.ptr);
-    const uint8_t *ptr2 = std::bit_cast<const uint8_t *>(buf2.ptr);
-    int64_t *ptr_out = std::bit_cast<int64_t *>(buf_out.ptr);
+    z2r::bitwise_dot(void_view(buf1), void_view(buf2),
+                     {static_cast<int64_t *>(buf_out.ptr), static_cast<size_t>(buf_out.size)});
 
-    size_t itemsize = buf1.itemsize;
-    size_t num_elem = buf1.size;
-    size_t u64_per_elem = itemsize / 8;
-    size_t tail_bytes = itemsize % 8;
-    size_t total_64_chunks = num_elem * u64_per_elem;
-
-    if (num_elem == 1) {
+    if (buf1.size == 1) {
         // Special case for when the NumPy array is one-dimensional.
         // This is necessary in order to return the exact same output as the Python version of this
         // function. i.e. a single integer instead of a one-element array.
-        const uint8_t *base1 = ptr1;
-        const uint8_t *base2 = ptr2;
-        int64_t count = 0;
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (u64_per_elem >= BOPS_THRESHOLD_PARALLEL) schedule(static)         \
-        reduction(+ : count)
-#endif
-        for (size_t k = 0; k < u64_per_elem; ++k) {
-            uint64_t w1, w2;
-            std::memcpy(&w1, base1 + k * 8, 8);
-            std::memcpy(&w2, base2 + k * 8, 8);
-            count += std::popcount(w1 & w2);
-        }
-        for (size_t t = 0; t < tail_bytes; ++t) {
-            count += std::popcount(
-                static_cast<uint8_t>(base1[u64_per_elem * 8 + t] & base2[u64_per_elem * 8 + t]));
-        }
-        return py::int_(count);
-    }
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (total_64_chunks >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t i = 0; i < num_elem; ++i) {
-        const uint8_t *base1 = ptr1 + i * itemsize;
-        const uint8_t *base2 = ptr2 + i * itemsize;
-        int64_t count = 0;
-        for (size_t k = 0; k < u64_per_elem; ++k) {
-            uint64_t w1, w2;
-            std::memcpy(&w1, base1 + k * 8, 8);
-            std::memcpy(&w2, base2 + k * 8, 8);
-            count += std::popcount(w1 & w2);
-        }
-        for (size_t t = 0; t < tail_bytes; ++t) {
-            count += std::popcount(
-                static_cast<uint8_t>(base1[u64_per_elem * 8 + t] & base2[u64_per_elem * 8 + t]));
-        }
-        ptr_out[i] = count;
+        return py::int_(static_cast<int64_t *>(buf_out.ptr)[0]);
     }
 
     return result;
@@ -0,0 +1,372 @@
+/**
+ * @file clifford.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note The conjugation of Pauli arrays itself is in z2r_clifford.cpp, so that the tapering of
+ * z2r_taper.cpp can use it without Python.
+ *
+ * @note StabilizerTableau keeps its rows in the Z2R layout rather than in the transposed blocks of
+ * 64 Pauli strings of the conjugation, since measurements are dominated by row products.
+ *
+ * @version 0.1.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "clifford.h"
+#include "z2r_stats.h"
+
+/**
+ * @brief Conjugates every Pauli string of an array by a Clifford circuit, i.e. computes
+ * C P C^dagger for each P. See z2r::conjugate_rows().
+ *
+ * @param z_voids Z voids of the Pauli strings, of any shape
+ * @param x_voids X voids of the Pauli strings, same shape and dtype as z_voids
+ * @param gates The compiled circuit, an int64 array of shape (num_gates, 3). See CliffordGate.
+ * @param phases Complex phases (or weights) of the Pauli strings, same shape as z_voids
+ * @return py::tuple Returns (new_z, new_x, new_phases). new_phases is phases multiplied by the
+ * sign picked up by each Pauli string
+ */
+py::tuple clifford_conjugate(py::array z_voids, py::array x_voids, py::array_t<int64_t> gates,
+                             py::array_t<std::complex<double>> phases) {
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+    auto buf_g = gates.request();
+    auto buf_p = phases.request();
+
+    if (buf_z.itemsize != buf_x.itemsize || buf_z.size != buf_x.size) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+    if (buf_p.size != buf_z.size) {
+        throw std::runtime_error("phases must have one element per Pauli string.");
+    }
+    if (buf_g.size > 0 && (buf_g.ndim != 2 || buf_g.shape[1] != 3)) {
+        throw std::runtime_error("gates must be an array of shape (num_gates, 3).");
+    }
+
+    size_t n_gates = (buf_g.size > 0) ? static_cast<size_t>(buf_g.shape[0]) : 0;
+    CompiledCircuit circuit = z2r::compile_circuit(
+        {static_cast<const int64_t *>(buf_g.ptr), 3 * n_gates}, buf_z.itemsize);
+
+    py::array new_z = py::array(z_voids.dtype(), buf_z.shape);
+    py::array new_x = py::array(x_voids.dtype(), buf_x.shape);
+    py::array_t<std::complex<double>> new_phases(buf_p.shape);
+    auto buf_nz = new_z.request();
+    auto buf_nx = new_x.request();
+    auto buf_np = new_phases.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::conjugate_rows(circuit, void_view(buf_z), void_view(buf_x),
+                            {static_cast<const std::complex<double> *>(buf_p.ptr),
+                             static_cast<size_t>(buf_p.size)},
+                            mutable_void_view(buf_nz), mutable_void_view(buf_nx),
+                            {static_cast<std::complex<double> *>(buf_np.ptr),
+                             static_cast<size_t>(buf_np.size)});
+    } // GIL reacquired here
+
+    return py::make_tuple(new_z, new_x, new_phases);
+}
+
+/**
+ * @brief Creates the tableau of the |0...0> state: destabilizer i is X_i and stabilizer i is Z_i.
+ *
+ * @param num_qubits Number of qubits
+ * @param seed Seed of the generator used for random measurement outcomes. A random one is drawn
+ * when none is given.
+ */
+StabilizerTableau::StabilizerTableau(size_t num_qubits, std::optional<uint64_t> seed)
+    : n_(num_qubits), words_(std::max<size_t>((num_qubits + 63) / 64, 1)),
+      data_(2 * (2 * num_qubits + 1) * words_, 0), signs_(2 * num_qubits + 1, 0),
+      key_(splitmix64(seed.has_value() ? *seed : std::random_device{}())) {
+    for (size_t q = 0; q < n_; ++q) {
+        x_row(q)[q / 64] |= uint64_t{1} << (q % 64);
+        z_row(n_ + q)[q / 64] |= uint64_t{1} << (q % 64);
+    }
+}
+
+/**
+ * @brief Replaces row h by the product of rows h and i, with its sign (the "rowsum" of Aaronson and
+ * Gottesman). Both rows are expected to commute.
+ *
+ * @param h The row to update
+ * @param i The row to multiply it by
+ */
+void StabilizerTableau::rowsum(size_t h, size_t i) {
+    int log_i = pauli_mul_log_i(z_row(h), x_row(h), z_row(i), x_row(i), words_);
+    signs_[h] = ((2 * signs_[h] + 2 * signs_[i] + log_i) & 3) == 2;
+}
+
+/**
+ * @brief Applies a Clifford gate to the state.
+ *
+ * @param code The gate, from CliffordGate
+ * @param a The first qubit
+ * @param b The second qubit, for two-qubit gates
+ */
+void StabilizerTableau::apply_gate(int64_t code, int64_t a, int64_t b) {
+    z2r::threads::apply();
+    if (code < GATE_H || code > GATE_SWAP) {
+        throw std::runtime_error("Unknown gate code " + std::to_string(code) + ".");
+    }
+    bool two_qubits = code >= GATE_CX;
+    if (!two_qubits) {
+        b = a;
+    }
+    if (a < 0 || b < 0 || static_cast<size_t>(a) >= n_ || static_cast<size_t>(b) >= n_) {
+        throw std::runtime_error("Gate qubit out of range for a tableau of " + std::to_string(n_) +
+                                 " qubits.");
+    }
+    if (two_qubits && a == b) {
+        throw std::runtime_error("Two-qubit gates must act on two different qubits.");
+    }
+
+    size_t wa = a / 64, sa = a % 64;
+    size_t wb = b / 64, sb = b % 64;
+    size_t n_rows = 2 * n_;
+
+    // Each row goes through the same bit-sliced rules as clifford_conjugate(), on 1-bit columns
+#ifdef USE_OPENMP
+    #pragma omp parallel for if (n_rows >= TABLEAU_THRESHOLD_PARALLEL) schedule(runtime)
+#endif
+    for (size_t r = 0; r < n_rows; ++r) {
+        uint64_t *zr = z_row(r);
+        uint64_t *xr = x_row(r);
+        uint64_t z[2] = {(zr[wa] >> sa) & 1, (zr[wb] >> sb) & 1};
+        uint64_t x[2] = {(xr[wa] >> sa) & 1, (xr[wb] >> sb) & 1};
+        uint64_t sign = 0;
+        apply_clifford_gate(code, 0, 1, z, x, sign);
+
+        zr[wa] = (zr[wa] & ~(uint64_t{1} << sa)) | (z[0] << sa);
+        xr[wa] = (xr[wa] & ~(uint64_t{1} << sa)) | (x[0] << sa);
+        if (two_qubits) {
+            zr[wb] = (zr[wb] & ~(uint64_t{1} << sb)) | (z[1] << sb);
+            xr[wb] = (xr[wb] & ~(uint64_t{1} << sb)) | (x[1] << sb);
+        }
+        signs_[r] ^= sign & 1;
+    }
+}
+
+/**
+ * @brief Applies a compiled Clifford circuit to the state.
+ *
+ * @param gates The compiled circuit, an int64 array of shape (num_gates, 3). See CliffordGate.
+ */
+void StabilizerTableau::apply_circuit(py::array_t<int64_t> gates) {
+    auto buf_g = gates.request();
+    if (buf_g.size == 0) {
+        return;
+    }
+    if (buf_g.ndim != 2 || buf_g.shape[1] != 3) {
+        throw std::runtime_error("gates must be an array of shape (num_gates, 3).");
+    }
+    const int64_t *ptr_g = static_cast<const int64_t *>(buf_g.ptr);
+    for (ssize_t g = 0; g < buf_g.shape[0]; ++g) {
+        apply_gate(ptr_g[3 * g], ptr_g[3 * g + 1], ptr_g[3 * g + 2]);
+    }
+}
+
+/**
+ * @brief Measures a qubit in the Z basis and collapses the state accordingly.
+ *
+ * @param qubit The qubit to measure
+ * @return py::tuple Returns (outcome, deterministic). outcome is 0 or 1, and deterministic is
+ * false when the outcome was drawn at random.
+ */
+py::tuple StabilizerTableau::measure(size_t qubit) {
+    z2r::threads::apply();
+    if (qubit >= n_) {
+        throw std::runtime_error("Qubit out of range for a tableau of " + std::to_string(n_) +
+                                 " qubits.");
+    }
+
+    size_t p = 2 * n_;
+    for (size_t i = n_; i < 2 * n_; ++i) {
+        if (x_bit(i, qubit)) {
+            p = i;
+            break;
+        }
+    }
+
+    if (p < 2 * n_) {
+        // Random outcome: some stabilizer anticommutes with Z_qubit
+        size_t n_rows = 2 * n_;
+#ifdef USE_OPENMP
+    #pragma omp parallel for if (n_rows * words_ >= TABLEAU_THRESHOLD_PARALLEL) schedule(runtime)
+#endif
+        for (size_t i = 0; i < n_rows; ++i) {
+            if (i != p && x_bit(i, qubit)) {
+                rowsum(i, p);
+            }
+        }
+
+        std::memcpy(z_row(p - n_), z_row(p), 2 * words_ * sizeof(uint64_t));
+        signs_[p - n_] = signs_[p];
+
+        std::fill(z_row(p), z_row(p) + 2 * words_, 0);
+        z_row(p)[qubit / 64] |= uint64_t{1} << (qubit % 64);
+        signs_[p] = counter_rng64(key_, counter_++) & 1;
+        return py::make_tuple(static_cast<int>(signs_[p]), false);
+    }
+
+    // Deterministic outcome: Z_qubit is, up to a sign, a product of stabilizers
+    size_t scratch = 2 * n_;
+    std::fill(z_row(scratch), z_row(scratch) + 2 * words_, 0);
+    signs_[scratch] = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (x_bit(i, qubit)) {
+            rowsum(scratch, i + n_);
+        }
+    }
+    return py::make_tuple(static_cast<int>(signs_[scratch]), true);
+}
+
+/**
+ * @brief Computes the expectation value of every Pauli string of an array against the state.
+ * For a stabilizer state, it is 0 if the Pauli string anticommutes with any stabilizer, and +1 or
+ * -1 otherwise. In the latter case the Pauli string is rebuilt as the product of the stabilizers
+ * paired with the destabilizers it anticommutes with, which gives its sign.
+ *
+ * @param z_voids Z voids of the Pauli strings, of any shape. Bits past num_qubits must be zero.
+ * @param x_voids X voids of the Pauli strings, same shape and dtype as z_voids
+ * @return py::array_t<double> The expectation values, same shape as z_voids
+ */
+py::array_t<double> StabilizerTableau::expectation_values(py::array z_voids,
+                                                          py::array x_voids) const {
+    z2r::threads::apply();
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+    if (buf_z.itemsize != buf_x.itemsize || buf_z.size != buf_x.size) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+
+    size_t itemsize = buf_z.itemsize;
+    size_t n_rows = buf_z.size;
+    size_t words = words_;
+    size_t n = n_;
+    uint64_t last_mask = (n % 64) ? (uint64_t{1} << (n % 64)) - 1 : ~uint64_t{0};
+
+    py::array_t<double> result(buf_z.shape);
+    auto buf_out = result.request();
+    double *ptr_out = static_cast<double *>(buf_out.ptr);
+    const uint8_t *ptr_z = std::bit_cast<const uint8_t *>(buf_z.ptr);
+    const uint8_t *ptr_x = std::bit_cast<const uint8_t *>(buf_x.ptr);
+
+    bool out_of_range = false;
+
+    {
+        py::gil_scoped_release release;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n_rows >= TABLEAU_THRESHOLD_PARALLEL)
+#endif
+        {
+            // Pauli string, then scratch product
+            std::vector<uint64_t> pz(words), px(words), sz(words), sx(words);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime) reduction(|| : out_of_range)
+#endif
+            for (size_t row = 0; row < n_rows; ++row) {
+                const uint8_t *zp = ptr_z + row * itemsize;
+                const uint8_t *xp = ptr_x + row * itemsize;
+                size_t nbytes = std::min(itemsize, words * 8);
+                std::fill(pz.begin(), pz.end(), 0);
+                std::fill(px.begin(), px.end(), 0);
+                std::memcpy(pz.data(), zp, nbytes);
+                std::memcpy(px.data(), xp, nbytes);
+
+                bool bad = (pz[words - 1] | px[words - 1]) & ~last_mask;
+                for (size_t b = nbytes; b < itemsize; ++b) {
+                    bad |= (zp[b] | xp[b]) != 0;
+                }
+                if (bad) {
+                    out_of_range = true;
+                    ptr_out[row] = 0.0;
+                    continue;
+                }
+
+                auto anticommutes = [&](size_t r) {
+                    const uint64_t *zr = z_row(r);
+                    const uint64_t *xr = x_row(r);
+                    int parity = 0;
+                    for (size_t k = 0; k < words; ++k) {
+                        parity ^= std::popcount((pz[k] & xr[k]) ^ (px[k] & zr[k])) & 1;
+                    }
+                    return parity != 0;
+                };
+
+                bool commutes = true;
+                for (size_t i = n; i < 2 * n && commutes; ++i) {
+                    commutes = !anticommutes(i);
+                }
+                if (!commutes) {
+                    ptr_out[row] = 0.0;
+                    continue;
+                }
+
+                std::fill(sz.begin(), sz.end(), 0);
+                std::fill(sx.begin(), sx.end(), 0);
+                int log_i = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    if (anticommutes(i)) {
+                        log_i += pauli_mul_log_i(sz.data(), sx.data(), z_row(i + n), x_row(i + n),
+                                                 words);
+                        log_i += 2 * signs_[i + n];
+                    }
+                }
+                ptr_out[row] = ((log_i & 3) == 0) ? 1.0 : -1.0;
+            }
+        }
+    } // GIL reacquired here
+
+    if (out_of_range) {
+        throw std::runtime_error("Pauli strings act on more qubits than the tableau (" +
+                                 std::to_string(n_) + ").");
+    }
+    return result;
+}
+
+/**
+ * @brief Copies n consecutive rows of the tableau into voids.
+ *
+ * @param first The first row
+ * @return py::tuple Returns (z_voids, x_voids, signs), with voids of dtype |V{8 * words} and signs
+ * an int8 array of +1 and -1
+ */
+py::tuple StabilizerTableau::rows_to_voids(size_t first) const {
+    size_t itemsize = words_ * 8;
+    py::dtype out_dtype("|V" + std::to_string(itemsize));
+    std::vector<ssize_t> shape = {static_cast<ssize_t>(n_)};
+    py::array z_voids = py::array(out_dtype, shape);
+    py::array x_voids = py::array(out_dtype, shape);
+    py::array_t<int8_t> signs(shape);
+    uint8_t *ptr_z = static_cast<uint8_t *>(z_voids.request().ptr);
+    uint8_t *ptr_x = static_cast<uint8_t *>(x_voids.request().ptr);
+    int8_t *ptr_s = static_cast<int8_t *>(signs.request().ptr);
+
+    for (size_t i = 0; i < n_; ++i) {
+        std::memcpy(ptr_z + i * itemsize, z_row(first + i), itemsize);
+        std::memcpy(ptr_x + i * itemsize, x_row(first + i), itemsize);
+        ptr_s[i] = signs_[first + i] ? -1 : 1;
+    }
+    return py::make_tuple(z_voids, x_voids, signs);
+}
+
+/**
+ * @brief Returns the stabilizer generators of the state.
+ *
+ * @return py::tuple Returns (z_voids, x_voids, signs)
+ */
+py::tuple StabilizerTableau::stabilizers() const { return rows_to_voids(n_); }
+
+/**
+ * @brief Returns the destabilizers of the state.
+ *
+ * @return py::tuple Returns (z_voids, x_voids, signs)
+ */
+py::tuple StabilizerTableau::destabilizers() const { return rows_to_voids(0); }
@@ -6,9 +6,7 @@
  * @attention Your compiler must support at least C++20 standard to properly compile this file.
  *
  * @todo Add SIMD support,
- * to_matrix,
- * inserer des matrices dans dautres via indexes,
- * get_qubit_slices (?) - return toutes qubits pour un ensemble dindexes via vector<int>
+ * to_matrix
  *
  * @note It is assumed that all of the input arrays are contiguous, of the dtype |V{N}, and the
  * exact same shape. No checks are performed to ensure this is the case. Any broadcasting and
@@ -23,6 +21,7 @@
  */
 
 #include "cz2m.h"
+#include "z2r_stats.h"
 
 /**
  * @brief This function performs a 'tensor product' between two arrays of Pauli operators
@@ -43,8 +42,8 @@ py::tuple tensor(py::array z2, py::array x2, py::array z1, py::array x1) {
 
     std::vector<ssize_t> new_shape = buf_z1.shape;
     new_shape.back() += buf_z2.shape.back();
-    py::array new_z = py::array(z1.dtype(), new_shape);
-    py::array new_x = py::array(x1.dtype(), new_shape);
+    py::array new_z = output_array(z1.dtype(), new_shape);
+    py::array new_x = output_array(x1.dtype(), new_shape);
     auto buf_new_z = new_z.request();
     auto buf_new_x = new_x.request();
 
@@ -83,10 +82,7 @@ py::tuple tensor(py::array z2, py::array x2, py::array z1, py::array x1) {
 }
 
 /**
- * @brief Compose two arrays of Pauli operators.
- *
- * @warning Current implementation is very naive, error prone and probably slow.
- * Best to re-implement in a better way.
+ * @brief Compose two arrays of Pauli operators. See z2r::compose().
  *
  * @param z1
  * @param x1
@@ -96,58 +92,105 @@ py::tuple tensor(py::array z2, py::array x2, py::array z1, py::array x1) {
  * are the composed Pauli operators, and phase_power is a complex array of dtype complex128
  */
 py::tuple compose(py::array z1, py::array x1, py::array z2, py::array x2) {
-    py::array new_z = bitwise_xor(z1, z2);
-    py::array new_x = bitwise_xor(x1, x2);
-
-    py::array self_phase_power = bitwise_dot(z1, x1);
-    py::array other_phase_power = bitwise_dot(z2, x2);
-    py::array new_phase_power = bitwise_dot(new_z, new_x);
-    py::array commutation_phase_power = bitwise_dot(x1, z2);
-
-    // phase_power = commutation_phase_power + self_phase_power + other_phase_power -
-    // new_phase_power
-    py::array_t<std::complex<double>> phase_power =
-        py::array_t<std::complex<double>>(new_z.request().shape);
-
-    auto buf_comm = commutation_phase_power.request();
-    auto buf_self = self_phase_power.request();
-    auto buf_other = other_phase_power.request();
-    auto buf_new = new_phase_power.request();
+    auto buf_z1 = z1.request();
+    auto buf_x1 = x1.request();
+    auto buf_z2 = z2.request();
+    auto buf_x2 = x2.request();
+
+    py::array new_z = output_array(z1.dtype(), buf_z1.shape);
+    py::array new_x = output_array(x1.dtype(), buf_z1.shape);
+    py::array phase_power = output_array(py::dtype::of<std::complex<double>>(), buf_z1.shape);
+    auto buf_new_z = new_z.request();
+    auto buf_new_x = new_x.request();
     auto buf_phase = phase_power.request();
 
-    auto n = buf_phase.size;
-    const int64_t *ptr_comm = static_cast<const int64_t *>(buf_comm.ptr);
-    const int64_t *ptr_self = static_cast<const int64_t *>(buf_self.ptr);
-    const int64_t *ptr_other = static_cast<const int64_t *>(buf_other.ptr);
-    const int64_t *ptr_new = static_cast<const int64_t *>(buf_new.ptr);
-    std::complex<double> *ptr_phase = static_cast<std::complex<double> *>(buf_phase.ptr);
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (n >= FUNC_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (ssize_t i = 0; i < n; ++i) {
-        uint8_t tmp = (ptr_comm[i] * 2 + ptr_self[i] + ptr_other[i] - ptr_new[i]) % 4;
-        switch (tmp) {
-        case 0:
-            ptr_phase[i] = std::complex<double>(1.0, 0.0);
-            break;
-        case 1:
-            ptr_phase[i] = std::complex<double>(0.0, -1.0);
-            break;
-        case 2:
-            ptr_phase[i] = std::complex<double>(-1.0, 0.0);
-            break;
-        case 3:
-            ptr_phase[i] = std::complex<double>(0.0, 1.0);
-            break;
+    {
+        py::gil_scoped_release release;
+        z2r::compose(void_view(buf_z1), void_view(buf_x1), void_view(buf_z2), void_view(buf_x2),
+                     mutable_void_view(buf_new_z), mutable_void_view(buf_new_x),
+                     {static_cast<std::complex<double> *>(buf_phase.ptr),
+                      static_cast<size_t>(buf_phase.size)});
+    } // GIL reacquired here
+
+    return py::make_tuple(new_z, new_x, phase_power);
+}
+
+/**
+ * @brief Batched compose(): composes (z1s[i], x1s[i]) with (z2s[i], x2s[i]), for every i, in a
+ * single call. All of the compositions are validated first, then computed together without the
+ * GIL, so that the cost of a call is paid once per batch rather than once per composition. See
+ * z2r::compose_many().
+ *
+ * @note The arrays do not need to be contiguous. The outputs are views into a few shared buffers.
+ *
+ * @param z1s
+ * @param x1s
+ * @param z2s
+ * @param x2s
+ * @return py::list A (new_z, new_x, phase_power) tuple per composition, as returned by compose()
+ */
+py::list compose_many(const std::vector<py::array> &z1s, const std::vector<py::array> &x1s,
+                      const std::vector<py::array> &z2s, const std::vector<py::array> &x2s) {
+    size_t n = z1s.size();
+    if (x1s.size() != n || z2s.size() != n || x2s.size() != n) {
+        throw std::runtime_error("There must be as many arrays of each kind.");
+    }
+    std::vector<py::array> inputs;
+    std::vector<py::buffer_info> bufs;
+    std::vector<py::dtype> void_dtypes;
+    std::vector<py::dtype> phase_dtypes(n, py::dtype::of<std::complex<double>>());
+    std::vector<std::vector<ssize_t>> shapes;
+    inputs.reserve(4 * n);
+    bufs.reserve(4 * n);
+    void_dtypes.reserve(2 * n);
+    shapes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (const py::array *arr : {&z1s[i], &x1s[i], &z2s[i], &x2s[i]}) {
+            inputs.push_back(c_contiguous(*arr));
+            bufs.push_back(inputs.back().request());
         }
+        void_dtypes.push_back(inputs[4 * i].dtype());
+        void_dtypes.push_back(inputs[4 * i + 1].dtype());
+        shapes.push_back(bufs[4 * i].shape);
     }
-    return py::make_tuple(new_z, new_x, phase_power);
+
+    std::vector<std::vector<ssize_t>> void_shapes;
+    void_shapes.reserve(2 * n);
+    for (const std::vector<ssize_t> &shape : shapes) {
+        void_shapes.push_back(shape);
+        void_shapes.push_back(shape);
+    }
+    std::vector<py::array> new_zx = batch_outputs(void_dtypes, void_shapes);
+    std::vector<py::array> phases = batch_outputs(phase_dtypes, shapes);
+
+    std::vector<z2r::ComposeTask> tasks(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto buf_phase = phases[i].request();
+        tasks[i] = {void_view(bufs[4 * i]),
+                    void_view(bufs[4 * i + 1]),
+                    void_view(bufs[4 * i + 2]),
+                    void_view(bufs[4 * i + 3]),
+                    mutable_void_view(new_zx[2 * i].request()),
+                    mutable_void_view(new_zx[2 * i + 1].request()),
+                    {static_cast<std::complex<double> *>(buf_phase.ptr),
+                     static_cast<size_t>(buf_phase.size)}};
+    }
+
+    {
+        py::gil_scoped_release release;
+        z2r::compose_many(tasks);
+    } // GIL reacquired here
+
+    py::list result;
+    for (size_t i = 0; i < n; ++i) {
+        result.append(py::make_tuple(new_zx[2 * i], new_zx[2 * i + 1], phases[i]));
+    }
+    return result;
 }
 
 /**
- * @brief Operates on two arrays of Pauli operators and returns a boolean vector indicating which
- * qubits commute between the two arrays.
+ * @brief Operates on two arrays of Pauli operators and returns a boolean array indicating which
+ * pairs of Pauli strings commute qubit-wise. See z2r::commute_with().
  *
  * @param z1
  * @param x1
@@ -156,31 +199,28 @@ py::tuple compose(py::array z1, py::array x1, py::array z2, py::array x2) {
  * @return py::array_t<bool>
  */
 py::array_t<bool> bitwise_commute_with(py::array z1, py::array x1, py::array z2, py::array x2) {
-    py::array ovlp_1 = bitwise_and(z1, x2);
-    py::array ovlp_2 = bitwise_and(x1, z2);
-    py::array ovlp_3 = bitwise_xor(ovlp_1, ovlp_2);
+    auto buf_z1 = z1.request();
+    auto buf_x1 = x1.request();
+    auto buf_z2 = z2.request();
+    auto buf_x2 = x2.request();
 
-    size_t num_qubits = ovlp_3.request().size;
-    py::array_t<bool> result = py::array_t<bool>(num_qubits);
+    py::array_t<bool> result = py::array_t<bool>(buf_z1.shape);
     auto buf_result = result.request();
-    auto ptr_result = static_cast<bool *>(buf_result.ptr);
 
-    auto buf1 = ovlp_3.request();
-    const uint8_t *ptr1 = static_cast<const uint8_t *>(buf1.ptr);
-    size_t n = buf1.size;
+    {
+        py::gil_scoped_release release;
+        z2r::commute_with(void_view(buf_z1), void_view(buf_x1), void_view(buf_z2),
+                          void_view(buf_x2),
+                          {static_cast<bool *>(buf_result.ptr), static_cast<size_t>(buf_z1.size)});
+    } // GIL reacquired here
 
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (n >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t i = 0; i < n; ++i) {
-        ptr_result[i] = ptr1[i] == 0;
-    }
-    return result.reshape(z1.request().shape);
+    return result;
 }
 
 /**
  * @brief Generates random Z and X strings of given shape.
- * @attention This function exists mainly for testing purposes.
+ * @attention This function exists mainly for testing purposes. It is single-threaded and returns
+ * unpacked booleans; use random_zx_voids() to generate large arrays.
  *
  * @param shape
  * @return py::tuple Returns a tuple of (z_strings, x_strings), which are both
@@ -219,9 +259,55 @@ py::tuple random_zx_strings(const std::vector<size_t> &shape) { //, size_t num_q
     return py::make_tuple(z_strings, x_strings);
 }
 
+/**
+ * @brief Generates random Z and X voids of given shape, directly in their packed form. See
+ * z2r::random_zx_voids(): the result for a given seed is reproducible, and independent of the
+ * number of OpenMP threads.
+ *
+ * @param shape Shape of the output arrays
+ * @param itemsize Number of bytes of each void
+ * @param num_qubits Number of random qubits. Bits past num_qubits are zero. Defaults to all bits.
+ * @param weight Number of non-identity qubits of each Pauli string. Defaults to a random weight.
+ * @param seed Seed of the generator. A random one is drawn when none is given.
+ * @return py::tuple Returns a tuple of (z_voids, x_voids), both of dtype |V{itemsize}
+ */
+py::tuple random_zx_voids(const std::vector<ssize_t> &shape, size_t itemsize, int64_t num_qubits,
+                          int64_t weight, std::optional<uint64_t> seed) {
+    if (itemsize == 0) {
+        throw std::runtime_error("itemsize must be at least 1 byte.");
+    }
+    size_t n_bits = (num_qubits >= 0) ? static_cast<size_t>(num_qubits) : itemsize * 8;
+    uint64_t seed_value = seed.has_value() ? *seed : std::random_device{}();
+
+    py::dtype out_dtype("|V" + std::to_string(itemsize));
+    py::array z_voids = output_array(out_dtype, shape);
+    py::array x_voids = output_array(out_dtype, shape);
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::random_zx_voids(n_bits, weight, seed_value, mutable_void_view(buf_z),
+                             mutable_void_view(buf_x));
+    } // GIL reacquired here
+
+    return py::make_tuple(z_voids, x_voids);
+}
+
+/**
+ * @brief Copies a vector of indices into a new int64 array.
+ */
+static py::array_t<int64_t> int64_array(const std::vector<int64_t> &values) {
+    py::array_t<int64_t> out(static_cast<ssize_t>(values.size()));
+    if (!values.empty()) {
+        std::memcpy(out.mutable_data(), values.data(), values.size() * sizeof(int64_t));
+    }
+    return out;
+}
+
 /**
  * @brief Finds the unique rows in a Z2R array. Functions similarly to numpy.unique, but with
- * no axis parameter.
+ * no axis parameter. See z2r::unique().
  * @deprecated Use unordered_unique() instead for better performance (3x-15x) on the vast majority
  * of use cases.
  *
@@ -239,123 +325,33 @@ py::object unique(py::array z2r, bool return_index, bool return_inverse, bool re
             t[0] = z2r;
             int pos = 1;
             if (return_index) {
-                py::array_t<int64_t> arr_idx(1);
-                auto ib = arr_idx.request();
-                int64_t *iptr = static_cast<int64_t *>(ib.ptr);
-                iptr[0] = 0;
-                t[pos++] = arr_idx;
+                t[pos++] = int64_array({0});
             }
             if (return_inverse) {
-                py::array_t<int64_t> arr_inv(1);
-                auto rb = arr_inv.request();
-                int64_t *rptr = static_cast<int64_t *>(rb.ptr);
-                rptr[0] = 0;
-                t[pos++] = arr_inv;
+                t[pos++] = int64_array({0});
             }
             if (return_counts) {
-                py::array_t<int64_t> arr_cnt(1);
-                auto cb = arr_cnt.request();
-                int64_t *cptr = static_cast<int64_t *>(cb.ptr);
-                cptr[0] = 1;
-                t[pos++] = arr_cnt;
+                t[pos++] = int64_array({1});
             }
             return t;
         }
         return z2r;
     }
 
-    size_t n = buf.size;            // number of elements (
-    size_t itemsize = buf.itemsize; // bytes per element
-    auto ptr = static_cast<uint8_t *>(buf.ptr);
-
-    std::vector<size_t> idx(n);
-    std::iota(idx.begin(), idx.end(), 0);
-
-    // comparator: lexicographic bytes
-    auto cmp = [&](size_t a, size_t b) {
-        const void *pa = ptr + a * itemsize;
-        const void *pb = ptr + b * itemsize;
-        int row = std::memcmp(pa, pb, itemsize);
-        if (row != 0)
-            return row < 0;
-        return a < b;
-    };
-
-    std::sort(idx.begin(), idx.end(), cmp);
-
-    std::vector<size_t> group_of(n);
-    std::vector<size_t> representatives;
-    representatives.reserve(n);
-    std::vector<int64_t> counts;
-    counts.reserve(n);
-
-    size_t groups = 0;
-    for (size_t sorted_pos = 0; sorted_pos < n; ++sorted_pos) {
-        size_t cur = idx[sorted_pos];
-        if (sorted_pos == 0) {
-            representatives.push_back(cur);
-            counts.push_back(1);
-            group_of[cur] = 0;
-            groups = 1;
-        } else {
-            size_t prev = idx[sorted_pos - 1];
-            if (std::memcmp(ptr + prev * itemsize, ptr + cur * itemsize, itemsize) == 0) {
-                // same group
-                counts.back() += 1;
-                group_of[cur] = groups - 1;
-                if (cur < representatives.back())
-                    representatives.back() = cur;
-            } else {
-                // new group
-                representatives.push_back(cur);
-                counts.push_back(1);
-                group_of[cur] = groups;
-                groups += 1;
-            }
-        }
-    }
-
-    // Build unique array (sorted order = order of groups as encountered)
-    std::vector<ssize_t> unique_shape = {(ssize_t)groups};
-    py::array unique = py::array(z2r.dtype(), unique_shape);
-    auto ubuf = unique.request();
-    uint8_t *uptr = static_cast<uint8_t *>(ubuf.ptr);
+    VoidView voids = void_view(buf);
+    z2r::UniqueVoids result;
+    {
+        py::gil_scoped_release release;
+        result = z2r::unique(voids);
+    } // GIL reacquired here
 
+    // The unique voids, in sorted order, are copies of the first occurrence of each group
+    size_t groups = result.index.size();
+    std::vector<ssize_t> unique_shape = {static_cast<ssize_t>(groups)};
+    py::array unique = output_array(z2r.dtype(), unique_shape);
+    uint8_t *uptr = static_cast<uint8_t *>(unique.request().ptr);
     for (size_t gi = 0; gi < groups; ++gi) {
-        // find any element belonging to group gi -> we can use representatives[gi]
-        // (original index), but we must copy the representative's bytes (they equal
-        // the group's bytes)
-        size_t rep_orig_index = representatives[gi];
-        std::memcpy(uptr + gi * itemsize, ptr + rep_orig_index * itemsize, itemsize);
-    }
-
-    // build optional outputs
-    py::array_t<int64_t> py_indices;
-    py::array_t<int64_t> py_inverse;
-    py::array_t<int64_t> py_counts;
-
-    if (return_index) {
-        py_indices = py::array_t<int64_t>(groups);
-        auto ib = py_indices.request();
-        int64_t *iptr = static_cast<int64_t *>(ib.ptr);
-        for (size_t gi = 0; gi < groups; ++gi)
-            iptr[gi] = (int64_t)representatives[gi];
-    }
-
-    if (return_inverse) {
-        py_inverse = py::array_t<int64_t>(n);
-        auto rb = py_inverse.request();
-        int64_t *rptr = static_cast<int64_t *>(rb.ptr);
-        for (size_t orig = 0; orig < n; ++orig)
-            rptr[orig] = (int64_t)group_of[orig];
-    }
-
-    if (return_counts) {
-        py_counts = py::array_t<int64_t>(groups);
-        auto cb = py_counts.request();
-        int64_t *cptr = static_cast<int64_t *>(cb.ptr);
-        for (size_t gi = 0; gi < groups; ++gi)
-            cptr[gi] = counts[gi];
+        std::memcpy(uptr + gi * voids.itemsize, voids.row(result.index[gi]), voids.itemsize);
     }
 
     if (return_index || return_inverse || return_counts) {
@@ -364,31 +360,20 @@ py::object unique(py::array z2r, bool return_index, bool return_inverse, bool re
         int pos = 0;
         ret[pos++] = unique;
         if (return_index)
-            ret[pos++] = py_indices;
+            ret[pos++] = int64_array(result.index);
         if (return_inverse)
-            ret[pos++] = py_inverse;
+            ret[pos++] = int64_array(result.inverse);
         if (return_counts)
-            ret[pos++] = py_counts;
+            ret[pos++] = int64_array(result.counts);
         return ret;
     }
     return unique;
 }
 
-// TODO: See if xxhash is faster than std::hash for this use case
-//  #include "xxhash/xxhash.h"
-//  struct XXH3StringViewHash {
-//      size_t operator()(const std::string_view& s) const noexcept {
-//          return static_cast<size_t>(XXH3_64bits(s.data(), s.size()));
-//      }
-//  };
-
 /**
  * @brief This function finds unique rows in a NumPy 2D array by mapping the z2r to a hashmap.
  * Thus, two identical rows will be encoded to the same key via the hashing function and ensures
- * a fast execution time.
- * @todo Benchmark current std hashmap implementation against others.
- * (e.g. robin-hood-hashing, google dense-hash-map, etc).
- * Also benchmark std hashing function against other non-cryptographic ones. (e.g xxhash).
+ * a fast execution time. See z2r::unordered_unique().
  *
  * @attention Does not work for dimensions higher than 2.
  * @param z2r Both Z and X voids stiched together
@@ -397,177 +382,47 @@ py::object unique(py::array z2r, bool return_index, bool return_inverse, bool re
  * Inverse is the indices to remake the input array from only its unique elements.
  */
 py::tuple unordered_unique(py::array z2r) {
-
     auto buf = z2r.request();
     if (buf.ndim == 0) {
-        py::array_t<int64_t> idx(1);
-        py::array_t<int64_t> inv(1);
-        auto ib = idx.request();
-        auto rb = inv.request();
-        int64_t *ip = static_cast<int64_t *>(ib.ptr);
-        int64_t *rp = static_cast<int64_t *>(rb.ptr);
-        ip[0] = 0;
-        rp[0] = 0;
-        return py::make_tuple(idx, inv);
+        return py::make_tuple(int64_array({0}), int64_array({0}));
     }
 
-    const uint8_t *base = static_cast<const uint8_t *>(buf.ptr);
+    // The key of a row of a 2D array is all of its voids
     const size_t nrows = static_cast<size_t>(buf.shape[0]);
     const size_t row_bytes = (buf.ndim > 1) ? static_cast<size_t>(std::llabs(buf.strides[0]))
                                             : static_cast<size_t>(buf.itemsize);
+    VoidView rows(static_cast<const uint8_t *>(buf.ptr), nrows, row_bytes);
 
-    std::vector<std::string_view> keys;
-    keys.resize(nrows);
-
-    // these need to be out of the GIL scope to survive the release
-    std::vector<size_t> indices;
-    indices.reserve(nrows);
-    std::vector<size_t> inverses(nrows);
-
+    z2r::UniqueVoids result;
     {
         py::gil_scoped_release release;
-
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (nrows >= FUNC_THRESHOLD_PARALLEL) schedule(static)
-#endif
-        for (size_t i = 0; i < nrows; ++i) {
-            const char *ptr = reinterpret_cast<const char *>(base + i * row_bytes);
-            keys[i] = std::string_view(ptr, row_bytes);
-        }
-
-        std::unordered_map<std::string_view, size_t> table;
-        // std::unordered_map seems to be poor in performance (according to the internet)
-        // Perhaps we should be using another container implementation?
-        // See: https://martin.ankerl.com/2022/08/27/hashmap-bench-01/
-        table.max_load_factor(0.5);
-        // std::unordered_map<std::string_view, size_t, XXH3StringViewHash> table;
-        table.reserve(nrows);
-
-        for (size_t i = 0; i < nrows; ++i) {
-            const auto &key = keys[i];
-            auto it = table.find(key);
-            if (it != table.end()) {
-                inverses[i] = it->second;
-            } else {
-                size_t new_id = indices.size();
-                table.try_emplace(key, new_id);
-                indices.push_back(i);
-                inverses[i] = new_id;
-            }
-        }
+        result = z2r::unordered_unique(rows);
     } // GIL reacquired here
 
-    // Build numpy outputs
-    py::array_t<int64_t> py_indices(indices.size());
-    auto ib = py_indices.request();
-    int64_t *iptr = static_cast<int64_t *>(ib.ptr);
-    for (size_t k = 0; k < indices.size(); ++k)
-        iptr[k] = static_cast<int64_t>(indices[k]);
-
-    py::array_t<int64_t> py_inverse(nrows);
-    auto rb = py_inverse.request();
-    int64_t *rptr = static_cast<int64_t *>(rb.ptr);
-    for (size_t i = 0; i < nrows; ++i)
-        rptr[i] = static_cast<int64_t>(inverses[i]);
-
-    return py::make_tuple(py_indices, py_inverse);
+    return py::make_tuple(int64_array(result.index), int64_array(result.inverse));
 }
 
 /**
- * @brief applies Gauss-Jordan elimination on a binary matrix to produce row echelon form.
- * @todo Optimize this function!
+ * @brief applies Gauss-Jordan elimination on a binary matrix to produce row echelon form. See
+ * z2r::row_echelon().
  *
  * @param voids
  * @param num_qubits
  * @return py::array
  */
 py::array row_echelon(py::array voids, int num_qubits) {
+    if (num_qubits < 0) {
+        throw std::runtime_error("num_qubits must be non-negative.");
+    }
     auto buf = voids.request();
-
-    size_t n_rows = buf.size;
-    size_t n_cols = num_qubits;
-
-    py::array voids_out = py::array(voids.dtype(), buf.shape);
+    py::array voids_out = output_array(voids.dtype(), buf.shape);
     auto buf_out = voids_out.request();
 
-    const uint8_t *ptr_in = std::bit_cast<const uint8_t *>(buf.ptr);
-    uint8_t *ptr_out = std::bit_cast<uint8_t *>(buf_out.ptr);
-
-    // Copy input to output
-    std::memcpy(ptr_out, ptr_in, buf.size * buf.itemsize);
-
-    size_t h_row = 0;
-    size_t k_col = 0;
-
-    //     while h_row < n_rows and k_col < n_cols:
-    //         if np.all(re_bit_matrix[h_row:, k_col] == 0):
-    //             k_col += 1
-    //         else:
-    //             i_row = h_row + np.argmax(re_bit_matrix[h_row:, k_col])
-    //             if i_row != h_row:
-    //                 re_bit_matrix[[i_row, h_row], :] = re_bit_matrix[[h_row, i_row], :]
-
-    //             cond_rows = np.logical_and(re_bit_matrix[:, k_col], (row_range != h_row))
-
-    //             re_bit_matrix[cond_rows, :] = np.logical_xor(re_bit_matrix[cond_rows, :],
-    //             re_bit_matrix[h_row, :][None, :])
-
-    //             h_row += 1
-    //             k_col += 1
-
-    //     return re_bit_matrix
-
-    // TODO: Optimize!
-    while (h_row < n_rows && k_col < n_cols) {
-        int found_nonzero = 0;
-        for (size_t row = h_row; row < n_rows; row++) {
-            size_t byte_idx = k_col / 8;
-            size_t bit_idx = k_col % 8;
-            uint8_t bit = (ptr_out[row * buf.itemsize + byte_idx] >> bit_idx) & 1;
-            if (bit) {
-                found_nonzero = 1;
-                break;
-            }
-        }
-        if (!found_nonzero) {
-            k_col += 1;
-        } else {
-            // Find pivot row
-            size_t i_row = h_row;
-            for (size_t row = h_row; row < n_rows; row++) {
-                size_t byte_idx = k_col / 8;
-                size_t bit_idx = k_col % 8;
-                uint8_t bit = (ptr_out[row * buf.itemsize + byte_idx] >> bit_idx) & 1;
-                if (bit) {
-                    i_row = row;
-                    break;
-                }
-            }
-            // Swap rows if needed
-            if (i_row != h_row) {
-                for (size_t b = 0; b < buf.itemsize; b++) {
-                    std::swap(ptr_out[i_row * buf.itemsize + b], ptr_out[h_row * buf.itemsize + b]);
-                }
-            }
-
-            // Eliminate other rows
-            for (size_t row = 0; row < n_rows; row++) {
-                if (row != h_row) {
-                    size_t byte_idx = k_col / 8;
-                    size_t bit_idx = k_col % 8;
-                    uint8_t bit = (ptr_out[row * buf.itemsize + byte_idx] >> bit_idx) & 1;
-                    if (bit) {
-                        // XOR rows
-                        for (size_t b = 0; b < buf.itemsize; b++) {
-                            ptr_out[row * buf.itemsize + b] ^= ptr_out[h_row * buf.itemsize + b];
-                        }
-                    }
-                }
-            }
-            h_row++;
-            k_col++;
-        }
-    }
+    {
+        py::gil_scoped_release release;
+        z2r::row_echelon(void_view(buf), static_cast<size_t>(num_qubits),
+                         mutable_void_view(buf_out));
+    } // GIL reacquired here
 
     return voids_out;
 }
@@ -675,7 +530,7 @@ std::vector<std::complex<double>> get_phases(py::array z_voids, py::array x_void
 //         return matrix
 // todo: Check return type of operator::to_matrix()
 /**
- * @brief Converts two arrays of Z2Rs into a dense matrix representation.
+ * @brief Converts two arrays of Z2Rs into a dense matrix representation. See z2r::to_matrix().
  *
  * @attention This function is mainly for testing purposes.
  *
@@ -686,29 +541,21 @@ std::vector<std::complex<double>> get_phases(py::array z_voids, py::array x_void
 py::array_t<std::complex<double>> to_matrix(py::array z_voids, py::array x_voids, int num_qubits) {
     auto buf_z = z_voids.request();
     auto buf_x = x_voids.request();
+    // Checked before the 4^num_qubits elements are allocated
+    if (num_qubits < 0 || num_qubits > 30) {
+        throw std::runtime_error("num_qubits must be in [0, min(30, itemsize * 8)].");
+    }
 
-    size_t n_rows = buf_z.shape[0];
-    size_t n_cols = num_qubits;
-
+    size_t dim = size_t{1} << num_qubits;
     py::array_t<std::complex<double>> matrix(
-        {static_cast<ssize_t>(1 << n_cols), static_cast<ssize_t>(1 << n_cols)});
-    auto buf_mat = matrix.request();
-    auto ptr_mat = static_cast<std::complex<double> *>(buf_mat.ptr);
+        {static_cast<ssize_t>(dim), static_cast<ssize_t>(dim)});
+    auto ptr_mat = static_cast<std::complex<double> *>(matrix.request().ptr);
 
-    std::memset(buf_mat.ptr, 0, buf_mat.size * buf_mat.itemsize);
-
-    for (size_t idx = 0; idx < n_rows; ++idx) {
-        py::array z_row = z_voids[py::int_(idx)];
-        py::array x_row = x_voids[py::int_(idx)];
-
-        auto [row_ind, col_ind, matrix_elements] = sparse_matrix_from_z2r(z_row, x_row, num_qubits);
-
-        for (size_t k = 0; k < row_ind.size(); ++k) {
-            size_t row = row_ind[k];
-            size_t c = col_ind[k];
-            ptr_mat[row * (1 << n_cols) + c] += matrix_elements[k];
-        }
-    }
+    {
+        py::gil_scoped_release release;
+        z2r::to_matrix(void_view(buf_z), void_view(buf_x), static_cast<size_t>(num_qubits),
+                       {ptr_mat, dim * dim});
+    } // GIL reacquired here
 
     return matrix;
 }
@@ -779,36 +626,10 @@ py::array transpose(py::array voids, int64_t num_bits) {
         "|V" + std::to_string(out_bytes); // a revisiter, peux etre pas necessaire
     py::dtype out_dtype(dtype_str);
     std::vector<ssize_t> out_shape = {static_cast<ssize_t>(N_bits)};
-    py::array z2r_out = py::array(out_dtype, out_shape);
+    py::array z2r_out = output_array(out_dtype, out_shape);
     auto buf_out = z2r_out.request();
 
-    const uint8_t *ptr_in = std::bit_cast<const uint8_t *>(buf.ptr);
-    uint8_t *ptr_out = std::bit_cast<uint8_t *>(buf_out.ptr);
-
-    // Initialize output to zero
-    std::memset(ptr_out, 0, N_bits * out_bytes);
-
-    // Transpose: bit j of element i becomes bit i of element j
-#ifdef USE_OPENMP
-    #pragma omp parallel for if (N_bits * M >= BOPS_THRESHOLD_PARALLEL) schedule(static)
-#endif
-    for (size_t j = 0; j < N_bits; ++j) {
-        size_t byte_idx_in = j / 8;
-        size_t bit_idx_in = j % 8;
-
-        for (size_t i = 0; i < M; ++i) {
-            // Get bit j from element i
-            uint8_t bit = (ptr_in[i * buf.itemsize + byte_idx_in] >> bit_idx_in) & 1;
-
-            // Set bit i in element j of output
-            size_t byte_idx_out = i / 8;
-            size_t bit_idx_out = i % 8;
-
-            if (bit) {
-                ptr_out[j * out_bytes + byte_idx_out] |= (1 << bit_idx_out);
-            }
-        }
-    }
+    z2r::transpose(void_view(buf), N_bits, mutable_void_view(buf_out));
 
     return z2r_out;
 }
@@ -829,18 +650,8 @@ py::array matmul(py::array z2r_a, py::array z2r_b, int a_num_qubits, int b_num_q
 
     size_t a_rows = buf1.size;
     size_t a_cols = a_num_qubits; // Number of bits per element in void
-    size_t b_rows = buf2.size;
     size_t b_cols = b_num_qubits; // Number of bits per element in void
 
-    std::cout << "A shape: (" << a_rows << ", " << a_cols << ")\n";
-    std::cout << "B shape: (" << b_rows << ", " << b_cols << ")\n";
-
-    if (a_cols != b_rows) {
-        throw std::runtime_error("Shape mismatch for matrix multiplication: A columns (" +
-                                 std::to_string(a_cols) + ") must equal B rows (" +
-                                 std::to_string(b_rows) + ").");
-    }
-
     size_t out_bytes = (b_cols + 7) / 8;
     std::string dtype_str =
         "|V" + std::to_string(out_bytes); // a revisiter, peux etre pas necessaire
@@ -848,41 +659,14 @@ py::array matmul(py::array z2r_a, py::array z2r_b, int a_num_qubits, int b_num_q
 
     // output is 1-D array of a_rows elements, each a void of out_bytes
     std::vector<ssize_t> out_shape = {static_cast<ssize_t>(a_rows)};
-    py::array z2r_out = py::array(out_dtype, out_shape);
+    py::array z2r_out = output_array(out_dtype, out_shape);
     auto buf_out = z2r_out.request();
 
-    std::memset(buf_out.ptr, 0, buf_out.size * buf_out.itemsize);
-    // Output array with shape (a_rows, b_cols)
-
-    const uint8_t *ptr_a = std::bit_cast<const uint8_t *>(buf1.ptr);
-    const uint8_t *ptr_b = std::bit_cast<const uint8_t *>(buf2.ptr);
-    int8_t *ptr_out = std::bit_cast<int8_t *>(buf_out.ptr);
-
-    // TODO: Parallelize this whole block
-    for (size_t i = 0; i < a_rows; i++) {
-        for (size_t j = 0; j < b_cols; j++) {
-            int8_t bit_sum = 0;
-            for (size_t k = 0; k < a_cols; k++) {
-                // Get bit k of row i in A
-                size_t a_byte_idx = k / 8;
-                size_t a_bit_idx = k % 8;
-                uint8_t a_bit = (ptr_a[i * buf1.itemsize + a_byte_idx] >> a_bit_idx) & 1;
-
-                // Get bit j of row k in B
-                size_t b_byte_idx = j / 8;
-                size_t b_bit_idx = j % 8;
-                uint8_t b_bit = (ptr_b[k * buf2.itemsize + b_byte_idx] >> b_bit_idx) & 1;
-
-                bit_sum += a_bit & b_bit;
-            }
-            // Set bit j of row i in output
-            size_t out_byte_idx = j / 8;
-            size_t out_bit_idx = j % 8;
-            if (bit_sum % 2) { // Modulo 2 for bitwise addition
-                ptr_out[i * buf_out.itemsize + out_byte_idx] |= (1 << out_bit_idx);
-            }
-        }
-    }
+    {
+        py::gil_scoped_release release;
+        z2r::matmul(void_view(buf1), void_view(buf2), a_cols, b_cols, mutable_void_view(buf_out));
+    } // GIL reacquired here
+
     return z2r_out;
 }
 
@@ -1050,7 +834,7 @@ py::array_t<uint8_t> z2_to_uint8(py::array z2r, int num_bits) {
  * - It is inconsistant with its dtype and num_qubits
  * - It is is singular, i.e inatly does not have a inverse
  * If an input is bad, a runtime error will be thrown and function exited.
- * @todo rename function variables to something less terrible
+ * @see batched_gauss_jordan_inverse() to invert many matrices at once.
  * @attention This function was only lightly tested. Use with caution.
  * @param z2r
  * @param num_bits
@@ -1061,73 +845,676 @@ py::array gauss_jordan_inverse(py::array z2r, int num_bits) {
     if (buf.ndim != 1) {
         throw std::runtime_error("gauss_jordan_inverse expects 1D z2r array of voids.");
     }
-    ssize_t n = buf.shape[0];
-    if (num_bits != n) {
-        // Require square (n x n) bit matrix
+    if (num_bits < 0) {
         throw std::runtime_error("num_bits must equal number of rows (square matrix).");
     }
-    size_t itemsize = buf.itemsize;
-    if ((size_t)num_bits > itemsize * 8) {
+    py::array inverse = output_array(z2r.dtype(), buf.shape);
+    auto buf_inv = inverse.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::gauss_jordan_inverse(void_view(buf), static_cast<size_t>(num_bits),
+                                  mutable_void_view(buf_inv));
+    } // GIL reacquired here
+
+    return inverse;
+}
+
+/**
+ * @brief Inverts a whole stack of binary matrices with Gauss-Jordan elimination. Singular matrices
+ * do not throw; they are flagged and their inverse is left zeroed. See
+ * z2r::batched_gauss_jordan_inverse().
+ *
+ * @param matrices Array of voids of shape (..., num_bits). Each void is one row of a matrix, and
+ * the last axis stacks the rows of one matrix.
+ * @param num_bits Size n of the n x n matrices
+ * @return py::tuple Returns (inverses, singular). inverses has the shape and dtype of matrices, and
+ * singular is a bool array of shape matrices.shape[:-1]
+ */
+py::tuple batched_gauss_jordan_inverse(py::array matrices, int num_bits) {
+    auto buf = matrices.request();
+    if (buf.ndim < 1 || buf.shape.back() != num_bits) {
+        throw std::runtime_error("The last axis of matrices must have num_bits rows.");
+    }
+    if (num_bits <= 0) {
         throw std::runtime_error("num_bits exceeds bit capacity of row dtype.");
     }
 
-    py::array A = py::array(z2r.dtype(), buf.shape);
-    auto bufA = A.request();
-    std::memcpy(bufA.ptr, buf.ptr, buf.size * buf.itemsize);
-    uint8_t *Aptr = static_cast<uint8_t *>(bufA.ptr);
-
-    // identity crisis
-    py::array Inv = py::array(z2r.dtype(), buf.shape);
-    auto bufInv = Inv.request();
-    uint8_t *Iptr = static_cast<uint8_t *>(bufInv.ptr);
-    std::memset(Iptr, 0, bufInv.size * bufInv.itemsize);
-    for (ssize_t row = 0; row < n; ++row) {
-        ssize_t byte_idx = row / 8;
-        int bit_idx = row % 8;
-        Iptr[row * itemsize + byte_idx] |= (1u << bit_idx);
+    py::array inverses = output_array(matrices.dtype(), buf.shape);
+    std::vector<ssize_t> flag_shape(buf.shape.begin(), buf.shape.end() - 1);
+    py::array_t<bool> singular(flag_shape);
+    auto buf_inv = inverses.request();
+    auto buf_sing = singular.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::batched_gauss_jordan_inverse(
+            void_view(buf), static_cast<size_t>(num_bits), mutable_void_view(buf_inv),
+            {static_cast<bool *>(buf_sing.ptr), static_cast<size_t>(buf_sing.size)});
+    } // GIL reacquired here
+
+    return py::make_tuple(inverses, singular);
+}
+
+/**
+ * @brief Extracts an arbitrary list of qubits (bits) from every void of an array. Output bit j is
+ * input bit indices[j], so the indices may be given in any order. Apply it to both the z and x
+ * voids to restrict Pauli strings to a subsystem. See z2r::get_qubit_slices().
+ *
+ * @param voids Input array, of any shape
+ * @param indices The qubits to extract
+ * @return py::array Array of the same shape as the input, with the smallest dtype |V{N} holding
+ * len(indices) bits
+ */
+py::array get_qubit_slices(py::array voids, const std::vector<int64_t> &indices) {
+    auto buf = voids.request();
+    size_t out_itemsize = std::max<size_t>((indices.size() + 7) / 8, 1);
+    py::array voids_out = output_array(py::dtype("|V" + std::to_string(out_itemsize)), buf.shape);
+    auto buf_out = voids_out.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::get_qubit_slices(void_view(buf), indices, mutable_void_view(buf_out));
+    } // GIL reacquired here
+
+    return voids_out;
+}
+
+/**
+ * @brief Applies a qubit permutation to every void of an array, such that new qubit i is old
+ * qubit permutation[i]. Bits past len(permutation) (padding) are left untouched. See
+ * z2r::permute_qubits().
+ *
+ * @param voids Input array, of any shape
+ * @param permutation A permutation of range(num_qubits)
+ * @return py::array Array of the same shape and dtype as the input
+ */
+py::array permute_qubits(py::array voids, const std::vector<int64_t> &permutation) {
+    auto buf = voids.request();
+    py::array voids_out = output_array(voids.dtype(), buf.shape);
+    auto buf_out = voids_out.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::permute_qubits(void_view(buf), permutation, mutable_void_view(buf_out));
+    } // GIL reacquired here
+
+    return voids_out;
+}
+
+/**
+ * @brief Inserts narrow voids into wider ones at given qubit positions. This is the inverse of
+ * get_qubit_slices(): bit j of sub_voids is written to bit indices[j] of voids. All other bits are
+ * copied from voids. If an index is repeated, the last write wins. See z2r::set_qubit_slices().
+ *
+ * @param voids The wide voids, of any shape
+ * @param sub_voids The narrow voids, with the same number of elements as voids
+ * @param indices Where to write each bit of sub_voids
+ * @return py::array A copy of voids with the given qubits replaced
+ */
+py::array set_qubit_slices(py::array voids, py::array sub_voids,
+                           const std::vector<int64_t> &indices) {
+    auto buf = voids.request();
+    auto buf_sub = sub_voids.request();
+    py::array voids_out = output_array(voids.dtype(), buf.shape);
+    auto buf_out = voids_out.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::set_qubit_slices(void_view(buf), void_view(buf_sub), indices,
+                              mutable_void_view(buf_out));
+    } // GIL reacquired here
+
+    return voids_out;
+}
+
+/**
+ * @brief Adapter of z2r::accumulate_products() for NumPy arrays, run without the GIL.
+ */
+static PauliAccumulator weighted_products(py::array zx_a, py::array_t<std::complex<double>> w_a,
+                                          py::array zx_b, py::array_t<std::complex<double>> w_b,
+                                          int num_qubits, bool anticommuting_only) {
+    if (num_qubits < 0) {
+        throw std::runtime_error("num_qubits must be non-negative.");
     }
+    auto buf_a = zx_a.request();
+    auto buf_b = zx_b.request();
+    auto buf_wa = w_a.request();
+    auto buf_wb = w_b.request();
+
+    py::gil_scoped_release release;
+    return z2r::accumulate_products(
+        void_view(buf_a),
+        {static_cast<const std::complex<double> *>(buf_wa.ptr), static_cast<size_t>(buf_wa.size)},
+        void_view(buf_b),
+        {static_cast<const std::complex<double> *>(buf_wb.ptr), static_cast<size_t>(buf_wb.size)},
+        static_cast<size_t>(num_qubits), anticommuting_only);
+}
 
-    // G-J here
-    for (int col = 0; col < num_bits; ++col) {
-        ssize_t pivot = -1;
-        ssize_t byte_idx = col / 8;
-        int bit_idx = col % 8;
-
-        // Find pivot
-        for (ssize_t row = col; row < n; ++row) {
-            uint8_t bit = (Aptr[row * itemsize + byte_idx] >> bit_idx) & 1u;
-            // uint8_t bit =
-            if (bit) {
-                pivot = row;
-                break;
-            }
-        }
-        if (pivot < 0) {
-            throw std::runtime_error("Matrix is singular (no pivot).");
-        }
+/**
+ * @brief Multiplies two weighted sums of Pauli strings, A = sum_i a_i P_i and B = sum_j b_j Q_j,
+ * and simplifies the result. See z2r::accumulate_products() for the algorithm.
+ *
+ * @param zx_a Z and X voids stitched together (Z bits [0, n), X bits [n, 2n)) of the terms of A
+ * @param w_a Weights of the terms of A
+ * @param zx_b Stitched voids of the terms of B, with the same dtype as zx_a
+ * @param w_b Weights of the terms of B
+ * @param num_qubits Number of qubits n
+ * @param tolerance Terms of the product with a weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights) of the unique terms of A * B, in no specific order
+ */
+py::tuple operator_product(py::array zx_a, py::array_t<std::complex<double>> w_a, py::array zx_b,
+                           py::array_t<std::complex<double>> w_b, int num_qubits,
+                           double tolerance) {
+    PauliAccumulator acc = weighted_products(zx_a, w_a, zx_b, w_b, num_qubits, false);
+    return accumulator_to_arrays(&acc, 1, zx_a.dtype(), tolerance);
+}
 
-        // Swap pivot row into position col
-        if (pivot != col) {
-            for (size_t b = 0; b < itemsize; ++b) {
-                std::swap(Aptr[pivot * itemsize + b], Aptr[col * itemsize + b]);
-                std::swap(Iptr[pivot * itemsize + b], Iptr[col * itemsize + b]);
+/**
+ * @brief Computes the commutator [A, B] = AB - BA of two weighted sums of Pauli strings. Only the
+ * anticommuting pairs of terms are composed (see z2r::accumulate_products()), so the commuting pairs
+ * cost a single symplectic product each and never need to cancel out.
+ *
+ * @param zx_a Z and X voids stitched together (Z bits [0, n), X bits [n, 2n)) of the terms of A
+ * @param w_a Weights of the terms of A
+ * @param zx_b Stitched voids of the terms of B, with the same dtype as zx_a
+ * @param w_b Weights of the terms of B
+ * @param num_qubits Number of qubits n
+ * @param tolerance Terms of the commutator with a weight of magnitude <= tolerance are dropped
+ * @param return_norm Only return the norm sqrt(sum_k |c_k|^2) of the commutator's weights
+ * @return py::object Returns (zx_voids, weights) of the unique terms of [A, B], in no specific
+ * order, or a float if return_norm is true
+ */
+py::object commutator(py::array zx_a, py::array_t<std::complex<double>> w_a, py::array zx_b,
+                      py::array_t<std::complex<double>> w_b, int num_qubits, double tolerance,
+                      bool return_norm) {
+    PauliAccumulator acc = weighted_products(zx_a, w_a, zx_b, w_b, num_qubits, true);
+    if (return_norm) {
+        double norm = 0.0;
+        for (size_t i = 0; i < acc.size(); ++i) {
+            if (std::abs(acc.weight(i)) > tolerance) {
+                norm += std::norm(acc.weight(i));
             }
         }
+        return py::float_(std::sqrt(norm));
+    }
+    return accumulator_to_arrays(&acc, 1, zx_a.dtype(), tolerance);
+}
 
-        // Eliminate other rows
-        for (ssize_t row = 0; row < n; ++row) {
-            if (row == col)
-                continue;
-            uint8_t bit = (Aptr[row * itemsize + byte_idx] >> bit_idx) & 1u;
-            if (bit) {
-                //
-                for (size_t b = 0; b < itemsize; ++b) {
-                    Aptr[row * itemsize + b] ^= Aptr[col * itemsize + b];
-                    //
-                    Iptr[row * itemsize + b] ^= Iptr[col * itemsize + b];
-                }
+/**
+ * @brief Sums the weights of identical Pauli strings and drops the negligible ones. See
+ * z2r::simplify() for the algorithm.
+ *
+ * @param zx_voids The Pauli strings (any void layout, only byte equality matters)
+ * @param weights One weight per Pauli string
+ * @param tolerance Terms with a summed weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights) of the unique terms, in no specific order
+ */
+py::tuple simplify(py::array zx_voids, py::array_t<std::complex<double>> weights,
+                   double tolerance) {
+    auto buf = zx_voids.request();
+    auto buf_w = weights.request();
+
+    std::vector<PauliAccumulator> partials;
+    {
+        py::gil_scoped_release release;
+        partials = z2r::simplify(void_view(buf), {static_cast<const std::complex<double> *>(buf_w.ptr),
+                                                  static_cast<size_t>(buf_w.size)});
+    } // GIL reacquired here
+
+    return accumulator_to_arrays(partials.data(), partials.size(), zx_voids.dtype(), tolerance);
+}
+
+/**
+ * @brief Assigns every Pauli string to one of `num_partitions` partitions, from its hash_void().
+ * Identical strings always land in the same partition, whatever the array they come from, so
+ * partitions can be simplified independently (e.g. chunk by chunk, through on-disk buckets).
+ *
+ * @param zx_voids The Pauli strings
+ * @param num_partitions The number of partitions
+ * @return py::array_t<int64_t> The partition of each Pauli string, in [0, num_partitions)
+ */
+py::array_t<int64_t> hash_partition(py::array zx_voids, int64_t num_partitions) {
+    if (num_partitions <= 0) {
+        throw std::runtime_error("num_partitions must be positive.");
+    }
+    auto buf = zx_voids.request();
+    py::array_t<int64_t> partitions(buf.size);
+    auto buf_out = partitions.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::hash_partition(void_view(buf), static_cast<uint64_t>(num_partitions),
+                            {static_cast<int64_t *>(buf_out.ptr), static_cast<size_t>(buf.size)});
+    } // GIL reacquired here
+
+    return partitions;
+}
+
+/**
+ * @brief The output array of a zx layout function: `out` when given, after checking that it can
+ * hold `shape` voids of `itemsize` bytes, a new array otherwise.
+ */
+static py::array zx_output(std::optional<py::array> out, const std::vector<ssize_t> &shape,
+                           size_t itemsize) {
+    if (!out) {
+        return output_array(py::dtype("|V" + std::to_string(itemsize)), shape);
+    }
+    ssize_t size = 1;
+    for (ssize_t dim : shape) {
+        size *= dim;
+    }
+    if (out->dtype().kind() != 'V' || static_cast<size_t>(out->itemsize()) != itemsize) {
+        throw std::runtime_error("out must be an array of |V" + std::to_string(itemsize) + ".");
+    }
+    if (out->size() != size) {
+        throw std::runtime_error("out must have " + std::to_string(size) + " elements.");
+    }
+    if (!(out->flags() & py::array::c_style) || !out->writeable()) {
+        throw std::runtime_error("out must be a writeable C-contiguous array.");
+    }
+    return *out;
+}
+
+static void check_num_qubits(int num_qubits) {
+    if (num_qubits < 0) {
+        throw std::runtime_error("num_qubits must be non-negative.");
+    }
+}
+
+/**
+ * @brief Splits stitched zx voids into Z and X voids. See z2r::split_zx().
+ *
+ * @param zx_voids The stitched voids
+ * @param num_qubits Number of qubits n
+ * @param z_out Optional output Z voids. When not given, they are allocated with (n + 7) / 8 bytes.
+ * @param x_out Optional output X voids, with the same itemsize as z_out
+ * @return py::tuple Returns (z_voids, x_voids), of the shape of zx_voids
+ */
+py::tuple split_zx(py::array zx_voids, int num_qubits, std::optional<py::array> z_out,
+                   std::optional<py::array> x_out) {
+    check_num_qubits(num_qubits);
+    auto buf = zx_voids.request();
+    size_t itemsize = z_out   ? static_cast<size_t>(z_out->itemsize())
+                      : x_out ? static_cast<size_t>(x_out->itemsize())
+                              : std::max<size_t>((static_cast<size_t>(num_qubits) + 7) / 8, 1);
+    py::array z_voids = zx_output(z_out, buf.shape, itemsize);
+    py::array x_voids = zx_output(x_out, buf.shape, itemsize);
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::split_zx(void_view(buf), num_qubits, mutable_void_view(buf_z),
+                      mutable_void_view(buf_x));
+    } // GIL reacquired here
+
+    return py::make_tuple(z_voids, x_voids);
+}
+
+/**
+ * @brief Stitches Z and X voids into zx voids. See z2r::stitch_zx().
+ *
+ * @param z_voids Z voids
+ * @param x_voids X voids, with the same shape and itemsize
+ * @param num_qubits Number of qubits n
+ * @param out Optional output zx voids. When not given, they are allocated with (2n + 7) / 8 bytes.
+ * @return py::array The stitched voids, of the shape of z_voids
+ */
+py::array stitch_zx(py::array z_voids, py::array x_voids, int num_qubits,
+                    std::optional<py::array> out) {
+    check_num_qubits(num_qubits);
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+    size_t itemsize = out ? static_cast<size_t>(out->itemsize())
+                          : std::max<size_t>((2 * static_cast<size_t>(num_qubits) + 7) / 8, 1);
+    py::array zx_voids = zx_output(out, buf_z.shape, itemsize);
+    auto buf = zx_voids.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::stitch_zx(void_view(buf_z), void_view(buf_x), num_qubits, mutable_void_view(buf));
+    } // GIL reacquired here
+
+    return zx_voids;
+}
+
+/**
+ * @brief compose() on stitched zx voids. See z2r::zx_compose().
+ *
+ * @param zx1 Stitched voids of the first Pauli strings
+ * @param zx2 Stitched voids of the second Pauli strings
+ * @param num_qubits Number of qubits n
+ * @param out Optional output zx voids, which may be zx1 or zx2 to compose in place
+ * @return py::tuple Returns (zx_voids, phases)
+ */
+py::tuple zx_compose(py::array zx1, py::array zx2, int num_qubits, std::optional<py::array> out) {
+    check_num_qubits(num_qubits);
+    auto buf_1 = zx1.request();
+    auto buf_2 = zx2.request();
+    py::array zx_out = zx_output(out, buf_1.shape, buf_1.itemsize);
+    py::array phases = output_array(py::dtype::of<std::complex<double>>(), buf_1.shape);
+    auto buf_out = zx_out.request();
+    auto buf_phase = phases.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::zx_compose(void_view(buf_1), void_view(buf_2), num_qubits,
+                        mutable_void_view(buf_out),
+                        {static_cast<std::complex<double> *>(buf_phase.ptr),
+                         static_cast<size_t>(buf_phase.size)});
+    } // GIL reacquired here
+
+    return py::make_tuple(zx_out, phases);
+}
+
+static py::array_t<bool> zx_commute_rows(py::array zx1, py::array zx2, int num_qubits,
+                                         bool qubit_wise) {
+    check_num_qubits(num_qubits);
+    auto buf_1 = zx1.request();
+    auto buf_2 = zx2.request();
+    py::array_t<bool> result(buf_1.shape);
+    auto buf_result = result.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::zx_commute_with(void_view(buf_1), void_view(buf_2), num_qubits, qubit_wise,
+                             {static_cast<bool *>(buf_result.ptr),
+                              static_cast<size_t>(buf_result.size)});
+    } // GIL reacquired here
+
+    return result;
+}
+
+/**
+ * @brief Whether the Pauli strings of two arrays of stitched zx voids commute, element by element.
+ */
+py::array_t<bool> zx_commute_with(py::array zx1, py::array zx2, int num_qubits) {
+    return zx_commute_rows(zx1, zx2, num_qubits, false);
+}
+
+/**
+ * @brief bitwise_commute_with() on stitched zx voids: whether the Pauli strings commute on every
+ * qubit, element by element.
+ */
+py::array_t<bool> zx_bitwise_commute_with(py::array zx1, py::array zx2, int num_qubits) {
+    return zx_commute_rows(zx1, zx2, num_qubits, true);
+}
+
+/**
+ * @brief Weight (number of non-identity qubits) of Pauli strings in stitched zx voids.
+ *
+ * @param zx_voids The stitched voids
+ * @param num_qubits Number of qubits n
+ * @return py::array_t<int64_t> The weight of each Pauli string, of the shape of zx_voids
+ */
+py::array_t<int64_t> zx_weight(py::array zx_voids, int num_qubits) {
+    check_num_qubits(num_qubits);
+    auto buf = zx_voids.request();
+    py::array_t<int64_t> weights(buf.shape);
+    auto buf_out = weights.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::zx_weight(void_view(buf), num_qubits,
+                       {static_cast<int64_t *>(buf_out.ptr), static_cast<size_t>(buf_out.size)});
+    } // GIL reacquired here
+
+    return weights;
+}
+
+/**
+ * @brief The weights of a term function as a span, checking that there is one per Pauli string.
+ * Empty when not given.
+ */
+static std::span<const std::complex<double>>
+weights_span(const std::optional<py::array_t<std::complex<double>>> &weights, size_t rows) {
+    if (!weights) {
+        return {};
+    }
+    if (static_cast<size_t>(weights->size()) != rows) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+    return {weights->data(), rows};
+}
+
+/**
+ * @brief Gathers the terms at `indices` into new arrays. See z2r::gather_terms().
+ *
+ * @return py::tuple Returns (zx_voids, weights), weights being None if has_weights is false
+ */
+static py::tuple gathered_terms(VoidView zx, const py::dtype &dtype, bool has_weights,
+                                std::span<const std::complex<double>> w,
+                                std::span<const int64_t> indices) {
+    std::vector<ssize_t> shape = {static_cast<ssize_t>(indices.size())};
+    py::array zx_out = output_array(dtype, shape);
+    py::object w_out = py::none();
+    std::span<std::complex<double>> w_span;
+    if (has_weights) {
+        py::array_t<std::complex<double>> w_array(shape);
+        w_span = {w_array.mutable_data(), indices.size()};
+        w_out = w_array;
+    }
+    auto buf_out = zx_out.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::gather_terms(zx, w, indices, mutable_void_view(buf_out), w_span);
+    } // GIL reacquired here
+
+    return py::make_tuple(zx_out, w_out);
+}
+
+/**
+ * @brief Keeps the terms that pass every given check, in their order, in one parallel pass. See
+ * z2r::select_terms().
+ *
+ * @param zx_voids Stitched voids of the terms
+ * @param weights One weight per term, or None
+ * @param num_qubits Number of qubits n
+ * @param tolerance Keep the terms with |weight| > tolerance. Requires weights.
+ * @param max_weight Keep the terms acting on at most max_weight qubits
+ * @param support Keep the terms acting only on these qubits
+ * @return py::tuple Returns (zx_voids, weights) of the kept terms, weights being None if not given
+ */
+py::tuple filter_terms(py::array zx_voids, std::optional<py::array_t<std::complex<double>>> weights,
+                       int num_qubits, std::optional<double> tolerance,
+                       std::optional<int64_t> max_weight,
+                       std::optional<py::array_t<int64_t>> support) {
+    check_num_qubits(num_qubits);
+    auto buf = zx_voids.request();
+    VoidView zx = void_view(buf);
+    std::span<const std::complex<double>> w = weights_span(weights, zx.rows);
+    if (tolerance && !weights) {
+        throw std::runtime_error("A tolerance requires the weights.");
+    }
+    if (max_weight && *max_weight < 0) {
+        throw std::runtime_error("max_weight must be non-negative.");
+    }
+    if ((max_weight || support) && num_qubits <= 0) {
+        throw std::runtime_error("max_weight and support require a positive num_qubits.");
+    }
+
+    z2r::TermFilter filter;
+    filter.tolerance = tolerance.value_or(-1.0);
+    filter.max_weight = max_weight.value_or(-1);
+    filter.num_qubits = num_qubits;
+    std::vector<uint64_t> mask;
+    if (support) {
+        mask.assign(std::max<size_t>((static_cast<size_t>(num_qubits) + 63) / 64, 1), 0);
+        const int64_t *qubits = support->data();
+        for (ssize_t i = 0; i < support->size(); ++i) {
+            if (qubits[i] < 0 || qubits[i] >= num_qubits) {
+                throw std::runtime_error("Support qubit out of range.");
             }
+            mask[qubits[i] / 64] |= uint64_t{1} << (qubits[i] % 64);
         }
+        filter.support = mask;
+    }
+
+    std::vector<int64_t> selected;
+    {
+        py::gil_scoped_release release;
+        selected = z2r::select_terms(zx, w, filter);
+    } // GIL reacquired here
+
+    return gathered_terms(zx, zx_voids.dtype(), weights.has_value(), w, selected);
+}
+
+/**
+ * @brief Gathers terms by index, as zx_voids[indices] and weights[indices] in one parallel pass.
+ *
+ * @param zx_voids Voids of the terms (any layout)
+ * @param indices The terms to take, in [0, len(zx_voids))
+ * @param weights One weight per term, or None
+ * @return py::tuple Returns (zx_voids, weights) of the taken terms, weights being None if not given
+ */
+py::tuple take_terms(py::array zx_voids, py::array_t<int64_t> indices,
+                     std::optional<py::array_t<std::complex<double>>> weights) {
+    auto buf = zx_voids.request();
+    VoidView zx = void_view(buf);
+    std::span<const std::complex<double>> w = weights_span(weights, zx.rows);
+    return gathered_terms(zx, zx_voids.dtype(), weights.has_value(), w,
+                          {indices.data(), static_cast<size_t>(indices.size())});
+}
+
+/**
+ * @brief Keeps the k terms of largest weight magnitude. See z2r::top_k().
+ *
+ * @param zx_voids Voids of the terms (any layout)
+ * @param weights One weight per term
+ * @param k The number of terms to keep
+ * @return py::tuple Returns (zx_voids, weights) of the kept terms, by decreasing magnitude
+ */
+py::tuple top_k_terms(py::array zx_voids, py::array_t<std::complex<double>> weights, int64_t k) {
+    if (k < 0) {
+        throw std::runtime_error("k must be non-negative.");
     }
-    return Inv;
+    auto buf = zx_voids.request();
+    VoidView zx = void_view(buf);
+    std::span<const std::complex<double>> w = weights_span(weights, zx.rows);
+
+    std::vector<int64_t> selected;
+    {
+        py::gil_scoped_release release;
+        selected = z2r::top_k(w, static_cast<size_t>(k));
+    } // GIL reacquired here
+
+    return gathered_terms(zx, zx_voids.dtype(), true, w, selected);
+}
+
+/**
+ * @brief Reduces the commutation of every Pauli string of zx_voids with all the strings of
+ * zx_terms. See z2r::zx_commute_reduce().
+ *
+ * @return py::array_t<int64_t> One result per void of zx_voids, of its shape
+ */
+static py::array_t<int64_t> commute_reduction(py::array zx_voids, py::array zx_terms,
+                                              int num_qubits, bool qubit_wise,
+                                              z2r::CommuteReduction reduction) {
+    check_num_qubits(num_qubits);
+    auto buf = zx_voids.request();
+    auto buf_terms = zx_terms.request();
+    py::array_t<int64_t> result(buf.shape);
+    auto buf_out = result.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::zx_commute_reduce(
+            void_view(buf), void_view(buf_terms), num_qubits, qubit_wise, reduction,
+            {static_cast<int64_t *>(buf_out.ptr), static_cast<size_t>(buf.size)});
+    } // GIL reacquired here
+
+    return result;
+}
+
+/**
+ * @brief Whether each Pauli string of zx_voids commutes with all the strings of zx_terms. Stops at
+ * the first anticommuting term.
+ *
+ * @param zx_voids Stitched voids of the strings to check (a single void for a one-vs-many check)
+ * @param zx_terms Stitched voids of the strings to check against, with the same dtype
+ * @param num_qubits Number of qubits n
+ * @param qubit_wise Whether to test qubit-wise commutation instead of operator commutation
+ * @return py::array_t<bool> One flag per void of zx_voids, of its shape
+ */
+py::array_t<bool> commutes_all(py::array zx_voids, py::array zx_terms, int num_qubits,
+                               bool qubit_wise) {
+    py::array_t<int64_t> first = commute_reduction(
+        zx_voids, zx_terms, num_qubits, qubit_wise, z2r::CommuteReduction::FirstAnticommuting);
+    py::array_t<bool> result(first.request().shape);
+    const int64_t *ptr_first = first.data();
+    bool *ptr_out = result.mutable_data();
+    for (ssize_t i = 0; i < first.size(); ++i) {
+        ptr_out[i] = ptr_first[i] < 0;
+    }
+    return result;
+}
+
+/**
+ * @brief Whether each Pauli string of zx_voids commutes with at least one string of zx_terms. Stops
+ * at the first commuting term. The arguments are those of commutes_all().
+ */
+py::array_t<bool> commutes_any(py::array zx_voids, py::array zx_terms, int num_qubits,
+                               bool qubit_wise) {
+    py::array_t<int64_t> first = commute_reduction(zx_voids, zx_terms, num_qubits, qubit_wise,
+                                                   z2r::CommuteReduction::FirstCommuting);
+    py::array_t<bool> result(first.request().shape);
+    const int64_t *ptr_first = first.data();
+    bool *ptr_out = result.mutable_data();
+    for (ssize_t i = 0; i < first.size(); ++i) {
+        ptr_out[i] = ptr_first[i] >= 0;
+    }
+    return result;
+}
+
+/**
+ * @brief Number of strings of zx_terms that do not commute with each Pauli string of zx_voids. The
+ * arguments are those of commutes_all().
+ */
+py::array_t<int64_t> count_anticommuting(py::array zx_voids, py::array zx_terms, int num_qubits,
+                                         bool qubit_wise) {
+    return commute_reduction(zx_voids, zx_terms, num_qubits, qubit_wise,
+                             z2r::CommuteReduction::CountAnticommuting);
+}
+
+/**
+ * @brief Index of the first string of zx_terms that does not commute with each Pauli string of
+ * zx_voids, or -1. The arguments are those of commutes_all().
+ */
+py::array_t<int64_t> first_anticommuting(py::array zx_voids, py::array zx_terms, int num_qubits,
+                                         bool qubit_wise) {
+    return commute_reduction(zx_voids, zx_terms, num_qubits, qubit_wise,
+                             z2r::CommuteReduction::FirstAnticommuting);
+}
+
+/**
+ * @brief Bit-packed commutation flags of every Pauli string of zx_voids with every string of
+ * zx_terms. See z2r::zx_commute_mask().
+ *
+ * @param zx_voids Stitched voids of the m strings to check
+ * @param zx_terms Stitched voids of the N strings to check against, with the same dtype
+ * @param num_qubits Number of qubits n
+ * @param qubit_wise Whether to test qubit-wise commutation instead of operator commutation
+ * @return py::array Returns uint8 of shape (*zx_voids.shape, (N + 7) / 8): bit j % 8 of byte j / 8
+ * is set when zx_terms[j] commutes, as np.packbits(..., bitorder="little")
+ */
+py::array commute_mask(py::array zx_voids, py::array zx_terms, int num_qubits, bool qubit_wise) {
+    check_num_qubits(num_qubits);
+    auto buf = zx_voids.request();
+    auto buf_terms = zx_terms.request();
+    size_t row_bytes = (static_cast<size_t>(buf_terms.size) + 7) / 8;
+    std::vector<ssize_t> shape = buf.shape;
+    shape.push_back(static_cast<ssize_t>(row_bytes));
+    py::array mask = output_array(py::dtype("u1"), shape);
+    auto buf_out = mask.request();
+
+    {
+        py::gil_scoped_release release;
+        z2r::zx_commute_mask(void_view(buf), void_view(buf_terms), num_qubits, qubit_wise,
+                             MutableVoidView(static_cast<uint8_t *>(buf_out.ptr),
+                                             static_cast<size_t>(buf.size), row_bytes));
+    } // GIL reacquired here
+
+    return mask;
 }
@@ -0,0 +1,62 @@
+/**
+ * @file fermion.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the fermion-to-qubit mappings. See z2r_fermion.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "fermion.h"
+
+/**
+ * @brief Maps sum_t v_t op_{t,0} op_{t,1} ... op_{t,L-1}, where each op is a creation or an
+ * annihilation operator of one mode, to qubits, and simplifies the result. See
+ * z2r::map_ladder_terms().
+ *
+ * @param modes Mode of each ladder operator, of shape (num_terms, L). -1 is an identity.
+ * @param creation Whether each ladder operator is a creation operator, of shape (num_terms, L)
+ * @param values The coefficient v_t of each term
+ * @param num_modes Number of modes n, which is also the number of qubits
+ * @param mapping The mapping, from FermionMapping
+ * @param tolerance Terms with a summed weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights) of the unique terms, in no specific order, as zx
+ * voids of max((2n + 7) / 8, 1) bytes
+ */
+py::tuple fermion_to_qubit(py::array_t<int64_t> modes, py::array_t<bool> creation,
+                           py::array_t<std::complex<double>> values, int num_modes,
+                           int64_t mapping, double tolerance) {
+    if (num_modes < 0) {
+        throw std::runtime_error("num_modes must be non-negative.");
+    }
+    auto buf_m = modes.request();
+    auto buf_c = creation.request();
+    auto buf_v = values.request();
+    if (buf_m.ndim != 2 || buf_c.ndim != 2 || buf_m.shape[0] != buf_c.shape[0] ||
+        buf_m.shape[1] != buf_c.shape[1]) {
+        throw std::runtime_error(
+            "modes and creation must be arrays of the same shape (num_terms, length).");
+    }
+    if (buf_v.size != buf_m.shape[0]) {
+        throw std::runtime_error("values must have one element per term.");
+    }
+    size_t num_terms = static_cast<size_t>(buf_m.shape[0]);
+    size_t length = static_cast<size_t>(buf_m.shape[1]);
+    LadderTerms terms{{static_cast<const int64_t *>(buf_m.ptr), num_terms * length},
+                      {static_cast<const uint8_t *>(buf_c.ptr), num_terms * length},
+                      {static_cast<const std::complex<double> *>(buf_v.ptr), num_terms},
+                      length};
+    size_t out_itemsize = std::max<size_t>((2 * static_cast<size_t>(num_modes) + 7) / 8, 1);
+
+    PauliAccumulator acc(out_itemsize);
+    {
+        py::gil_scoped_release release;
+        acc = z2r::map_ladder_terms(terms, static_cast<size_t>(num_modes), mapping);
+    } // GIL reacquired here
+
+    return accumulator_to_arrays(&acc, 1, py::dtype("|V" + std::to_string(out_itemsize)),
+                                 tolerance);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file operator_builder.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the append-only builder of weighted sums of Pauli strings. See
+ * z2r_builder.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "operator_builder.h"
+
+/**
+ * @brief Appends a batch of terms. See z2r::OperatorBuilder::add().
+ *
+ * @param zx_voids The Pauli strings (any void layout, only byte equality matters)
+ * @param weights One weight per Pauli string
+ */
+void OperatorBuilder::add(py::array zx_voids, py::array_t<std::complex<double>> weights) {
+    auto buf = zx_voids.request();
+    auto buf_w = weights.request();
+    VoidView rows = void_view(buf);
+    std::span<const std::complex<double>> w(
+        static_cast<const std::complex<double> *>(buf_w.ptr), static_cast<size_t>(buf_w.size));
+    {
+        py::gil_scoped_release release;
+        builder_.add(rows, w);
+    } // GIL reacquired here
+}
+
+/**
+ * @brief Merges the pending terms now, whatever their number.
+ */
+void OperatorBuilder::flush() {
+    py::gil_scoped_release release;
+    builder_.flush();
+}
+
+/**
+ * @brief The simplified operator. The builder is left as is, and can take more terms.
+ *
+ * @param tolerance Terms with a summed weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights) of the unique terms, in the order of their first
+ * addition
+ */
+py::tuple OperatorBuilder::finalize(double tolerance) {
+    z2r::WeightedTerms terms;
+    {
+        py::gil_scoped_release release;
+        terms = builder_.finalize(tolerance);
+    } // GIL reacquired here
+
+    std::vector<ssize_t> out_shape = {static_cast<ssize_t>(terms.weights.size())};
+    py::array zx_out = output_array(py::dtype("|V" + std::to_string(itemsize())), out_shape);
+    py::array_t<std::complex<double>> w_out(out_shape);
+    if (!terms.weights.empty()) {
+        std::memcpy(zx_out.request().ptr, terms.keys.data(), terms.keys.size());
+        std::memcpy(w_out.request().ptr, terms.weights.data(),
+                    terms.weights.size() * sizeof(terms.weights[0]));
+    }
+    return py::make_tuple(zx_out, w_out);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file pauli_index.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the persistent hash index over a set of Pauli strings. See
+ * z2r_index.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "pauli_index.h"
+
+namespace {
+
+py::array_t<int64_t> int64_array(const std::vector<int64_t> &values) {
+    py::array_t<int64_t> out(static_cast<ssize_t>(values.size()));
+    std::copy(values.begin(), values.end(), out.mutable_data());
+    return out;
+}
+
+} // namespace
+
+/**
+ * @brief Builds the index of a set of voids. Repeated voids are stored once, numbered by their
+ * first occurrence.
+ *
+ * @param zx_voids The voids. Their dtype fixes the itemsize of every later query.
+ */
+PauliIndex::PauliIndex(py::array zx_voids) : index_(zx_voids.dtype().itemsize()) {
+    insert(zx_voids);
+}
+
+/**
+ * @brief The voids of the set, in the order of their numbers.
+ *
+ * @return py::array A copy of the keys, of dtype |V{itemsize}
+ */
+py::array PauliIndex::keys() const {
+    std::vector<uint8_t> copy;
+    {
+        py::gil_scoped_release release;
+        copy = index_.keys();
+    } // GIL reacquired here
+    std::vector<ssize_t> shape = {static_cast<ssize_t>(copy.size() / itemsize())};
+    py::array out = py::array(py::dtype("|V" + std::to_string(itemsize())), shape);
+    if (!copy.empty()) {
+        std::memcpy(out.request().ptr, copy.data(), copy.size());
+    }
+    return out;
+}
+
+VoidView PauliIndex::checked_view(const py::buffer_info &buf) const {
+    if (static_cast<size_t>(buf.itemsize) != itemsize()) {
+        throw std::runtime_error("Expected voids of " + std::to_string(itemsize()) +
+                                 " bytes, got " + std::to_string(buf.itemsize) + ".");
+    }
+    return void_view(buf);
+}
+
+/**
+ * @brief Looks up a batch of voids.
+ *
+ * @param zx_voids The queries
+ * @return py::array_t<int64_t> The number of each query in the set, or -1 if it is not there
+ */
+py::array_t<int64_t> PauliIndex::lookup(py::array zx_voids) const {
+    auto buf = zx_voids.request();
+    VoidView queries = checked_view(buf);
+    py::array_t<int64_t> out(queries.rows);
+    std::span<int64_t> found(out.mutable_data(), queries.rows);
+    {
+        py::gil_scoped_release release;
+        index_.find_all(queries, found);
+    } // GIL reacquired here
+    return out;
+}
+
+/**
+ * @brief Membership of a batch of voids.
+ *
+ * @param zx_voids The queries
+ * @return py::array_t<bool> Whether each query is in the set
+ */
+py::array_t<bool> PauliIndex::isin(py::array zx_voids) const {
+    auto buf = zx_voids.request();
+    VoidView queries = checked_view(buf);
+    py::array_t<bool> out(queries.rows);
+    bool *ptr_out = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        std::vector<int64_t> found(queries.rows);
+        index_.find_all(queries, found);
+        for (size_t i = 0; i < queries.rows; ++i) {
+            ptr_out[i] = found[i] != z2r::PauliIndex::EMPTY;
+        }
+    } // GIL reacquired here
+    return out;
+}
+
+/**
+ * @brief Adds a batch of voids to the set. The ones already there keep their number, the new ones
+ * are numbered from size() on, in the order of their first occurrence.
+ *
+ * @param zx_voids The voids to add
+ * @return py::array_t<int64_t> The number of each void in the set
+ */
+py::array_t<int64_t> PauliIndex::insert(py::array zx_voids) {
+    auto buf = zx_voids.request();
+    VoidView rows = checked_view(buf);
+    py::array_t<int64_t> out(rows.rows);
+    std::span<int64_t> numbers(out.mutable_data(), rows.rows);
+    {
+        py::gil_scoped_release release;
+        index_.insert_rows(rows, numbers);
+    } // GIL reacquired here
+    return out;
+}
+
+/**
+ * @brief Intersection of the set with a batch of voids.
+ *
+ * @param zx_voids The queries
+ * @return py::tuple Returns (positions, numbers): the positions, in increasing order, of the
+ * queries that are in the set, and their numbers in the set
+ */
+py::tuple PauliIndex::intersect(py::array zx_voids) const {
+    auto buf = zx_voids.request();
+    VoidView queries = checked_view(buf);
+    z2r::IndexMatches matches;
+    {
+        py::gil_scoped_release release;
+        matches = index_.intersect(queries);
+    } // GIL reacquired here
+    return py::make_tuple(int64_array(matches.positions), int64_array(matches.numbers));
+}
+
+/**
+ * @brief Difference of the set with a batch of voids.
+ *
+ * @param zx_voids The voids to remove
+ * @return py::array_t<int64_t> The numbers, in increasing order, of the voids of the set that are
+ * not among zx_voids
+ */
+py::array_t<int64_t> PauliIndex::difference(py::array zx_voids) const {
+    auto buf = zx_voids.request();
+    VoidView queries = checked_view(buf);
+    std::vector<int64_t> kept;
+    {
+        py::gil_scoped_release release;
+        kept = index_.difference(queries);
+    } // GIL reacquired here
+    return int64_array(kept);
+}
@@ -0,0 +1,220 @@
+/**
+ * @file sparse_pauli.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the support-list encoding of low-weight Pauli strings. See
+ * z2r_sparse.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note The kernels producing support lists run in two passes, each with the GIL released: the
+ * offsets array is filled by the first one, and the entries array is allocated in between.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "sparse_pauli.h"
+
+namespace {
+
+SupportLists support_view(const py::buffer_info &buf_offsets, const py::buffer_info &buf_entries) {
+    if (buf_offsets.ndim != 1 || buf_entries.ndim != 1) {
+        throw std::runtime_error("offsets and entries must be 1-D arrays.");
+    }
+    return z2r::support_lists(
+        {static_cast<const int64_t *>(buf_offsets.ptr), static_cast<size_t>(buf_offsets.size)},
+        {static_cast<const uint32_t *>(buf_entries.ptr), static_cast<size_t>(buf_entries.size)});
+}
+
+py::array_t<int64_t> int64_array(const std::vector<int64_t> &values) {
+    py::array_t<int64_t> out(static_cast<ssize_t>(values.size()));
+    std::copy(values.begin(), values.end(), out.mutable_data());
+    return out;
+}
+
+py::array_t<bool> commute_rows(py::array_t<int64_t> offsets_1, py::array_t<uint32_t> entries_1,
+                               py::array_t<int64_t> offsets_2, py::array_t<uint32_t> entries_2,
+                               bool qubit_wise) {
+    auto buf_o1 = offsets_1.request();
+    auto buf_e1 = entries_1.request();
+    auto buf_o2 = offsets_2.request();
+    auto buf_e2 = entries_2.request();
+    SupportLists a = support_view(buf_o1, buf_e1);
+    SupportLists b = support_view(buf_o2, buf_e2);
+    py::array_t<bool> result(a.rows());
+    std::span<bool> out(result.mutable_data(), a.rows());
+    {
+        py::gil_scoped_release release;
+        z2r::sparse_commute_with(a, b, qubit_wise, out);
+    } // GIL reacquired here
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Converts Pauli strings from Z and X voids to support lists. See z2r::to_support_lists().
+ *
+ * @param z_voids Z voids of the strings
+ * @param x_voids X voids of the strings, with the same size and itemsize
+ * @return py::tuple Returns (offsets, entries). See z2r_sparse.h.
+ */
+py::tuple to_support_lists(py::array z_voids, py::array x_voids) {
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+    if (buf_z.itemsize != buf_x.itemsize || buf_z.size != buf_x.size) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+    VoidView z = void_view(buf_z);
+    VoidView x = void_view(buf_x);
+
+    py::array_t<int64_t> offsets(z.rows + 1);
+    std::span<int64_t> off(offsets.mutable_data(), z.rows + 1);
+    size_t total;
+    {
+        py::gil_scoped_release release;
+        total = z2r::support_list_offsets(z, x, off);
+    } // GIL reacquired here
+
+    py::array_t<uint32_t> entries(total);
+    std::span<uint32_t> out(entries.mutable_data(), total);
+    {
+        py::gil_scoped_release release;
+        z2r::to_support_lists(z, x, off, out);
+    } // GIL reacquired here
+
+    return py::make_tuple(offsets, entries);
+}
+
+/**
+ * @brief Converts Pauli strings from support lists back to Z and X voids. See
+ * z2r::from_support_lists().
+ *
+ * @param offsets Offsets of the strings, num_strings + 1 of them
+ * @param entries Entries of the strings
+ * @param num_qubits Number of qubits n. Every qubit of the entries must be below n.
+ * @return py::tuple Returns (z_voids, x_voids), of (n + 7) / 8 bytes each
+ */
+py::tuple from_support_lists(py::array_t<int64_t> offsets, py::array_t<uint32_t> entries,
+                             int num_qubits) {
+    if (num_qubits < 0 || static_cast<size_t>(num_qubits) > SUPPORT_MAX_QUBITS) {
+        throw std::runtime_error("num_qubits must be between 0 and 2^30.");
+    }
+    auto buf_off = offsets.request();
+    auto buf_e = entries.request();
+    SupportLists s = support_view(buf_off, buf_e);
+    size_t itemsize = std::max<size_t>((static_cast<size_t>(num_qubits) + 7) / 8, 1);
+    py::dtype dtype("|V" + std::to_string(itemsize));
+    std::vector<ssize_t> shape = {static_cast<ssize_t>(s.rows())};
+    py::array z_voids = py::array(dtype, shape);
+    py::array x_voids = py::array(dtype, shape);
+    auto buf_z = z_voids.request();
+    auto buf_x = x_voids.request();
+    MutableVoidView z = mutable_void_view(buf_z);
+    MutableVoidView x = mutable_void_view(buf_x);
+
+    {
+        py::gil_scoped_release release;
+        z2r::from_support_lists(s, static_cast<size_t>(num_qubits), z, x);
+    } // GIL reacquired here
+
+    return py::make_tuple(z_voids, x_voids);
+}
+
+/**
+ * @brief Composes Pauli strings in the support-list encoding row by row, P_i = P1_i P2_i. See
+ * z2r::sparse_compose().
+ *
+ * @param offsets_1 Offsets of the first strings
+ * @param entries_1 Entries of the first strings
+ * @param offsets_2 Offsets of the second strings, as many as the first ones
+ * @param entries_2 Entries of the second strings
+ * @return py::tuple Returns (offsets, entries, phases) of the products
+ */
+py::tuple sparse_compose(py::array_t<int64_t> offsets_1, py::array_t<uint32_t> entries_1,
+                         py::array_t<int64_t> offsets_2, py::array_t<uint32_t> entries_2) {
+    auto buf_o1 = offsets_1.request();
+    auto buf_e1 = entries_1.request();
+    auto buf_o2 = offsets_2.request();
+    auto buf_e2 = entries_2.request();
+    SupportLists a = support_view(buf_o1, buf_e1);
+    SupportLists b = support_view(buf_o2, buf_e2);
+    size_t rows = a.rows();
+
+    py::array_t<int64_t> offsets(rows + 1);
+    py::array_t<std::complex<double>> phases(rows);
+    std::span<int64_t> off(offsets.mutable_data(), rows + 1);
+    std::span<std::complex<double>> ph(phases.mutable_data(), rows);
+    size_t total;
+    {
+        py::gil_scoped_release release;
+        total = z2r::sparse_compose_offsets(a, b, off, ph);
+    } // GIL reacquired here
+
+    py::array_t<uint32_t> entries(total);
+    std::span<uint32_t> out(entries.mutable_data(), total);
+    {
+        py::gil_scoped_release release;
+        z2r::sparse_compose(a, b, off, out);
+    } // GIL reacquired here
+
+    return py::make_tuple(offsets, entries, phases);
+}
+
+/**
+ * @brief Checks row by row whether two Pauli strings in the support-list encoding commute, i.e.
+ * whether they anticommute on an even number of qubits.
+ *
+ * @param offsets_1 Offsets of the first strings
+ * @param entries_1 Entries of the first strings
+ * @param offsets_2 Offsets of the second strings, as many as the first ones
+ * @param entries_2 Entries of the second strings
+ * @return py::array_t<bool> Whether P1_i and P2_i commute
+ */
+py::array_t<bool> sparse_commute_with(py::array_t<int64_t> offsets_1,
+                                      py::array_t<uint32_t> entries_1,
+                                      py::array_t<int64_t> offsets_2,
+                                      py::array_t<uint32_t> entries_2) {
+    return commute_rows(offsets_1, entries_1, offsets_2, entries_2, false);
+}
+
+/**
+ * @brief Checks row by row whether two Pauli strings in the support-list encoding commute qubit by
+ * qubit, as bitwise_commute_with() does for voids.
+ *
+ * @param offsets_1 Offsets of the first strings
+ * @param entries_1 Entries of the first strings
+ * @param offsets_2 Offsets of the second strings, as many as the first ones
+ * @param entries_2 Entries of the second strings
+ * @return py::array_t<bool> Whether P1_i and P2_i commute on every qubit
+ */
+py::array_t<bool> sparse_bitwise_commute_with(py::array_t<int64_t> offsets_1,
+                                              py::array_t<uint32_t> entries_1,
+                                              py::array_t<int64_t> offsets_2,
+                                              py::array_t<uint32_t> entries_2) {
+    return commute_rows(offsets_1, entries_1, offsets_2, entries_2, true);
+}
+
+/**
+ * @brief Finds the unique Pauli strings of a batch in the support-list encoding. See
+ * z2r::sparse_unique().
+ *
+ * @param offsets Offsets of the strings
+ * @param entries Entries of the strings
+ * @return py::tuple Returns (indices, inverse): the index of the first occurrence of each unique
+ * string, and the number of the unique string of each input string
+ */
+py::tuple sparse_unique(py::array_t<int64_t> offsets, py::array_t<uint32_t> entries) {
+    auto buf_off = offsets.request();
+    auto buf_e = entries.request();
+    SupportLists s = support_view(buf_off, buf_e);
+
+    z2r::UniqueVoids result;
+    {
+        py::gil_scoped_release release;
+        result = z2r::sparse_unique(s);
+    } // GIL reacquired here
+
+    return py::make_tuple(int64_array(result.index), int64_array(result.inverse));
+}
@@ -0,0 +1,96 @@
+/**
+ * @file taper.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python bindings of the Z2 symmetries of a qubit operator, and qubit tapering. See
+ * z2r_taper.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "taper.h"
+
+/**
+ * @brief Finds the Z2 symmetries of an operator. See z2r::find_z2_symmetries().
+ *
+ * @param zx_voids The Pauli strings of the operator, in the stitched layout
+ * @param num_qubits Number of qubits n
+ * @return py::tuple Returns (generators, qubits, gates, signs): the k symmetries as zx voids of the
+ * same dtype as zx_voids, the qubit each of them is mapped to, the Clifford circuit doing so as an
+ * int64 array of shape (num_gates, 3), and the sign s_k of C g_k C^dagger = s_k Z_{q_k}
+ */
+py::tuple z2_symmetries(py::array zx_voids, int num_qubits) {
+    if (num_qubits < 0) {
+        throw std::runtime_error("num_qubits must be non-negative.");
+    }
+    auto buf = zx_voids.request();
+
+    Z2Symmetries sym;
+    {
+        py::gil_scoped_release release;
+        sym = z2r::find_z2_symmetries(void_view(buf), static_cast<size_t>(num_qubits));
+    } // GIL reacquired here
+
+    size_t k = sym.size();
+    py::array generators(zx_voids.dtype(), std::vector<ssize_t>{static_cast<ssize_t>(k)});
+    z2r::symmetry_generators(sym, mutable_void_view(generators.request()));
+
+    py::array_t<int64_t> qubits(static_cast<ssize_t>(k));
+    py::array_t<int64_t> signs(static_cast<ssize_t>(k));
+    py::array_t<int64_t> gates(std::vector<ssize_t>{static_cast<ssize_t>(sym.gates.size() / 3), 3});
+    std::copy(sym.qubits.begin(), sym.qubits.end(), qubits.mutable_data());
+    for (size_t g = 0; g < k; ++g) {
+        signs.mutable_data()[g] = sym.signs[g] ? -1 : 1;
+    }
+    std::copy(sym.gates.begin(), sym.gates.end(), gates.mutable_data());
+
+    return py::make_tuple(generators, qubits, gates, signs);
+}
+
+/**
+ * @brief Tapers the qubits of an operator off, one per independent Z2 symmetry. See
+ * z2r::taper().
+ *
+ * @param zx_voids The terms of the operator, in the stitched layout
+ * @param weights One weight per term
+ * @param num_qubits Number of qubits n
+ * @param sector The eigenvalue (+1 or -1) of each symmetry generator, in the order of
+ * z2_symmetries(). All +1 when none is given.
+ * @param tolerance Terms with a summed weight of magnitude <= tolerance are dropped
+ * @return py::tuple Returns (zx_voids, weights) of the tapered operator on n - k qubits, in the
+ * smallest void dtype holding 2 (n - k) bits, in no specific order
+ */
+py::tuple taper(py::array zx_voids, py::array_t<std::complex<double>> weights, int num_qubits,
+                std::optional<std::vector<int>> sector, double tolerance) {
+    if (num_qubits < 0) {
+        throw std::runtime_error("num_qubits must be non-negative.");
+    }
+    auto buf = zx_voids.request();
+    auto buf_w = weights.request();
+    if (buf_w.size != buf.size) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+
+    Z2Symmetries sym;
+    std::vector<PauliAccumulator> partials;
+    {
+        py::gil_scoped_release release;
+        sym = z2r::find_z2_symmetries(void_view(buf), static_cast<size_t>(num_qubits));
+        // An empty span means all +1 to the kernel, so an empty sector is checked here
+        if (sector && sector->size() != sym.size()) {
+            throw std::runtime_error("The sector must have one eigenvalue per symmetry (" +
+                                     std::to_string(sym.size()) + ").");
+        }
+        partials = z2r::taper(void_view(buf),
+                              {static_cast<const std::complex<double> *>(buf_w.ptr),
+                               static_cast<size_t>(buf_w.size)},
+                              sym, sector ? std::span<const int>(*sector) : std::span<const int>{});
+    } // GIL reacquired here
+
+    return accumulator_to_arrays(partials.data(), partials.size(),
+                                 py::dtype("|V" + std::to_string(sym.tapered_itemsize())),
+                                 tolerance);
+}
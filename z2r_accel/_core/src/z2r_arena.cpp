@@ -0,0 +1,195 @@
+/**
+ * @file z2r_arena.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Pooled, cache-line aligned allocator. See z2r_arena.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+namespace z2r::arena {
+
+namespace {
+
+// Every block starts with a header holding its size class, so that deallocate() needs nothing but
+// the pointer (NumPy capsules only give that back). It takes a whole line, to keep the data
+// aligned.
+constexpr size_t HEADER = ALIGNMENT;
+// 64 to 256 bytes, then four classes per power of two from 2^8 to 2^63
+constexpr size_t NUM_CLASSES = 4 + 4 * (64 - 8);
+
+size_t class_of(size_t bytes) {
+    if (bytes <= 256) {
+        return (std::max<size_t>(bytes, 1) + 63) / 64 - 1;
+    }
+    size_t k = std::bit_width(bytes - 1) - 1; // 2^k < bytes <= 2^(k + 1)
+    size_t step = size_t{1} << (k - 2);
+    size_t j = (bytes - (size_t{1} << k) + step - 1) / step; // 1 to 4
+    return 4 + 4 * (k - 8) + (j - 1);
+}
+
+size_t class_size(size_t c) {
+    if (c < 4) {
+        return 64 * (c + 1);
+    }
+    size_t k = 8 + (c - 4) / 4;
+    size_t j = (c - 4) % 4 + 1;
+    return (size_t{1} << k) + j * (size_t{1} << (k - 2));
+}
+
+size_t limit_from_environment() {
+    const char *value = std::getenv("Z2R_ARENA_LIMIT");
+    if (value == nullptr || std::string_view(value) == "") {
+        return size_t{1} << 31;
+    }
+    return std::strtoull(value, nullptr, 10);
+}
+
+bool outputs_from_environment() {
+    const char *value = std::getenv("Z2R_ARENA_OUTPUTS");
+    return value != nullptr && std::string_view(value) != "" && std::string_view(value) != "0";
+}
+
+std::atomic<bool> outputs_flag{outputs_from_environment()};
+
+struct Pool {
+    std::mutex mutex;
+    std::vector<void *> free_lists[NUM_CLASSES];
+    size_t limit = limit_from_environment();
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t live_bytes = 0;
+    uint64_t cached_bytes = 0;
+
+    // Pops cached blocks, largest classes first, until at most `target` bytes are cached. The
+    // caller frees them once the lock is released.
+    void evict(size_t target, std::vector<void *> &released) {
+        for (size_t c = NUM_CLASSES; c-- > 0 && cached_bytes > target;) {
+            while (!free_lists[c].empty() && cached_bytes > target) {
+                released.push_back(free_lists[c].back());
+                free_lists[c].pop_back();
+                cached_bytes -= class_size(c);
+            }
+        }
+    }
+};
+
+// Never destroyed: NumPy arrays owning a block may outlive the static objects of the module
+Pool &pool() {
+    static Pool *instance = new Pool;
+    return *instance;
+}
+
+void release_all(const std::vector<void *> &blocks) {
+    for (void *block : blocks) {
+        std::free(block);
+    }
+}
+
+} // namespace
+
+void *allocate(size_t bytes) {
+    if (bytes > (size_t{1} << 62)) {
+        throw std::bad_alloc();
+    }
+    size_t c = class_of(bytes + HEADER);
+    size_t size = class_size(c);
+    Pool &p = pool();
+    void *block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        if (!p.free_lists[c].empty()) {
+            block = p.free_lists[c].back();
+            p.free_lists[c].pop_back();
+            p.cached_bytes -= size;
+            ++p.hits;
+        } else {
+            ++p.misses;
+        }
+        p.live_bytes += size;
+    }
+    if (block == nullptr) {
+        block = std::aligned_alloc(ALIGNMENT, size);
+        if (block == nullptr) {
+            std::lock_guard<std::mutex> lock(p.mutex);
+            p.live_bytes -= size;
+            throw std::bad_alloc();
+        }
+    }
+    *static_cast<size_t *>(block) = c;
+    return static_cast<uint8_t *>(block) + HEADER;
+}
+
+void deallocate(void *ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    void *block = static_cast<uint8_t *>(ptr) - HEADER;
+    size_t c = *static_cast<size_t *>(block);
+    size_t size = class_size(c);
+    Pool &p = pool();
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.live_bytes -= size;
+        if (p.cached_bytes + size <= p.limit) {
+            try {
+                p.free_lists[c].push_back(block);
+                p.cached_bytes += size;
+                return;
+            } catch (const std::bad_alloc &) {
+                // No room to cache it: free it below
+            }
+        }
+    }
+    std::free(block);
+}
+
+void set_limit(size_t bytes) {
+    Pool &p = pool();
+    std::vector<void *> released;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.limit = bytes;
+        p.evict(bytes, released);
+    }
+    release_all(released);
+}
+
+size_t limit() {
+    Pool &p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    return p.limit;
+}
+
+void trim() {
+    Pool &p = pool();
+    std::vector<void *> released;
+    {
+        std::lock_guard<std::mutex> lock(p.mutex);
+        p.evict(0, released);
+    }
+    release_all(released);
+}
+
+ArenaStats snapshot() {
+    Pool &p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+    return {p.hits, p.misses, p.live_bytes, p.cached_bytes, p.limit};
+}
+
+void set_outputs(bool enable) { outputs_flag.store(enable, std::memory_order_relaxed); }
+
+bool outputs() { return outputs_flag.load(std::memory_order_relaxed); }
+
+} // namespace z2r::arena
@@ -0,0 +1,122 @@
+/**
+ * @file z2r_builder.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free append-only builder of weighted sums of Pauli strings. See z2r_builder.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_builder.h"
+
+namespace z2r {
+
+/**
+ * @brief Creates an empty builder.
+ *
+ * @param itemsize Number of bytes of the voids of every term
+ * @param flush_threshold Number of pending terms from which add() merges them into the unique ones
+ */
+OperatorBuilder::OperatorBuilder(size_t itemsize, size_t flush_threshold)
+    : flush_threshold_(flush_threshold), index_(itemsize) {
+    if (itemsize == 0) {
+        throw std::runtime_error("itemsize must be positive.");
+    }
+    if (flush_threshold == 0) {
+        throw std::runtime_error("flush_threshold must be positive.");
+    }
+}
+
+size_t OperatorBuilder::num_unique() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+size_t OperatorBuilder::num_pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_weights_.size();
+}
+
+/**
+ * @brief Appends a batch of terms. They are only merged with the others once the pending terms
+ * reach the flush threshold.
+ *
+ * @param rows The Pauli strings (any void layout, only byte equality matters), of itemsize() bytes
+ * @param weights One weight per Pauli string
+ */
+void OperatorBuilder::add(VoidView rows, std::span<const std::complex<double>> weights) {
+    if (rows.itemsize != itemsize()) {
+        throw std::runtime_error("Expected voids of " + std::to_string(itemsize()) +
+                                 " bytes, got " + std::to_string(rows.itemsize) + ".");
+    }
+    if (weights.size() != rows.rows) {
+        throw std::runtime_error("zx_voids and weights must have the same number of elements.");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // insert() of a range grows the buffers geometrically, so appending is amortized O(batch)
+    if (rows.stride == rows.itemsize) {
+        pending_keys_.insert(pending_keys_.end(), rows.data, rows.data + rows.rows * rows.itemsize);
+    } else {
+        for (size_t i = 0; i < rows.rows; ++i) {
+            pending_keys_.insert(pending_keys_.end(), rows.row(i), rows.row(i) + rows.itemsize);
+        }
+    }
+    pending_weights_.insert(pending_weights_.end(), weights.begin(), weights.end());
+    if (pending_weights_.size() >= flush_threshold_) {
+        merge_pending();
+    }
+}
+
+/**
+ * @brief Merges the pending terms into the unique ones: only the pending voids are hashed, and
+ * their weights are summed into the weight of their number in the index. Must be called with the
+ * builder locked.
+ */
+void OperatorBuilder::merge_pending() {
+    size_t n = pending_weights_.size();
+    if (n == 0) {
+        return;
+    }
+    std::vector<int64_t> numbers(n);
+    index_.insert_rows(VoidView(pending_keys_.data(), n, itemsize()), numbers);
+    weights_.resize(index_.size());
+    for (size_t i = 0; i < n; ++i) {
+        weights_[numbers[i]] += pending_weights_[i];
+    }
+    // clear() keeps the capacity for the next batches
+    pending_keys_.clear();
+    pending_weights_.clear();
+}
+
+/**
+ * @brief Merges the pending terms now, whatever their number.
+ */
+void OperatorBuilder::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    merge_pending();
+}
+
+/**
+ * @brief The simplified operator. The builder is left as is, and can take more terms.
+ *
+ * @param tolerance Terms with a summed weight of magnitude <= tolerance are dropped
+ * @return WeightedTerms The unique terms, in the order of their first addition
+ */
+WeightedTerms OperatorBuilder::finalize(double tolerance) {
+    WeightedTerms out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    merge_pending();
+    for (size_t k = 0; k < weights_.size(); ++k) {
+        if (std::abs(weights_[k]) > tolerance) {
+            out.keys.insert(out.keys.end(), index_.key(k), index_.key(k) + itemsize());
+            out.weights.push_back(weights_[k]);
+        }
+    }
+    return out;
+}
+
+} // namespace z2r
@@ -0,0 +1,180 @@
+/**
+ * @file z2r_clifford.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free Clifford conjugation of Pauli strings. See z2r_clifford.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note Pauli strings are processed in blocks of 64. Each block is transposed with transpose64()
+ * so that a 64-bit word holds one qubit of 64 Pauli strings; a gate then updates the whole block
+ * with a handful of word operations.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_clifford.h"
+#include "z2r_stats.h"
+
+namespace z2r {
+
+/**
+ * @brief Checks a compiled circuit against the size of the voids it will act on, and maps the
+ * qubits of its gates to columns of the block buffers of conjugate_rows().
+ *
+ * @param gates The compiled circuit, num_gates rows of (code, qubit_0, qubit_1), flattened
+ * @param itemsize Number of bytes of the Z (or X) voids
+ * @return CompiledCircuit
+ */
+CompiledCircuit compile_circuit(std::span<const int64_t> gates, size_t itemsize) {
+    if (gates.size() % 3 != 0) {
+        throw std::runtime_error("gates must be an array of shape (num_gates, 3).");
+    }
+    CompiledCircuit circuit;
+    size_t num_gates = gates.size() / 3;
+    size_t words = (itemsize + 7) / 8;
+
+    // Only the words holding a touched qubit are transposed. slot_of_word maps them to their
+    // position in the block buffers.
+    std::vector<int64_t> slot_of_word(words, -1);
+    auto column_of = [&](int64_t qubit) {
+        if (qubit < 0 || static_cast<size_t>(qubit) >= itemsize * 8) {
+            throw std::runtime_error("Gate qubit " + std::to_string(qubit) +
+                                     " is out of range for voids of " +
+                                     std::to_string(itemsize * 8) + " bits.");
+        }
+        size_t w = static_cast<size_t>(qubit) / 64;
+        if (slot_of_word[w] < 0) {
+            slot_of_word[w] = circuit.touched_words.size();
+            circuit.touched_words.push_back(w);
+        }
+        return static_cast<size_t>(slot_of_word[w]) * 64 + static_cast<size_t>(qubit) % 64;
+    };
+
+    // (code, column a, column b) for every gate
+    circuit.codes.resize(num_gates);
+    circuit.cols_a.resize(num_gates);
+    circuit.cols_b.resize(num_gates);
+    for (size_t g = 0; g < num_gates; ++g) {
+        circuit.codes[g] = gates[3 * g];
+        if (circuit.codes[g] < GATE_H || circuit.codes[g] > GATE_SWAP) {
+            throw std::runtime_error("Unknown gate code " + std::to_string(circuit.codes[g]) +
+                                     ".");
+        }
+        circuit.cols_a[g] = column_of(gates[3 * g + 1]);
+        circuit.cols_b[g] = circuit.cols_a[g];
+        if (circuit.codes[g] >= GATE_CX) {
+            if (gates[3 * g + 1] == gates[3 * g + 2]) {
+                throw std::runtime_error("Two-qubit gates must act on two different qubits.");
+            }
+            circuit.cols_b[g] = column_of(gates[3 * g + 2]);
+        }
+    }
+    return circuit;
+}
+
+/**
+ * @brief Conjugates Pauli strings by a compiled circuit, i.e. computes C P C^dagger for each P.
+ *
+ * The whole circuit is applied to a block of 64 Pauli strings before moving on to the next block.
+ * Only the 64-bit words holding a qubit touched by the circuit are transposed, and a block of w
+ * touched words takes 2 * w * 512 bytes, so it stays in L1 cache for the whole circuit. Blocks are
+ * spread over the OpenMP threads.
+ *
+ * @param circuit The circuit, from compile_circuit() with the same itemsize
+ * @param z Z voids of the Pauli strings
+ * @param x X voids of the Pauli strings
+ * @param phases Phases (or weights) of the Pauli strings
+ * @param new_z Z voids of the conjugated Pauli strings. May alias z.
+ * @param new_x X voids of the conjugated Pauli strings. May alias x.
+ * @param new_phases phases multiplied by the sign picked up by each Pauli string. May alias phases.
+ */
+void conjugate_rows(const CompiledCircuit &circuit, VoidView z, VoidView x,
+                    std::span<const std::complex<double>> phases, MutableVoidView new_z,
+                    MutableVoidView new_x, std::span<std::complex<double>> new_phases) {
+    threads::apply();
+    size_t n_rows = z.rows;
+    size_t itemsize = z.itemsize;
+    for (VoidView v : {x, VoidView(new_z), VoidView(new_x)}) {
+        if (v.rows != n_rows || v.itemsize != itemsize) {
+            throw std::runtime_error("Input arrays must have the same size and itemsize.");
+        }
+    }
+    if (phases.size() != n_rows || new_phases.size() != n_rows) {
+        throw std::runtime_error("phases must have one element per Pauli string.");
+    }
+    size_t n_gates = circuit.codes.size();
+    size_t n_slots = circuit.touched_words.size();
+    size_t n_blocks = (n_rows + 63) / 64;
+    Z2R_KERNEL_STATS("clifford_conjugate", n_rows,
+                     n_rows * (4 * itemsize + 2 * sizeof(std::complex<double>)));
+
+    for (size_t i = 0; i < n_rows && new_z.data != z.data; ++i) {
+        std::memcpy(new_z.row(i), z.row(i), itemsize);
+    }
+    for (size_t i = 0; i < n_rows && new_x.data != x.data; ++i) {
+        std::memcpy(new_x.row(i), x.row(i), itemsize);
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n_blocks >= CLIFFORD_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> z_cols(n_slots * 64);
+        std::vector<uint64_t> x_cols(n_slots * 64);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t block = 0; block < n_blocks; ++block) {
+            size_t row0 = block * 64;
+            size_t rows = std::min<size_t>(64, n_rows - row0);
+
+            // Gather the touched words of the block (missing rows are zero), then transpose
+            for (size_t s = 0; s < n_slots; ++s) {
+                size_t offset = circuit.touched_words[s] * 8;
+                size_t nbytes = std::min<size_t>(8, itemsize - offset);
+                uint64_t *zc = z_cols.data() + s * 64;
+                uint64_t *xc = x_cols.data() + s * 64;
+                for (size_t r = 0; r < 64; ++r) {
+                    zc[r] = 0;
+                    xc[r] = 0;
+                    if (r < rows) {
+                        std::memcpy(&zc[r], new_z.row(row0 + r) + offset, nbytes);
+                        std::memcpy(&xc[r], new_x.row(row0 + r) + offset, nbytes);
+                    }
+                }
+                transpose64(zc);
+                transpose64(xc);
+            }
+
+            uint64_t sign = 0;
+            for (size_t g = 0; g < n_gates; ++g) {
+                apply_clifford_gate(circuit.codes[g], circuit.cols_a[g], circuit.cols_b[g],
+                                    z_cols.data(), x_cols.data(), sign);
+            }
+
+            // Transpose back and scatter the touched words
+            for (size_t s = 0; s < n_slots; ++s) {
+                size_t offset = circuit.touched_words[s] * 8;
+                size_t nbytes = std::min<size_t>(8, itemsize - offset);
+                uint64_t *zc = z_cols.data() + s * 64;
+                uint64_t *xc = x_cols.data() + s * 64;
+                transpose64(zc);
+                transpose64(xc);
+                for (size_t r = 0; r < rows; ++r) {
+                    std::memcpy(new_z.row(row0 + r) + offset, &zc[r], nbytes);
+                    std::memcpy(new_x.row(row0 + r) + offset, &xc[r], nbytes);
+                }
+            }
+
+            for (size_t r = 0; r < rows; ++r) {
+                new_phases[row0 + r] = ((sign >> r) & 1) ? -phases[row0 + r] : phases[row0 + r];
+            }
+        }
+    }
+}
+
+} // namespace z2r
@@ -0,0 +1,2162 @@
+/**
+ * @file z2r_core.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free kernels of the z2r_core library. See z2r_core.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note No argument checks are made here beyond the ones that would lead to out of bounds
+ * accesses; the Python adapters (bitops.cpp, cz2m.cpp) validate the arrays before calling in.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_core.h"
+#include "z2r_arena.h"
+#include "z2r_stats.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace z2r {
+
+void bitwise_and(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out) {
+    threads::apply();
+    Z2R_KERNEL_STATS("bitwise_and", a.size() / 8, 3 * a.size());
+    bitwise_binary(a, b, out, std::bit_and<uint64_t>());
+}
+
+void bitwise_xor(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out) {
+    threads::apply();
+    Z2R_KERNEL_STATS("bitwise_xor", a.size() / 8, 3 * a.size());
+    bitwise_binary(a, b, out, std::bit_xor<uint64_t>());
+}
+
+void bitwise_or(std::span<const uint8_t> a, std::span<const uint8_t> b, std::span<uint8_t> out) {
+    threads::apply();
+    Z2R_KERNEL_STATS("bitwise_or", a.size() / 8, 3 * a.size());
+    bitwise_binary(a, b, out, std::bit_or<uint64_t>());
+}
+
+std::vector<BatchRange> batch_ranges(std::span<const size_t> sizes, size_t chunk) {
+    std::vector<BatchRange> ranges;
+    for (size_t t = 0; t < sizes.size(); ++t) {
+        for (size_t begin = 0; begin < sizes[t]; begin += chunk) {
+            ranges.push_back({t, begin, std::min(begin + chunk, sizes[t])});
+        }
+    }
+    return ranges;
+}
+
+void bitwise_xor_many(std::span<const BinaryTask> tasks) {
+    threads::apply();
+    size_t total_bytes = 0;
+    for (const BinaryTask &task : tasks) {
+        total_bytes += task.a.size();
+    }
+    Z2R_KERNEL_STATS("bitwise_xor_many", total_bytes / 8, 3 * total_bytes);
+    bitwise_binary_many(tasks, std::bit_xor<uint64_t>());
+}
+
+/**
+ * @brief Flips all the bits of a byte buffer.
+ *
+ * @param in The input buffer
+ * @param out The output buffer, of the same size, which may alias the input
+ */
+void bitwise_not(std::span<const uint8_t> in, std::span<uint8_t> out) {
+    threads::apply();
+    if (in.size() != out.size()) {
+        throw std::runtime_error("Input and output must have the same size.");
+    }
+    const uint64_t *ptr_64 = std::bit_cast<const uint64_t *>(in.data());
+    uint64_t *ptr_out_64 = std::bit_cast<uint64_t *>(out.data());
+
+    size_t num_u64_chunks = in.size() / 8;
+    Z2R_KERNEL_STATS("bitwise_not", num_u64_chunks, 2 * in.size());
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (num_u64_chunks >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < num_u64_chunks; ++i) {
+            ptr_out_64[i] = ~ptr_64[i];
+        }
+    }
+
+    for (size_t i = num_u64_chunks * 8; i < in.size(); ++i) {
+        out[i] = static_cast<uint8_t>(~in[i]);
+    }
+}
+
+/**
+ * @brief Counts the number of set bits in each void.
+ *
+ * @param voids The voids
+ * @param out One count per void
+ */
+void bitwise_count(VoidView voids, std::span<int64_t> out) {
+    threads::apply();
+    if (out.size() != voids.rows) {
+        throw std::runtime_error("There must be one output per void.");
+    }
+    size_t itemsize = voids.itemsize;
+    size_t num_elem = voids.rows;
+    size_t u64_per_elem = itemsize / 8;
+    size_t tail_bytes = itemsize % 8;
+    size_t total_64_chunks = num_elem * u64_per_elem;
+    Z2R_KERNEL_STATS("bitwise_count", num_elem, num_elem * (itemsize + 8));
+
+    if (num_elem == 1) {
+        // A single (possibly huge) void: parallelize over its words instead
+        const uint8_t *base = voids.row(0);
+        int64_t count = 0;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (u64_per_elem >= BOPS_THRESHOLD_PARALLEL)
+#endif
+        {
+            Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime) reduction(+ : count)
+#endif
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t word;
+                std::memcpy(&word, base + k * 8, 8);
+                count += std::popcount(word);
+            }
+        }
+        count += std::popcount(load_tail(base + u64_per_elem * 8, tail_bytes));
+        out[0] = count;
+        return;
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (total_64_chunks >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < num_elem; ++i) {
+            const uint8_t *base = voids.row(i);
+            int64_t count = 0;
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t word;
+                std::memcpy(&word, base + k * 8, 8);
+                count += std::popcount(word);
+            }
+            count += std::popcount(load_tail(base + u64_per_elem * 8, tail_bytes));
+            out[i] = count;
+        }
+    }
+}
+
+/**
+ * @brief Computes the bitwise dot product (popcount of the AND) of corresponding voids.
+ *
+ * @param a The first voids
+ * @param b The second voids, with the same number of rows and itemsize
+ * @param out One dot product per pair of voids
+ */
+void bitwise_dot(VoidView a, VoidView b, std::span<int64_t> out) {
+    threads::apply();
+    if (a.itemsize != b.itemsize) {
+        throw std::runtime_error("Input arrays must have the same itemsize. Got " +
+                                 std::to_string(a.itemsize) + " and " +
+                                 std::to_string(b.itemsize));
+    }
+    if (a.rows != b.rows || out.size() != a.rows) {
+        throw std::runtime_error("Input arrays must have the same size. Got " +
+                                 std::to_string(a.rows) + " and " + std::to_string(b.rows));
+    }
+    size_t num_elem = a.rows;
+    size_t u64_per_elem = a.itemsize / 8;
+    size_t tail_bytes = a.itemsize % 8;
+    size_t total_64_chunks = num_elem * u64_per_elem;
+    Z2R_KERNEL_STATS("bitwise_dot", num_elem, num_elem * (2 * a.itemsize + 8));
+
+    if (num_elem == 1) {
+        const uint8_t *base1 = a.row(0);
+        const uint8_t *base2 = b.row(0);
+        int64_t count = 0;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (u64_per_elem >= BOPS_THRESHOLD_PARALLEL)
+#endif
+        {
+            Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime) reduction(+ : count)
+#endif
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t w1, w2;
+                std::memcpy(&w1, base1 + k * 8, 8);
+                std::memcpy(&w2, base2 + k * 8, 8);
+                count += std::popcount(w1 & w2);
+            }
+        }
+        count += std::popcount(load_tail(base1 + u64_per_elem * 8, tail_bytes) &
+                               load_tail(base2 + u64_per_elem * 8, tail_bytes));
+        out[0] = count;
+        return;
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (total_64_chunks >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < num_elem; ++i) {
+            const uint8_t *base1 = a.row(i);
+            const uint8_t *base2 = b.row(i);
+            int64_t count = 0;
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t w1, w2;
+                std::memcpy(&w1, base1 + k * 8, 8);
+                std::memcpy(&w2, base2 + k * 8, 8);
+                count += std::popcount(w1 & w2);
+            }
+            count += std::popcount(load_tail(base1 + u64_per_elem * 8, tail_bytes) &
+                                   load_tail(base2 + u64_per_elem * 8, tail_bytes));
+            out[i] = count;
+        }
+    }
+}
+
+namespace {
+
+void check_compose(VoidView z1, VoidView x1, VoidView z2, VoidView x2, MutableVoidView z_out,
+                   MutableVoidView x_out, std::span<std::complex<double>> phases) {
+    for (VoidView v : {x1, z2, x2, VoidView(z_out), VoidView(x_out)}) {
+        if (v.rows != z1.rows || v.itemsize != z1.itemsize) {
+            throw std::runtime_error("Input arrays must have the same size and itemsize.");
+        }
+    }
+    if (phases.size() != z1.rows) {
+        throw std::runtime_error("There must be one phase per Pauli string.");
+    }
+}
+
+// Computes row i of the composition described by t
+inline void compose_row(const ComposeTask &t, size_t i) {
+    static const std::complex<double> phase_of_power[4] = {
+        {1.0, 0.0}, {0.0, -1.0}, {-1.0, 0.0}, {0.0, 1.0}};
+    size_t u64_per_elem = t.z1.itemsize / 8;
+    size_t tail_bytes = t.z1.itemsize % 8;
+
+    int64_t power = 0;
+    auto step = [&](uint64_t a_z, uint64_t a_x, uint64_t b_z, uint64_t b_x, uint64_t &n_z,
+                    uint64_t &n_x) {
+        n_z = a_z ^ b_z;
+        n_x = a_x ^ b_x;
+        power += 2 * std::popcount(a_x & b_z) + std::popcount(a_z & a_x) +
+                 std::popcount(b_z & b_x) - std::popcount(n_z & n_x);
+    };
+    for (size_t k = 0; k < u64_per_elem; ++k) {
+        uint64_t a_z, a_x, b_z, b_x, n_z, n_x;
+        std::memcpy(&a_z, t.z1.row(i) + k * 8, 8);
+        std::memcpy(&a_x, t.x1.row(i) + k * 8, 8);
+        std::memcpy(&b_z, t.z2.row(i) + k * 8, 8);
+        std::memcpy(&b_x, t.x2.row(i) + k * 8, 8);
+        step(a_z, a_x, b_z, b_x, n_z, n_x);
+        std::memcpy(t.z_out.row(i) + k * 8, &n_z, 8);
+        std::memcpy(t.x_out.row(i) + k * 8, &n_x, 8);
+    }
+    if (tail_bytes) {
+        size_t off = u64_per_elem * 8;
+        uint64_t n_z, n_x;
+        step(load_tail(t.z1.row(i) + off, tail_bytes), load_tail(t.x1.row(i) + off, tail_bytes),
+             load_tail(t.z2.row(i) + off, tail_bytes), load_tail(t.x2.row(i) + off, tail_bytes),
+             n_z, n_x);
+        std::memcpy(t.z_out.row(i) + off, &n_z, tail_bytes);
+        std::memcpy(t.x_out.row(i) + off, &n_x, tail_bytes);
+    }
+    // & 3 is the positive remainder, even when power < 0
+    t.phases[i] = phase_of_power[power & 3];
+}
+
+// First and last + 1 of the static chunk of thread t out of n, so that the chunks follow each other
+// in thread order
+inline std::pair<size_t, size_t> thread_chunk(size_t rows, size_t t, size_t n) {
+    return {rows * t / n, rows * (t + 1) / n};
+}
+
+} // namespace
+
+/**
+ * @brief Composes Pauli strings row by row, P_i = P1_i P2_i, in a single pass: the new Z and X are
+ * the XORs of the inputs, and the phase (-i)^p, with
+ * p = 2 x1.z2 + z1.x1 + z2.x2 - z.x (mod 4), is accumulated from the same words.
+ *
+ * @param z1 Z voids of the first Pauli strings
+ * @param x1 X voids of the first Pauli strings
+ * @param z2 Z voids of the second Pauli strings
+ * @param x2 X voids of the second Pauli strings
+ * @param z_out Z voids of the products
+ * @param x_out X voids of the products
+ * @param phases Phase of each product
+ */
+void compose(VoidView z1, VoidView x1, VoidView z2, VoidView x2, MutableVoidView z_out,
+             MutableVoidView x_out, std::span<std::complex<double>> phases) {
+    threads::apply();
+    check_compose(z1, x1, z2, x2, z_out, x_out, phases);
+    const ComposeTask task{z1, x1, z2, x2, z_out, x_out, phases};
+    size_t rows = z1.rows;
+    Z2R_KERNEL_STATS("compose", rows, rows * (6 * z1.itemsize + sizeof(std::complex<double>)));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            compose_row(task, i);
+        }
+    }
+}
+
+/**
+ * @brief Batched compose(): every composition of the batch, in a single parallel loop over all of
+ * their rows. Every task is validated before any of them is computed.
+ *
+ * @param tasks The compositions, each with the arguments of a compose() call
+ */
+void compose_many(std::span<const ComposeTask> tasks) {
+    threads::apply();
+    std::vector<size_t> rows(tasks.size());
+    size_t total_rows = 0;
+    size_t total_bytes = 0;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        const ComposeTask &task = tasks[t];
+        check_compose(task.z1, task.x1, task.z2, task.x2, task.z_out, task.x_out, task.phases);
+        rows[t] = task.z1.rows;
+        total_rows += rows[t];
+        total_bytes += rows[t] * (6 * task.z1.itemsize + sizeof(std::complex<double>));
+    }
+    std::vector<BatchRange> ranges = batch_ranges(rows, BATCH_CHUNK_SIZE);
+    Z2R_KERNEL_STATS("compose_many", total_rows, total_bytes);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (total_rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            for (size_t i = ranges[r].begin; i < ranges[r].end; ++i) {
+                compose_row(tasks[ranges[r].task], i);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks, row by row, whether two Pauli strings commute qubit-wise, i.e. whether
+ * (z1 & x2) ^ (x1 & z2) has no bit set.
+ *
+ * @param z1 Z voids of the first Pauli strings
+ * @param x1 X voids of the first Pauli strings
+ * @param z2 Z voids of the second Pauli strings
+ * @param x2 X voids of the second Pauli strings
+ * @param out One flag per pair of Pauli strings
+ */
+void commute_with(VoidView z1, VoidView x1, VoidView z2, VoidView x2, std::span<bool> out) {
+    threads::apply();
+    size_t rows = z1.rows;
+    size_t itemsize = z1.itemsize;
+    for (VoidView v : {x1, z2, x2}) {
+        if (v.rows != rows || v.itemsize != itemsize) {
+            throw std::runtime_error("Input arrays must have the same size and itemsize.");
+        }
+    }
+    if (out.size() != rows) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+    size_t u64_per_elem = itemsize / 8;
+    size_t tail_bytes = itemsize % 8;
+    Z2R_KERNEL_STATS("commute_with", rows, rows * (4 * itemsize + 1));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (u64_per_elem + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            uint64_t acc = 0;
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t a_z, a_x, b_z, b_x;
+                std::memcpy(&a_z, z1.row(i) + k * 8, 8);
+                std::memcpy(&a_x, x1.row(i) + k * 8, 8);
+                std::memcpy(&b_z, z2.row(i) + k * 8, 8);
+                std::memcpy(&b_x, x2.row(i) + k * 8, 8);
+                acc |= (a_z & b_x) ^ (a_x & b_z);
+            }
+            if (tail_bytes) {
+                size_t off = u64_per_elem * 8;
+                acc |= (load_tail(z1.row(i) + off, tail_bytes) &
+                        load_tail(x2.row(i) + off, tail_bytes)) ^
+                       (load_tail(x1.row(i) + off, tail_bytes) &
+                        load_tail(z2.row(i) + off, tail_bytes));
+            }
+            out[i] = acc == 0;
+        }
+    }
+}
+
+/**
+ * @brief Transposes M voids of (at least) N bits, seen as an M x N bit matrix, into N voids of M
+ * bits: bit j of void i becomes bit i of void j.
+ *
+ * @param voids The M input voids
+ * @param num_bits Number of bits N to transpose
+ * @param out The N output voids, of at least (M + 7) / 8 bytes
+ */
+void transpose(VoidView voids, size_t num_bits, MutableVoidView out) {
+    threads::apply();
+    size_t M = voids.rows;
+    if (num_bits > voids.itemsize * 8) {
+        throw std::runtime_error("num_bits cannot exceed itemsize * 8");
+    }
+    if (out.rows != num_bits || out.itemsize * 8 < M) {
+        throw std::runtime_error("Output of transpose is too small.");
+    }
+    Z2R_KERNEL_STATS("transpose", M, M * voids.itemsize + num_bits * out.itemsize);
+
+    // Transpose: bit j of element i becomes bit i of element j. Each output row is cleared by the
+    // thread that fills it, so that its pages are first touched from that thread's NUMA node.
+#ifdef USE_OPENMP
+    #pragma omp parallel if (num_bits * M >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t j = 0; j < num_bits; ++j) {
+            size_t byte_idx_in = j / 8;
+            size_t bit_idx_in = j % 8;
+            uint8_t *row_out = out.row(j);
+            std::memset(row_out, 0, out.itemsize);
+
+            for (size_t i = 0; i < M; ++i) {
+                uint8_t bit = (voids.row(i)[byte_idx_in] >> bit_idx_in) & 1;
+                if (bit) {
+                    row_out[i / 8] |= (1 << (i % 8));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Product over Z2 of an (a_rows x a_cols) bit matrix by an (a_cols x b_cols) bit matrix,
+ * each row being a void.
+ *
+ * @todo Optimize the heavy nested loops in this function.
+ *
+ * @param a The rows of A
+ * @param b The rows of B
+ * @param a_cols Number of columns of A (must be the number of rows of B)
+ * @param b_cols Number of columns of B
+ * @param out The a_rows rows of the product, of at least (b_cols + 7) / 8 bytes
+ */
+void matmul(VoidView a, VoidView b, size_t a_cols, size_t b_cols, MutableVoidView out) {
+    if (a_cols != b.rows) {
+        throw std::runtime_error("Shape mismatch for matrix multiplication: A columns (" +
+                                 std::to_string(a_cols) + ") must equal B rows (" +
+                                 std::to_string(b.rows) + ").");
+    }
+    if (out.rows != a.rows || out.itemsize * 8 < b_cols) {
+        throw std::runtime_error("Output of matmul is too small.");
+    }
+    threads::apply();
+    size_t work = a.rows * b_cols * a_cols;
+    Z2R_KERNEL_STATS("matmul", a.rows,
+                     a.rows * a.itemsize + b.rows * b.itemsize + out.rows * out.itemsize);
+
+    // Rows are independent: each one is cleared and filled by the same thread, which also makes it
+    // first touched from that thread's NUMA node.
+#ifdef USE_OPENMP
+    #pragma omp parallel if (work >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < a.rows; i++) {
+            std::memset(out.row(i), 0, out.itemsize);
+            for (size_t j = 0; j < b_cols; j++) {
+                uint8_t bit_sum = 0;
+                for (size_t k = 0; k < a_cols; k++) {
+                    // Bit k of row i in A, and bit j of row k in B
+                    uint8_t a_bit = (a.row(i)[k / 8] >> (k % 8)) & 1;
+                    uint8_t b_bit = (b.row(k)[j / 8] >> (j % 8)) & 1;
+                    bit_sum += a_bit & b_bit;
+                }
+                if (bit_sum % 2) { // Modulo 2 for bitwise addition
+                    out.row(i)[j / 8] |= (1 << (j % 8));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Accumulates the pairwise products of two weighted sums of Pauli strings, A = sum_i a_i P_i
+ * and B = sum_j b_j Q_j.
+ *
+ * Every pair (P_i, Q_j) is composed on the fly: the product Pauli string is the XOR of the zx
+ * voids, and its phase, computed as in compose(), is folded into a_i * b_j. The products are
+ * accumulated into one PauliAccumulator per thread, which are merged at the end. The N*M
+ * intermediate products are thus never stored.
+ *
+ * With `anticommuting_only`, the pairs for which P_i and Q_j commute are skipped before being
+ * composed, and the surviving products are doubled. This gives [A, B] = AB - BA, since
+ * Q_j P_i = -P_i Q_j for the anticommuting pairs and the commuting ones cancel exactly.
+ *
+ * @param zx_a Z and X voids stitched together (Z bits [0, n), X bits [n, 2n)) of the terms of A
+ * @param w_a Weights of the terms of A
+ * @param zx_b Stitched voids of the terms of B, with the same itemsize as zx_a
+ * @param w_b Weights of the terms of B
+ * @param num_qubits Number of qubits n
+ * @param anticommuting_only Only keep the anticommuting pairs, with a factor of 2
+ * @return PauliAccumulator The unique product Pauli strings and their summed weights
+ */
+PauliAccumulator accumulate_products(VoidView zx_a, std::span<const std::complex<double>> w_a,
+                                     VoidView zx_b, std::span<const std::complex<double>> w_b,
+                                     size_t num_qubits, bool anticommuting_only) {
+    threads::apply();
+    if (zx_a.itemsize != zx_b.itemsize) {
+        throw std::runtime_error("Input arrays must have the same itemsize. Got " +
+                                 std::to_string(zx_a.itemsize) + " and " +
+                                 std::to_string(zx_b.itemsize));
+    }
+    if (w_a.size() != zx_a.rows || w_b.size() != zx_b.rows) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+    size_t itemsize = zx_a.itemsize;
+    if (2 * num_qubits > itemsize * 8) {
+        throw std::runtime_error("2 * num_qubits exceeds bit capacity of the zx dtype.");
+    }
+
+    size_t n_a = zx_a.rows;
+    size_t n_b = zx_b.rows;
+    size_t n = num_qubits;
+    size_t words = std::max<size_t>((n + 63) / 64, 1);
+    size_t row_words = (itemsize + 7) / 8;
+
+#ifdef USE_OPENMP
+    int n_threads = (n_a * n_b >= FUNC_THRESHOLD_PARALLEL) ? omp_get_max_threads() : 1;
+#else
+    int n_threads = 1;
+#endif
+    Z2R_KERNEL_STATS("accumulate_products", n_a * n_b,
+                     (n_a + n_b) * (itemsize + sizeof(std::complex<double>)));
+    std::vector<PauliAccumulator> partials;
+    partials.reserve(n_threads);
+    for (int t = 0; t < n_threads; ++t) {
+        partials.emplace_back(itemsize);
+    }
+
+    // Padded raw rows (for the product keys) and split Z/X words (for the phases)
+    auto unpack = [&](VoidView zx, arena::vector<uint64_t> &raw, arena::vector<uint64_t> &z,
+                      arena::vector<uint64_t> &x, arena::vector<uint8_t> &self_power) {
+        raw.assign(zx.rows * row_words, 0);
+        z.assign(zx.rows * words, 0);
+        x.assign(zx.rows * words, 0);
+        self_power.assign(zx.rows, 0);
+        std::vector<uint64_t> scratch(itemsize / 8 + 2);
+        for (size_t i = 0; i < zx.rows; ++i) {
+            std::memcpy(&raw[i * row_words], zx.row(i), itemsize);
+            if (n > 0) {
+                split_zx_row(zx.row(i), itemsize, n, scratch.data(), &z[i * words], &x[i * words]);
+            }
+            int count = 0;
+            for (size_t k = 0; k < words; ++k) {
+                count += std::popcount(z[i * words + k] & x[i * words + k]);
+            }
+            self_power[i] = count & 3;
+        }
+    };
+    arena::vector<uint64_t> raw_a, z_a, x_a, raw_b, z_b, x_b;
+    arena::vector<uint8_t> self_a, self_b;
+    unpack(zx_a, raw_a, z_a, x_a, self_a);
+    unpack(zx_b, raw_b, z_b, x_b, self_b);
+
+    // (-i)^power, doubled for the commutator
+    const double scale = anticommuting_only ? 2.0 : 1.0;
+    const std::complex<double> phases[4] = {
+        {scale, 0.0}, {0.0, -scale}, {-scale, 0.0}, {0.0, scale}};
+
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(n_threads)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+        PauliAccumulator &acc = partials[omp_get_thread_num()];
+#else
+        PauliAccumulator &acc = partials[0];
+#endif
+        std::vector<uint64_t> key(row_words);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < n_a; ++i) {
+            const uint64_t *ra = &raw_a[i * row_words];
+            const uint64_t *za = &z_a[i * words];
+            const uint64_t *xa = &x_a[i * words];
+            for (size_t j = 0; j < n_b; ++j) {
+                const uint64_t *zb = &z_b[j * words];
+                const uint64_t *xb = &x_b[j * words];
+
+                // Symplectic product first: it is all we need to discard a commuting pair
+                int comm = 0;
+                int symplectic = 0;
+                for (size_t k = 0; k < words; ++k) {
+                    comm += std::popcount(xa[k] & zb[k]);
+                    symplectic += std::popcount(za[k] & xb[k]);
+                }
+                if (anticommuting_only && ((comm + symplectic) & 1) == 0) {
+                    continue;
+                }
+
+                const uint64_t *rb = &raw_b[j * row_words];
+                int new_power = 0;
+                for (size_t k = 0; k < words; ++k) {
+                    new_power += std::popcount((za[k] ^ zb[k]) & (xa[k] ^ xb[k]));
+                }
+                for (size_t k = 0; k < row_words; ++k) {
+                    key[k] = ra[k] ^ rb[k];
+                }
+                int power = (2 * comm + self_a[i] + self_b[j] - new_power) & 3;
+                acc.add(std::bit_cast<const uint8_t *>(key.data()), w_a[i] * w_b[j] * phases[power]);
+            }
+        }
+    }
+
+    for (int t = 1; t < n_threads; ++t) {
+        partials[0].merge(partials[t]);
+    }
+    return std::move(partials[0]);
+}
+
+/**
+ * @brief Sums the weights of identical Pauli strings.
+ *
+ * The strings are hashed once with hash_void(). When going multi-threaded, they are split into one
+ * partition per thread, from their (remixed) hash, and bucketed by partition. Each partition is
+ * filled by a single thread, from its own bucket, in its own PauliAccumulator, so the tables are
+ * built in parallel without any lock nor final merge, and each string is read by one thread only.
+ *
+ * @param zx_voids The Pauli strings (any void layout, only byte equality matters)
+ * @param weights One weight per Pauli string
+ * @return std::vector<PauliAccumulator> Disjoint accumulators, one per partition, which together
+ * hold every unique Pauli string once
+ */
+std::vector<PauliAccumulator> simplify(VoidView zx_voids,
+                                       std::span<const std::complex<double>> weights) {
+    threads::apply();
+    if (weights.size() != zx_voids.rows) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+    size_t itemsize = zx_voids.itemsize;
+    size_t num_terms = zx_voids.rows;
+
+#ifdef USE_OPENMP
+    int n_threads = (num_terms >= FUNC_THRESHOLD_PARALLEL) ? omp_get_max_threads() : 1;
+#else
+    int n_threads = 1;
+#endif
+    Z2R_KERNEL_STATS("simplify", num_terms, num_terms * (itemsize + sizeof(std::complex<double>)));
+    std::vector<PauliAccumulator> partials;
+    partials.reserve(n_threads);
+    for (int t = 0; t < n_threads; ++t) {
+        partials.emplace_back(itemsize);
+    }
+
+    if (n_threads == 1) {
+        partials[0].reserve(num_terms);
+        for (size_t i = 0; i < num_terms; ++i) {
+            partials[0].add(zx_voids.row(i), weights[i]);
+        }
+        return partials;
+    }
+
+    // The rows are bucketed by partition, in their order, with a counting sort over n_threads
+    // contiguous chunks: every chunk counts its rows per partition, a prefix sum over the
+    // partitions then the chunks gives where each (chunk, partition) pair starts, and the chunks
+    // scatter their rows there. Chunks and partitions are handed out as loop iterations rather than
+    // by thread number: the runtime may give a smaller team than asked (OMP_DYNAMIC,
+    // OMP_THREAD_LIMIT, nested call), and every one of them must still be processed.
+    size_t parts = static_cast<size_t>(n_threads);
+    arena::vector<uint32_t> owner(num_terms);
+    std::vector<size_t> starts(parts * parts, 0);
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(n_threads)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(static, 1)
+#endif
+        for (size_t c = 0; c < parts; ++c) {
+            auto [begin, end] = thread_chunk(num_terms, c, parts);
+            size_t *counts = &starts[c * parts];
+            for (size_t i = begin; i < end; ++i) {
+                owner[i] = static_cast<uint32_t>(
+                    bounded_rng64(splitmix64(hash_void(zx_voids.row(i), itemsize)),
+                                  static_cast<uint64_t>(parts)));
+                ++counts[owner[i]];
+            }
+        }
+    }
+
+    // bounds[p] is the first of the rows of partition p
+    std::vector<size_t> bounds(parts + 1);
+    size_t offset = 0;
+    for (size_t p = 0; p < parts; ++p) {
+        bounds[p] = offset;
+        for (size_t c = 0; c < parts; ++c) {
+            size_t count = starts[c * parts + p];
+            starts[c * parts + p] = offset;
+            offset += count;
+        }
+    }
+    bounds[parts] = offset;
+
+    arena::vector<size_t> order(num_terms);
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(n_threads)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(static, 1)
+#endif
+        for (size_t c = 0; c < parts; ++c) {
+            auto [begin, end] = thread_chunk(num_terms, c, parts);
+            size_t *next = &starts[c * parts];
+            for (size_t i = begin; i < end; ++i) {
+                order[next[owner[i]]++] = i;
+            }
+        }
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(n_threads)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+        for (size_t p = 0; p < parts; ++p) {
+            PauliAccumulator &acc = partials[p];
+            acc.reserve(bounds[p + 1] - bounds[p]);
+            for (size_t k = bounds[p]; k < bounds[p + 1]; ++k) {
+                acc.add(zx_voids.row(order[k]), weights[order[k]]);
+            }
+        }
+    }
+
+    return partials;
+}
+
+/**
+ * @brief Assigns every Pauli string to one of `num_partitions` partitions, from its hash_void().
+ * Identical strings always land in the same partition, whatever the array they come from.
+ *
+ * @param zx_voids The Pauli strings
+ * @param num_partitions The number of partitions
+ * @param out The partition of each Pauli string, in [0, num_partitions)
+ */
+void hash_partition(VoidView zx_voids, uint64_t num_partitions, std::span<int64_t> out) {
+    threads::apply();
+    if (num_partitions == 0) {
+        throw std::runtime_error("num_partitions must be positive.");
+    }
+    if (out.size() != zx_voids.rows) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+    size_t num_terms = zx_voids.rows;
+    Z2R_KERNEL_STATS("hash_partition", num_terms, num_terms * (zx_voids.itemsize + 8));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (num_terms >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < num_terms; ++i) {
+            out[i] = static_cast<int64_t>(
+                bounded_rng64(hash_void(zx_voids.row(i), zx_voids.itemsize), num_partitions));
+        }
+    }
+}
+
+
+/**
+ * @brief In NUMA mode (threads::numa()), writes a zero to every page of a fresh buffer from the
+ * threads of a static parallel loop, so that the pages are allocated on the node of the thread
+ * whose static chunk of a kernel will cover them. Does nothing otherwise, or on small buffers.
+ *
+ * @param bytes The buffer, whose content is left unspecified
+ */
+void first_touch(std::span<uint8_t> bytes) {
+    if (!threads::numa() || bytes.size() < NUMA_FIRST_TOUCH_BYTES) {
+        return;
+    }
+    threads::apply();
+    constexpr size_t PAGE = 4096;
+    size_t pages = (bytes.size() + PAGE - 1) / PAGE;
+    Z2R_KERNEL_STATS("first_touch", pages, bytes.size());
+
+#ifdef USE_OPENMP
+    #pragma omp parallel
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+        for (size_t p = 0; p < pages; ++p) {
+            bytes[p * PAGE] = 0;
+        }
+    }
+}
+
+namespace {
+
+// Number of 64-bit words of each half of a stitched zx void, after checking its capacity
+size_t zx_words(VoidView zx, size_t num_qubits) {
+    if (2 * num_qubits > zx.itemsize * 8) {
+        throw std::runtime_error("2 * num_qubits exceeds bit capacity of the zx dtype.");
+    }
+    return std::max<size_t>((num_qubits + 63) / 64, 1);
+}
+
+void check_zx_pair(VoidView zx1, VoidView zx2, size_t out_rows) {
+    if (zx1.rows != zx2.rows || zx1.itemsize != zx2.itemsize) {
+        throw std::runtime_error("Input arrays must have the same size and itemsize.");
+    }
+    if (out_rows != zx1.rows) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+}
+
+// Z and X words of a stitched zx void. The words past the last qubit are left untouched, so they
+// stay zero if they were.
+inline void load_zx(const uint8_t *row, size_t itemsize, size_t num_qubits, uint64_t *buffer,
+                    uint64_t *z, uint64_t *x) {
+    if (num_qubits > 0) {
+        split_zx_row(row, itemsize, num_qubits, buffer, z, x);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Splits stitched zx voids into separate Z and X voids.
+ *
+ * @param zx The stitched voids, Z bits [0, n) followed by X bits [n, 2n)
+ * @param num_qubits Number of qubits n
+ * @param z_out Z voids, of at least (n + 7) / 8 bytes. The bits past n are cleared.
+ * @param x_out X voids, with the same itemsize as z_out
+ */
+void split_zx(VoidView zx, size_t num_qubits, MutableVoidView z_out, MutableVoidView x_out) {
+    threads::apply();
+    size_t words = zx_words(zx, num_qubits);
+    size_t rows = zx.rows;
+    size_t out_itemsize = z_out.itemsize;
+    if (z_out.rows != rows || x_out.rows != rows || x_out.itemsize != out_itemsize) {
+        throw std::runtime_error("There must be one Z and one X void per zx void.");
+    }
+    if (num_qubits > out_itemsize * 8) {
+        throw std::runtime_error("num_qubits exceeds bit capacity of the output dtype.");
+    }
+    Z2R_KERNEL_STATS("split_zx", rows, rows * (zx.itemsize + 2 * out_itemsize));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        size_t out_words = std::max(words, (out_itemsize + 7) / 8);
+        std::vector<uint64_t> buffer(zx.itemsize / 8 + 2);
+        std::vector<uint64_t> z(out_words, 0);
+        std::vector<uint64_t> x(out_words, 0);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            load_zx(zx.row(i), zx.itemsize, num_qubits, buffer.data(), z.data(), x.data());
+            std::memcpy(z_out.row(i), z.data(), out_itemsize);
+            std::memcpy(x_out.row(i), x.data(), out_itemsize);
+        }
+    }
+}
+
+/**
+ * @brief Stitches separate Z and X voids into zx voids. Inverse of split_zx().
+ *
+ * @param z Z voids, of at least (n + 7) / 8 bytes. The bits past n are ignored.
+ * @param x X voids, with the same size and itemsize as z
+ * @param num_qubits Number of qubits n
+ * @param zx_out The stitched voids, of at least (2n + 7) / 8 bytes. The bits past 2n are cleared.
+ */
+void stitch_zx(VoidView z, VoidView x, size_t num_qubits, MutableVoidView zx_out) {
+    threads::apply();
+    size_t words = zx_words(zx_out, num_qubits);
+    size_t rows = z.rows;
+    size_t in_itemsize = z.itemsize;
+    if (x.rows != rows || x.itemsize != in_itemsize) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+    if (zx_out.rows != rows) {
+        throw std::runtime_error("There must be one zx void per Z and X void.");
+    }
+    if (num_qubits > in_itemsize * 8) {
+        throw std::runtime_error("num_qubits exceeds bit capacity of the input dtype.");
+    }
+    Z2R_KERNEL_STATS("stitch_zx", rows, rows * (2 * in_itemsize + zx_out.itemsize));
+
+    size_t in_bytes = std::min(in_itemsize, words * 8);
+    uint64_t last_mask =
+        (num_qubits % 64) ? (uint64_t{1} << (num_qubits % 64)) - 1 : ~uint64_t{0};
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(zx_out.itemsize / 8 + 2);
+        std::vector<uint64_t> zw(words, 0);
+        std::vector<uint64_t> xw(words, 0);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            std::memcpy(zw.data(), z.row(i), in_bytes);
+            std::memcpy(xw.data(), x.row(i), in_bytes);
+            zw[words - 1] &= last_mask;
+            xw[words - 1] &= last_mask;
+            stitch_zx_row(zw.data(), xw.data(), zx_out.itemsize, num_qubits, buffer.data(),
+                          zx_out.row(i));
+        }
+    }
+}
+
+/**
+ * @brief compose() on stitched zx voids. The product of two rows is the XOR of the whole rows; only
+ * the phase needs the Z and X halves, which are split in registers from the same cache lines.
+ *
+ * @param zx1 Stitched voids of the first Pauli strings
+ * @param zx2 Stitched voids of the second Pauli strings, with the same size and itemsize
+ * @param num_qubits Number of qubits n
+ * @param zx_out Stitched voids of the products. May be zx1 or zx2, to compose in place.
+ * @param phases Phase of each product, (-i)^p as in compose()
+ */
+void zx_compose(VoidView zx1, VoidView zx2, size_t num_qubits, MutableVoidView zx_out,
+                std::span<std::complex<double>> phases) {
+    threads::apply();
+    check_zx_pair(zx1, zx2, phases.size());
+    if (zx_out.rows != zx1.rows || zx_out.itemsize != zx1.itemsize) {
+        throw std::runtime_error("Input arrays must have the same size and itemsize.");
+    }
+    size_t words = zx_words(zx1, num_qubits);
+    size_t rows = zx1.rows;
+    size_t itemsize = zx1.itemsize;
+    size_t u64_per_elem = itemsize / 8;
+    Z2R_KERNEL_STATS("zx_compose", rows, rows * (3 * itemsize + sizeof(std::complex<double>)));
+    static const std::complex<double> phase_of_power[4] = {
+        {1.0, 0.0}, {0.0, -1.0}, {-1.0, 0.0}, {0.0, 1.0}};
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(itemsize / 8 + 2);
+        std::vector<uint64_t> v(4 * words, 0);
+        uint64_t *z1 = v.data();
+        uint64_t *x1 = z1 + words;
+        uint64_t *z2 = x1 + words;
+        uint64_t *x2 = z2 + words;
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            const uint8_t *a = zx1.row(i);
+            const uint8_t *b = zx2.row(i);
+            uint8_t *out = zx_out.row(i);
+            load_zx(a, itemsize, num_qubits, buffer.data(), z1, x1);
+            load_zx(b, itemsize, num_qubits, buffer.data(), z2, x2);
+            int64_t power = 0;
+            for (size_t k = 0; k < words; ++k) {
+                power += 2 * std::popcount(x1[k] & z2[k]) + std::popcount(z1[k] & x1[k]) +
+                         std::popcount(z2[k] & x2[k]) -
+                         std::popcount((z1[k] ^ z2[k]) & (x1[k] ^ x2[k]));
+            }
+            // & 3 is the positive remainder, even when power < 0
+            phases[i] = phase_of_power[power & 3];
+
+            for (size_t k = 0; k < u64_per_elem; ++k) {
+                uint64_t wa, wb;
+                std::memcpy(&wa, a + k * 8, 8);
+                std::memcpy(&wb, b + k * 8, 8);
+                wa ^= wb;
+                std::memcpy(out + k * 8, &wa, 8);
+            }
+            for (size_t k = u64_per_elem * 8; k < itemsize; ++k) {
+                out[k] = a[k] ^ b[k];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Commutation of Pauli strings on stitched zx voids, row by row.
+ *
+ * @param zx1 Stitched voids of the first Pauli strings
+ * @param zx2 Stitched voids of the second Pauli strings, with the same size and itemsize
+ * @param num_qubits Number of qubits n
+ * @param qubit_wise If true, whether the strings commute on every qubit, as commute_with().
+ * Otherwise, whether they commute as operators: z1.x2 + x1.z2 is even.
+ * @param out One flag per pair of Pauli strings
+ */
+void zx_commute_with(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                     std::span<bool> out) {
+    threads::apply();
+    check_zx_pair(zx1, zx2, out.size());
+    size_t words = zx_words(zx1, num_qubits);
+    size_t rows = zx1.rows;
+    size_t itemsize = zx1.itemsize;
+    Z2R_KERNEL_STATS("zx_commute_with", rows, rows * (2 * itemsize + 1));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(itemsize / 8 + 2);
+        std::vector<uint64_t> v(4 * words, 0);
+        uint64_t *z1 = v.data();
+        uint64_t *x1 = z1 + words;
+        uint64_t *z2 = x1 + words;
+        uint64_t *x2 = z2 + words;
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            load_zx(zx1.row(i), itemsize, num_qubits, buffer.data(), z1, x1);
+            load_zx(zx2.row(i), itemsize, num_qubits, buffer.data(), z2, x2);
+            uint64_t acc = 0;
+            int parity = 0;
+            for (size_t k = 0; k < words; ++k) {
+                uint64_t anti = (z1[k] & x2[k]) ^ (x1[k] & z2[k]);
+                acc |= anti;
+                parity ^= std::popcount(anti);
+            }
+            out[i] = qubit_wise ? acc == 0 : (parity & 1) == 0;
+        }
+    }
+}
+
+/**
+ * @brief Weight (number of non-identity qubits, popcount of z | x) of Pauli strings on stitched zx
+ * voids.
+ *
+ * @param zx Stitched voids of the Pauli strings
+ * @param num_qubits Number of qubits n
+ * @param out The weight of each Pauli string
+ */
+void zx_weight(VoidView zx, size_t num_qubits, std::span<int64_t> out) {
+    threads::apply();
+    if (out.size() != zx.rows) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+    size_t words = zx_words(zx, num_qubits);
+    size_t rows = zx.rows;
+    Z2R_KERNEL_STATS("zx_weight", rows, rows * (zx.itemsize + 8));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(zx.itemsize / 8 + 2);
+        std::vector<uint64_t> z(words, 0);
+        std::vector<uint64_t> x(words, 0);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            load_zx(zx.row(i), zx.itemsize, num_qubits, buffer.data(), z.data(), x.data());
+            int64_t weight = 0;
+            for (size_t k = 0; k < words; ++k) {
+                weight += std::popcount(z[k] | x[k]);
+            }
+            out[i] = weight;
+        }
+    }
+}
+
+namespace {
+
+// Whether two loaded zx voids do not commute (qubit-wise or as operators)
+inline bool zx_anticommute(const uint64_t *z1, const uint64_t *x1, const uint64_t *z2,
+                           const uint64_t *x2, size_t words, bool qubit_wise) {
+    uint64_t acc = 0;
+    int parity = 0;
+    for (size_t k = 0; k < words; ++k) {
+        uint64_t anti = (z1[k] & x2[k]) ^ (x1[k] & z2[k]);
+        acc |= anti;
+        parity ^= std::popcount(anti);
+    }
+    return qubit_wise ? acc != 0 : (parity & 1) != 0;
+}
+
+// Z and X words of rows [begin, end) of zx, loaded into out: row begin + r at r * 2 * words, its X
+// words after its Z words
+void load_zx_rows(VoidView zx, size_t begin, size_t end, size_t num_qubits, size_t words,
+                  std::vector<uint64_t> &buffer, std::vector<uint64_t> &out) {
+    out.assign((end - begin) * 2 * words, 0);
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t *z = out.data() + (i - begin) * 2 * words;
+        load_zx(zx.row(i), zx.itemsize, num_qubits, buffer.data(), z, z + words);
+    }
+}
+
+// Rows of zx1 and zx2 of task t of the commutation kernels, out of tiles tiles of zx1 per block of
+// zx2. The tasks go block by block, so that the first rows of zx2 are handed out first.
+struct CommuteTask {
+    size_t begin1, end1, begin2, end2;
+
+    CommuteTask(size_t t, size_t tiles, size_t m, size_t rows)
+        : begin1((t % tiles) * COMMUTE_TILE_ROWS),
+          end1(std::min(begin1 + COMMUTE_TILE_ROWS, m)),
+          begin2((t / tiles) * COMMUTE_BLOCK_ROWS),
+          end2(std::min(begin2 + COMMUTE_BLOCK_ROWS, rows)) {}
+};
+
+} // namespace
+
+/**
+ * @brief Reduces the commutation of every row of zx1 with all the rows of zx2, without
+ * materializing the m x N flags. The m x N pairs are split in tiles of COMMUTE_TILE_ROWS rows of
+ * zx1 by COMMUTE_BLOCK_ROWS rows of zx2, handed out to the threads in order of their block of zx2.
+ * A task loads its rows once, then checks each of its rows of zx1 against the whole block. For the
+ * First* reductions, a row of zx1 stops being checked past its first hit, and a task past the first
+ * hit of every one of its rows is skipped at once, so that the answer costs about the position of
+ * the hit rather than N.
+ *
+ * @param zx1 Stitched voids of the m Pauli strings to check (one for a one-vs-many check)
+ * @param zx2 Stitched voids of the N Pauli strings to check against, with the itemsize of zx1
+ * @param num_qubits Number of qubits n
+ * @param qubit_wise Whether to test qubit-wise commutation instead of operator commutation
+ * @param reduction The reduction over the rows of zx2
+ * @param out One result per row of zx1
+ */
+void zx_commute_reduce(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                       CommuteReduction reduction, std::span<int64_t> out) {
+    threads::apply();
+    if (zx1.itemsize != zx2.itemsize) {
+        throw std::runtime_error("Input arrays must have the same itemsize.");
+    }
+    if (out.size() != zx1.rows) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+    size_t words = zx_words(zx1, num_qubits);
+    size_t m = zx1.rows;
+    size_t rows = zx2.rows;
+    size_t tiles = (m + COMMUTE_TILE_ROWS - 1) / COMMUTE_TILE_ROWS;
+    size_t tasks = tiles * ((rows + COMMUTE_BLOCK_ROWS - 1) / COMMUTE_BLOCK_ROWS);
+    bool parallel = m * rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL && tasks > 1;
+    Z2R_KERNEL_STATS("zx_commute_reduce", m * rows, (m + rows) * zx1.itemsize + m * 8);
+
+    bool count = reduction == CommuteReduction::CountAnticommuting;
+    bool target = reduction != CommuteReduction::FirstCommuting;
+    // First hit of each row of zx1 (rows if none yet), or its number of hits
+    std::vector<std::atomic<int64_t>> result(m);
+    for (auto &r : result) {
+        r.store(count ? 0 : static_cast<int64_t>(rows), std::memory_order_relaxed);
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(zx1.itemsize / 8 + 2);
+        std::vector<uint64_t> rows1;
+        std::vector<uint64_t> rows2;
+        // dynamic: the tasks are handed out in order, so the first hits are found first
+#ifdef USE_OPENMP
+    #pragma omp for schedule(dynamic)
+#endif
+        for (size_t t = 0; t < tasks; ++t) {
+            CommuteTask task(t, tiles, m, rows);
+            if (!count) {
+                int64_t last = 0;
+                for (size_t i = task.begin1; i < task.end1; ++i) {
+                    last = std::max(last, result[i].load(std::memory_order_relaxed));
+                }
+                if (static_cast<int64_t>(task.begin2) >= last) {
+                    continue;
+                }
+            }
+            load_zx_rows(zx1, task.begin1, task.end1, num_qubits, words, buffer, rows1);
+            load_zx_rows(zx2, task.begin2, task.end2, num_qubits, words, buffer, rows2);
+            for (size_t i = task.begin1; i < task.end1; ++i) {
+                const uint64_t *z1 = rows1.data() + (i - task.begin1) * 2 * words;
+                size_t end = task.end2;
+                if (!count) {
+                    int64_t first = result[i].load(std::memory_order_relaxed);
+                    end = std::min(end, static_cast<size_t>(first));
+                }
+                int64_t hits = 0;
+                for (size_t j = task.begin2; j < end; ++j) {
+                    const uint64_t *z2 = rows2.data() + (j - task.begin2) * 2 * words;
+                    bool anticommute = zx_anticommute(z1, z1 + words, z2, z2 + words, words,
+                                                      qubit_wise);
+                    if (anticommute != target) {
+                        continue;
+                    }
+                    if (count) {
+                        ++hits;
+                        continue;
+                    }
+                    int64_t first = result[i].load(std::memory_order_relaxed);
+                    while (static_cast<int64_t>(j) < first &&
+                           !result[i].compare_exchange_weak(first, static_cast<int64_t>(j),
+                                                            std::memory_order_relaxed)) {
+                    }
+                    break;
+                }
+                if (hits > 0) {
+                    result[i].fetch_add(hits, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+        int64_t r = result[i].load(std::memory_order_relaxed);
+        out[i] = (!count && r == static_cast<int64_t>(rows)) ? -1 : r;
+    }
+}
+
+/**
+ * @brief Bit-packed commutation flags of every row of zx1 with every row of zx2: bit j % 8 of byte
+ * j / 8 of out row i is set when zx1[i] and zx2[j] commute. This is the layout of
+ * np.packbits(..., bitorder="little"), an eighth of the size of a bool array. The flags are
+ * computed in the tiles of zx_commute_reduce(), each task writing the bytes of its block of zx2 in
+ * its rows of out.
+ *
+ * @param zx1 Stitched voids of the m Pauli strings
+ * @param zx2 Stitched voids of the N Pauli strings, with the itemsize of zx1
+ * @param num_qubits Number of qubits n
+ * @param qubit_wise Whether to test qubit-wise commutation instead of operator commutation
+ * @param out m rows of at least (N + 7) / 8 bytes. The bits past N are cleared.
+ */
+void zx_commute_mask(VoidView zx1, VoidView zx2, size_t num_qubits, bool qubit_wise,
+                     MutableVoidView out) {
+    threads::apply();
+    if (zx1.itemsize != zx2.itemsize) {
+        throw std::runtime_error("Input arrays must have the same itemsize.");
+    }
+    size_t m = zx1.rows;
+    size_t rows = zx2.rows;
+    if (out.rows != m || out.itemsize < (rows + 7) / 8) {
+        throw std::runtime_error("There must be one output row of (N + 7) / 8 bytes per string.");
+    }
+    size_t words = zx_words(zx1, num_qubits);
+    size_t tiles = (m + COMMUTE_TILE_ROWS - 1) / COMMUTE_TILE_ROWS;
+    size_t tasks = tiles * ((rows + COMMUTE_BLOCK_ROWS - 1) / COMMUTE_BLOCK_ROWS);
+    bool parallel = m * rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL && tasks > 1;
+    Z2R_KERNEL_STATS("zx_commute_mask", m * rows, (m + rows) * zx1.itemsize + m * out.itemsize);
+
+    for (size_t i = 0; i < m; ++i) {
+        std::memset(out.row(i) + (rows + 7) / 8, 0, out.itemsize - (rows + 7) / 8);
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(zx1.itemsize / 8 + 2);
+        std::vector<uint64_t> rows1;
+        std::vector<uint64_t> rows2;
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t t = 0; t < tasks; ++t) {
+            CommuteTask task(t, tiles, m, rows);
+            load_zx_rows(zx1, task.begin1, task.end1, num_qubits, words, buffer, rows1);
+            load_zx_rows(zx2, task.begin2, task.end2, num_qubits, words, buffer, rows2);
+            for (size_t i = task.begin1; i < task.end1; ++i) {
+                const uint64_t *z1 = rows1.data() + (i - task.begin1) * 2 * words;
+                uint8_t *row = out.row(i);
+                for (size_t j0 = task.begin2; j0 < task.end2; j0 += 8) {
+                    uint8_t byte = 0;
+                    for (size_t j = j0; j < std::min(j0 + 8, task.end2); ++j) {
+                        const uint64_t *z2 = rows2.data() + (j - task.begin2) * 2 * words;
+                        if (!zx_anticommute(z1, z1 + words, z2, z2 + words, words, qubit_wise)) {
+                            byte |= static_cast<uint8_t>(1u << (j - j0));
+                        }
+                    }
+                    row[j0 / 8] = byte;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Stream compaction: the indices, in increasing order, of the terms that pass a filter.
+ * Every thread scans a contiguous chunk of the terms and keeps its matches; the chunks are then
+ * laid out one after the other, from the prefix sum of their counts.
+ *
+ * @param zx Stitched voids of the terms. Only read for the max_weight and support checks.
+ * @param weights One weight per term, or empty if the filter has no tolerance
+ * @param filter The checks to apply
+ * @return std::vector<int64_t> The indices of the terms kept
+ */
+std::vector<int64_t> select_terms(VoidView zx, std::span<const std::complex<double>> weights,
+                                  const TermFilter &filter) {
+    threads::apply();
+    bool check_weights = filter.tolerance >= 0.0;
+    bool check_qubits = filter.max_weight >= 0 || !filter.support.empty();
+    if (check_weights && weights.size() != zx.rows) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+    if (check_qubits && filter.num_qubits == 0) {
+        throw std::runtime_error("max_weight and support require a positive num_qubits.");
+    }
+    size_t words = check_qubits ? zx_words(zx, filter.num_qubits) : 0;
+    if (!filter.support.empty() && filter.support.size() != words) {
+        throw std::runtime_error("The support mask must have one bit per qubit.");
+    }
+    size_t rows = zx.rows;
+    bool parallel = rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL;
+    Z2R_KERNEL_STATS("select_terms", rows,
+                     rows * ((check_qubits ? zx.itemsize : 0) +
+                             (check_weights ? sizeof(std::complex<double>) : 0)));
+
+    std::vector<int64_t> selected;
+#ifdef USE_OPENMP
+    std::vector<size_t> offsets(omp_get_max_threads() + 1, 0);
+    #pragma omp parallel if (parallel)
+#else
+    std::vector<size_t> offsets(2, 0);
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+        size_t t = omp_get_thread_num();
+        size_t n_threads = omp_get_num_threads();
+#else
+        size_t t = 0;
+        size_t n_threads = 1;
+#endif
+        auto [begin, end] = thread_chunk(rows, t, n_threads);
+        std::vector<uint64_t> buffer(check_qubits ? zx.itemsize / 8 + 2 : 0);
+        std::vector<uint64_t> z(words, 0);
+        std::vector<uint64_t> x(words, 0);
+        arena::vector<int64_t> local;
+        for (size_t i = begin; i < end; ++i) {
+            if (check_weights && !(std::abs(weights[i]) > filter.tolerance)) {
+                continue;
+            }
+            if (check_qubits) {
+                load_zx(zx.row(i), zx.itemsize, filter.num_qubits, buffer.data(), z.data(),
+                        x.data());
+                int64_t weight = 0;
+                uint64_t outside = 0;
+                for (size_t k = 0; k < words; ++k) {
+                    weight += std::popcount(z[k] | x[k]);
+                    if (!filter.support.empty()) {
+                        outside |= (z[k] | x[k]) & ~filter.support[k];
+                    }
+                }
+                if ((filter.max_weight >= 0 && weight > filter.max_weight) || outside != 0) {
+                    continue;
+                }
+            }
+            local.push_back(static_cast<int64_t>(i));
+        }
+        offsets[t + 1] = local.size();
+#ifdef USE_OPENMP
+    #pragma omp barrier
+    #pragma omp single
+#endif
+        {
+            for (size_t u = 0; u < n_threads; ++u) {
+                offsets[u + 1] += offsets[u];
+            }
+            selected.resize(offsets[n_threads]);
+        } // implicit barrier
+        std::copy(local.begin(), local.end(), selected.begin() + offsets[t]);
+    }
+    return selected;
+}
+
+/**
+ * @brief Gathers terms by index: zx_out[j] = zx[indices[j]], and the same for the weights.
+ *
+ * @param zx Stitched voids (or voids of any layout) of the terms
+ * @param weights One weight per term, or empty to only gather the voids
+ * @param indices The terms to gather, in [0, zx.rows)
+ * @param zx_out The gathered voids, one per index, with the itemsize of zx
+ * @param w_out The gathered weights, one per index, or empty
+ */
+void gather_terms(VoidView zx, std::span<const std::complex<double>> weights,
+                  std::span<const int64_t> indices, MutableVoidView zx_out,
+                  std::span<std::complex<double>> w_out) {
+    threads::apply();
+    size_t count = indices.size();
+    if (zx_out.rows != count || zx_out.itemsize != zx.itemsize) {
+        throw std::runtime_error("There must be one output void per index, of the input itemsize.");
+    }
+    if (!weights.empty() && (weights.size() != zx.rows || w_out.size() != count)) {
+        throw std::runtime_error("There must be one weight per Pauli string and per index.");
+    }
+    bool parallel = count >= FUNC_THRESHOLD_PARALLEL;
+    Z2R_KERNEL_STATS("gather_terms", count,
+                     count * (2 * zx.itemsize + 8 +
+                              (weights.empty() ? 0 : 2 * sizeof(std::complex<double>))));
+
+    bool out_of_range = false;
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime) reduction(|| : out_of_range)
+#endif
+        for (size_t j = 0; j < count; ++j) {
+            out_of_range = out_of_range || indices[j] < 0 ||
+                           static_cast<size_t>(indices[j]) >= zx.rows;
+        }
+    }
+    if (out_of_range) {
+        throw std::runtime_error("Index out of range.");
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t j = 0; j < count; ++j) {
+            std::memcpy(zx_out.row(j), zx.row(indices[j]), zx.itemsize);
+            if (!weights.empty()) {
+                w_out[j] = weights[indices[j]];
+            }
+        }
+    }
+}
+
+/**
+ * @brief The k terms of largest weight magnitude. Every thread selects the k largest of its chunk
+ * with nth_element(), and the candidates of all the threads are then reduced to the k largest.
+ *
+ * @param weights The weights of the terms
+ * @param k The number of terms to keep. All the terms are kept if there are fewer.
+ * @return std::vector<int64_t> The indices of the kept terms, by decreasing magnitude, ties broken
+ * by index. The weights of NaN magnitude come last.
+ */
+std::vector<int64_t> top_k(std::span<const std::complex<double>> weights, size_t k) {
+    threads::apply();
+    size_t rows = weights.size();
+    k = std::min(k, rows);
+    bool parallel = rows >= FUNC_THRESHOLD_PARALLEL;
+    Z2R_KERNEL_STATS("top_k", rows, rows * (sizeof(std::complex<double>) + 8));
+    // NaN magnitudes go last, as in a NumPy sort, so that the order stays a strict weak one
+    auto before = [&weights](int64_t a, int64_t b) {
+        double norm_a = std::norm(weights[a]);
+        double norm_b = std::norm(weights[b]);
+        bool nan_a = std::isnan(norm_a);
+        bool nan_b = std::isnan(norm_b);
+        if (nan_a || nan_b) {
+            return nan_a != nan_b ? nan_b : a < b;
+        }
+        return norm_a > norm_b || (norm_a == norm_b && a < b);
+    };
+    if (k == 0) {
+        return {};
+    }
+
+    std::vector<int64_t> candidates;
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+        auto [begin, end] = thread_chunk(rows, omp_get_thread_num(), omp_get_num_threads());
+#else
+        auto [begin, end] = thread_chunk(rows, 0, 1);
+#endif
+        arena::vector<int64_t> local(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            local[i - begin] = static_cast<int64_t>(i);
+        }
+        if (local.size() > k) {
+            std::nth_element(local.begin(), local.begin() + k, local.end(), before);
+            local.resize(k);
+        }
+#ifdef USE_OPENMP
+    #pragma omp critical
+#endif
+        candidates.insert(candidates.end(), local.begin(), local.end());
+    }
+
+    if (candidates.size() > k) {
+        std::nth_element(candidates.begin(), candidates.begin() + k, candidates.end(), before);
+        candidates.resize(k);
+    }
+    std::sort(candidates.begin(), candidates.end(), before);
+    return candidates;
+}
+
+/**
+ * @brief Random Z and X voids, drawn directly in their packed form.
+ *
+ * Every 64-bit word is drawn from a counter-based generator (see counter_rng64()), indexed by its
+ * position in the output. The result for a given seed is thus reproducible, and independent of
+ * the number of OpenMP threads.
+ *
+ * If `weight` is non-negative, each Pauli string has exactly `weight` non-identity qubits. Their
+ * positions are chosen uniformly among the first `num_qubits` qubits (Floyd's algorithm), and each
+ * one is uniformly X, Y or Z. Otherwise, all 4^num_qubits Pauli strings are equally likely.
+ *
+ * @param num_qubits Number of random qubits. Bits past num_qubits are zero.
+ * @param weight Number of non-identity qubits of each Pauli string, or -1 for a random weight
+ * @param seed Seed of the generator
+ * @param z_out The Z voids
+ * @param x_out The X voids, with the same rows and itemsize as z_out
+ */
+void random_zx_voids(size_t num_qubits, int64_t weight, uint64_t seed, MutableVoidView z_out,
+                     MutableVoidView x_out) {
+    size_t itemsize = z_out.itemsize;
+    if (x_out.rows != z_out.rows || x_out.itemsize != itemsize) {
+        throw std::runtime_error("z_out and x_out must have the same size and itemsize.");
+    }
+    if (num_qubits > itemsize * 8) {
+        throw std::runtime_error("num_qubits cannot exceed itemsize * 8");
+    }
+    if (weight > static_cast<int64_t>(num_qubits)) {
+        throw std::runtime_error("weight cannot exceed num_qubits");
+    }
+    threads::apply();
+    uint64_t key = splitmix64(seed);
+    size_t n_rows = z_out.rows;
+    size_t words = (itemsize + 7) / 8;
+    size_t full_words = num_qubits / 64;
+    uint64_t last_mask = (num_qubits % 64) ? (uint64_t{1} << (num_qubits % 64)) - 1 : 0;
+    Z2R_KERNEL_STATS("random_zx_voids", n_rows, 2 * n_rows * itemsize);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n_rows * words >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        arena::vector<uint64_t> z(words, 0);
+        arena::vector<uint64_t> x(words, 0);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < n_rows; ++i) {
+            if (weight < 0) {
+                uint64_t counter = 2 * i * words;
+                for (size_t k = 0; k < words; ++k) {
+                    uint64_t mask = ~uint64_t{0};
+                    if (k == full_words) {
+                        mask = last_mask;
+                    } else if (k > full_words) {
+                        mask = 0;
+                    }
+                    z[k] = counter_rng64(key, counter + 2 * k) & mask;
+                    x[k] = counter_rng64(key, counter + 2 * k + 1) & mask;
+                }
+            } else {
+                std::fill(z.begin(), z.end(), 0);
+                std::fill(x.begin(), x.end(), 0);
+                uint64_t counter = 2 * i * static_cast<uint64_t>(weight);
+                // Floyd's algorithm: `weight` distinct qubits among num_qubits, with as many draws
+                for (size_t j = num_qubits - static_cast<size_t>(weight); j < num_qubits; ++j) {
+                    size_t q = bounded_rng64(counter_rng64(key, counter++), j + 1);
+                    if (((z[q / 64] | x[q / 64]) >> (q % 64)) & 1) {
+                        q = j;
+                    }
+                    // 1 = X, 2 = Z, 3 = Y
+                    uint64_t pauli = 1 + bounded_rng64(counter_rng64(key, counter++), 3);
+                    x[q / 64] |= (pauli & 1) << (q % 64);
+                    z[q / 64] |= (pauli >> 1) << (q % 64);
+                }
+            }
+            std::memcpy(z_out.row(i), z.data(), itemsize);
+            std::memcpy(x_out.row(i), x.data(), itemsize);
+        }
+    }
+}
+
+/**
+ * @brief Sorted unique voids, as numpy.unique() on their bytes: the groups of equal voids are
+ * ordered lexicographically by bytes.
+ *
+ * @param voids The voids
+ * @return UniqueVoids The first occurrence of each group, the group of each void and the size of
+ * each group
+ */
+UniqueVoids unique(VoidView voids) {
+    threads::apply();
+    size_t n = voids.rows;
+    size_t itemsize = voids.itemsize;
+    Z2R_KERNEL_STATS("unique", n, n * (itemsize + 3 * sizeof(int64_t)));
+
+    arena::vector<size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    // Lexicographic bytes, then index, so that the first of a group is its first occurrence
+    std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+        int row = std::memcmp(voids.row(a), voids.row(b), itemsize);
+        return row != 0 ? row < 0 : a < b;
+    });
+
+    UniqueVoids out;
+    out.inverse.resize(n);
+    for (size_t sorted_pos = 0; sorted_pos < n; ++sorted_pos) {
+        size_t cur = idx[sorted_pos];
+        if (sorted_pos == 0 ||
+            std::memcmp(voids.row(idx[sorted_pos - 1]), voids.row(cur), itemsize) != 0) {
+            out.index.push_back(static_cast<int64_t>(cur));
+            out.counts.push_back(0);
+        }
+        out.counts.back() += 1;
+        out.inverse[cur] = static_cast<int64_t>(out.index.size() - 1);
+    }
+    return out;
+}
+
+/**
+ * @brief Unique voids, in the order of their first occurrence, found with a hash table of their
+ * bytes instead of a sort.
+ *
+ * @todo Benchmark the std hashmap against others (robin-hood-hashing, google dense-hash-map...),
+ * and std::hash against other non-cryptographic hashes (e.g. xxhash).
+ *
+ * @param voids The voids
+ * @return UniqueVoids The first occurrence of each unique void, and the number of the unique void
+ * of each void. The counts are left empty.
+ */
+UniqueVoids unordered_unique(VoidView voids) {
+    threads::apply();
+    size_t nrows = voids.rows;
+    size_t row_bytes = voids.itemsize;
+    Z2R_KERNEL_STATS("unordered_unique", nrows, nrows * (row_bytes + 2 * sizeof(size_t)));
+
+    arena::vector<std::string_view> keys(nrows);
+#ifdef USE_OPENMP
+    #pragma omp parallel if (nrows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < nrows; ++i) {
+            keys[i] = std::string_view(reinterpret_cast<const char *>(voids.row(i)), row_bytes);
+        }
+    }
+
+    // std::unordered_map seems to be poor in performance (according to the internet)
+    // Perhaps we should be using another container implementation?
+    // See: https://martin.ankerl.com/2022/08/27/hashmap-bench-01/
+    std::unordered_map<std::string_view, size_t> table;
+    table.max_load_factor(0.5);
+    table.reserve(nrows);
+
+    UniqueVoids out;
+    out.inverse.resize(nrows);
+    for (size_t i = 0; i < nrows; ++i) {
+        auto [it, inserted] = table.try_emplace(keys[i], out.index.size());
+        if (inserted) {
+            out.index.push_back(static_cast<int64_t>(i));
+        }
+        out.inverse[i] = static_cast<int64_t>(it->second);
+    }
+    return out;
+}
+
+/**
+ * @brief Reduced row echelon form over Z2 of a bit matrix, each row being a void, by Gauss-Jordan
+ * elimination of its first num_cols columns.
+ *
+ * @todo Optimize this function!
+ *
+ * @param voids The rows of the matrix
+ * @param num_cols Number of columns to eliminate
+ * @param out The rows of the reduced matrix, of the size and itemsize of voids. May alias voids.
+ */
+void row_echelon(VoidView voids, size_t num_cols, MutableVoidView out) {
+    if (out.rows != voids.rows || out.itemsize != voids.itemsize) {
+        throw std::runtime_error("Output of row_echelon must have the shape of its input.");
+    }
+    if (num_cols > voids.itemsize * 8) {
+        throw std::runtime_error("num_qubits cannot exceed itemsize * 8");
+    }
+    threads::apply();
+    size_t n_rows = voids.rows;
+    size_t itemsize = voids.itemsize;
+    Z2R_KERNEL_STATS("row_echelon", n_rows, 2 * n_rows * itemsize);
+
+    if (out.data != voids.data) {
+        for (size_t row = 0; row < n_rows; ++row) {
+            std::memcpy(out.row(row), voids.row(row), itemsize);
+        }
+    }
+    auto bit = [&out](size_t row, size_t col) { return (out.row(row)[col / 8] >> (col % 8)) & 1; };
+
+    size_t h_row = 0;
+    for (size_t k_col = 0; h_row < n_rows && k_col < num_cols; ++k_col) {
+        size_t i_row = h_row;
+        while (i_row < n_rows && !bit(i_row, k_col)) {
+            ++i_row;
+        }
+        if (i_row == n_rows) {
+            continue;
+        }
+        if (i_row != h_row) {
+            std::swap_ranges(out.row(i_row), out.row(i_row) + itemsize, out.row(h_row));
+        }
+        for (size_t row = 0; row < n_rows; ++row) {
+            if (row != h_row && bit(row, k_col)) {
+                for (size_t b = 0; b < itemsize; ++b) {
+                    out.row(row)[b] ^= out.row(h_row)[b];
+                }
+            }
+        }
+        ++h_row;
+    }
+}
+
+/**
+ * @brief Dense matrix of the sum of Pauli strings given by their Z and X voids, without their
+ * phases: the string with integers z_int and x_int maps row r to column r ^ x_int, with sign
+ * (-1)^|r & z_int|.
+ *
+ * @param z The Z voids
+ * @param x The X voids, with the same rows and itemsize
+ * @param num_qubits Number of qubits n, at most 30
+ * @param out The 2^n x 2^n matrix, row-major
+ */
+void to_matrix(VoidView z, VoidView x, size_t num_qubits, std::span<std::complex<double>> out) {
+    if (z.rows != x.rows || z.itemsize != x.itemsize) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+    if (num_qubits > 30 || num_qubits > z.itemsize * 8) {
+        throw std::runtime_error("num_qubits must be in [0, min(30, itemsize * 8)].");
+    }
+    size_t dim = size_t{1} << num_qubits;
+    if (out.size() != dim * dim) {
+        throw std::runtime_error("Output of to_matrix must have 4^num_qubits elements.");
+    }
+    threads::apply();
+    Z2R_KERNEL_STATS("to_matrix", z.rows, 2 * z.rows * z.itemsize + out.size_bytes());
+
+    std::fill(out.begin(), out.end(), std::complex<double>(0.0));
+    uint64_t mask = dim - 1;
+    size_t bytes = std::min<size_t>(z.itemsize, 8);
+    for (size_t idx = 0; idx < z.rows; ++idx) {
+        uint64_t z_int = load_tail(z.row(idx), bytes) & mask;
+        uint64_t x_int = load_tail(x.row(idx), bytes) & mask;
+        for (size_t row = 0; row < dim; ++row) {
+            double sign = (std::popcount(row & z_int) & 1) ? -1.0 : 1.0;
+            out[row * dim + (row ^ x_int)] += sign;
+        }
+    }
+}
+
+/**
+ * @brief Inverse over Z2 of a square bit matrix, each row being a void, by Gauss-Jordan
+ * elimination. Throws if the matrix is singular.
+ *
+ * @see batched_gauss_jordan_inverse() to invert many matrices at once.
+ *
+ * @param matrix The num_bits rows of the matrix
+ * @param num_bits Size n of the n x n matrix
+ * @param out The rows of the inverse, of the size and itemsize of matrix
+ */
+void gauss_jordan_inverse(VoidView matrix, size_t num_bits, MutableVoidView out) {
+    if (matrix.rows != num_bits) {
+        throw std::runtime_error("num_bits must equal number of rows (square matrix).");
+    }
+    size_t itemsize = matrix.itemsize;
+    if (num_bits > itemsize * 8) {
+        throw std::runtime_error("num_bits exceeds bit capacity of row dtype.");
+    }
+    if (out.rows != num_bits || out.itemsize != itemsize) {
+        throw std::runtime_error(
+            "Output of gauss_jordan_inverse must have the shape of its input.");
+    }
+    threads::apply();
+    size_t n = num_bits;
+    Z2R_KERNEL_STATS("gauss_jordan_inverse", n, 2 * n * itemsize);
+
+    arena::vector<uint8_t> a(n * itemsize);
+    for (size_t row = 0; row < n; ++row) {
+        std::memcpy(&a[row * itemsize], matrix.row(row), itemsize);
+        std::memset(out.row(row), 0, itemsize);
+        out.row(row)[row / 8] |= uint8_t(1u << (row % 8));
+    }
+
+    for (size_t col = 0; col < n; ++col) {
+        size_t byte_idx = col / 8;
+        size_t bit_idx = col % 8;
+        size_t pivot = col;
+        while (pivot < n && !((a[pivot * itemsize + byte_idx] >> bit_idx) & 1u)) {
+            ++pivot;
+        }
+        if (pivot == n) {
+            throw std::runtime_error("Matrix is singular (no pivot).");
+        }
+        if (pivot != col) {
+            std::swap_ranges(&a[pivot * itemsize], &a[pivot * itemsize] + itemsize,
+                             &a[col * itemsize]);
+            std::swap_ranges(out.row(pivot), out.row(pivot) + itemsize, out.row(col));
+        }
+        for (size_t row = 0; row < n; ++row) {
+            if (row != col && ((a[row * itemsize + byte_idx] >> bit_idx) & 1u)) {
+                for (size_t b = 0; b < itemsize; ++b) {
+                    a[row * itemsize + b] ^= a[col * itemsize + b];
+                    out.row(row)[b] ^= out.row(col)[b];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Inverts a whole stack of binary matrices with Gauss-Jordan elimination.
+ *
+ * Unlike gauss_jordan_inverse(), rows are handled as 64-bit words: a matrix of n <= 64 bits
+ * eliminates with one word XOR per row and pivot. Singular matrices do not throw; they are
+ * flagged and their inverse is left zeroed. Matrices are spread over the OpenMP threads.
+ *
+ * @param matrices The rows of all the matrices, num_bits rows per matrix
+ * @param num_bits Size n of the n x n matrices
+ * @param out The rows of the inverses, of the size and itemsize of matrices
+ * @param singular Whether each matrix is singular, one flag per matrix
+ */
+void batched_gauss_jordan_inverse(VoidView matrices, size_t num_bits, MutableVoidView out,
+                                  std::span<bool> singular) {
+    size_t itemsize = matrices.itemsize;
+    if (num_bits == 0 || num_bits > itemsize * 8) {
+        throw std::runtime_error("num_bits exceeds bit capacity of row dtype.");
+    }
+    if (matrices.rows % num_bits != 0 || singular.size() != matrices.rows / num_bits) {
+        throw std::runtime_error("There must be num_bits rows and one flag per matrix.");
+    }
+    if (out.rows != matrices.rows || out.itemsize != itemsize) {
+        throw std::runtime_error("Output of batched_gauss_jordan_inverse must have the shape of "
+                                 "its input.");
+    }
+    threads::apply();
+    size_t n = num_bits;
+    size_t n_mats = singular.size();
+    size_t words = (n + 63) / 64;
+    size_t row_bytes = std::min(itemsize, words * 8);
+    uint64_t last_mask = (n % 64) ? (uint64_t{1} << (n % 64)) - 1 : ~uint64_t{0};
+    bool parallel = n_mats * n * words >= FUNC_THRESHOLD_PARALLEL;
+    Z2R_KERNEL_STATS("batched_gauss_jordan_inverse", n_mats,
+                     2 * matrices.rows * itemsize + n_mats);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (parallel)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        arena::vector<uint64_t> a(n * words);
+        arena::vector<uint64_t> inv(n * words);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t m = 0; m < n_mats; ++m) {
+            std::fill(a.begin(), a.end(), 0);
+            std::fill(inv.begin(), inv.end(), 0);
+            for (size_t r = 0; r < n; ++r) {
+                std::memcpy(&a[r * words], matrices.row(m * n + r), row_bytes);
+                a[r * words + words - 1] &= last_mask;
+                inv[r * words + r / 64] = uint64_t{1} << (r % 64);
+            }
+
+            bool is_singular = false;
+            for (size_t col = 0; col < n; ++col) {
+                size_t w = col / 64;
+                uint64_t bit = uint64_t{1} << (col % 64);
+
+                size_t pivot = col;
+                while (pivot < n && !(a[pivot * words + w] & bit)) {
+                    ++pivot;
+                }
+                if (pivot == n) {
+                    is_singular = true;
+                    break;
+                }
+                if (pivot != col) {
+                    std::swap_ranges(&a[pivot * words], &a[pivot * words] + words,
+                                     &a[col * words]);
+                    std::swap_ranges(&inv[pivot * words], &inv[pivot * words] + words,
+                                     &inv[col * words]);
+                }
+
+                const uint64_t *a_piv = &a[col * words];
+                const uint64_t *inv_piv = &inv[col * words];
+                for (size_t r = 0; r < n; ++r) {
+                    // All ones if row r must be eliminated, zero otherwise (branchless)
+                    uint64_t mask = (r != col) ? uint64_t{0} - ((a[r * words + w] & bit) != 0) : 0;
+                    for (size_t k = 0; k < words; ++k) {
+                        a[r * words + k] ^= a_piv[k] & mask;
+                        inv[r * words + k] ^= inv_piv[k] & mask;
+                    }
+                }
+            }
+
+            singular[m] = is_singular;
+            // Every output row is written by the thread of its matrix, zeroed when singular
+            for (size_t r = 0; r < n; ++r) {
+                uint8_t *row_out = out.row(m * n + r);
+                std::memset(row_out, 0, itemsize);
+                if (!is_singular) {
+                    std::memcpy(row_out, &inv[r * words], row_bytes);
+                }
+            }
+        }
+    }
+}
+
+namespace {
+
+/**
+ * @brief A run of qubit indices which all live in the same 64-bit word on one side and are
+ * contiguous on the other side. A whole run can be moved with a single pext64()/pdep64().
+ */
+struct QubitSegment {
+    size_t word;   // word holding the (non contiguous) bits, selected by mask
+    uint64_t mask; // bits of `word` that belong to the run
+    size_t bit;    // first bit of the contiguous side
+    size_t count;  // number of bits in the run
+};
+
+/**
+ * @brief Cuts a list of qubit indices into QubitSegment runs. A new run starts every time the
+ * indices stop increasing or cross a 64-bit word. Sorted indices thus give at most one run per
+ * word, while an arbitrary permutation can degrade to one run per qubit.
+ *
+ * @param indices The qubit indices, on the non contiguous side
+ * @param max_bits The number of bits available on the non contiguous side
+ * @return std::vector<QubitSegment>
+ */
+std::vector<QubitSegment> make_qubit_segments(std::span<const int64_t> indices, size_t max_bits) {
+    std::vector<QubitSegment> segments;
+    for (size_t j = 0; j < indices.size(); ++j) {
+        if (indices[j] < 0 || static_cast<size_t>(indices[j]) >= max_bits) {
+            throw std::runtime_error("Qubit index " + std::to_string(indices[j]) +
+                                     " is out of range for voids of " + std::to_string(max_bits) +
+                                     " bits.");
+        }
+        size_t idx = static_cast<size_t>(indices[j]);
+        if (segments.empty() || idx <= static_cast<size_t>(indices[j - 1]) ||
+            idx / 64 != segments.back().word) {
+            segments.push_back({idx / 64, 0, j, 0});
+        }
+        segments.back().mask |= uint64_t{1} << (idx % 64);
+        segments.back().count += 1;
+    }
+    return segments;
+}
+
+} // namespace
+
+/**
+ * @brief Extracts an arbitrary list of qubits (bits) from every void. Output bit j is input bit
+ * indices[j], so the indices may be given in any order. Every row is loaded once into a
+ * thread-local word buffer, then each run of increasing indices within a same 64-bit word is moved
+ * with one pext64(), so slicing contiguous or sorted qubits costs about one instruction per word.
+ *
+ * @param voids The input voids
+ * @param indices The input bit taken for each output bit
+ * @param out The output voids, of the size of voids and of at least (len(indices) + 7) / 8 bytes.
+ * Their bits past len(indices) are zeroed.
+ */
+void get_qubit_slices(VoidView voids, std::span<const int64_t> indices, MutableVoidView out) {
+    size_t itemsize = voids.itemsize;
+    size_t out_itemsize = out.itemsize;
+    if (out.rows != voids.rows || indices.size() > out_itemsize * 8) {
+        throw std::runtime_error("Output of get_qubit_slices is too small.");
+    }
+    std::vector<QubitSegment> segments = make_qubit_segments(indices, itemsize * 8);
+    threads::apply();
+    size_t n_rows = voids.rows;
+    size_t in_words = (itemsize + 7) / 8;
+    size_t out_words = (out_itemsize + 7) / 8 + 1; // +1 so a run can always spill over
+    Z2R_KERNEL_STATS("gather_qubits", n_rows, n_rows * (itemsize + out_itemsize));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n_rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        // The tail of the last word is zeroed once and never overwritten by the memcpy
+        arena::vector<uint64_t> src(in_words, 0);
+        arena::vector<uint64_t> dst(out_words, 0);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < n_rows; ++i) {
+            std::memcpy(src.data(), voids.row(i), itemsize);
+            std::fill(dst.begin(), dst.end(), 0);
+
+            for (const QubitSegment &seg : segments) {
+                uint64_t bits = pext64(src[seg.word], seg.mask);
+                size_t w = seg.bit / 64;
+                size_t s = seg.bit % 64;
+                dst[w] |= bits << s;
+                if (s + seg.count > 64) {
+                    dst[w + 1] |= bits >> (64 - s);
+                }
+            }
+            std::memcpy(out.row(i), dst.data(), out_itemsize);
+        }
+    }
+}
+
+/**
+ * @brief Applies a qubit permutation to every void, such that new qubit i is old qubit
+ * permutation[i]. Bits past len(permutation) (padding) are left untouched.
+ *
+ * @param voids The input voids
+ * @param permutation A permutation of range(num_qubits)
+ * @param out The output voids, of the size and itemsize of voids
+ */
+void permute_qubits(VoidView voids, std::span<const int64_t> permutation, MutableVoidView out) {
+    size_t max_bits = voids.itemsize * 8;
+    size_t n = permutation.size();
+    if (n > max_bits) {
+        throw std::runtime_error("Permutation is longer than the number of bits of the dtype.");
+    }
+    if (out.itemsize != voids.itemsize) {
+        throw std::runtime_error("Output of permute_qubits must have the itemsize of its input.");
+    }
+    std::vector<uint8_t> seen(n, 0);
+    for (int64_t p : permutation) {
+        if (p < 0 || static_cast<size_t>(p) >= n || seen[p]) {
+            throw std::runtime_error("Input is not a permutation of range(" + std::to_string(n) +
+                                     ").");
+        }
+        seen[p] = 1;
+    }
+
+    // Padding bits map to themselves
+    std::vector<int64_t> indices(permutation.begin(), permutation.end());
+    for (size_t k = n; k < max_bits; ++k) {
+        indices.push_back(static_cast<int64_t>(k));
+    }
+    get_qubit_slices(voids, indices, out);
+}
+
+/**
+ * @brief Inserts narrow voids into wider ones at given qubit positions. This is the inverse of
+ * get_qubit_slices(): bit j of sub_voids is written to bit indices[j] of voids. All other bits are
+ * copied from voids. If an index is repeated, the last write wins.
+ *
+ * @param voids The wide voids
+ * @param sub_voids The narrow voids, as many as voids
+ * @param indices Where to write each bit of sub_voids
+ * @param out The output voids, of the size and itemsize of voids
+ */
+void set_qubit_slices(VoidView voids, VoidView sub_voids, std::span<const int64_t> indices,
+                      MutableVoidView out) {
+    if (voids.rows != sub_voids.rows) {
+        throw std::runtime_error("Input arrays must have the same size. Got " +
+                                 std::to_string(voids.rows) + " and " +
+                                 std::to_string(sub_voids.rows));
+    }
+    size_t itemsize = voids.itemsize;
+    size_t sub_itemsize = sub_voids.itemsize;
+    if (indices.size() > sub_itemsize * 8) {
+        throw std::runtime_error("More indices than bits in sub_voids.");
+    }
+    if (out.rows != voids.rows || out.itemsize != itemsize) {
+        throw std::runtime_error("Output of set_qubit_slices must have the shape of voids.");
+    }
+    std::vector<QubitSegment> segments = make_qubit_segments(indices, itemsize * 8);
+    threads::apply();
+    size_t n_rows = voids.rows;
+    size_t words = (itemsize + 7) / 8;
+    size_t sub_words = (sub_itemsize + 7) / 8 + 1; // +1 so a run can always spill over
+    Z2R_KERNEL_STATS("set_qubit_slices", n_rows, n_rows * (2 * itemsize + sub_itemsize));
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n_rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        arena::vector<uint64_t> dst(words, 0);
+        arena::vector<uint64_t> src(sub_words, 0);
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < n_rows; ++i) {
+            std::memcpy(dst.data(), voids.row(i), itemsize);
+            std::memcpy(src.data(), sub_voids.row(i), sub_itemsize);
+
+            for (const QubitSegment &seg : segments) {
+                size_t w = seg.bit / 64;
+                size_t s = seg.bit % 64;
+                uint64_t bits = src[w] >> s;
+                if (s + seg.count > 64) {
+                    bits |= src[w + 1] << (64 - s);
+                }
+                dst[seg.word] = (dst[seg.word] & ~seg.mask) | pdep64(bits, seg.mask);
+            }
+            std::memcpy(out.row(i), dst.data(), itemsize);
+        }
+    }
+}
+
+} // namespace z2r
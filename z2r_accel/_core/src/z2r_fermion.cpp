@@ -0,0 +1,246 @@
+/**
+ * @file z2r_fermion.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free fermion-to-qubit mappings of ladder operator terms. See z2r_fermion.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note The Majorana strings are built once per call as separate Z and X words. Each term is then
+ * expanded, multiplied and stitched into a zx void (Z bits [0, n) followed by X bits [n, 2n))
+ * which goes straight into the accumulator of its thread: the 2^L products of a term are never
+ * stored.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_fermion.h"
+#include "z2r_stats.h"
+
+#include <cmath>
+
+namespace z2r {
+
+namespace {
+
+/**
+ * @brief Qubit sets of one mode: see fermion.h.
+ */
+struct ModeSets {
+    std::vector<size_t> update;
+    std::vector<size_t> parity;
+    std::vector<size_t> occupation;
+};
+
+/**
+ * @brief Update, parity and occupation sets of mode j among n.
+ *
+ * Jordan-Wigner stores the occupation of mode j on qubit j, and the parity mapping stores the
+ * parity of modes 0 to j on qubit j. Bravyi-Kitaev stores on qubit k the parity of the modes
+ * (k + 1 - lowbit(k + 1), k], as a Fenwick tree does, which works for any n (Havlicek et al.,
+ * arXiv:1701.07072). The loops below use the 1-based indices of the tree.
+ */
+ModeSets mode_sets(int64_t mapping, size_t j, size_t n) {
+    ModeSets s;
+    switch (mapping) {
+    case MAPPING_JORDAN_WIGNER:
+        s.update = {j};
+        for (size_t k = 0; k < j; ++k) {
+            s.parity.push_back(k);
+        }
+        s.occupation = {j};
+        break;
+    case MAPPING_PARITY:
+        for (size_t k = j; k < n; ++k) {
+            s.update.push_back(k);
+        }
+        if (j > 0) {
+            s.parity = {j - 1};
+            s.occupation.push_back(j - 1);
+        }
+        s.occupation.push_back(j);
+        break;
+    case MAPPING_BRAVYI_KITAEV: {
+        for (size_t i = j + 1; i <= n; i += i & (~i + 1)) {
+            s.update.push_back(i - 1);
+        }
+        for (size_t i = j; i > 0; i &= i - 1) {
+            s.parity.push_back(i - 1);
+        }
+        s.occupation = {j};
+        size_t parent = (j + 1) & j;
+        for (size_t i = j; i != parent; i &= i - 1) {
+            s.occupation.push_back(i - 1);
+        }
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown fermion-to-qubit mapping " + std::to_string(mapping) +
+                                 ". Expected Jordan-Wigner, parity or Bravyi-Kitaev.");
+    }
+    return s;
+}
+
+inline void set_bit(uint64_t *v, size_t i) { v[i / 64] |= uint64_t{1} << (i % 64); }
+
+/**
+ * @brief The 2n Majorana strings c_0, d_0, c_1, d_1, ... as Hermitian Pauli strings, each with a
+ * sign of i^power (power 0 or 2).
+ */
+struct Majoranas {
+    size_t words;
+    std::vector<uint64_t> z;
+    std::vector<uint64_t> x;
+    std::vector<uint8_t> power;
+
+    const uint64_t *z_of(size_t m) const { return &z[m * words]; }
+    const uint64_t *x_of(size_t m) const { return &x[m * words]; }
+};
+
+Majoranas build_majoranas(int64_t mapping, size_t n, size_t words) {
+    Majoranas maj{words, std::vector<uint64_t>(2 * n * words), std::vector<uint64_t>(2 * n * words),
+                  std::vector<uint8_t>(2 * n)};
+    std::vector<uint64_t> occupation(words);
+    std::vector<uint64_t> none(words, 0);
+    for (size_t j = 0; j < n; ++j) {
+        ModeSets s = mode_sets(mapping, j, n);
+        uint64_t *cz = &maj.z[2 * j * words];
+        uint64_t *cx = &maj.x[2 * j * words];
+        for (size_t q : s.update) {
+            set_bit(cx, q);
+        }
+        for (size_t q : s.parity) {
+            set_bit(cz, q);
+        }
+
+        // d_j = i c_j Z_O = i^(1 + s) D_j, where i^s D_j is the product computed here
+        uint64_t *dz = cz + words;
+        uint64_t *dx = cx + words;
+        std::copy(cz, cz + words, dz);
+        std::copy(cx, cx + words, dx);
+        std::fill(occupation.begin(), occupation.end(), 0);
+        for (size_t q : s.occupation) {
+            set_bit(occupation.data(), q);
+        }
+        int power = (1 + pauli_mul_log_i(dz, dx, occupation.data(), none.data(), words)) & 3;
+        if (power & 1) {
+            throw std::runtime_error("Inconsistent qubit sets for mode " + std::to_string(j) + ".");
+        }
+        maj.power[2 * j + 1] = static_cast<uint8_t>(power);
+    }
+    return maj;
+}
+
+} // namespace
+
+/**
+ * @brief Maps a sum of products of ladder operators to a sum of Pauli strings.
+ *
+ * The terms are spread over the threads, each accumulating the Pauli strings of its terms into
+ * its own PauliAccumulator; the accumulators are merged at the end, as in
+ * z2r::accumulate_products().
+ *
+ * @param terms The terms. See LadderTerms.
+ * @param num_modes Number of modes n, which is also the number of qubits
+ * @param mapping The mapping, from FermionMapping
+ * @return PauliAccumulator The unique Pauli strings, as zx voids of max((2n + 7) / 8, 1) bytes,
+ * with their summed weights
+ */
+PauliAccumulator map_ladder_terms(const LadderTerms &terms, size_t num_modes, int64_t mapping) {
+    threads::apply();
+    if (terms.length > MAX_LADDER_OPERATORS) {
+        throw std::runtime_error("Terms can have at most " +
+                                 std::to_string(MAX_LADDER_OPERATORS) + " ladder operators.");
+    }
+    const size_t n = num_modes;
+    const size_t words = std::max<size_t>((n + 63) / 64, 1);
+    const size_t itemsize = std::max<size_t>((2 * n + 7) / 8, 1);
+    const size_t length = terms.length;
+    const size_t num_terms = terms.num_terms();
+    if (terms.modes.size() != num_terms * length || terms.creation.size() != num_terms * length) {
+        throw std::runtime_error("There must be `length` modes and creation flags per term.");
+    }
+    for (size_t i = 0; i < num_terms * length; ++i) {
+        if (terms.modes[i] < -1 || terms.modes[i] >= static_cast<int64_t>(n)) {
+            throw std::runtime_error("Mode " + std::to_string(terms.modes[i]) +
+                                     " is out of range for " + std::to_string(n) + " modes.");
+        }
+    }
+    Majoranas maj = build_majoranas(mapping, n, words);
+
+    size_t expansions = num_terms << length;
+#ifdef USE_OPENMP
+    int n_threads = (expansions >= FUNC_THRESHOLD_PARALLEL) ? omp_get_max_threads() : 1;
+#else
+    int n_threads = 1;
+#endif
+    Z2R_KERNEL_STATS("map_ladder_terms", expansions,
+                     num_terms * (length * (sizeof(int64_t) + 1) +
+                                        sizeof(std::complex<double>)));
+    std::vector<PauliAccumulator> partials;
+    partials.reserve(n_threads);
+    for (int t = 0; t < n_threads; ++t) {
+        partials.emplace_back(itemsize);
+    }
+
+    const std::complex<double> i_powers[4] = {{1.0, 0.0}, {0.0, 1.0}, {-1.0, 0.0}, {0.0, -1.0}};
+
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(n_threads)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+        PauliAccumulator &acc = partials[omp_get_thread_num()];
+#else
+        PauliAccumulator &acc = partials[0];
+#endif
+        std::vector<uint64_t> z(words), x(words), scratch(itemsize / 8 + 2);
+        std::vector<uint8_t> key(itemsize);
+        size_t majorana[MAX_LADDER_OPERATORS];
+        bool creation[MAX_LADDER_OPERATORS];
+
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t t = 0; t < num_terms; ++t) {
+            size_t num_ops = 0;
+            for (size_t k = 0; k < length; ++k) {
+                int64_t mode = terms.modes[t * length + k];
+                if (mode >= 0) {
+                    majorana[num_ops] = 2 * static_cast<size_t>(mode);
+                    creation[num_ops] = terms.creation[t * length + k] != 0;
+                    ++num_ops;
+                }
+            }
+            const std::complex<double> value =
+                terms.values[t] * std::ldexp(1.0, -static_cast<int>(num_ops));
+
+            // Bit k of `mask` picks d (else c) for operator k, with a factor -i for a^dagger and
+            // i for a
+            for (size_t mask = 0; mask < (size_t{1} << num_ops); ++mask) {
+                std::fill(z.begin(), z.end(), 0);
+                std::fill(x.begin(), x.end(), 0);
+                int power = 0;
+                for (size_t k = 0; k < num_ops; ++k) {
+                    size_t m = majorana[k];
+                    if ((mask >> k) & 1) {
+                        ++m;
+                        power += (creation[k] ? 3 : 1) + maj.power[m];
+                    }
+                    power += pauli_mul_log_i(z.data(), x.data(), maj.z_of(m), maj.x_of(m), words);
+                }
+                stitch_zx_row(z.data(), x.data(), itemsize, n, scratch.data(), key.data());
+                acc.add(key.data(), value * i_powers[power & 3]);
+            }
+        }
+    }
+
+    for (int t = 1; t < n_threads; ++t) {
+        partials[0].merge(partials[t]);
+    }
+    return std::move(partials[0]);
+}
+
+} // namespace z2r
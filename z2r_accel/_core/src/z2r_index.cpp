@@ -0,0 +1,240 @@
+/**
+ * @file z2r_index.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free persistent hash index over a set of Pauli strings. See z2r_index.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_index.h"
+
+#include <mutex>
+
+#include "z2r_stats.h"
+
+namespace z2r {
+
+namespace {
+
+/**
+ * @brief hash_void() of every row, in parallel for large batches.
+ */
+std::vector<uint64_t> hash_rows(VoidView rows) {
+    std::vector<uint64_t> hashes(rows.rows);
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows.rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows.rows; ++i) {
+            hashes[i] = hash_void(rows.row(i), rows.itemsize);
+        }
+    }
+    return hashes;
+}
+
+} // namespace
+
+/**
+ * @brief Copy of another index, taken while no insertion runs on it.
+ */
+PauliIndex::PauliIndex(const PauliIndex &other) : itemsize_(other.itemsize_) {
+    std::shared_lock lock(other.mutex_);
+    keys_ = other.keys_;
+    hashes_ = other.hashes_;
+    slots_ = other.slots_;
+}
+
+/**
+ * @brief Number of voids in the set.
+ */
+size_t PauliIndex::size() const {
+    std::shared_lock lock(mutex_);
+    return hashes_.size();
+}
+
+/**
+ * @brief The voids of the set, in the order of their numbers.
+ *
+ * @return std::vector<uint8_t> A copy of the keys, size() * itemsize() bytes
+ */
+std::vector<uint8_t> PauliIndex::keys() const {
+    std::shared_lock lock(mutex_);
+    return keys_;
+}
+
+/**
+ * @brief Number of the void in the set, or EMPTY if it is not there.
+ */
+int64_t PauliIndex::find(const uint8_t *row, uint64_t hash) const {
+    if (slots_.empty()) {
+        return EMPTY;
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+        int64_t k = slots_[pos];
+        if (k == EMPTY) {
+            return EMPTY;
+        }
+        if (hashes_[k] == hash && std::memcmp(key(k), row, itemsize_) == 0) {
+            return k;
+        }
+    }
+}
+
+/**
+ * @brief Number of the void in the set, after adding it if it was not there. The table must have
+ * room for it (see reserve()).
+ */
+int64_t PauliIndex::insert_row(const uint8_t *row, uint64_t hash) {
+    size_t mask = slots_.size() - 1;
+    size_t pos = hash & mask;
+    for (; slots_[pos] != EMPTY; pos = (pos + 1) & mask) {
+        int64_t k = slots_[pos];
+        if (hashes_[k] == hash && std::memcmp(key(k), row, itemsize_) == 0) {
+            return k;
+        }
+    }
+    int64_t k = static_cast<int64_t>(hashes_.size());
+    slots_[pos] = k;
+    hashes_.push_back(hash);
+    keys_.insert(keys_.end(), row, row + itemsize_);
+    return k;
+}
+
+/**
+ * @brief Grows the table, if needed, so that it can hold n keys with a load factor of at most 1/2.
+ */
+void PauliIndex::reserve(size_t n) {
+    size_t capacity = std::bit_ceil(std::max<size_t>(2 * n, 16));
+    if (capacity <= slots_.size()) {
+        return;
+    }
+    slots_.assign(capacity, EMPTY);
+    size_t mask = capacity - 1;
+    for (size_t k = 0; k < hashes_.size(); ++k) {
+        size_t pos = hashes_[k] & mask;
+        while (slots_[pos] != EMPTY) {
+            pos = (pos + 1) & mask;
+        }
+        slots_[pos] = static_cast<int64_t>(k);
+    }
+    hashes_.reserve(n);
+    keys_.reserve(n * itemsize_);
+}
+
+void PauliIndex::check_rows(VoidView rows, size_t out_size) const {
+    if (rows.itemsize != itemsize_) {
+        throw std::runtime_error("Expected voids of " + std::to_string(itemsize_) +
+                                 " bytes, got " + std::to_string(rows.itemsize) + ".");
+    }
+    if (out_size != rows.rows) {
+        throw std::runtime_error("There must be one output per void.");
+    }
+}
+
+/**
+ * @brief find() of every query, in parallel for large batches.
+ *
+ * @param queries The voids to look up, of itemsize() bytes
+ * @param out The number of each query in the set, or EMPTY if it is not there
+ * @return size_t The size of the set the queries were looked up in
+ */
+size_t PauliIndex::find_all(VoidView queries, std::span<int64_t> out) const {
+    check_rows(queries, out.size());
+    std::shared_lock lock(mutex_);
+    threads::apply();
+    size_t n = queries.rows;
+    Z2R_KERNEL_STATS("pauli_index_lookup", n, n * (itemsize_ + sizeof(int64_t)));
+#ifdef USE_OPENMP
+    #pragma omp parallel if (n >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t *row = queries.row(i);
+            out[i] = find(row, hash_void(row, itemsize_));
+        }
+    }
+    return hashes_.size();
+}
+
+/**
+ * @brief Adds a batch of voids to the set. The ones already there keep their number, the new ones
+ * are numbered from size() on, in the order of their first occurrence.
+ *
+ * @param rows The voids to add, of itemsize() bytes
+ * @param out The number of each void in the set
+ */
+void PauliIndex::insert_rows(VoidView rows, std::span<int64_t> out) {
+    check_rows(rows, out.size());
+    threads::apply();
+    Z2R_KERNEL_STATS("pauli_index_insert", rows.rows, rows.rows * (itemsize_ + sizeof(int64_t)));
+    // Hashed before taking the lock, so that queries can run in the meantime
+    std::vector<uint64_t> hashes = hash_rows(rows);
+    std::unique_lock lock(mutex_);
+    reserve(hashes_.size() + rows.rows);
+    for (size_t i = 0; i < rows.rows; ++i) {
+        out[i] = insert_row(rows.row(i), hashes[i]);
+    }
+}
+
+/**
+ * @brief Intersection of the set with a batch of voids.
+ *
+ * @param queries The voids to look up
+ * @return IndexMatches The positions, in increasing order, of the queries that are in the set,
+ * and their numbers in the set
+ */
+IndexMatches PauliIndex::intersect(VoidView queries) const {
+    std::vector<int64_t> found(queries.rows);
+    find_all(queries, found);
+
+    IndexMatches matches;
+    for (size_t i = 0; i < queries.rows; ++i) {
+        if (found[i] != EMPTY) {
+            matches.positions.push_back(static_cast<int64_t>(i));
+            matches.numbers.push_back(found[i]);
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Difference of the set with a batch of voids.
+ *
+ * @param queries The voids to remove
+ * @return std::vector<int64_t> The numbers, in increasing order, of the voids of the set that are
+ * not among the queries
+ */
+std::vector<int64_t> PauliIndex::difference(VoidView queries) const {
+    std::vector<int64_t> found(queries.rows);
+    // Keys are never removed, so the numbers below the size at the lookup stay valid
+    size_t num_keys = find_all(queries, found);
+
+    std::vector<uint8_t> removed(num_keys, 0);
+    for (int64_t k : found) {
+        if (k != EMPTY) {
+            removed[k] = 1;
+        }
+    }
+    std::vector<int64_t> kept;
+    for (size_t k = 0; k < num_keys; ++k) {
+        if (!removed[k]) {
+            kept.push_back(static_cast<int64_t>(k));
+        }
+    }
+    return kept;
+}
+
+} // namespace z2r
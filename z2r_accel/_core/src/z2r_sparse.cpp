@@ -0,0 +1,439 @@
+/**
+ * @file z2r_sparse.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free support-list encoding of low-weight Pauli strings. See z2r_sparse.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note Both passes of the kernels producing support lists are parallel over the rows.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_sparse.h"
+#include "z2r_stats.h"
+
+namespace z2r {
+
+namespace {
+
+inline uint64_t load_word(const uint8_t *row, size_t k, size_t itemsize) {
+    size_t off = k * 8;
+    if (off + 8 <= itemsize) {
+        uint64_t word;
+        std::memcpy(&word, row + off, 8);
+        return word;
+    }
+    return load_tail(row + off, itemsize - off);
+}
+
+/**
+ * @brief Turns the per-row counts in offsets[1, rows] into offsets, in place.
+ *
+ * @return size_t The total number of entries
+ */
+size_t counts_to_offsets(std::span<int64_t> offsets) {
+    size_t rows = offsets.size() - 1;
+    offsets[0] = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    return static_cast<size_t>(offsets[rows]);
+}
+
+void check_zx(VoidView z, VoidView x) {
+    if (z.itemsize != x.itemsize || z.rows != x.rows) {
+        throw std::runtime_error("z_voids and x_voids must have the same size and itemsize.");
+    }
+    if (z.itemsize * 8 > SUPPORT_MAX_QUBITS) {
+        throw std::runtime_error("Support lists address at most 2^30 qubits.");
+    }
+}
+
+void check_pair(SupportLists a, SupportLists b) {
+    if (a.rows() != b.rows()) {
+        throw std::runtime_error("Input arrays must have the same number of Pauli strings.");
+    }
+}
+
+/**
+ * @brief Product of two strings of support lists, by merging them. The power p of the phase
+ * (-i)^p is accumulated over the common qubits only, as in compose(): for the other ones, the
+ * z.x terms of the input and of the output cancel out.
+ *
+ * @tparam Write Whether to write the entries of the product, or only to count them
+ * @param a Entries of the first string
+ * @param na Weight of the first string
+ * @param b Entries of the second string
+ * @param nb Weight of the second string
+ * @param out Entries of the product (if Write), at most na + nb of them
+ * @param power Incremented by p
+ * @return size_t Weight of the product
+ */
+template <bool Write>
+size_t merge_product(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out,
+                     int64_t &power) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        uint32_t qa = a[i] >> 2;
+        uint32_t qb = b[j] >> 2;
+        if (qa != qb) {
+            uint32_t entry = (qa < qb) ? a[i++] : b[j++];
+            if constexpr (Write) {
+                out[k] = entry;
+            }
+            ++k;
+            continue;
+        }
+        uint32_t ca = a[i++] & 3;
+        uint32_t cb = b[j++] & 3;
+        uint32_t c = ca ^ cb;
+        // x = code & 1, z = code >> 1
+        power += 2 * ((ca & 1) & (cb >> 1)) + ((ca >> 1) & ca & 1) + ((cb >> 1) & cb & 1) -
+                 ((c >> 1) & c & 1);
+        if (c) {
+            if constexpr (Write) {
+                out[k] = (qa << 2) | c;
+            }
+            ++k;
+        }
+    }
+    if constexpr (Write) {
+        std::copy(a + i, a + na, out + k);
+        std::copy(b + j, b + nb, out + k + (na - i));
+    }
+    return k + (na - i) + (nb - j);
+}
+
+} // namespace
+
+/**
+ * @brief A view of support lists, after checking that the offsets start at 0, end at the number
+ * of entries and never decrease.
+ *
+ * @param offsets Offsets of the strings, num_strings + 1 of them
+ * @param entries Entries of the strings
+ * @return SupportLists
+ */
+SupportLists support_lists(std::span<const int64_t> offsets, std::span<const uint32_t> entries) {
+    if (offsets.empty()) {
+        throw std::runtime_error("offsets must be a 1-D array of num_strings + 1 elements.");
+    }
+    size_t rows = offsets.size() - 1;
+    if (offsets[0] != 0 || offsets[rows] != static_cast<int64_t>(entries.size())) {
+        throw std::runtime_error("offsets must start at 0 and end at the number of entries.");
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw std::runtime_error("offsets must be non-decreasing.");
+        }
+    }
+    return {offsets, entries};
+}
+
+/**
+ * @brief First pass of to_support_lists(): the offsets of the support lists of Pauli strings.
+ *
+ * @param z Z voids of the strings
+ * @param x X voids of the strings, with the same size and itemsize
+ * @param offsets The offsets, z.rows + 1 of them
+ * @return size_t The number of entries
+ */
+size_t support_list_offsets(VoidView z, VoidView x, std::span<int64_t> offsets) {
+    threads::apply();
+    check_zx(z, x);
+    size_t rows = z.rows;
+    if (offsets.size() != rows + 1) {
+        throw std::runtime_error("There must be one offset per Pauli string, plus one.");
+    }
+    size_t itemsize = z.itemsize;
+    size_t words = (itemsize + 7) / 8;
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            int64_t count = 0;
+            for (size_t k = 0; k < words; ++k) {
+                count += std::popcount(load_word(z.row(i), k, itemsize) |
+                                       load_word(x.row(i), k, itemsize));
+            }
+            offsets[i + 1] = count;
+        }
+    }
+    return counts_to_offsets(offsets);
+}
+
+/**
+ * @brief Converts Pauli strings from Z and X voids to support lists.
+ *
+ * @param z Z voids of the strings
+ * @param x X voids of the strings, with the same size and itemsize
+ * @param offsets The offsets, from support_list_offsets()
+ * @param entries The entries, offsets.back() of them
+ */
+void to_support_lists(VoidView z, VoidView x, std::span<const int64_t> offsets,
+                      std::span<uint32_t> entries) {
+    threads::apply();
+    check_zx(z, x);
+    size_t rows = z.rows;
+    if (offsets.size() != rows + 1 || offsets[rows] != static_cast<int64_t>(entries.size())) {
+        throw std::runtime_error("The offsets must come from support_list_offsets().");
+    }
+    size_t itemsize = z.itemsize;
+    size_t words = (itemsize + 7) / 8;
+    Z2R_KERNEL_STATS("to_support_lists", rows,
+                     rows * 2 * itemsize + entries.size() * sizeof(uint32_t));
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (words + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            uint32_t *out = entries.data() + offsets[i];
+            for (size_t k = 0; k < words; ++k) {
+                uint64_t wz = load_word(z.row(i), k, itemsize);
+                uint64_t wx = load_word(x.row(i), k, itemsize);
+                for (uint64_t m = wz | wx; m; m &= m - 1) {
+                    uint32_t b = std::countr_zero(m);
+                    uint32_t code = ((wx >> b) & 1) | (((wz >> b) & 1) << 1);
+                    *out++ = (static_cast<uint32_t>(k * 64 + b) << 2) | code;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Converts Pauli strings from support lists back to Z and X voids.
+ *
+ * @param s The strings
+ * @param num_qubits Number of qubits n. Every qubit of the entries must be below n.
+ * @param z_out Z voids of the strings, of at least n bits
+ * @param x_out X voids of the strings, of the same size and itemsize
+ */
+void from_support_lists(SupportLists s, size_t num_qubits, MutableVoidView z_out,
+                        MutableVoidView x_out) {
+    threads::apply();
+    if (num_qubits > SUPPORT_MAX_QUBITS) {
+        throw std::runtime_error("num_qubits must be between 0 and 2^30.");
+    }
+    for (uint32_t e : s.entries) {
+        if ((e >> 2) >= num_qubits) {
+            throw std::runtime_error("Qubit " + std::to_string(e >> 2) + " is out of range for " +
+                                     std::to_string(num_qubits) + " qubits.");
+        }
+    }
+    size_t rows = s.rows();
+    size_t itemsize = z_out.itemsize;
+    if (z_out.rows != rows || x_out.rows != rows || x_out.itemsize != itemsize ||
+        num_qubits > itemsize * 8) {
+        throw std::runtime_error("There must be one Z and X void of num_qubits bits per string.");
+    }
+    Z2R_KERNEL_STATS("from_support_lists", rows,
+                     rows * 2 * itemsize + s.entries.size() * sizeof(uint32_t));
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows * (itemsize / 8 + 1) >= BOPS_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            uint8_t *rz = z_out.row(i);
+            uint8_t *rx = x_out.row(i);
+            std::memset(rz, 0, itemsize);
+            std::memset(rx, 0, itemsize);
+            const uint32_t *e = s.begin(i);
+            for (size_t k = 0; k < s.weight(i); ++k) {
+                uint32_t q = e[k] >> 2;
+                rx[q / 8] |= (e[k] & 1) << (q % 8);
+                rz[q / 8] |= ((e[k] >> 1) & 1) << (q % 8);
+            }
+        }
+    }
+}
+
+/**
+ * @brief First pass of sparse_compose(): the offsets of the products, and their phases.
+ *
+ * @param a The first strings
+ * @param b The second strings, as many as the first ones
+ * @param offsets The offsets of the products, a.rows() + 1 of them
+ * @param phases The phase of each product, with the convention of compose()
+ * @return size_t The number of entries of the products
+ */
+size_t sparse_compose_offsets(SupportLists a, SupportLists b, std::span<int64_t> offsets,
+                              std::span<std::complex<double>> phases) {
+    static const std::complex<double> phase_of_power[4] = {
+        {1.0, 0.0}, {0.0, -1.0}, {-1.0, 0.0}, {0.0, 1.0}};
+    threads::apply();
+    check_pair(a, b);
+    size_t rows = a.rows();
+    if (offsets.size() != rows + 1 || phases.size() != rows) {
+        throw std::runtime_error("There must be one offset and one phase per Pauli string.");
+    }
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            int64_t power = 0;
+            offsets[i + 1] = static_cast<int64_t>(merge_product<false>(
+                a.begin(i), a.weight(i), b.begin(i), b.weight(i), nullptr, power));
+            // & 3 is the positive remainder, even when power < 0
+            phases[i] = phase_of_power[power & 3];
+        }
+    }
+    return counts_to_offsets(offsets);
+}
+
+/**
+ * @brief Composes Pauli strings in the support-list encoding row by row, P_i = P1_i P2_i, with the
+ * same phase convention as compose(). Only the qubits in the support of P1_i or P2_i are visited.
+ *
+ * @param a The first strings
+ * @param b The second strings, as many as the first ones
+ * @param offsets The offsets of the products, from sparse_compose_offsets()
+ * @param entries The entries of the products, offsets.back() of them
+ */
+void sparse_compose(SupportLists a, SupportLists b, std::span<const int64_t> offsets,
+                    std::span<uint32_t> entries) {
+    threads::apply();
+    check_pair(a, b);
+    size_t rows = a.rows();
+    if (offsets.size() != rows + 1 || offsets[rows] != static_cast<int64_t>(entries.size())) {
+        throw std::runtime_error("The offsets must come from sparse_compose_offsets().");
+    }
+    Z2R_KERNEL_STATS("sparse_compose", rows,
+                     (a.entries.size() + b.entries.size() + entries.size()) * sizeof(uint32_t) +
+                         rows * (3 * sizeof(int64_t) + sizeof(std::complex<double>)));
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            int64_t power = 0;
+            merge_product<true>(a.begin(i), a.weight(i), b.begin(i), b.weight(i),
+                                entries.data() + offsets[i], power);
+        }
+    }
+}
+
+namespace {
+
+/**
+ * @brief sparse_commute_with() for one kind of commutation. Each kind has its own call site of
+ * Z2R_KERNEL_STATS, whose counter is bound on the first call.
+ */
+template <bool QubitWise>
+void commute_rows(SupportLists a, SupportLists b, std::span<bool> out) {
+    size_t rows = a.rows();
+    Z2R_KERNEL_STATS(QubitWise ? "sparse_bitwise_commute_with" : "sparse_commute_with", rows,
+                     (a.entries.size() + b.entries.size()) * sizeof(uint32_t) +
+                         rows * 2 * sizeof(int64_t));
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            const uint32_t *ea = a.begin(i);
+            const uint32_t *eb = b.begin(i);
+            size_t na = a.weight(i);
+            size_t nb = b.weight(i);
+            size_t j = 0, k = 0;
+            uint32_t anticommuting = 0;
+            while (j < na && k < nb) {
+                uint32_t qa = ea[j] >> 2;
+                uint32_t qb = eb[k] >> 2;
+                if (qa == qb) {
+                    anticommuting += (ea[j] & 3) != (eb[k] & 3);
+                }
+                j += qa <= qb;
+                k += qb <= qa;
+            }
+            out[i] = QubitWise ? anticommuting == 0 : (anticommuting & 1) == 0;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Checks row by row whether two Pauli strings in the support-list encoding commute, by
+ * counting the common qubits on which they hold different non-identity Paulis, i.e. the qubits
+ * on which they anticommute.
+ *
+ * @param a The first strings
+ * @param b The second strings, as many as the first ones
+ * @param qubit_wise Whether each pair commutes when no qubit anticommutes (qubit-wise
+ * commutation, as bitwise_commute_with()), rather than when an even number of them do
+ * @param out Whether P1_i and P2_i commute
+ */
+void sparse_commute_with(SupportLists a, SupportLists b, bool qubit_wise, std::span<bool> out) {
+    threads::apply();
+    check_pair(a, b);
+    if (out.size() != a.rows()) {
+        throw std::runtime_error("There must be one output per Pauli string.");
+    }
+    if (qubit_wise) {
+        commute_rows<true>(a, b, out);
+    } else {
+        commute_rows<false>(a, b, out);
+    }
+}
+
+/**
+ * @brief Finds the unique Pauli strings of a batch in the support-list encoding, as
+ * unordered_unique() does for voids. Since the encoding is canonical, the entries of each string
+ * are hashed and compared as a byte key.
+ *
+ * @param s The strings
+ * @return UniqueVoids The index of the first occurrence of each unique string, and the number of
+ * the unique string of each input string. counts is left empty.
+ */
+UniqueVoids sparse_unique(SupportLists s) {
+    threads::apply();
+    size_t rows = s.rows();
+    Z2R_KERNEL_STATS("sparse_unique", rows,
+                     s.entries.size() * sizeof(uint32_t) + rows * 3 * sizeof(int64_t));
+    UniqueVoids out;
+    out.inverse.resize(rows);
+    std::unordered_map<std::string_view, size_t> table;
+    table.max_load_factor(0.5);
+    table.reserve(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        std::string_view key(reinterpret_cast<const char *>(s.begin(i)),
+                             s.weight(i) * sizeof(uint32_t));
+        auto [it, inserted] = table.try_emplace(key, out.index.size());
+        if (inserted) {
+            out.index.push_back(static_cast<int64_t>(i));
+        }
+        out.inverse[i] = static_cast<int64_t>(it->second);
+    }
+    return out;
+}
+
+} // namespace z2r
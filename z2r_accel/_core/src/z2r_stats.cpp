@@ -0,0 +1,141 @@
+/**
+ * @file z2r_stats.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Registry of the per-kernel performance counters. See z2r_stats.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_stats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string_view>
+
+#ifdef USE_OPENMP
+    #include <omp.h>
+#endif
+
+namespace z2r::stats {
+
+namespace {
+
+bool enabled_from_environment() {
+    const char *value = std::getenv("Z2R_STATS");
+    return compiled() && value != nullptr && std::string_view(value) != "" &&
+           std::string_view(value) != "0";
+}
+
+std::atomic<bool> enabled_flag{enabled_from_environment()};
+
+// The innermost open scope of each thread
+thread_local ScopedTimer *active_timer = nullptr;
+
+// Counters are never removed, so a deque keeps the references handed out by counter() valid
+struct Registry {
+    std::mutex mutex;
+    std::deque<std::pair<std::string, KernelCounter>> counters;
+};
+
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+void atomic_max(std::atomic<int> &target, int value) {
+    int current = target.load(std::memory_order_relaxed);
+    while (current < value &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+bool enabled() { return enabled_flag.load(std::memory_order_relaxed); }
+
+void set_enabled(bool enable) { enabled_flag.store(enable, std::memory_order_relaxed); }
+
+KernelCounter &counter(const char *name) {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto &[counter_name, counter] : reg.counters) {
+        if (counter_name == name) {
+            return counter;
+        }
+    }
+    return reg.counters.emplace_back(std::piecewise_construct, std::forward_as_tuple(name),
+                                     std::forward_as_tuple())
+        .second;
+}
+
+std::vector<KernelStats> snapshot(bool reset) {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::vector<KernelStats> out;
+    for (auto &[name, c] : reg.counters) {
+        auto take = [reset](auto &value) {
+            return reset ? value.exchange(0, std::memory_order_relaxed)
+                         : value.load(std::memory_order_relaxed);
+        };
+        KernelStats s{name,
+                      take(c.calls),
+                      take(c.parallel_calls),
+                      take(c.elements),
+                      take(c.bytes),
+                      static_cast<double>(take(c.nanoseconds)) * 1e-9,
+                      take(c.max_threads)};
+        if (s.calls > 0) {
+            out.push_back(std::move(s));
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [](const KernelStats &a, const KernelStats &b) { return a.name < b.name; });
+    return out;
+}
+
+void reset() { snapshot(true); }
+
+ScopedTimer::ScopedTimer(KernelCounter &counter, uint64_t elements, uint64_t bytes) {
+    if (!enabled()) {
+        return;
+    }
+    counter_ = &counter;
+    outer_ = active_timer;
+    elements_ = elements;
+    bytes_ = bytes;
+    active_timer = this;
+    start_ = std::chrono::steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer() {
+    if (counter_ == nullptr) {
+        return;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    active_timer = outer_;
+    counter_->calls.fetch_add(1, std::memory_order_relaxed);
+    counter_->parallel_calls.fetch_add(team_ > 1 ? 1 : 0, std::memory_order_relaxed);
+    counter_->elements.fetch_add(elements_, std::memory_order_relaxed);
+    counter_->bytes.fetch_add(bytes_, std::memory_order_relaxed);
+    atomic_max(counter_->max_threads, team_);
+    counter_->nanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+}
+
+void record_team() {
+#ifdef USE_OPENMP
+    // Thread 0 of a team is the thread that opened the region, and so the one that holds the scope
+    // of its kernel. The regions of a call run one after the other, so it is the only writer.
+    if (omp_get_thread_num() == 0 && active_timer != nullptr) {
+        active_timer->team_ = std::max(active_timer->team_, omp_get_num_threads());
+    }
+#endif
+}
+
+} // namespace z2r::stats
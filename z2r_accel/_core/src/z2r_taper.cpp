@@ -0,0 +1,456 @@
+/**
+ * @file z2r_taper.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Python-free Z2 symmetries of a qubit operator, and qubit tapering. See z2r_taper.h.
+ *
+ * @attention Your compiler must support at least C++20 standard to properly compile this file.
+ *
+ * @note The Pauli strings are given as zx voids (Z bits [0, n) followed by X bits [n, 2n)). They
+ * are split into separate Z and X words for the linear algebra and the Clifford conjugation, and
+ * stitched back together at the end.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_taper.h"
+#include "z2r_arena.h"
+#include "z2r_stats.h"
+
+#include <numeric>
+
+namespace z2r {
+
+namespace {
+
+constexpr size_t NO_BIT = SIZE_MAX;
+
+inline bool get_bit(const uint64_t *v, size_t i) { return (v[i / 64] >> (i % 64)) & 1; }
+
+inline size_t lowest_bit(const uint64_t *v, size_t words) {
+    for (size_t w = 0; w < words; ++w) {
+        if (v[w]) {
+            return w * 64 + std::countr_zero(v[w]);
+        }
+    }
+    return NO_BIT;
+}
+
+inline void xor_into(uint64_t *v, const uint64_t *u, size_t words) {
+    for (size_t w = 0; w < words; ++w) {
+        v[w] ^= u[w];
+    }
+}
+
+/**
+ * @brief Row-reduced basis of a set of bit vectors of `words` words, each basis row keyed by its
+ * lowest set bit (its pivot).
+ */
+class XorBasis {
+  public:
+    explicit XorBasis(size_t words) : words_(words), row_of_pivot_(words * 64, -1) {}
+
+    size_t rank() const { return pivots_.size(); }
+    size_t pivot(size_t r) const { return pivots_[r]; }
+    const uint64_t *row(size_t r) const { return rows_.data() + r * words_; }
+
+    /**
+     * @brief Reduces v against the basis, and adds what is left of it if it is not zero.
+     *
+     * @param v The vector, overwritten
+     */
+    void insert(uint64_t *v) {
+        for (size_t p = lowest_bit(v, words_); p != NO_BIT; p = lowest_bit(v, words_)) {
+            if (row_of_pivot_[p] < 0) {
+                row_of_pivot_[p] = static_cast<int64_t>(pivots_.size());
+                pivots_.push_back(p);
+                rows_.insert(rows_.end(), v, v + words_);
+                return;
+            }
+            xor_into(v, row(row_of_pivot_[p]), words_);
+        }
+    }
+
+    void merge(const XorBasis &other) {
+        std::vector<uint64_t> v(words_);
+        for (size_t r = 0; r < other.rank(); ++r) {
+            std::copy(other.row(r), other.row(r) + words_, v.begin());
+            insert(v.data());
+        }
+    }
+
+    /**
+     * @brief Clears the pivot of every row from all the other rows (reduced row echelon form).
+     * From the highest pivot down, so that a row never brings back a pivot already cleared.
+     */
+    void reduce() {
+        std::vector<size_t> order(rank());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return pivots_[a] > pivots_[b]; });
+        for (size_t r : order) {
+            for (size_t s = 0; s < rank(); ++s) {
+                if (s != r && get_bit(row(s), pivots_[r])) {
+                    xor_into(rows_.data() + s * words_, row(r), words_);
+                }
+            }
+        }
+    }
+
+    bool is_pivot(size_t p) const { return row_of_pivot_[p] >= 0; }
+
+  private:
+    size_t words_;
+    std::vector<uint64_t> rows_;
+    std::vector<size_t> pivots_;
+    std::vector<int64_t> row_of_pivot_;
+};
+
+// Symplectic product of two Pauli strings of `words` Z words followed by `words` X words
+inline bool anticommute(const uint64_t *a, const uint64_t *b, size_t words) {
+    int count = 0;
+    for (size_t w = 0; w < words; ++w) {
+        count += std::popcount(a[w] & b[words + w]) + std::popcount(a[words + w] & b[w]);
+    }
+    return count & 1;
+}
+
+// Applies a gate to a single Pauli string of Z words z and X words x, with the rules of
+// apply_clifford_gate()
+void apply_gate_to_row(int64_t code, size_t a, size_t b, uint64_t *z, uint64_t *x,
+                       uint8_t &sign) {
+    uint64_t z_cols[2] = {get_bit(z, a), get_bit(z, b)};
+    uint64_t x_cols[2] = {get_bit(x, a), get_bit(x, b)};
+    uint64_t s = sign;
+    apply_clifford_gate(code, 0, 1, z_cols, x_cols, s);
+    sign = s & 1;
+    auto set_bit = [](uint64_t *v, size_t i, uint64_t bit) {
+        v[i / 64] = (v[i / 64] & ~(uint64_t{1} << (i % 64))) | ((bit & 1) << (i % 64));
+    };
+    set_bit(z, a, z_cols[0]);
+    set_bit(x, a, x_cols[0]);
+    if (b != a) {
+        set_bit(z, b, z_cols[1]);
+        set_bit(x, b, x_cols[1]);
+    }
+}
+
+/**
+ * @brief Builds a Clifford circuit mapping each generator g_k to +-Z on a qubit of its own, and
+ * fills qubits, signs and gates. Generator by generator: the circuit so far already maps g_1..g_k-1
+ * to Z_{q_1}..Z_{q_k-1}, so g_k has no X on these qubits. A qubit q where g_k has X (after an H if
+ * it only has Z) is picked, CX gates clear its other X, an S turns Y_q into X_q, CZ gates clear its
+ * Z, and a final H maps X_q to Z_q. None of these gates change Z_{q_1}..Z_{q_k-1}.
+ */
+void map_to_single_qubit_z(Z2Symmetries &sym) {
+    size_t n = sym.num_qubits;
+    size_t words = sym.words;
+    size_t k = sym.generators.size() / (2 * words);
+    std::vector<uint64_t> rows(sym.generators);
+    sym.signs.assign(k, 0);
+
+    auto z_of = [&](size_t g) { return rows.data() + 2 * g * words; };
+    auto x_of = [&](size_t g) { return rows.data() + (2 * g + 1) * words; };
+    auto emit = [&](int64_t code, size_t a, size_t b) {
+        sym.gates.insert(sym.gates.end(),
+                         {code, static_cast<int64_t>(a), static_cast<int64_t>(b)});
+        for (size_t g = 0; g < k; ++g) {
+            apply_gate_to_row(code, a, b, z_of(g), x_of(g), sym.signs[g]);
+        }
+    };
+
+    std::vector<uint8_t> chosen(n, 0);
+    for (size_t g = 0; g < k; ++g) {
+        size_t q = NO_BIT;
+        for (size_t j = 0; j < n && q == NO_BIT; ++j) {
+            if (!chosen[j] && get_bit(x_of(g), j)) {
+                q = j;
+            }
+        }
+        for (size_t j = 0; j < n && q == NO_BIT; ++j) {
+            if (!chosen[j] && get_bit(z_of(g), j)) {
+                q = j;
+                emit(GATE_H, q, q);
+            }
+        }
+        if (q == NO_BIT) {
+            throw std::runtime_error("The symmetry generators are not independent.");
+        }
+
+        for (size_t j = 0; j < n; ++j) {
+            if (j != q && !chosen[j] && get_bit(x_of(g), j)) {
+                emit(GATE_CX, q, j);
+            }
+        }
+        if (get_bit(z_of(g), q)) {
+            emit(GATE_S, q, q);
+        }
+        for (size_t j = 0; j < n; ++j) {
+            if (j != q && get_bit(z_of(g), j)) {
+                emit(GATE_CZ, q, j);
+            }
+        }
+        emit(GATE_H, q, q);
+
+        chosen[q] = 1;
+        sym.qubits.push_back(static_cast<int64_t>(q));
+    }
+}
+
+/**
+ * @brief Copies the bits of `in` selected by `keep` to the low bits of `out`, in order.
+ */
+inline void compact_bits(const uint64_t *in, const uint64_t *keep, size_t words, uint64_t *out,
+                         size_t out_words) {
+    std::fill(out, out + out_words, 0);
+    size_t pos = 0;
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = pext64(in[w], keep[w]);
+        size_t count = std::popcount(keep[w]);
+        if (count == 0) {
+            continue;
+        }
+        out[pos / 64] |= bits << (pos % 64);
+        if (pos % 64 && pos % 64 + count > 64) {
+            out[pos / 64 + 1] |= bits >> (64 - pos % 64);
+        }
+        pos += count;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Finds a maximal set of independent and commuting Z2 symmetries of a set of Pauli strings,
+ * and the Clifford circuit mapping them to single-qubit Z.
+ *
+ * The check matrix is row-reduced on the fly: each thread reduces its share of the Pauli strings
+ * into a basis of at most 2n rows, the bases are merged, and the kernel is read from the reduced
+ * row echelon form. The kernel may hold pairs of anticommuting symmetries (e.g. X_q and Z_q for a
+ * qubit q that no term acts on); a symplectic Gram-Schmidt keeps one of each pair.
+ *
+ * @param zx_voids The Pauli strings, in the stitched layout
+ * @param num_qubits Number of qubits n
+ * @return Z2Symmetries
+ */
+Z2Symmetries find_z2_symmetries(VoidView zx_voids, size_t num_qubits) {
+    threads::apply();
+    size_t n = num_qubits;
+    size_t rows = zx_voids.rows;
+    size_t itemsize = zx_voids.itemsize;
+    if (n == 0 || 2 * n > itemsize * 8) {
+        throw std::runtime_error("num_qubits must be positive, and 2 * num_qubits must fit in the "
+                                 "bits of the voids.");
+    }
+    size_t words = (n + 63) / 64;
+    Z2R_KERNEL_STATS("find_z2_symmetries", rows, rows * itemsize);
+
+    // Rows of the check matrix: [z_t | x_t]
+    XorBasis basis(2 * words);
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        XorBasis local(2 * words);
+        std::vector<uint64_t> buffer(itemsize / 8 + 2);
+        std::vector<uint64_t> v(2 * words);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime) nowait
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            if (local.rank() == 2 * n) {
+                continue; // Full rank, nothing left to find
+            }
+            split_zx_row(zx_voids.row(i), itemsize, n, buffer.data(), v.data(), v.data() + words);
+            local.insert(v.data());
+        }
+#ifdef USE_OPENMP
+    #pragma omp critical
+#endif
+        basis.merge(local);
+    }
+    basis.reduce();
+
+    // One kernel vector [x | z] per free column f: e_f, plus the pivot of every row holding f
+    std::vector<std::vector<uint64_t>> kernel;
+    for (size_t f = 0; f < 2 * words * 64; ++f) {
+        if (f % (words * 64) >= n || basis.is_pivot(f)) {
+            continue;
+        }
+        std::vector<uint64_t> v(2 * words, 0);
+        v[f / 64] |= uint64_t{1} << (f % 64);
+        for (size_t r = 0; r < basis.rank(); ++r) {
+            if (get_bit(basis.row(r), f)) {
+                v[basis.pivot(r) / 64] |= uint64_t{1} << (basis.pivot(r) % 64);
+            }
+        }
+        // [x | z] to the [z | x] layout of the generators
+        std::rotate(v.begin(), v.begin() + words, v.end());
+        kernel.push_back(std::move(v));
+    }
+
+    // Symplectic Gram-Schmidt: keep a, drop its partner b, and make the rest commute with both
+    Z2Symmetries sym;
+    sym.num_qubits = n;
+    sym.words = words;
+    while (!kernel.empty()) {
+        std::vector<uint64_t> a = std::move(kernel.front());
+        kernel.erase(kernel.begin());
+        auto partner = std::find_if(kernel.begin(), kernel.end(), [&](const auto &c) {
+            return anticommute(a.data(), c.data(), words);
+        });
+        if (partner != kernel.end()) {
+            std::vector<uint64_t> b = std::move(*partner);
+            kernel.erase(partner);
+            for (std::vector<uint64_t> &c : kernel) {
+                if (anticommute(c.data(), a.data(), words)) {
+                    xor_into(c.data(), b.data(), 2 * words);
+                }
+                if (anticommute(c.data(), b.data(), words)) {
+                    xor_into(c.data(), a.data(), 2 * words);
+                }
+            }
+        }
+        sym.generators.insert(sym.generators.end(), a.begin(), a.end());
+    }
+
+    map_to_single_qubit_z(sym);
+    return sym;
+}
+
+
+/**
+ * @brief Stitches the symmetry generators back into zx voids.
+ *
+ * @param sym The symmetries, from find_z2_symmetries()
+ * @param zx_out One void per generator, of at least 2 * num_qubits bits
+ */
+void symmetry_generators(const Z2Symmetries &sym, MutableVoidView zx_out) {
+    if (zx_out.rows != sym.size() || 2 * sym.num_qubits > zx_out.itemsize * 8) {
+        throw std::runtime_error("There must be one output void of 2 * num_qubits bits per "
+                                 "symmetry generator.");
+    }
+    std::vector<uint64_t> buffer(zx_out.itemsize / 8 + 2);
+    for (size_t g = 0; g < sym.size(); ++g) {
+        const uint64_t *z = sym.generators.data() + 2 * g * sym.words;
+        stitch_zx_row(z, z + sym.words, zx_out.itemsize, sym.num_qubits, buffer.data(),
+                      zx_out.row(g));
+    }
+}
+
+/**
+ * @brief Tapers the qubits of an operator off, one per independent Z2 symmetry. See z2r_taper.h.
+ *
+ * The terms are conjugated by the Clifford circuit of find_z2_symmetries(), after which they only
+ * act on the tapered qubits with I or Z. The Z are replaced by the eigenvalue of the chosen sector,
+ * the tapered qubits are removed, and identical terms are summed.
+ *
+ * @param zx_voids The terms of the operator, in the stitched layout
+ * @param weights One weight per term
+ * @param sym The symmetries of the operator, from find_z2_symmetries()
+ * @param sector The eigenvalue (+1 or -1) of each symmetry generator, in the order of sym. All +1
+ * when empty.
+ * @return std::vector<PauliAccumulator> Disjoint partial sums of the tapered terms (see
+ * simplify()), keyed by stitched voids of sym.tapered_itemsize() bytes
+ */
+std::vector<PauliAccumulator> taper(VoidView zx_voids,
+                                    std::span<const std::complex<double>> weights,
+                                    const Z2Symmetries &sym, std::span<const int> sector) {
+    threads::apply();
+    size_t n = sym.num_qubits;
+    size_t k = sym.size();
+    size_t words = sym.words;
+    size_t rows = zx_voids.rows;
+    size_t itemsize = zx_voids.itemsize;
+    if (weights.size() != rows) {
+        throw std::runtime_error("There must be one weight per Pauli string.");
+    }
+    if (2 * n > itemsize * 8) {
+        throw std::runtime_error("2 * num_qubits must fit in the bits of the voids.");
+    }
+    if (!sector.empty() && sector.size() != k) {
+        throw std::runtime_error("The sector must have one eigenvalue per symmetry (" +
+                                 std::to_string(k) + ").");
+    }
+    // Z on a tapered qubit is replaced by -1 when sector[k] * (-1)^signs[k] is -1
+    std::vector<uint64_t> negative(words, 0);
+    std::vector<uint64_t> keep(words, 0);
+    for (size_t q = 0; q < n; ++q) {
+        keep[q / 64] |= uint64_t{1} << (q % 64);
+    }
+    for (size_t g = 0; g < k; ++g) {
+        int eigenvalue = sector.empty() ? 1 : sector[g];
+        if (eigenvalue != 1 && eigenvalue != -1) {
+            throw std::runtime_error("Sector eigenvalues must be +1 or -1.");
+        }
+        size_t q = static_cast<size_t>(sym.qubits[g]);
+        if ((eigenvalue < 0) != (sym.signs[g] != 0)) {
+            negative[q / 64] |= uint64_t{1} << (q % 64);
+        }
+        keep[q / 64] &= ~(uint64_t{1} << (q % 64));
+    }
+    CompiledCircuit circuit = compile_circuit(sym.gates, words * 8);
+
+    size_t out_qubits = n - k;
+    size_t out_words = std::max<size_t>((out_qubits + 63) / 64, 1);
+    size_t out_itemsize = sym.tapered_itemsize();
+    Z2R_KERNEL_STATS("taper", rows, rows * (itemsize + out_itemsize));
+
+    arena::vector<uint64_t> z(rows * words);
+    arena::vector<uint64_t> x(rows * words);
+    arena::vector<std::complex<double>> w(weights.begin(), weights.end());
+    arena::vector<uint8_t> reduced(rows * out_itemsize);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(std::max(itemsize, out_itemsize) / 8 + 2);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            split_zx_row(zx_voids.row(i), itemsize, n, buffer.data(), &z[i * words],
+                         &x[i * words]);
+        }
+    }
+
+    MutableVoidView z_rows(reinterpret_cast<uint8_t *>(z.data()), rows, words * 8);
+    MutableVoidView x_rows(reinterpret_cast<uint8_t *>(x.data()), rows, words * 8);
+    conjugate_rows(circuit, z_rows, x_rows, w, z_rows, x_rows, w);
+
+#ifdef USE_OPENMP
+    #pragma omp parallel if (rows >= FUNC_THRESHOLD_PARALLEL)
+#endif
+    {
+        Z2R_KERNEL_TEAM();
+        std::vector<uint64_t> buffer(std::max(itemsize, out_itemsize) / 8 + 2);
+        std::vector<uint64_t> out_z(out_words);
+        std::vector<uint64_t> out_x(out_words);
+#ifdef USE_OPENMP
+    #pragma omp for schedule(runtime)
+#endif
+        for (size_t i = 0; i < rows; ++i) {
+            const uint64_t *zi = &z[i * words];
+            const uint64_t *xi = &x[i * words];
+            int flips = 0;
+            for (size_t word = 0; word < words; ++word) {
+                flips += std::popcount(zi[word] & negative[word]);
+            }
+            if (flips & 1) {
+                w[i] = -w[i];
+            }
+            compact_bits(zi, keep.data(), words, out_z.data(), out_words);
+            compact_bits(xi, keep.data(), words, out_x.data(), out_words);
+            stitch_zx_row(out_z.data(), out_x.data(), out_itemsize, out_qubits, buffer.data(),
+                          &reduced[i * out_itemsize]);
+        }
+    }
+
+    return simplify(VoidView(reduced.data(), rows, out_itemsize), w);
+}
+
+} // namespace z2r
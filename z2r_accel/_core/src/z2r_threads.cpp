@@ -0,0 +1,464 @@
+/**
+ * @file z2r_threads.cpp
+ * @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+ * @brief Thread count, scheduling and affinity of the parallel kernels. See z2r_threads.h.
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Copyright 2026 Zakary Romdhane
+ */
+
+#include "z2r_threads.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef USE_OPENMP
+    #include <omp.h>
+#endif
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+namespace z2r::threads {
+
+namespace {
+
+struct Settings {
+    int num_threads = 0;
+    Schedule kind = Schedule::Static;
+    int chunk = 0;
+    std::vector<int> cpus;
+    bool pin_caller = false;
+};
+
+struct Limits {
+    int num_threads;
+    int kind;
+    int chunk;
+};
+
+bool numa_from_environment() {
+    const char *value = std::getenv("Z2R_NUMA");
+    return value != nullptr && std::string_view(value) != "" && std::string_view(value) != "0";
+}
+
+bool persistent_from_environment() {
+    const char *value = std::getenv("Z2R_PERSISTENT_POOL");
+    return value != nullptr && std::string_view(value) != "" && std::string_view(value) != "0";
+}
+
+std::mutex settings_mutex;
+Settings global_settings;
+// Bumped on every change of global_settings, starts above the initial seen_generation
+std::atomic<uint64_t> generation{1};
+std::atomic<bool> persistent{persistent_from_environment()};
+// Read by first_touch() on every output, hence atomic. Written under settings_mutex.
+std::atomic<bool> numa_flag{numa_from_environment()};
+
+thread_local std::vector<Limits> local_limits;
+thread_local uint64_t local_version = 1;
+thread_local uint64_t seen_generation = 0;
+thread_local uint64_t seen_version = 0;
+// OpenMP default of this thread, before any omp_set_num_threads() from here
+thread_local int default_threads = 0;
+// CPU list (explicit or NUMA) and team of the last pin_team() from this thread
+thread_local std::vector<int> pinned_cpus;
+thread_local bool pinned_numa = false;
+thread_local int pinned_threads = 0;
+thread_local bool pinned_caller = false;
+
+#ifdef __linux__
+cpu_set_t original_mask_of_process() {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    sched_getaffinity(0, sizeof(mask), &mask);
+    return mask;
+}
+
+// Mask of the thread which loaded the library, given back by set_affinity({})
+const cpu_set_t original_mask = original_mask_of_process();
+#endif
+
+// CPUs of a list such as "0-3,8-11", as in the sysfs cpulist files
+std::vector<int> parse_cpu_list(const std::string &list) {
+    std::vector<int> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<std::vector<int>> read_numa_nodes() {
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (!std::getline(online, list)) {
+        return nodes;
+    }
+    for (int node : parse_cpu_list(list)) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string cpu_list;
+        std::getline(file, cpu_list);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(cpu_list)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &original_mask)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+#endif
+    return nodes;
+}
+
+// Read once: the topology does not change while the process runs
+const std::vector<std::vector<int>> &cached_numa_nodes() {
+    static const std::vector<std::vector<int>> nodes = read_numa_nodes();
+    return nodes;
+}
+
+// CPUs of all the nodes, node by node
+std::vector<int> numa_cpus() {
+    std::vector<int> cpus;
+    for (const std::vector<int> &node : cached_numa_nodes()) {
+        cpus.insert(cpus.end(), node.begin(), node.end());
+    }
+    return cpus;
+}
+
+// CPU of each thread of a team of n in NUMA mode, when it is the only pinned team: contiguous
+// thread numbers share a node, so that the static chunks of neighbouring threads, and the pages
+// they first touch, stay on one node.
+std::vector<int> numa_placement(int n) {
+    const std::vector<std::vector<int>> &nodes = cached_numa_nodes();
+    std::vector<int> cpus;
+    if (nodes.empty()) {
+        return cpus;
+    }
+    size_t num_nodes = nodes.size();
+    for (size_t t = 0; t < static_cast<size_t>(n); ++t) {
+        size_t node = t * num_nodes / n;
+        size_t first = (node * n + num_nodes - 1) / num_nodes;
+        cpus.push_back(nodes[node][(t - first) % nodes[node].size()]);
+    }
+    return cpus;
+}
+
+// Slices of the CPU list held by the root threads (the threads calling the kernels, each with its
+// own team) with pinned teams, in the order they were taken. Guarded by settings_mutex.
+struct Slice {
+    uint64_t id;
+    size_t offset;
+    size_t size;
+};
+std::vector<Slice> slices;
+uint64_t next_slice_id = 1;
+
+void release_slice(uint64_t id) {
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    std::erase_if(slices, [id](const Slice &slice) { return slice.id == id; });
+}
+
+// Slice of the calling root thread, given back when the thread exits
+struct SliceOwner {
+    uint64_t id = 0;
+    ~SliceOwner() {
+        if (id != 0) {
+            release_slice(id);
+        }
+    }
+};
+thread_local SliceOwner own_slice;
+
+/**
+ * Takes the next n positions of a CPU list of num_cpus, after the slice of the last root thread
+ * still pinned (wrapping around), so that the teams of concurrent root threads, such as the workers
+ * of the async pool, run on different CPUs rather than all on the first ones.
+ *
+ * @return (offset, lone): the first position, and whether no other root thread holds a slice
+ */
+std::pair<size_t, bool> take_slice(size_t n, size_t num_cpus) {
+    if (own_slice.id != 0) {
+        release_slice(own_slice.id);
+    }
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    size_t offset = slices.empty() ? 0 : (slices.back().offset + slices.back().size) % num_cpus;
+    own_slice.id = next_slice_id++;
+    slices.push_back({own_slice.id, offset, n});
+    return {offset, slices.size() == 1};
+}
+
+/**
+ * CPU of each thread of a team of n, in the slice of the calling root thread. Thread t takes the
+ * CPU at position offset + t of the list. A lone NUMA team keeps numa_placement(), spread over all
+ * the nodes.
+ */
+std::vector<int> team_placement(const std::vector<int> &cpus, int n, bool use_numa) {
+    auto [offset, lone] = take_slice(n, cpus.size());
+    if (use_numa && lone) {
+        return numa_placement(n);
+    }
+    std::vector<int> team(n);
+    for (size_t t = 0; t < static_cast<size_t>(n); ++t) {
+        team[t] = cpus[(offset + t) % cpus.size()];
+    }
+    return team;
+}
+
+void bump_generation() { generation.fetch_add(1, std::memory_order_acq_rel); }
+
+void check_kind(int kind) {
+    if (kind < static_cast<int>(Schedule::Static) || kind > static_cast<int>(Schedule::Guided)) {
+        throw std::runtime_error("Unknown schedule " + std::to_string(kind) +
+                                 ". Expected static, dynamic or guided.");
+    }
+}
+
+#ifdef USE_OPENMP
+// Pins thread t of a team of n to team[t], or unpins the team if team is empty. The calling
+// thread (t = 0) is only pinned if pin_caller, and only given its original mask back if it was.
+void pin_team([[maybe_unused]] const std::vector<int> &team, [[maybe_unused]] int n,
+              [[maybe_unused]] bool pin_caller) {
+    #ifdef __linux__
+    bool restore_caller = pinned_caller;
+        #pragma omp parallel num_threads(n)
+    {
+        int t = omp_get_thread_num();
+        bool pin = !team.empty() && (t != 0 || pin_caller);
+        if (t != 0 || pin || restore_caller) {
+            cpu_set_t mask = original_mask;
+            if (pin) {
+                CPU_ZERO(&mask);
+                CPU_SET(team[t], &mask);
+            }
+            sched_setaffinity(0, sizeof(mask), &mask);
+        }
+    }
+    #endif
+}
+
+void start_team(int n) {
+    #pragma omp parallel num_threads(n)
+    {
+    }
+}
+
+void apply_slow(uint64_t gen) {
+    if (default_threads == 0) {
+        default_threads = omp_get_max_threads();
+    }
+    Settings s;
+    bool use_numa;
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex);
+        s = global_settings;
+        use_numa = numa_flag.load(std::memory_order_relaxed);
+    }
+    if (use_numa) {
+        s.cpus = numa_cpus();
+    }
+    int n = s.num_threads > 0 ? s.num_threads : default_threads;
+    int kind = static_cast<int>(s.kind);
+    int chunk = s.chunk;
+    for (const Limits &l : local_limits) {
+        if (l.num_threads > 0) {
+            n = l.num_threads;
+        }
+        if (l.kind != 0) {
+            kind = l.kind;
+            chunk = l.chunk;
+        }
+    }
+
+    omp_set_num_threads(n);
+    omp_set_schedule(static_cast<omp_sched_t>(kind), chunk);
+
+    if (s.cpus != pinned_cpus || use_numa != pinned_numa ||
+        (!s.cpus.empty() && (n != pinned_threads || s.pin_caller != pinned_caller))) {
+        std::vector<int> team;
+        if (!s.cpus.empty()) {
+            team = team_placement(s.cpus, n, use_numa);
+        } else if (own_slice.id != 0) {
+            release_slice(own_slice.id);
+            own_slice.id = 0;
+        }
+        pin_team(team, n, s.pin_caller);
+        pinned_cpus = s.cpus;
+        pinned_numa = use_numa;
+        pinned_threads = n;
+        pinned_caller = s.pin_caller && !team.empty();
+    } else if (persistent.load(std::memory_order_relaxed)) {
+        start_team(n);
+    }
+
+    seen_generation = gen;
+    seen_version = local_version;
+}
+#endif
+
+} // namespace
+
+void apply() {
+#ifdef USE_OPENMP
+    uint64_t gen = generation.load(std::memory_order_acquire);
+    if (gen != seen_generation || local_version != seen_version) {
+        apply_slow(gen);
+    }
+#endif
+}
+
+void set_num_threads(int num_threads) {
+    if (num_threads < 0) {
+        throw std::runtime_error("num_threads must be positive, or 0 for the OpenMP default.");
+    }
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex);
+        global_settings.num_threads = num_threads;
+    }
+    bump_generation();
+    apply();
+}
+
+int num_threads() {
+#ifdef USE_OPENMP
+    apply();
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void set_schedule(Schedule kind, int chunk) {
+    check_kind(static_cast<int>(kind));
+    if (chunk < 0) {
+        throw std::runtime_error("chunk must be positive, or 0 for the default chunk size.");
+    }
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex);
+        global_settings.kind = kind;
+        global_settings.chunk = chunk;
+    }
+    bump_generation();
+    apply();
+}
+
+Schedule schedule_kind() {
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    return global_settings.kind;
+}
+
+int schedule_chunk() {
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    return global_settings.chunk;
+}
+
+void set_affinity(const std::vector<int> &cpus, bool pin_caller) {
+#ifdef __linux__
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &original_mask)) {
+            throw std::runtime_error("CPU " + std::to_string(cpu) +
+                                     " is not available to this process.");
+        }
+    }
+#else
+    if (!cpus.empty()) {
+        throw std::runtime_error("Thread affinity is only supported on Linux.");
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex);
+        global_settings.cpus = cpus;
+        global_settings.pin_caller = pin_caller;
+        numa_flag.store(false, std::memory_order_relaxed);
+    }
+    bump_generation();
+    apply();
+}
+
+void set_numa(bool enable, bool pin_caller) {
+#ifndef __linux__
+    if (enable) {
+        throw std::runtime_error("NUMA mode is only supported on Linux.");
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(settings_mutex);
+        numa_flag.store(enable, std::memory_order_relaxed);
+        if (enable) {
+            global_settings.cpus.clear();
+            global_settings.pin_caller = pin_caller;
+        }
+    }
+    bump_generation();
+    apply();
+}
+
+bool numa() { return numa_flag.load(std::memory_order_relaxed); }
+
+std::vector<std::vector<int>> numa_nodes() { return cached_numa_nodes(); }
+
+std::vector<int> affinity() {
+    std::lock_guard<std::mutex> lock(settings_mutex);
+    return global_settings.cpus;
+}
+
+void set_persistent_pool(bool enable) {
+    persistent.store(enable, std::memory_order_relaxed);
+    bump_generation();
+    apply();
+}
+
+bool persistent_pool() { return persistent.load(std::memory_order_relaxed); }
+
+void warm_up() {
+#ifdef USE_OPENMP
+    apply();
+    start_team(omp_get_max_threads());
+#endif
+}
+
+void push_limits(int num_threads, int kind, int chunk) {
+    if (num_threads < 0) {
+        throw std::runtime_error("num_threads must be positive, or 0 to keep the current one.");
+    }
+    if (kind != 0) {
+        check_kind(kind);
+    }
+    if (chunk < 0) {
+        throw std::runtime_error("chunk must be positive, or 0 for the default chunk size.");
+    }
+    local_limits.push_back({num_threads, kind, chunk});
+    ++local_version;
+}
+
+void pop_limits() {
+    if (local_limits.empty()) {
+        throw std::runtime_error("pop_limits() called without a matching push_limits().");
+    }
+    local_limits.pop_back();
+    ++local_version;
+}
+
+} // namespace z2r::threads
@@ -0,0 +1,59 @@
+## @package z2r_accel.arena
+# @file arena.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Pooled, cache-line aligned allocator of the C++ kernels.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# The temporaries of the kernels come from a pool of 64-byte aligned blocks: a freed block is kept
+# for the next allocation of its size class, with its pages already mapped, instead of being given
+# back to the system. The pool keeps at most set_arena_limit() bytes (2 GiB by default, or the
+# Z2R_ARENA_LIMIT environment variable). The returned arrays only come from the pool after
+# set_arena_outputs(True) (or Z2R_ARENA_OUTPUTS=1 before import); their blocks go back to it when
+# the arrays are freed. There is a single pool per process, in the z2r_core library that every C++
+# module shares: the limit covers the blocks of all of them.
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+
+def set_arena_limit(limit_bytes: int) -> None:
+    """
+    Sets the maximum number of bytes the pool keeps for reuse, releasing the blocks cached beyond
+    it. 0 disables the pooling: every block goes back to the system when freed.
+    """
+    if C_CCP:
+        _cz2m.set_arena_limit(limit_bytes)
+
+
+def trim_arena() -> None:
+    """Gives every cached block back to the system. The blocks in use are not affected."""
+    if C_CCP:
+        _cz2m.trim_arena()
+
+
+def set_arena_outputs(enabled: bool = True) -> None:
+    """Whether the arrays returned by the kernels are allocated from the pool rather than NumPy."""
+    if C_CCP:
+        _cz2m.set_arena_outputs(enabled)
+
+
+def arena_outputs() -> bool:
+    """Whether the arrays returned by the kernels are allocated from the pool."""
+    return _cz2m.arena_outputs() if C_CCP else False
+
+
+def arena_stats() -> dict:
+    """
+    Counters of the pool: "hits" (allocations served from the pool), "misses" (allocations that
+    went to the system), "live_bytes" (blocks in use), "cached_bytes" (blocks waiting for reuse) and
+    "limit" (the most it keeps for reuse).
+    """
+    if not C_CCP:
+        return {"hits": 0, "misses": 0, "live_bytes": 0, "cached_bytes": 0, "limit": 0}
+    return _cz2m.arena_stats()
@@ -66,6 +66,15 @@ def bitwise_xor(
     return _bitops.bitwise_xor(*_bc(z2r_1, z2r_2))
 
 
+def bitwise_xor_many(z2r_1s, z2r_2s) -> list[NDArray]:
+    """
+    bitwise_xor() of every pair (z2r_1s[i], z2r_2s[i]) in a single call, which is much cheaper than
+    a loop of bitwise_xor() calls on small arrays. The arrays of a pair must have the same size
+    (no broadcasting). The outputs are views into a single buffer.
+    """
+    return _bitops.bitwise_xor_many(z2r_1s, z2r_2s)
+
+
 def bitwise_or(
     z2r_1: NDArray,
     z2r_2: NDArray,
@@ -0,0 +1,156 @@
+## @package z2r_accel.clifford
+# @file clifford.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief
+# @version 0.1
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+
+import numpy as np
+from numpy.typing import NDArray
+from typing import Tuple
+
+try:
+    from ._core.build import _clifford
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+# Must be kept in sync with the CliffordGate enum in clifford.h
+CLIFFORD_GATES = {
+    "h": 0,
+    "s": 1,
+    "sdg": 2,
+    "x": 3,
+    "y": 4,
+    "z": 5,
+    "cx": 6,
+    "cnot": 6,
+    "cz": 7,
+    "swap": 8,
+}
+
+
+def _contiguous(a):
+    if a.flags.c_contiguous:
+        return a
+    else:
+        return np.ascontiguousarray(a)
+
+
+def compile_gates(gates) -> NDArray[np.int64]:
+    """
+    Compiles a Clifford circuit into the int64 array expected by the C++ backend.
+
+    Args:
+        gates: A sequence of tuples (name, qubit) or (name, qubit_0, qubit_1), e.g.
+            [("h", 0), ("cx", 0, 1)]. An already compiled array is returned as is.
+
+    Returns:
+        NDArray[np.int64]: An array of shape (num_gates, 3) of rows (code, qubit_0, qubit_1)
+    """
+    if isinstance(gates, np.ndarray):
+        return _contiguous(gates.astype(np.int64, copy=False).reshape(-1, 3))
+
+    compiled = np.zeros((len(gates), 3), dtype=np.int64)
+    for i, gate in enumerate(gates):
+        compiled[i, 0] = CLIFFORD_GATES[gate[0].lower()]
+        compiled[i, 1] = gate[1]
+        compiled[i, 2] = gate[2] if len(gate) > 2 else gate[1]
+    return compiled
+
+
+def clifford_conjugate(
+    z_voids: NDArray, x_voids: NDArray, gates, phases: NDArray = None
+) -> Tuple[NDArray, NDArray, NDArray]:
+    """
+    Conjugates every Pauli string P by a Clifford circuit C, i.e. computes C P C^dagger.
+
+    Args:
+        z_voids (NDArray): Z voids of the Pauli strings
+        x_voids (NDArray): X voids of the Pauli strings
+        gates: The circuit, either as a list of gates or compiled with compile_gates()
+        phases (NDArray, optional): Phases or weights to carry along. Defaults to ones.
+
+    Returns:
+        Tuple[NDArray, NDArray, NDArray]: The new z voids, x voids and phases
+    """
+    if phases is None:
+        phases = np.ones(z_voids.shape, dtype=np.complex128)
+    phases = np.ascontiguousarray(phases, dtype=np.complex128)
+    return _clifford.clifford_conjugate(
+        _contiguous(z_voids), _contiguous(x_voids), compile_gates(gates), phases
+    )
+
+
+def z2_symmetries(
+    zx_voids: NDArray, num_qubits: int
+) -> Tuple[NDArray, NDArray[np.int64], NDArray[np.int64], NDArray[np.int64]]:
+    """
+    Finds a maximal set of independent and commuting Z2 symmetries of an operator, i.e. Pauli
+    strings g_k commuting with each of its terms, and a Clifford circuit C mapping each of them to a
+    single-qubit Z: C g_k C^dagger = s_k Z_{q_k}.
+
+    Args:
+        zx_voids (NDArray): Terms of the operator, with the Z bits [0, num_qubits) followed by the X
+            bits [num_qubits, 2 * num_qubits) of each term
+        num_qubits (int): Number of qubits
+
+    Returns:
+        Tuple: (generators, qubits, gates, signs): the g_k as zx voids, the q_k, C compiled as by
+        compile_gates(), and the s_k (+1 or -1)
+    """
+    return _clifford.z2_symmetries(_contiguous(zx_voids).ravel(), num_qubits)
+
+
+def taper(
+    zx_voids: NDArray,
+    weights: NDArray,
+    num_qubits: int,
+    sector=None,
+    tolerance: float = 0.0,
+) -> Tuple[NDArray, NDArray]:
+    """
+    Tapers one qubit off an operator per Z2 symmetry found by z2_symmetries(): the terms are
+    conjugated by the Clifford circuit, each Z_{q_k} is replaced by the eigenvalue of g_k in the
+    chosen sector, the qubits q_k are removed, and identical terms are summed.
+
+    Args:
+        zx_voids (NDArray): Terms of the operator, in the same layout as for z2_symmetries()
+        weights (NDArray): Weights of the terms
+        num_qubits (int): Number of qubits
+        sector (optional): Eigenvalue (+1 or -1) of each generator, in the order of
+            z2_symmetries(). Defaults to all +1.
+        tolerance (float, optional): Terms whose summed weight has a magnitude <= tolerance are
+            dropped. Defaults to 0.
+
+    Returns:
+        Tuple[NDArray, NDArray]: The zx voids, on num_qubits - k qubits, and weights of the tapered
+        operator, in no specific order
+    """
+    return _clifford.taper(
+        _contiguous(zx_voids).ravel(),
+        np.ascontiguousarray(weights, dtype=np.complex128).ravel(),
+        num_qubits,
+        None if sector is None else [int(s) for s in sector],
+        tolerance,
+    )
+
+
+if C_CCP:
+
+    class StabilizerTableau(_clifford.StabilizerTableau):
+        """
+        Stabilizer state stored as an Aaronson-Gottesman tableau. Starts in |0...0>.
+        """
+
+        def apply(self, gates):
+            """
+            Applies a Clifford circuit, given as a list of gates or compiled with compile_gates().
+            """
+            self.apply_circuit(compile_gates(gates))
+
+        def expectation_values(self, z_voids: NDArray, x_voids: NDArray) -> NDArray[np.float64]:
+            return super().expectation_values(_contiguous(z_voids), _contiguous(x_voids))
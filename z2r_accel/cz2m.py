@@ -73,7 +73,7 @@ def unordered_unique(
 
     idx, inv = _cz2m.unordered_unique(z2r)
 
-    uniques = pa.PauliArray.from_zx_voids(paulis.zx_voids[idx], paulis.num_qubits)
+    uniques = pa.PauliArray.from_zx_voids(take(paulis.zx_voids, idx), paulis.num_qubits)
     # uniques = None
 
     # print("Uniques:", uniques)
@@ -92,6 +92,14 @@ def random_zx_strings(shape):
     return _cz2m.random_zx_strings(shape)
 
 
+def random_zx_voids(
+    shape, itemsize: int, num_qubits: int = -1, weight: int = -1, seed=None
+) -> Tuple[NDArray, NDArray]:
+    if isinstance(shape, int):
+        shape = (shape,)
+    return _cz2m.random_zx_voids(shape, itemsize, num_qubits, weight, seed)
+
+
 def transpose(z2r: NDArray, num_qubits: int) -> NDArray:
     return _cz2m.transpose(_contiguous(z2r), num_qubits)
 
@@ -108,6 +116,15 @@ def transpose(z2r: NDArray, num_qubits: int) -> NDArray:
 #     return "\n".join(lines)
 
 
+def compose_many(z1s, x1s, z2s, x2s) -> list[Tuple[NDArray, NDArray, NDArray]]:
+    """
+    Composes (z1s[i], x1s[i]) with (z2s[i], x2s[i]) for every i in a single call, which is much
+    cheaper than a loop of compose() calls on small arrays. Returns a (z_voids, x_voids, phases)
+    tuple per composition. The outputs are views into a few shared buffers.
+    """
+    return _cz2m.compose_many(z1s, x1s, z2s, x2s)
+
+
 def matmul(z2r_1: NDArray, z2r_2: NDArray, a_num_qubits: int, b_num_qubits: int) -> NDArray:
     return _cz2m.matmul(_contiguous(z2r_1), _contiguous(z2r_2), a_num_qubits, b_num_qubits)
 
@@ -126,3 +143,303 @@ def z2_to_uint8(z2r: NDArray, num_qubits: int) -> NDArray:
 
 def gauss_jordan_inverse(matrix: NDArray, num_qubits: int) -> NDArray:
     return _cz2m.gauss_jordan_inverse(_contiguous(matrix), num_qubits)
+
+
+def batched_gauss_jordan_inverse(matrices: NDArray, num_qubits: int) -> Tuple[NDArray, NDArray]:
+    return _cz2m.batched_gauss_jordan_inverse(_contiguous(matrices), num_qubits)
+
+
+def get_qubit_slices(z2r: NDArray, indices) -> NDArray:
+    return _cz2m.get_qubit_slices(_contiguous(z2r), indices)
+
+
+def set_qubit_slices(z2r: NDArray, sub_z2r: NDArray, indices) -> NDArray:
+    return _cz2m.set_qubit_slices(_contiguous(z2r), _contiguous(sub_z2r), indices)
+
+
+def permute_qubits(z2r: NDArray, permutation) -> NDArray:
+    return _cz2m.permute_qubits(_contiguous(z2r), permutation)
+
+
+def operator_product(
+    zx_a: NDArray,
+    w_a: NDArray,
+    zx_b: NDArray,
+    w_b: NDArray,
+    num_qubits: int,
+    tolerance: float = 0.0,
+) -> Tuple[NDArray, NDArray]:
+    """
+    Product of the weighted sums of Pauli strings (zx_a, w_a) and (zx_b, w_b), where each zx void
+    holds the Z bits [0, num_qubits) followed by the X bits [num_qubits, 2 * num_qubits). The
+    N * M products are accumulated directly into unique terms.
+    """
+    return _cz2m.operator_product(
+        _contiguous(zx_a).ravel(),
+        np.ascontiguousarray(w_a, dtype=np.complex128).ravel(),
+        _contiguous(zx_b).ravel(),
+        np.ascontiguousarray(w_b, dtype=np.complex128).ravel(),
+        num_qubits,
+        tolerance,
+    )
+
+
+def commutator(
+    zx_a: NDArray,
+    w_a: NDArray,
+    zx_b: NDArray,
+    w_b: NDArray,
+    num_qubits: int,
+    tolerance: float = 0.0,
+    return_norm: bool = False,
+):
+    """
+    Commutator [A, B] of the weighted sums of Pauli strings (zx_a, w_a) and (zx_b, w_b), in the same
+    stitched layout as operator_product. Only the anticommuting pairs of terms are composed. With
+    return_norm, only sqrt(sum |c_k|^2) of the resulting weights is returned.
+    """
+    return _cz2m.commutator(
+        _contiguous(zx_a).ravel(),
+        np.ascontiguousarray(w_a, dtype=np.complex128).ravel(),
+        _contiguous(zx_b).ravel(),
+        np.ascontiguousarray(w_b, dtype=np.complex128).ravel(),
+        num_qubits,
+        tolerance,
+        return_norm,
+    )
+
+
+def simplify(
+    zx_voids: NDArray, weights: NDArray, tolerance: float = 0.0
+) -> Tuple[NDArray, NDArray]:
+    """
+    Sums the weights of identical Pauli strings and drops the terms whose summed weight has a
+    magnitude <= tolerance. The order of the returned terms is unspecified.
+    """
+    return _cz2m.simplify(
+        _contiguous(zx_voids).ravel(),
+        np.ascontiguousarray(weights, dtype=np.complex128).ravel(),
+        tolerance,
+    )
+
+
+def hash_partition(zx_voids: NDArray, num_partitions: int) -> NDArray[np.int64]:
+    return _cz2m.hash_partition(_contiguous(zx_voids).ravel(), num_partitions)
+
+
+def split_zx(
+    zx_voids: NDArray, num_qubits: int, z_out: NDArray = None, x_out: NDArray = None
+) -> Tuple[NDArray, NDArray]:
+    """
+    Splits stitched zx voids (Z bits [0, num_qubits) followed by X bits) into (z_voids, x_voids).
+    When given, z_out and x_out must be writeable C-contiguous void arrays of the same shape, and
+    are filled in place instead of allocating new arrays.
+    """
+    return _cz2m.split_zx(_contiguous(zx_voids), num_qubits, z_out, x_out)
+
+
+def stitch_zx(z_voids: NDArray, x_voids: NDArray, num_qubits: int, out: NDArray = None) -> NDArray:
+    """Stitches Z and X voids into zx voids. Inverse of split_zx(); out is filled in place."""
+    return _cz2m.stitch_zx(_contiguous(z_voids), _contiguous(x_voids), num_qubits, out)
+
+
+def zx_compose(
+    zx1: NDArray, zx2: NDArray, num_qubits: int, out: NDArray = None
+) -> Tuple[NDArray, NDArray[np.complex128]]:
+    """
+    compose() on stitched zx voids: returns (zx_voids, phases), with the same phase convention.
+    out may be zx1 or zx2 itself, to compose in place.
+    """
+    zx1, zx2 = _bc(zx1, zx2)
+    return _cz2m.zx_compose(zx1, zx2, num_qubits, out)
+
+
+def zx_commute_with(zx1: NDArray, zx2: NDArray, num_qubits: int) -> NDArray[np.bool_]:
+    """Whether the Pauli strings of two arrays of stitched zx voids commute, element by element."""
+    return _cz2m.zx_commute_with(*_bc(zx1, zx2), num_qubits)
+
+
+def zx_bitwise_commute_with(zx1: NDArray, zx2: NDArray, num_qubits: int) -> NDArray[np.bool_]:
+    """Qubit-wise commutation of two arrays of stitched zx voids, as bitwise_commute_with()."""
+    return _cz2m.zx_bitwise_commute_with(*_bc(zx1, zx2), num_qubits)
+
+
+def zx_weight(zx_voids: NDArray, num_qubits: int) -> NDArray[np.int64]:
+    """Number of non-identity qubits of each Pauli string of stitched zx voids."""
+    return _cz2m.zx_weight(_contiguous(zx_voids), num_qubits)
+
+
+def commutes_all(zx_voids: NDArray, zx_terms: NDArray, num_qubits: int, qubit_wise: bool = False):
+    """
+    Whether each Pauli string of zx_voids (stitched zx voids, or a single one) commutes with all the
+    strings of zx_terms, qubit-wise if qubit_wise. Stops at the first anticommuting term, instead of
+    building the full array of flags of zx_commute_with() and reducing it.
+    """
+    return _cz2m.commutes_all(
+        np.ascontiguousarray(zx_voids), _contiguous(zx_terms), num_qubits, qubit_wise
+    )[()]
+
+
+def commutes_any(zx_voids: NDArray, zx_terms: NDArray, num_qubits: int, qubit_wise: bool = False):
+    """Whether each Pauli string of zx_voids commutes with at least one string of zx_terms."""
+    return _cz2m.commutes_any(
+        np.ascontiguousarray(zx_voids), _contiguous(zx_terms), num_qubits, qubit_wise
+    )[()]
+
+
+def count_anticommuting(
+    zx_voids: NDArray, zx_terms: NDArray, num_qubits: int, qubit_wise: bool = False
+):
+    """Number of strings of zx_terms that do not commute with each Pauli string of zx_voids."""
+    return _cz2m.count_anticommuting(
+        np.ascontiguousarray(zx_voids), _contiguous(zx_terms), num_qubits, qubit_wise
+    )[()]
+
+
+def first_anticommuting(
+    zx_voids: NDArray, zx_terms: NDArray, num_qubits: int, qubit_wise: bool = False
+):
+    """
+    Index of the first string of zx_terms that does not commute with each Pauli string of zx_voids,
+    or -1 if they all commute.
+    """
+    return _cz2m.first_anticommuting(
+        np.ascontiguousarray(zx_voids), _contiguous(zx_terms), num_qubits, qubit_wise
+    )[()]
+
+
+def commute_mask(
+    zx_voids: NDArray, zx_terms: NDArray, num_qubits: int, qubit_wise: bool = False
+) -> NDArray[np.uint8]:
+    """
+    Bit-packed commutation flags of each Pauli string of zx_voids with every string of zx_terms,
+    of shape (*zx_voids.shape, (len(zx_terms) + 7) // 8): bit j is set when zx_terms[j] commutes.
+    np.unpackbits(mask, axis=-1, count=len(zx_terms), bitorder="little") gives the bool flags.
+    """
+    return _cz2m.commute_mask(
+        np.ascontiguousarray(zx_voids), _contiguous(zx_terms), num_qubits, qubit_wise
+    )
+
+
+def _weights(weights, size: int) -> NDArray[np.complex128]:
+    return np.ascontiguousarray(
+        np.broadcast_to(np.asarray(weights, dtype=np.complex128).ravel(), (size,))
+    )
+
+
+def filter_terms(
+    zx_voids: NDArray,
+    weights: NDArray = None,
+    num_qubits: int = 0,
+    tolerance: float = None,
+    max_weight: int = None,
+    support=None,
+) -> Tuple[NDArray, NDArray]:
+    """
+    Keeps the terms, in their order, whose weight has a magnitude > tolerance, which act on at most
+    max_weight qubits and whose support lies within the qubits of support, in one parallel pass
+    instead of a chain of boolean masks. Each check is skipped when its argument is None;
+    max_weight and support need the num_qubits of the stitched zx voids, and raise an error without
+    it. Returns (zx_voids, weights), weights being None when not given.
+    """
+    zx_voids = _contiguous(zx_voids).ravel()
+    if weights is not None:
+        weights = _weights(weights, zx_voids.size)
+    if support is not None:
+        support = np.ascontiguousarray(support, dtype=np.int64).ravel()
+    return _cz2m.filter_terms(zx_voids, weights, num_qubits, tolerance, max_weight, support)
+
+
+def take(zx_voids: NDArray, indices: NDArray, weights: NDArray = None):
+    """
+    zx_voids[indices], gathered in parallel. With weights, returns (zx_voids[indices],
+    weights[indices]).
+    """
+    zx_voids = _contiguous(zx_voids).ravel()
+    indices = np.ascontiguousarray(indices, dtype=np.int64).ravel()
+    if weights is None:
+        return _cz2m.take_terms(zx_voids, indices)[0]
+    return _cz2m.take_terms(zx_voids, indices, _weights(weights, zx_voids.size))
+
+
+def top_k(zx_voids: NDArray, weights: NDArray, k: int) -> Tuple[NDArray, NDArray]:
+    """
+    The k terms of largest weight magnitude, as (zx_voids, weights), by decreasing magnitude. As in
+    a NumPy sort, the weights of NaN magnitude come last.
+    """
+    zx_voids = _contiguous(zx_voids).ravel()
+    return _cz2m.top_k_terms(zx_voids, _weights(weights, zx_voids.size), k)
+
+
+if C_CCP:
+
+    class PauliIndex(_cz2m.PauliIndex):
+        """
+        Set of unique Pauli strings (voids of any layout, only byte equality matters), numbered in
+        insertion order. The hash table is built once and kept, so that batched queries and set
+        operations cost O(queries) instead of a rebuild of the whole set, as unordered_unique()
+        does. The arguments can be voids of the same itemsize, or another PauliIndex.
+        """
+
+        def __init__(self, zx_voids):
+            if isinstance(zx_voids, _cz2m.PauliIndex):
+                super().__init__(zx_voids)
+            else:
+                super().__init__(self._voids(zx_voids))
+
+        @staticmethod
+        def _voids(zx_voids):
+            if isinstance(zx_voids, _cz2m.PauliIndex):
+                return zx_voids.keys()
+            return _contiguous(zx_voids).ravel()
+
+        def lookup(self, zx_voids) -> NDArray[np.int64]:
+            """Number of each void in the set, or -1 if it is not there."""
+            return super().lookup(self._voids(zx_voids))
+
+        def isin(self, zx_voids) -> NDArray[np.bool_]:
+            """Whether each void is in the set."""
+            return super().isin(self._voids(zx_voids))
+
+        def insert(self, zx_voids) -> NDArray[np.int64]:
+            """Adds voids to the set. Returns the number of each of them, new or not."""
+            return super().insert(self._voids(zx_voids))
+
+        def intersect(self, zx_voids) -> Tuple[NDArray[np.int64], NDArray[np.int64]]:
+            """(positions, numbers) of the voids that are in the set."""
+            return super().intersect(self._voids(zx_voids))
+
+        def difference(self, zx_voids) -> NDArray[np.int64]:
+            """Numbers of the voids of the set that are not among zx_voids, in increasing order."""
+            return super().difference(self._voids(zx_voids))
+
+        def union(self, zx_voids) -> Tuple["PauliIndex", NDArray[np.int64]]:
+            """A new index holding both sets, and the number of each of zx_voids in it."""
+            result = self.copy()
+            return result, result.insert(zx_voids)
+
+        def copy(self) -> "PauliIndex":
+            return PauliIndex(self)
+
+    class OperatorBuilder(_cz2m.OperatorBuilder):
+        """
+        Builds a weighted sum of Pauli strings from many batches of terms. add() only appends, and
+        the pending terms are merged into the unique ones (summing the weights of identical voids)
+        once there are flush_threshold of them, or on flush() and finalize(). The unique voids keep
+        their hash, so a merge only hashes the new terms: no concatenate then simplify() of the
+        whole operator after every batch.
+        """
+
+        def add(self, zx_voids, weights) -> None:
+            """Appends terms. weights can be a scalar, shared by all the voids."""
+            zx_voids = _contiguous(zx_voids).ravel()
+            weights = np.broadcast_to(np.asarray(weights, dtype=np.complex128), zx_voids.shape)
+            super().add(zx_voids, np.ascontiguousarray(weights))
+
+        def finalize(self, tolerance: float = 0.0) -> Tuple[NDArray, NDArray[np.complex128]]:
+            """
+            (zx_voids, weights) of the unique terms whose summed weight has a magnitude >
+            tolerance, in the order of their first addition. The builder can take more terms
+            afterwards.
+            """
+            return super().finalize(tolerance)
@@ -0,0 +1,155 @@
+## @package z2r_accel.fermion
+# @file fermion.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Fermion-to-qubit mappings (Jordan-Wigner, parity and Bravyi-Kitaev).
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# The mapped operators are returned as (zx_voids, weights): each zx void holds the Z bits
+# [0, num_modes) followed by the X bits [num_modes, 2 * num_modes) of a term, mode j being mapped
+# to qubit j. The terms are unique, in no specific order.
+
+import numpy as np
+from numpy.typing import NDArray
+from typing import Tuple
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+# Must be kept in sync with the FermionMapping enum in fermion.h
+FERMION_MAPPINGS = {"jordan_wigner": 0, "parity": 1, "bravyi_kitaev": 2}
+
+
+def _mapping_code(mapping: str) -> int:
+    if mapping not in FERMION_MAPPINGS:
+        raise ValueError(f"Unknown mapping {mapping!r}. Expected one of {list(FERMION_MAPPINGS)}")
+    return FERMION_MAPPINGS[mapping]
+
+
+def ladder_to_qubit(
+    modes: NDArray,
+    creation: NDArray,
+    values: NDArray,
+    num_modes: int,
+    mapping: str = "jordan_wigner",
+    tolerance: float = 0.0,
+) -> Tuple[NDArray, NDArray]:
+    """
+    Maps sum_t values[t] op_{t,0} op_{t,1} ... to qubits, op_{t,k} being the creation (if
+    creation[t, k]) or annihilation operator of mode modes[t, k].
+
+    Args:
+        modes (NDArray): Modes of the ladder operators, of shape (num_terms, length). A mode of -1
+            is an identity, to pad the shorter terms.
+        creation (NDArray): Booleans broadcastable to the shape of modes, e.g. [True, False] for
+            terms a_i^dagger a_j
+        values (NDArray): Coefficient of each term
+        num_modes (int): Number of modes, which is also the number of qubits
+        mapping (str, optional): "jordan_wigner", "parity" or "bravyi_kitaev"
+        tolerance (float, optional): Terms whose summed weight has a magnitude <= tolerance are
+            dropped. Defaults to 0.
+
+    Returns:
+        Tuple[NDArray, NDArray]: The zx voids and weights of the mapped operator
+    """
+    modes = np.ascontiguousarray(modes, dtype=np.int64)
+    if modes.ndim == 1:
+        modes = modes.reshape(-1, 1)
+    creation = np.ascontiguousarray(np.broadcast_to(np.asarray(creation, dtype=bool), modes.shape))
+    return _cz2m.fermion_to_qubit(
+        modes,
+        creation,
+        np.ascontiguousarray(values, dtype=np.complex128).ravel(),
+        num_modes,
+        _mapping_code(mapping),
+        tolerance,
+    )
+
+
+def _integral_terms(integrals, rank: int) -> Tuple[NDArray, NDArray]:
+    """Mode indices, of shape (num_terms, rank), and values of dense or sparse integrals."""
+    if isinstance(integrals, tuple):
+        orbitals, values = integrals
+        indices = np.stack([np.asarray(o, dtype=np.int64) for o in orbitals], axis=1)
+        values = np.asarray(values)
+    else:
+        integrals = np.asarray(integrals)
+        nonzero = np.nonzero(integrals)
+        indices = np.stack(nonzero, axis=1).astype(np.int64)
+        values = integrals[nonzero]
+    if indices.shape[1:] != (rank,):
+        raise ValueError(f"Expected {rank} mode indices per term, got shape {indices.shape}")
+    return indices.reshape(-1, rank), values.ravel()
+
+
+def fermion_to_qubit(
+    one_body=None,
+    two_body=None,
+    num_modes: int | None = None,
+    mapping: str = "jordan_wigner",
+    constant: complex = 0.0,
+    tolerance: float = 0.0,
+) -> Tuple[NDArray, NDArray]:
+    """
+    Maps H = constant + sum_ij h_ij a_i^dagger a_j + sum_ijkl h_ijkl a_i^dagger a_j^dagger a_k a_l
+    to qubits, in a single parallel C++ call. There is no implicit factor of 1/2 on the two-body
+    terms: h_ijkl is the coefficient of each ordered product, as in the terms of qiskit-nature's
+    second_q_op().
+
+    Args:
+        one_body (optional): The h_ij, either as a dense (N, N) tensor, whose zeros are skipped, or
+            as a sparse (orbitals, values) tuple, orbitals being 2 arrays of mode indices (i and j)
+        two_body (optional): The h_ijkl, as a dense (N, N, N, N) tensor or a sparse
+            (orbitals, values) tuple with 4 arrays of mode indices
+        num_modes (int, optional): Number of modes. Defaults to N for dense tensors, or to one more
+            than the highest mode index.
+        mapping (str, optional): "jordan_wigner", "parity" or "bravyi_kitaev"
+        constant (complex, optional): Coefficient of the identity. Defaults to 0.
+        tolerance (float, optional): Terms whose summed weight has a magnitude <= tolerance are
+            dropped. Defaults to 0.
+
+    Returns:
+        Tuple[NDArray, NDArray]: The zx voids and weights of the mapped operator
+    """
+    parts = []
+    if one_body is not None:
+        parts.append((*_integral_terms(one_body, 2), [True, False]))
+    if two_body is not None:
+        parts.append((*_integral_terms(two_body, 4), [True, True, False, False]))
+
+    if num_modes is None:
+        num_modes = 0
+        for integrals in (one_body, two_body):
+            if integrals is not None and not isinstance(integrals, tuple):
+                num_modes = max(num_modes, np.shape(integrals)[0])
+        for indices, _, _ in parts:
+            if indices.size:
+                num_modes = max(num_modes, int(indices.max()) + 1)
+
+    # Every term is padded to 4 ladder operators, the constant being a term with none
+    length = 4
+    modes = [np.full((1, length), -1, dtype=np.int64)]
+    creation = [np.zeros((1, length), dtype=bool)]
+    values = [np.array([constant], dtype=np.complex128)]
+    for indices, vals, pattern in parts:
+        padded = np.full((len(indices), length), -1, dtype=np.int64)
+        padded[:, : indices.shape[1]] = indices
+        flags = np.zeros((len(indices), length), dtype=bool)
+        flags[:, : len(pattern)] = pattern
+        modes.append(padded)
+        creation.append(flags)
+        values.append(np.asarray(vals, dtype=np.complex128))
+
+    return ladder_to_qubit(
+        np.concatenate(modes),
+        np.concatenate(creation),
+        np.concatenate(values),
+        num_modes,
+        mapping,
+        tolerance,
+    )
@@ -0,0 +1,131 @@
+## @package z2r_accel.futures
+# @file futures.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Asynchronous variants of the heavy kernels.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# The *_async functions submit the kernel to an internal pool of worker threads and return at once
+# with a Z2RFuture. The kernels release the GIL while they run, so the calling thread (and the
+# asyncio event loop) is free in the meantime. A Z2RFuture is a concurrent.futures.Future, usable
+# with concurrent.futures.wait() / as_completed(), and can also be awaited in a coroutine.
+#
+# Each call runs with get_num_threads() // num_workers OpenMP threads by default, counted from the
+# settings of the calling thread when it is submitted, so that several asynchronous calls in flight
+# do not oversubscribe the cores and a later set_num_threads() or thread_limits() is followed.
+
+import asyncio
+import concurrent.futures
+import threading
+
+import numpy as np
+from numpy.typing import NDArray
+
+from .threads import get_num_threads, thread_limits
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+_pool_lock = threading.Lock()
+_pool = None
+_num_workers = 2
+_threads_per_worker = None
+
+
+def _contiguous(a):
+    if a.flags.c_contiguous:
+        return a
+    else:
+        return np.ascontiguousarray(a)
+
+
+class Z2RFuture(concurrent.futures.Future):
+    """
+    Result of an asynchronous kernel call. `inputs` holds the arrays the kernel reads, so that they
+    stay alive until the kernel is done, even if the caller drops them. They must not be written
+    to before the future is done.
+    """
+
+    def __init__(self, inputs: tuple):
+        super().__init__()
+        self.inputs = inputs
+
+    def __await__(self):
+        return asyncio.wrap_future(self).__await__()
+
+
+def _executor() -> concurrent.futures.ThreadPoolExecutor:
+    # Called with _pool_lock held
+    global _pool
+    if _pool is None:
+        _pool = concurrent.futures.ThreadPoolExecutor(_num_workers, thread_name_prefix="z2r")
+    return _pool
+
+
+def set_async_workers(num_workers: int, threads_per_worker: int | None = None) -> None:
+    """
+    Sets the number of worker threads running the *_async kernels, and the number of OpenMP threads
+    each call uses (by default, get_num_threads() // num_workers, when the call is submitted). Calls
+    already submitted finish on the previous pool.
+    """
+    global _pool, _num_workers, _threads_per_worker
+    if num_workers < 1:
+        raise ValueError("num_workers must be at least 1")
+    with _pool_lock:
+        if _pool is not None:
+            _pool.shutdown(wait=False)
+        _pool = None
+        _num_workers = num_workers
+        _threads_per_worker = threads_per_worker
+
+
+def _submit(kernel, *inputs) -> Z2RFuture:
+    future = Z2RFuture(inputs)
+
+    def run(num_threads: int):
+        if not future.set_running_or_notify_cancel():
+            return
+        try:
+            with thread_limits(num_threads):
+                result = kernel(*inputs)
+        except BaseException as exc:
+            future.set_exception(exc)
+        else:
+            future.set_result(result)
+
+    with _pool_lock:
+        num_threads = _threads_per_worker or max(get_num_threads() // _num_workers, 1)
+        _executor().submit(run, num_threads)
+    return future
+
+
+def unordered_unique_async(z2r: NDArray) -> Z2RFuture:
+    """Asynchronous _cz2m.unordered_unique(). The result is (indices, inverse)."""
+    return _submit(_cz2m.unordered_unique, _contiguous(z2r))
+
+
+def compose_async(z1: NDArray, x1: NDArray, z2: NDArray, x2: NDArray) -> Z2RFuture:
+    """Asynchronous _cz2m.compose(). The result is (z_voids, x_voids, phases)."""
+    return _submit(
+        _cz2m.compose, _contiguous(z1), _contiguous(x1), _contiguous(z2), _contiguous(x2)
+    )
+
+
+def matmul_async(z2r_1: NDArray, z2r_2: NDArray, a_num_qubits: int, b_num_qubits: int) -> Z2RFuture:
+    """Asynchronous matmul()."""
+    return _submit(_cz2m.matmul, _contiguous(z2r_1), _contiguous(z2r_2), a_num_qubits, b_num_qubits)
+
+
+def row_echelon_async(z2r: NDArray, num_qubits: int) -> Z2RFuture:
+    """Asynchronous row_echelon()."""
+    return _submit(_cz2m.row_echelon, _contiguous(z2r), num_qubits)
+
+
+def to_matrix_async(z_voids: NDArray, x_voids: NDArray, num_qubits: int) -> Z2RFuture:
+    """Asynchronous _cz2m.to_matrix()."""
+    return _submit(_cz2m.to_matrix, _contiguous(z_voids), _contiguous(x_voids), num_qubits)
@@ -0,0 +1,56 @@
+## @package z2r_accel.perf
+# @file perf.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Per-kernel performance counters of the C++ modules.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# The counters are compiled in with -DZ2R_PERF_COUNTERS=ON, and record nothing until
+# enable_stats() is called (or the Z2R_STATS environment variable is set to 1 before import).
+# Builds without the flag carry no instrumentation at all: stats() is then always empty.
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+
+def stats_available() -> bool:
+    """Whether the C++ modules were built with the performance counters."""
+    return C_CCP and _cz2m.stats_compiled()
+
+
+def enable_stats(enabled: bool = True) -> None:
+    """Starts (or stops) recording the per-kernel counters of the C++ modules."""
+    if enabled and not stats_available():
+        raise RuntimeError(
+            "The C++ modules were built without performance counters. "
+            "Rebuild them with -DZ2R_PERF_COUNTERS=ON."
+        )
+    if C_CCP:
+        _cz2m.set_stats_enabled(enabled)
+
+
+def stats(reset: bool = False) -> dict:
+    """
+    Returns the counters of every kernel called since the last reset, as
+    {kernel: {"calls", "parallel_calls", "elements", "bytes", "time", "max_threads"}}.
+
+    `parallel_calls` counts the calls that ran a parallel region on more than one thread, and
+    `max_threads` is the largest team that ran one. Both are measured from inside the regions, so
+    they count the threads the runtime gave (OMP_DYNAMIC, OMP_THREAD_LIMIT, nested calls), not the
+    ones asked for. `time` is the total wall time in seconds. With `reset`, the counters are zeroed
+    after being read.
+
+    The kernels of every C++ module count into the same counters, those of the z2r_core library.
+    """
+    return _cz2m.stats(reset) if C_CCP else {}
+
+
+def reset_stats() -> None:
+    """Zeroes the counters of every kernel."""
+    if C_CCP:
+        _cz2m.stats(True)
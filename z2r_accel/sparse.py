@@ -0,0 +1,74 @@
+## @package z2r_accel.sparse
+# @file sparse.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Support-list encoding of low-weight Pauli strings on many qubits.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# A batch of N Pauli strings is a tuple (offsets, entries), as the rows of a CSR matrix: string i
+# is entries[offsets[i]:offsets[i + 1]]. Each uint32 entry is one non-identity qubit q, as
+# (q << 2) | code, with code 1 for X, 2 for Z and 3 for Y, sorted by qubit. A string of weight w
+# takes 8 + 4w bytes, against n / 4 bytes for its Z and X voids: on 1000 qubits, 24 bytes instead of
+# 250 for weight 4.
+
+import numpy as np
+from numpy.typing import NDArray
+from typing import Tuple
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+SupportLists = Tuple[NDArray[np.int64], NDArray[np.uint32]]
+
+
+def _support(support) -> SupportLists:
+    offsets, entries = support
+    return (
+        np.ascontiguousarray(offsets, dtype=np.int64).ravel(),
+        np.ascontiguousarray(entries, dtype=np.uint32).ravel(),
+    )
+
+
+def to_support_lists(z_voids: NDArray, x_voids: NDArray) -> SupportLists:
+    """Converts Pauli strings from Z and X voids to support lists (offsets, entries)."""
+    return _cz2m.to_support_lists(
+        np.ascontiguousarray(z_voids).ravel(), np.ascontiguousarray(x_voids).ravel()
+    )
+
+
+def from_support_lists(support: SupportLists, num_qubits: int) -> Tuple[NDArray, NDArray]:
+    """Converts Pauli strings from support lists back to Z and X voids of num_qubits qubits."""
+    return _cz2m.from_support_lists(*_support(support), num_qubits)
+
+
+def sparse_compose(
+    support_1: SupportLists, support_2: SupportLists
+) -> Tuple[SupportLists, NDArray[np.complex128]]:
+    """
+    Composes two batches of Pauli strings in support lists, element by element. Returns the
+    products, in support lists, and their phases, with the same convention as compose().
+    """
+    offsets, entries, phases = _cz2m.sparse_compose(*_support(support_1), *_support(support_2))
+    return (offsets, entries), phases
+
+
+def sparse_commute_with(support_1: SupportLists, support_2: SupportLists) -> NDArray[np.bool_]:
+    """Whether the Pauli strings of two batches in support lists commute, element by element."""
+    return _cz2m.sparse_commute_with(*_support(support_1), *_support(support_2))
+
+
+def sparse_bitwise_commute_with(
+    support_1: SupportLists, support_2: SupportLists
+) -> NDArray[np.bool_]:
+    """Qubit-wise commutation of two batches in support lists, as bitwise_commute_with()."""
+    return _cz2m.sparse_bitwise_commute_with(*_support(support_1), *_support(support_2))
+
+
+def sparse_unique(support: SupportLists) -> Tuple[NDArray[np.int64], NDArray[np.int64]]:
+    """(indices, inverse) of the unique Pauli strings in support lists, as unordered_unique()."""
+    return _cz2m.sparse_unique(*_support(support))
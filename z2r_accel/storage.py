@@ -0,0 +1,201 @@
+## @package z2r_accel.storage
+# @file storage.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Memory-mapped on-disk container for weighted Z2R operators.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# File layout (little-endian), version 1:
+#
+# | offset         | size                   | content                                        |
+# |----------------|------------------------|------------------------------------------------|
+# | 0              | 8                      | magic b"Z2ROP\0\0\0"                           |
+# | 8              | 4                      | uint32 version                                 |
+# | 12             | 4                      | uint32 flags (reserved, 0)                     |
+# | 16             | 8                      | uint64 num_qubits                              |
+# | 24             | 8                      | uint64 itemsize of the zx voids                |
+# | 32             | 8                      | uint64 number of terms                         |
+# | 40             | 8                      | uint64 offset of the zx void block             |
+# | 48             | 8                      | uint64 offset of the weight block              |
+# | 56             | 8                      | padding                                        |
+# | zx_offset      | num_terms * itemsize   | zx voids (Z bits [0, n), X bits [n, 2n))       |
+# | weights_offset | num_terms * 16         | complex128 weights                             |
+#
+# Both blocks start on a 64-byte boundary, so the views returned by read_operator() are as aligned
+# as freshly allocated NumPy arrays, and can be passed as is to every _cz2m/_bitops kernel.
+
+import mmap
+import os
+import shutil
+import struct
+import tempfile
+from typing import NamedTuple
+
+import numpy as np
+from numpy.typing import NDArray
+
+_MAGIC = b"Z2ROP\0\0\0"
+_VERSION = 1
+_HEADER = struct.Struct("<8sIIQQQQQ8x")
+_ALIGN = 64
+
+
+def _align(offset: int) -> int:
+    return (offset + _ALIGN - 1) // _ALIGN * _ALIGN
+
+
+class Z2ROperator(NamedTuple):
+    zx_voids: NDArray
+    weights: NDArray[np.complex128]
+    num_qubits: int
+
+
+def write_operator(path, zx_voids: NDArray, weights: NDArray, num_qubits: int) -> None:
+    """
+    Writes a weighted sum of Pauli strings to `path`, in the layout described at the top of this
+    module. `zx_voids` holds one stitched void per term, `weights` one complex weight per term.
+    """
+    zx_voids = np.ascontiguousarray(zx_voids).ravel()
+    weights = np.ascontiguousarray(weights, dtype=np.complex128).ravel()
+    if zx_voids.dtype.kind != "V":
+        raise ValueError(f"zx_voids must be a void array, got dtype {zx_voids.dtype}")
+    if zx_voids.size != weights.size:
+        raise ValueError(
+            f"There must be one weight per Pauli string. Got {zx_voids.size} and {weights.size}"
+        )
+    itemsize = zx_voids.dtype.itemsize
+    if 2 * num_qubits > itemsize * 8:
+        raise ValueError("2 * num_qubits exceeds bit capacity of the zx dtype.")
+
+    with open(path, "wb") as f:
+        _write_blocks(f, zx_voids.size, itemsize, num_qubits, [zx_voids.data], [weights.data])
+
+
+def _write_blocks(f, num_terms: int, itemsize: int, num_qubits: int, zx_blocks, weight_blocks):
+    # Each block is a buffer or a binary file object, written in order
+    zx_offset = _align(_HEADER.size)
+    weights_offset = _align(zx_offset + num_terms * itemsize)
+    header = _HEADER.pack(
+        _MAGIC, _VERSION, 0, num_qubits, itemsize, num_terms, zx_offset, weights_offset
+    )
+
+    def copy(block):
+        if hasattr(block, "read"):
+            shutil.copyfileobj(block, f)
+        else:
+            f.write(block)
+
+    f.write(header)
+    f.write(b"\0" * (zx_offset - _HEADER.size))
+    for block in zx_blocks:
+        copy(block)
+    f.write(b"\0" * (weights_offset - zx_offset - num_terms * itemsize))
+    for block in weight_blocks:
+        copy(block)
+
+
+def read_operator(path, mode: str = "r") -> Z2ROperator:
+    """
+    Maps a file written by write_operator() into memory and returns zero-copy views of its zx voids
+    and weights. Pages are only read from disk when they are first touched.
+
+    `mode` is "r" (read-only views), "r+" (writes go to the file) or "c" (copy-on-write, writes
+    stay in memory). The mapping is released when both views are garbage collected.
+    """
+    access = {"r": mmap.ACCESS_READ, "r+": mmap.ACCESS_WRITE, "c": mmap.ACCESS_COPY}
+    if mode not in access:
+        raise ValueError(f'mode must be "r", "r+" or "c", got "{mode}"')
+
+    with open(path, "r+b" if mode == "r+" else "rb") as f:
+        mm = mmap.mmap(f.fileno(), 0, access=access[mode])
+
+    if len(mm) < _HEADER.size:
+        raise ValueError(f"{path} is too small to be a Z2R operator file")
+    magic, version, _, num_qubits, itemsize, num_terms, zx_offset, weights_offset = (
+        _HEADER.unpack_from(mm, 0)
+    )
+    if magic != _MAGIC:
+        raise ValueError(f"{path} is not a Z2R operator file")
+    if version != _VERSION:
+        raise ValueError(f"Unsupported Z2R operator file version {version} (expected {_VERSION})")
+    if weights_offset + num_terms * 16 > len(mm) or zx_offset + num_terms * itemsize > len(mm):
+        raise ValueError(f"{path} is truncated")
+
+    zx_voids = np.frombuffer(mm, dtype=np.dtype(f"V{itemsize}"), count=num_terms, offset=zx_offset)
+    weights = np.frombuffer(mm, dtype=np.complex128, count=num_terms, offset=weights_offset)
+    return Z2ROperator(zx_voids, weights, int(num_qubits))
+
+
+def simplify_out_of_core(
+    src,
+    dst,
+    memory_budget: int = 1 << 30,
+    tolerance: float = 0.0,
+    tmpdir=None,
+) -> int:
+    """
+    Simplifies the operator stored in `src` (see write_operator()) into `dst`, for operators which
+    do not fit in memory. Gives the same terms and weights as simplify() on the whole operator, in a
+    different order.
+
+    The input is mapped and read in chunks. Each chunk is split with hash_partition() into on-disk
+    buckets, so that all the copies of a Pauli string end up in the same bucket. The buckets are
+    then loaded and simplified one at a time with the parallel hash tables of simplify(). The
+    number of buckets is chosen so that a bucket and its hash table stay within about
+    `memory_budget` bytes, as long as the input does not contain a single Pauli string many times
+    over.
+
+    Returns the number of terms written to `dst`.
+    """
+    # Imported here, so that reading and writing files needs neither pauliarray nor the extension
+    from .cz2m import hash_partition, simplify
+
+    op = read_operator(src)
+    itemsize = op.zx_voids.dtype.itemsize
+    total_terms = op.zx_voids.size
+    # Raw term, plus its copy and key in the hash table of simplify(), plus the outputs
+    term_bytes = 4 * (itemsize + 16)
+    chunk_terms = max(memory_budget // term_bytes, 1)
+    num_buckets = max(-(-total_terms // chunk_terms), 1)
+
+    with tempfile.TemporaryDirectory(dir=tmpdir) as tmp:
+        zx_paths = [os.path.join(tmp, f"{b}.zx") for b in range(num_buckets)]
+        w_paths = [os.path.join(tmp, f"{b}.w") for b in range(num_buckets)]
+
+        for start in range(0, total_terms, chunk_terms):
+            zx = op.zx_voids[start : start + chunk_terms]
+            w = op.weights[start : start + chunk_terms]
+            buckets = hash_partition(zx, num_buckets)
+            order = np.argsort(buckets, kind="stable")
+            counts = np.bincount(buckets, minlength=num_buckets)
+            bounds = np.concatenate(([0], np.cumsum(counts)))
+            zx, w = zx[order], w[order]
+            # Files are reopened for every chunk to stay far from the open file limit
+            for b in np.flatnonzero(counts):
+                with open(zx_paths[b], "ab") as f:
+                    f.write(zx[bounds[b] : bounds[b + 1]].data)
+                with open(w_paths[b], "ab") as f:
+                    f.write(w[bounds[b] : bounds[b + 1]].data)
+
+        out_zx_path = os.path.join(tmp, "out.zx")
+        out_w_path = os.path.join(tmp, "out.w")
+        num_terms = 0
+        with open(out_zx_path, "wb") as out_zx, open(out_w_path, "wb") as out_w:
+            for zx_path, w_path in zip(zx_paths, w_paths):
+                if not os.path.exists(zx_path):
+                    continue
+                zx = np.fromfile(zx_path, dtype=op.zx_voids.dtype)
+                w = np.fromfile(w_path, dtype=np.complex128)
+                os.remove(zx_path)
+                os.remove(w_path)
+                zx, w = simplify(zx, w, tolerance)
+                out_zx.write(zx.data)
+                out_w.write(w.data)
+                num_terms += zx.size
+
+        with open(out_zx_path, "rb") as zx_in, open(out_w_path, "rb") as w_in:
+            with open(dst, "wb") as f:
+                _write_blocks(f, num_terms, itemsize, op.num_qubits, [zx_in], [w_in])
+
+    return num_terms
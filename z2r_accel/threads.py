@@ -0,0 +1,153 @@
+## @package z2r_accel.threads
+# @file threads.py
+# @author Zakary Romdhane (zakary.romdhane@usherbrooke.ca)
+# @brief Thread count, scheduling and affinity of the parallel C++ kernels.
+# @date 2026-10-19
+#
+# Copyright: Copyright 2026 Zakary Romdhane
+#
+# The settings are global (every Python thread), except for the ones of thread_limits(), which only
+# apply to the calls made from the thread that entered it. They live in the z2r_core library, which
+# every C++ module shares, and are bound in _cz2m only.
+
+import contextlib
+import os
+from typing import Sequence
+
+# The OpenMP runtime reads OMP_WAIT_POLICY once, when the first C++ module loads it. With an active
+# wait policy, idle workers spin between calls rather than going to sleep.
+if os.environ.get("Z2R_PERSISTENT_POOL", "0") not in ("", "0"):
+    os.environ.setdefault("OMP_WAIT_POLICY", "ACTIVE")
+
+try:
+    from ._core.build import _cz2m
+
+    C_CCP = True
+except ImportError:
+    C_CCP = False
+
+# Must be kept in sync with the Schedule enum in z2r_threads.h (values of omp_sched_t)
+SCHEDULES = {"static": 1, "dynamic": 2, "guided": 3}
+
+
+def _schedule_code(kind: str) -> int:
+    if kind not in SCHEDULES:
+        raise ValueError(f"Unknown schedule {kind!r}. Expected one of {list(SCHEDULES)}")
+    return SCHEDULES[kind]
+
+
+def set_num_threads(num_threads: int | None) -> None:
+    """Sets the number of threads of the parallel kernels. None goes back to the OpenMP default."""
+    if C_CCP:
+        _cz2m.set_num_threads(num_threads or 0)
+
+
+def get_num_threads() -> int:
+    """Number of threads the parallel kernels use when called from this thread."""
+    return _cz2m.get_num_threads() if C_CCP else 1
+
+
+def set_schedule(kind: str = "static", chunk: int = 0) -> None:
+    """
+    Sets the schedule of the parallel loops: "static" (the default), "dynamic" or "guided". `chunk`
+    is the chunk size, 0 for the OpenMP default of this kind.
+    """
+    code = _schedule_code(kind)
+    if C_CCP:
+        _cz2m.set_schedule(code, chunk)
+
+
+def get_schedule() -> tuple[str, int]:
+    """Schedule of the parallel loops, as (kind, chunk)."""
+    if not C_CCP:
+        return "static", 0
+    code, chunk = _cz2m.get_schedule()
+    return {v: k for k, v in SCHEDULES.items()}[code], chunk
+
+
+def set_affinity(cpus: Sequence[int] | None, pin_caller: bool = False) -> None:
+    """
+    Pins the OpenMP threads to the CPUs of a list. Each Python thread calling the kernels (which
+    has its own team) takes the next slice of the list, after those of the threads already pinned,
+    so that concurrent callers such as the *_async workers run on different CPUs. The calling
+    thread itself keeps its CPUs unless pin_caller. None (or an empty list) gives the threads their
+    original CPUs back. Only supported on Linux.
+    """
+    cpus = [int(c) for c in cpus] if cpus is not None else []
+    if C_CCP:
+        _cz2m.set_affinity(cpus, pin_caller)
+
+
+def get_affinity() -> list[int]:
+    """CPUs the threads are pinned to, empty if they are not pinned."""
+    return _cz2m.get_affinity() if C_CCP else []
+
+
+def set_numa(enabled: bool = True, pin_caller: bool = False) -> None:
+    """
+    NUMA mode, for machines with several sockets: the threads of a team are pinned node by node,
+    contiguous thread numbers on the same node (replacing set_affinity()), and the large output
+    arrays are first touched in parallel with a static schedule. Each page of an output then lives
+    on the node of the thread whose static chunk of the kernel covers it, so that the kernels read
+    and write local memory. Matches the "static" schedule (the default). Setting Z2R_NUMA=1 before
+    importing z2r_accel turns it on. Concurrent callers take slices of the CPUs, node by node, and
+    the calling thread is only pinned if pin_caller, as for set_affinity(). Only supported on Linux.
+    """
+    if C_CCP:
+        _cz2m.set_numa(enabled, pin_caller)
+
+
+def get_numa() -> bool:
+    """Whether the NUMA mode is on."""
+    return _cz2m.get_numa() if C_CCP else False
+
+
+def numa_nodes() -> list[list[int]]:
+    """CPUs available to this process, grouped by NUMA node. Empty if the topology is unknown."""
+    return _cz2m.numa_nodes() if C_CCP else []
+
+
+def set_persistent_pool(enabled: bool = True) -> None:
+    """
+    In persistent pool mode, the worker threads are started as soon as the settings change (and
+    right away), instead of on the first large enough call. To also keep them spinning rather than
+    sleeping between calls, set Z2R_PERSISTENT_POOL=1 in the environment before importing
+    z2r_accel.
+    """
+    if C_CCP:
+        _cz2m.set_persistent_pool(enabled)
+
+
+def get_persistent_pool() -> bool:
+    """Whether the persistent pool mode is on."""
+    return _cz2m.get_persistent_pool() if C_CCP else False
+
+
+def warm_up() -> None:
+    """Starts the worker threads now, so that the first parallel call does not pay for it."""
+    if C_CCP:
+        _cz2m.warm_up()
+
+
+class thread_limits(contextlib.ContextDecorator):
+    """
+    Overrides the thread count and/or schedule for the calls made from the current thread, e.g.
+
+        with z2r_accel.thread_limits(4):
+            z2r_accel.matmul(...)
+
+    or, as a decorator, for every call of a function. None keeps the current setting.
+    """
+
+    def __init__(self, num_threads: int | None = None, schedule: str | None = None, chunk: int = 0):
+        self._args = (num_threads or 0, _schedule_code(schedule) if schedule else 0, chunk)
+
+    def __enter__(self):
+        if C_CCP:
+            _cz2m.push_thread_limits(*self._args)
+        return self
+
+    def __exit__(self, *exc):
+        if C_CCP:
+            _cz2m.pop_thread_limits()
+        return False